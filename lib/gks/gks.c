@@ -2159,7 +2159,7 @@ void gks_create_seg(int segn)
       state = GKS_K_SGOP;
 
       /* save segment state */
-      seg_state = (gks_state_list_t *)gks_malloc(sizeof(gks_state_list_t));
+      if (seg_state == NULL) seg_state = (gks_state_list_t *)gks_malloc(sizeof(gks_state_list_t));
       memmove(seg_state, s, sizeof(gks_state_list_t));
     }
   else
@@ -251,6 +251,36 @@ DLLEXPORT char *gks_realloc(void *ptr, int size);
 DLLEXPORT void gks_free(void *ptr);
 DLLEXPORT char *gks_strdup(const char *str);
 
+/* maximum number of characters written by `gks_dtoa` (including the terminating null character) */
+#define GKS_DTOA_BUFFER_SIZE 32
+/* write "E", "NAN" and "INF" instead of "e", "nan" and "inf" */
+#define GKS_DTOA_UPPERCASE 1
+/* append a "." to integral numbers in fixed notation, so they are recognizable as floating point numbers */
+#define GKS_DTOA_MARK_FLOAT 2
+
+DLLEXPORT int gks_dtoa(char *buffer, double value, int flags);
+
+/* maximum length of a shared memory segment name (including the terminating null character) */
+#define GKS_SHM_NAME_SIZE 32
+/* smaller messages are sent through sockets, segments are created with at least this size */
+#define GKS_SHM_MIN_SIZE 65536
+
+typedef struct
+{
+  char name[GKS_SHM_NAME_SIZE];
+  size_t size;
+  char *data;
+  void *base;
+  int is_owner;
+} gks_shm_t;
+
+DLLEXPORT gks_shm_t *gks_shm_create(size_t size);
+DLLEXPORT gks_shm_t *gks_shm_open(const char *name, size_t size);
+DLLEXPORT void gks_shm_close(gks_shm_t *shm);
+DLLEXPORT int gks_shm_is_busy(const gks_shm_t *shm);
+DLLEXPORT void gks_shm_set_busy(gks_shm_t *shm, int busy);
+DLLEXPORT int gks_shm_is_available(int s);
+
 DLLEXPORT void gks_perror(const char *, ...);
 void gks_fatal_error(const char *, ...);
 const char *gks_function_name(int routine);
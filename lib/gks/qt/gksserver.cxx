@@ -37,7 +37,7 @@ inline QRect &operator-=(QRect &rect, const QMargins &margins)
 
 
 GKSConnection::GKSConnection(QTcpSocket *socket)
-    : socket(socket), widget(NULL), dl(NULL), dl_size(0), socket_function(SocketFunction::unknown)
+    : socket(socket), widget(NULL), dl(NULL), dl_size(0), shm(NULL), socket_function(SocketFunction::unknown)
 {
   ++index;
   connect(socket, SIGNAL(readyRead()), this, SLOT(readClient()));
@@ -51,7 +51,8 @@ GKSConnection::GKSConnection(QTcpSocket *socket)
     int width;
     int height;
     char name[6];
-  } workstation_information = {sizeof(workstation_information), 0, 0, 0, 0, "gksqt"};
+    char shared_memory[2];
+  } workstation_information = {sizeof(workstation_information), 0, 0, 0, 0, "gksqt", {'S', 'M'}};
   GKSWidget::inqdspsize(&workstation_information.mwidth, &workstation_information.mheight,
                         &workstation_information.width, &workstation_information.height);
   socket->write(reinterpret_cast<const char *>(&workstation_information), workstation_information.nbytes);
@@ -61,6 +62,7 @@ GKSConnection::~GKSConnection()
 {
   socket->close();
   delete socket;
+  gks_shm_close(shm);
   if (widget != NULL)
     {
       widget->close();
@@ -104,6 +106,51 @@ void GKSConnection::readClient()
           dl_size = 0;
           socket_function = SocketFunction::unknown;
           break;
+        case SocketFunction::attach_shm:
+          {
+            // display lists are read from this shared memory segment until another one is attached
+            char request[GKS_SHM_NAME_SIZE + sizeof(int)];
+            int segment_size;
+            if (socket->bytesAvailable() < (long)sizeof(request)) return;
+            socket->read(request, sizeof(request));
+            memcpy(&segment_size, request + GKS_SHM_NAME_SIZE, sizeof(int));
+            gks_shm_close(shm);
+            shm = (segment_size > 0) ? gks_shm_open(request, segment_size) : NULL;
+            char reply[1]{static_cast<char>(shm != NULL ? SocketFunction::attach_shm : SocketFunction::unknown)};
+            socket->write(reply, sizeof(reply));
+            socket->flush();
+            socket_function = SocketFunction::unknown;
+          }
+          break;
+        case SocketFunction::draw_shm:
+          if (socket->bytesAvailable() < (long)sizeof(int)) return;
+          socket->read((char *)&dl_size, sizeof(int));
+          if (shm != NULL && dl_size <= shm->size)
+            {
+              // the widget keeps the display list for repainting, so it is copied out of the segment
+              dl = new char[dl_size + sizeof(int)];
+              memcpy(dl, shm->data, dl_size);
+              gks_shm_set_busy(shm, 0);
+              memset(dl + dl_size, 0, sizeof(int));
+              if (widget == NULL)
+                {
+                  newWidget();
+                }
+              emit(data(dl));
+            }
+          else
+            {
+              qWarning("GKSserver: Dropped a display list of %d bytes which does not fit into an attached shared memory "
+                       "segment",
+                       dl_size);
+              if (shm != NULL)
+                {
+                  gks_shm_set_busy(shm, 0);
+                }
+            }
+          dl_size = 0;
+          socket_function = SocketFunction::unknown;
+          break;
         case SocketFunction::is_alive:
           {
             char reply[1]{static_cast<char>(SocketFunction::is_alive)};
@@ -6,6 +6,7 @@
 #include <QTcpSocket>
 #include <qstring.h>
 
+#include "gkscore.h"
 #include "gkswidget.h"
 
 
@@ -20,7 +21,9 @@ struct SocketFunction
     close_window = 4,
     is_running = 5,
     inq_ws_state = 6,
-    sample_locator = 7
+    sample_locator = 7,
+    attach_shm = 8,
+    draw_shm = 9
   };
 };
 
@@ -53,6 +56,7 @@ private:
   GKSWidget *widget;
   char *dl;
   unsigned int dl_size;
+  gks_shm_t *shm;
   SocketFunction::Enum socket_function;
 };
 
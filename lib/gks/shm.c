@@ -0,0 +1,231 @@
+#ifndef __FreeBSD__
+#ifdef __unix__
+#define _POSIX_C_SOURCE 200809L
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "gks.h"
+#include "gkscore.h"
+
+/*
+ * Shared memory segments are used to pass large messages to a process on the same host. Only the (small) description
+ * of a segment is sent through the socket connection which also serves as notification mechanism, so both sides can
+ * keep waiting for data in their usual event loops.
+ *
+ * A segment starts with a header of `SHM_HEADER_SIZE` bytes. Its first `int` is set by the writer when a message is
+ * stored in the segment and cleared by the reader when the message was consumed. The writer never modifies a segment
+ * which is still in use but sends the message through the socket instead.
+ *
+ * The reader removes the name of a segment as soon as it has mapped it, so segments cannot be left over when a process
+ * terminates unexpectedly. The writer removes the name on close, too, in case it was never mapped by a reader.
+ */
+
+#define SHM_HEADER_SIZE 64
+#define SHM_NAME_PREFIX "/gks-"
+#define SHM_ENV_KEY "GKS_SHARED_MEMORY"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SHM_MEMORY_BARRIER() __sync_synchronize()
+#else
+#define SHM_MEMORY_BARRIER()
+#endif
+
+#ifndef _WIN32
+
+static int shm_open_fd(const char *name, int flags)
+{
+#ifdef __linux__
+  /* `shm_open` needs `librt` on older glibc versions, but it only opens a file in `/dev/shm` on Linux */
+  char path[GKS_SHM_NAME_SIZE + 16];
+
+  snprintf(path, sizeof(path), "/dev/shm%s", name);
+  return open(path, flags | O_NOFOLLOW, 0600);
+#else
+  return shm_open(name, flags, 0600);
+#endif
+}
+
+static void shm_unlink_name(const char *name)
+{
+#ifdef __linux__
+  char path[GKS_SHM_NAME_SIZE + 16];
+
+  snprintf(path, sizeof(path), "/dev/shm%s", name);
+  unlink(path);
+#else
+  shm_unlink(name);
+#endif
+}
+
+static gks_shm_t *shm_map(int fd, const char *name, size_t size, int is_owner)
+{
+  gks_shm_t *shm;
+  void *base;
+
+  base = mmap(NULL, size + SHM_HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    {
+      return NULL;
+    }
+  shm = (gks_shm_t *)gks_malloc(sizeof(gks_shm_t));
+  /* the name is sent as a whole, so the unused bytes are cleared */
+  memset(shm->name, 0, GKS_SHM_NAME_SIZE);
+  strcpy(shm->name, name);
+  shm->size = size;
+  shm->base = base;
+  shm->data = (char *)base + SHM_HEADER_SIZE;
+  shm->is_owner = is_owner;
+
+  return shm;
+}
+
+#endif
+
+gks_shm_t *gks_shm_create(size_t size)
+{
+#ifndef _WIN32
+  static unsigned int counter = 0;
+  char name[GKS_SHM_NAME_SIZE];
+  gks_shm_t *shm;
+  int fd;
+
+  snprintf(name, GKS_SHM_NAME_SIZE, SHM_NAME_PREFIX "%ld-%u", (long)getpid(), counter++);
+  fd = shm_open_fd(name, O_RDWR | O_CREAT | O_EXCL);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+  if (ftruncate(fd, (off_t)(size + SHM_HEADER_SIZE)) != 0)
+    {
+      close(fd);
+      shm_unlink_name(name);
+      return NULL;
+    }
+  shm = shm_map(fd, name, size, 1);
+  if (shm == NULL)
+    {
+      shm_unlink_name(name);
+    }
+  return shm;
+#else
+  (void)size;
+  return NULL;
+#endif
+}
+
+gks_shm_t *gks_shm_open(const char *name, size_t size)
+{
+#ifndef _WIN32
+  struct stat file_stat;
+  gks_shm_t *shm;
+  int fd;
+
+  /* the name is received from another process, so accept only names created by `gks_shm_create` */
+  if (memchr(name, '\0', GKS_SHM_NAME_SIZE) == NULL || strncmp(name, SHM_NAME_PREFIX, strlen(SHM_NAME_PREFIX)) != 0 ||
+      strchr(name + 1, '/') != NULL)
+    {
+      return NULL;
+    }
+  fd = shm_open_fd(name, O_RDWR);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_uid != geteuid() ||
+      (size_t)file_stat.st_size < size + SHM_HEADER_SIZE)
+    {
+      close(fd);
+      return NULL;
+    }
+  shm = shm_map(fd, name, size, 0);
+  shm_unlink_name(name);
+  return shm;
+#else
+  (void)name;
+  (void)size;
+  return NULL;
+#endif
+}
+
+void gks_shm_close(gks_shm_t *shm)
+{
+#ifndef _WIN32
+  if (shm == NULL)
+    {
+      return;
+    }
+  munmap(shm->base, shm->size + SHM_HEADER_SIZE);
+  if (shm->is_owner)
+    {
+      shm_unlink_name(shm->name);
+    }
+  gks_free(shm);
+#else
+  (void)shm;
+#endif
+}
+
+int gks_shm_is_busy(const gks_shm_t *shm)
+{
+  int busy = *(volatile const int *)shm->base;
+  /* the message of the previous user must not be overwritten before it was read completely */
+  SHM_MEMORY_BARRIER();
+  return busy;
+}
+
+void gks_shm_set_busy(gks_shm_t *shm, int busy)
+{
+  /* make the message (or the completion of reading it) visible before the flag changes */
+  SHM_MEMORY_BARRIER();
+  *(volatile int *)shm->base = busy;
+}
+
+int gks_shm_is_available(int s)
+{
+#ifndef _WIN32
+  struct sockaddr_storage address;
+  socklen_t address_length = sizeof(address);
+  const char *env;
+
+  env = gks_getenv(SHM_ENV_KEY);
+  if (env != NULL && (!strcmp(env, "0") || !strcmp(env, "off") || !strcmp(env, "OFF") || !strcmp(env, "false") ||
+                      !strcmp(env, "FALSE") || !strcmp(env, "no") || !strcmp(env, "NO")))
+    {
+      return 0;
+    }
+  /* a peer connected via a loopback address usually runs on the same host */
+  if (getpeername(s, (struct sockaddr *)&address, &address_length) != 0)
+    {
+      return 0;
+    }
+  if (address.ss_family == AF_INET)
+    {
+      const unsigned char *ip = (const unsigned char *)&((struct sockaddr_in *)&address)->sin_addr;
+      return ip[0] == 127;
+    }
+  if (address.ss_family == AF_INET6)
+    {
+      const struct in6_addr *ip = &((struct sockaddr_in6 *)&address)->sin6_addr;
+      return IN6_IS_ADDR_LOOPBACK(ip) || (IN6_IS_ADDR_V4MAPPED(ip) && ip->s6_addr[12] == 127);
+    }
+  return 0;
+#else
+  (void)s;
+  return 0;
+#endif
+}
@@ -4,6 +4,7 @@
 #endif
 #endif
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -41,6 +42,9 @@
 #define SOCKET_FUNCTION_IS_RUNNING 5
 #define SOCKET_FUNCTION_INQ_WS_STATE 6
 #define SOCKET_FUNCTION_SAMPLE_LOCATOR 7
+/* only sent to servers which announce shared memory support in their workstation information */
+#define SOCKET_FUNCTION_ATTACH_SHM 8
+#define SOCKET_FUNCTION_DRAW_SHM 9
 
 
 #ifndef MAXPATHLEN
@@ -49,12 +53,26 @@
 
 #define PORT "8410"
 
+typedef struct
+{
+  int nbytes;
+  double mwidth;
+  double mheight;
+  int width;
+  int height;
+  char name[6];
+  /* "SM" if the server can read display lists from shared memory, fits into the padding of older versions */
+  char shared_memory[2];
+} workstation_information_t;
+
 typedef struct
 {
   int s;
   int wstype;
   gks_display_list_t dl;
   double aspect_ratio;
+  int shm_supported;
+  gks_shm_t *shm;
 } ws_state_list;
 
 static gks_state_list_t *gkss;
@@ -411,6 +429,99 @@ static int close_socket(int s)
   return 0;
 }
 
+static int read_workstation_information(ws_state_list *wss, workstation_information_t *workstation_information)
+{
+  int nbytes;
+
+  memset(workstation_information, 0, sizeof(workstation_information_t));
+  wss->shm_supported = 0;
+  if (read_socket(wss->s, (char *)&nbytes, sizeof(int), 0) != sizeof(int))
+    {
+      return 0;
+    }
+  if (nbytes != sizeof(workstation_information_t))
+    {
+      /* skip information of unknown layout */
+      if (nbytes > (int)sizeof(int))
+        {
+          char *buf = gks_malloc(nbytes - (int)sizeof(int));
+          read_socket(wss->s, buf, nbytes - (int)sizeof(int), 0);
+          gks_free(buf);
+        }
+      return 0;
+    }
+  if (read_socket(wss->s, (char *)workstation_information + sizeof(int), nbytes - (int)sizeof(int), 0) !=
+      nbytes - (int)sizeof(int))
+    {
+      return 0;
+    }
+  wss->shm_supported = workstation_information->shared_memory[0] == 'S' &&
+                       workstation_information->shared_memory[1] == 'M' && gks_shm_is_available(wss->s);
+  return 1;
+}
+
+static int attach_shm(ws_state_list *wss, size_t size)
+{
+  char request[1 + GKS_SHM_NAME_SIZE + sizeof(int)];
+  char reply;
+  size_t segment_size = GKS_SHM_MIN_SIZE;
+  int segment_size_int;
+
+  gks_shm_close(wss->shm);
+  while (segment_size < size)
+    {
+      segment_size *= 2;
+    }
+  if (segment_size > INT_MAX || (wss->shm = gks_shm_create(segment_size)) == NULL)
+    {
+      wss->shm = NULL;
+      return 0;
+    }
+  request[0] = SOCKET_FUNCTION_ATTACH_SHM;
+  memcpy(request + 1, wss->shm->name, GKS_SHM_NAME_SIZE);
+  segment_size_int = (int)segment_size;
+  memcpy(request + 1 + GKS_SHM_NAME_SIZE, &segment_size_int, sizeof(int));
+  /* the server fails to map the segment if it runs on another host, e.g. when ports are forwarded to `localhost` */
+  if (send_socket(wss->s, request, sizeof(request), 0) != sizeof(request) ||
+      read_socket(wss->s, &reply, 1, 0) != 1 || reply != SOCKET_FUNCTION_ATTACH_SHM)
+    {
+      gks_shm_close(wss->shm);
+      wss->shm = NULL;
+      wss->shm_supported = 0;
+      return 0;
+    }
+  return 1;
+}
+
+static int send_display_list_shm(ws_state_list *wss)
+{
+  /* returns 0 if the display list must be sent through the socket instead */
+  char request[1 + sizeof(int)];
+
+  if (!wss->shm_supported || wss->dl.nbytes < GKS_SHM_MIN_SIZE)
+    {
+      return 0;
+    }
+  if (wss->shm != NULL && gks_shm_is_busy(wss->shm))
+    {
+      /* the server has not consumed the previous display list yet */
+      return 0;
+    }
+  if (wss->shm == NULL || wss->shm->size < (size_t)wss->dl.nbytes)
+    {
+      if (!attach_shm(wss, wss->dl.nbytes))
+        {
+          return 0;
+        }
+    }
+  memcpy(wss->shm->data, wss->dl.buffer, wss->dl.nbytes);
+  gks_shm_set_busy(wss->shm, 1);
+  request[0] = SOCKET_FUNCTION_DRAW_SHM;
+  memcpy(request + 1, &wss->dl.nbytes, sizeof(int));
+  send_socket(wss->s, request, sizeof(request), 0);
+  return 1;
+}
+
 static void check_socket_connection(ws_state_list *wss)
 {
   if (wss->s != -1 && wss->wstype >= 411 && wss->wstype <= 413)
@@ -426,17 +537,15 @@ static void check_socket_connection(ws_state_list *wss)
   if (!is_running)
     {
       close_socket(wss->s);
+      /* the segment is attached to the previous server process */
+      gks_shm_close(wss->shm);
+      wss->shm = NULL;
       wss->s = open_socket(wss->wstype);
       if (wss->s != -1 && wss->wstype >= 411 && wss->wstype <= 413)
         {
-          /* workstation information was already read during OPEN_WS */
-          int nbytes;
-          if (read_socket(wss->s, (char *)&nbytes, sizeof(int), 0) == sizeof(int))
-            {
-              char *buf = gks_malloc(nbytes - (int)sizeof(int));
-              read_socket(wss->s, buf, nbytes - (int)sizeof(int), 0);
-              gks_free(buf);
-            }
+          /* workstation information was already read during OPEN_WS, only shared memory support may have changed */
+          workstation_information_t workstation_information;
+          read_workstation_information(wss, &workstation_information);
         }
     }
 }
@@ -456,6 +565,8 @@ void gks_drv_socket(int fctid, int dx, int dy, int dimx, int *ia, int lr1, doubl
       wss = (ws_state_list *)gks_malloc(sizeof(ws_state_list));
 
       wss->wstype = ia[2];
+      wss->shm_supported = 0;
+      wss->shm = NULL;
       wss->s = open_socket(ia[2]);
       if (wss->s == -1)
         {
@@ -472,20 +583,9 @@ void gks_drv_socket(int fctid, int dx, int dy, int dimx, int *ia, int lr1, doubl
           if (wss->wstype >= 411 && wss->wstype <= 413)
             {
               /* get workstation information */
-              int nbytes;
-              struct
-              {
-                int nbytes;
-                double mwidth;
-                double mheight;
-                int width;
-                int height;
-                char name[6];
-              } workstation_information = {sizeof(workstation_information), 0, 0, 0, 0, ""};
-              if (read_socket(wss->s, (char *)&nbytes, sizeof(int), 0) == sizeof(int) &&
-                  nbytes == workstation_information.nbytes)
+              workstation_information_t workstation_information;
+              if (read_workstation_information(wss, &workstation_information))
                 {
-                  read_socket(wss->s, (char *)&workstation_information + sizeof(int), nbytes - (int)sizeof(int), 0);
                   ia[0] = workstation_information.width;
                   ia[1] = workstation_information.height;
                   r1[0] = workstation_information.mwidth;
@@ -508,6 +608,7 @@ void gks_drv_socket(int fctid, int dx, int dy, int dimx, int *ia, int lr1, doubl
           send_socket(wss->s, &request_type, 1, 0);
         }
       close_socket(wss->s);
+      gks_shm_close(wss->shm);
       if (wss->dl.buffer)
         {
           free(wss->dl.buffer);
@@ -520,6 +621,10 @@ void gks_drv_socket(int fctid, int dx, int dy, int dimx, int *ia, int lr1, doubl
       if (ia[1] & GKS_K_PERFORM_FLAG)
         {
           check_socket_connection(wss);
+          if (send_display_list_shm(wss))
+            {
+              break;
+            }
           request_type = SOCKET_FUNCTION_DRAW;
           if (wss->wstype >= 411 && wss->wstype <= 413)
             {
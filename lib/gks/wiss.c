@@ -27,6 +27,12 @@
 #define GKS_UNUSED(x) (void)(x)
 #endif
 
+typedef struct
+{
+  int segn;
+  int start, end;
+} seg_range;
+
 typedef struct ws_state_list_struct
 {
   int conid, state;
@@ -34,6 +40,8 @@ typedef struct ws_state_list_struct
   int empty;
   char *buffer;
   int size, nbytes;
+  seg_range *ranges;
+  int nranges, max_ranges, ranges_valid;
 } ws_state_list;
 
 static ws_state_list *p;
@@ -43,6 +51,8 @@ static int unused_variable = 0;
 
 static void reallocate(int len)
 {
+  int size = p->size;
+
   while (p->nbytes + len > p->size) p->size += SEGM_SIZE;
 
   p->buffer = (char *)gks_realloc(p->buffer, p->size + 1);
@@ -51,6 +61,8 @@ static void reallocate(int len)
       gks_perror("memory allocation failed");
       exit(1);
     }
+  /* the segment storage is terminated by a zero length item */
+  memset(p->buffer + size, 0, p->size + 1 - size);
 }
 
 #if 0
@@ -214,6 +226,18 @@ static void write_item(int sgnum, int fctid, int dx, int dy, int dimx, int *i_ar
       COPY(f_arr_2, sizeof(double));
       break;
 
+    case 212: /* set clip sector */
+
+      len = 3 * sizeof(int) + 2 * sizeof(double);
+      if (p->nbytes + len > p->size) reallocate(len);
+
+      COPY(&len, sizeof(int));
+      COPY(&sgnum, sizeof(int));
+      COPY(&fctid, sizeof(int));
+      COPY(f_arr_1, sizeof(double));
+      COPY(f_arr_2, sizeof(double));
+      break;
+
     case 41: /* set aspect source flags */
 
       len = 3 * sizeof(int) + 13 * sizeof(int);
@@ -277,10 +301,101 @@ static void write_item(int sgnum, int fctid, int dx, int dy, int dimx, int *i_ar
     }
 }
 
+static void write_state(int sgnum)
+{
+  int i_arr[13], tnr;
+  double f_arr_1[3], f_arr_2[2];
+
+  /* record the current GKS state at the start of the segment, so that the
+     segment can be replayed without depending on the attributes which were
+     in effect when it was created */
+  i_arr[0] = gkss->ltype;
+  write_item(sgnum, 19, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->lwidth;
+  write_item(sgnum, 20, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->plcoli;
+  write_item(sgnum, 21, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->mtype;
+  write_item(sgnum, 23, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->mszsc;
+  write_item(sgnum, 24, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->pmcoli;
+  write_item(sgnum, 25, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->txfont;
+  i_arr[1] = gkss->txprec;
+  write_item(sgnum, 27, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->chxp;
+  write_item(sgnum, 28, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->chsp;
+  write_item(sgnum, 29, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->txcoli;
+  write_item(sgnum, 30, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->chh;
+  write_item(sgnum, 31, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->chup[0];
+  f_arr_2[0] = gkss->chup[1];
+  write_item(sgnum, 32, 0, 0, 0, i_arr, 1, f_arr_1, 1, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->txp;
+  write_item(sgnum, 33, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->txal[0];
+  i_arr[1] = gkss->txal[1];
+  write_item(sgnum, 34, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->ints;
+  write_item(sgnum, 36, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->styli;
+  write_item(sgnum, 37, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->facoli;
+  write_item(sgnum, 38, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  memcpy(i_arr, gkss->asf, 13 * sizeof(int));
+  write_item(sgnum, 41, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+
+  for (tnr = 1; tnr < MAX_TNR; tnr++)
+    {
+      i_arr[0] = tnr;
+      f_arr_1[0] = gkss->window[tnr][0];
+      f_arr_1[1] = gkss->window[tnr][1];
+      f_arr_2[0] = gkss->window[tnr][2];
+      f_arr_2[1] = gkss->window[tnr][3];
+      write_item(sgnum, 49, 0, 0, 0, i_arr, 2, f_arr_1, 2, f_arr_2, 0, NULL);
+      f_arr_1[0] = gkss->viewport[tnr][0];
+      f_arr_1[1] = gkss->viewport[tnr][1];
+      f_arr_2[0] = gkss->viewport[tnr][2];
+      f_arr_2[1] = gkss->viewport[tnr][3];
+      write_item(sgnum, 50, 0, 0, 0, i_arr, 2, f_arr_1, 2, f_arr_2, 0, NULL);
+    }
+  i_arr[0] = gkss->cntnr;
+  write_item(sgnum, 52, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->clip;
+  write_item(sgnum, 53, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->resample_method;
+  write_item(sgnum, 108, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->resize_behaviour;
+  write_item(sgnum, 109, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->txslant;
+  write_item(sgnum, 200, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->shoff[0];
+  f_arr_1[1] = gkss->shoff[1];
+  f_arr_1[2] = gkss->blur;
+  write_item(sgnum, 202, 0, 0, 0, i_arr, 3, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->alpha;
+  write_item(sgnum, 203, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->bwidth;
+  write_item(sgnum, 206, 0, 0, 0, i_arr, 1, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->bcoli;
+  write_item(sgnum, 207, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->clip_tnr;
+  write_item(sgnum, 208, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  i_arr[0] = gkss->clip_region;
+  write_item(sgnum, 211, 0, 0, 0, i_arr, 0, f_arr_1, 0, f_arr_2, 0, NULL);
+  f_arr_1[0] = gkss->clip_start_angle;
+  f_arr_2[0] = gkss->clip_end_angle;
+  write_item(sgnum, 212, 0, 0, 0, i_arr, 1, f_arr_1, 1, f_arr_2, 0, NULL);
+}
+
 static void delete_seg(char *str, int segn)
 {
   char *s, *d;
-  int sp = 0, *len, *sgnum, dp = 0, saved_sp;
+  int sp = 0, *len, *sgnum, dp = 0, saved_sp, item_len;
 
   s = d = str;
 
@@ -292,12 +407,14 @@ static void delete_seg(char *str, int segn)
       RESOLVE(sgnum, int, sizeof(int));
       sp = saved_sp;
 
+      /* the item may overwrite its own header when it is moved */
+      item_len = *len;
       if (*sgnum != 0 && segn != *sgnum)
         {
-          if (sp > dp) memmove(d + dp, s + sp, *len);
-          dp += *len;
+          if (sp > dp) memmove(d + dp, s + sp, item_len);
+          dp += item_len;
         }
-      sp += *len;
+      sp += item_len;
 
       saved_sp = sp;
       RESOLVE(len, int, sizeof(int));
@@ -310,6 +427,44 @@ static void delete_seg(char *str, int segn)
     }
 }
 
+static void add_range(int segn, int start, int end)
+{
+  if (p->nranges == p->max_ranges)
+    {
+      p->max_ranges = p->max_ranges > 0 ? 2 * p->max_ranges : 64;
+      p->ranges = (seg_range *)gks_realloc(p->ranges, p->max_ranges * sizeof(seg_range));
+    }
+  p->ranges[p->nranges].segn = segn;
+  p->ranges[p->nranges].start = start;
+  p->ranges[p->nranges].end = end;
+  p->nranges++;
+}
+
+static void rebuild_ranges(void)
+{
+  char *s = p->buffer;
+  int sp = 0, *len, *sgnum;
+  seg_range *last;
+
+  p->nranges = 0;
+  while (sp < p->nbytes)
+    {
+      len = (int *)(s + sp);
+      if (*len == 0) break;
+      sgnum = (int *)(s + sp + sizeof(int));
+      if (*sgnum != 0)
+        {
+          last = p->nranges > 0 ? p->ranges + p->nranges - 1 : NULL;
+          if (last != NULL && last->segn == *sgnum && last->end == sp)
+            last->end = sp + *len;
+          else
+            add_range(*sgnum, sp, sp + *len);
+        }
+      sp += *len;
+    }
+  p->ranges_valid = 1;
+}
+
 void gks_drv_wiss(int fctid, int dx, int dy, int dimx, int *i_arr, int len_farr_1, double *f_arr_1, int len_farr_2,
                   double *f_arr_2, int len_c_arr, char *c_arr, void **ptr)
 {
@@ -332,12 +487,17 @@ void gks_drv_wiss(int fctid, int dx, int dy, int dimx, int *i_arr, int len_farr_
       p->size = SEGM_SIZE;
       p->nbytes = 0;
 
+      p->ranges = NULL;
+      p->nranges = p->max_ranges = 0;
+      p->ranges_valid = 1;
+
       *ptr = p;
       break;
 
     case 3: /* close workstation */
 
       free(p->buffer);
+      free(p->ranges);
       free(p);
 
       p = NULL;
@@ -358,6 +518,8 @@ void gks_drv_wiss(int fctid, int dx, int dy, int dimx, int *i_arr, int len_farr_
       p->nbytes = 0;
       p->empty = 1;
       memset(p->buffer, 0, p->size);
+      p->nranges = 0;
+      p->ranges_valid = 1;
       break;
 
     case 8: /* update workstation */
@@ -408,6 +570,7 @@ void gks_drv_wiss(int fctid, int dx, int dy, int dimx, int *i_arr, int len_farr_
     case 207:
     case 208:
     case 211:
+    case 212:
 
       if (p->state == GKS_K_WS_ACTIVE)
         {
@@ -434,25 +597,29 @@ void gks_drv_wiss(int fctid, int dx, int dy, int dimx, int *i_arr, int len_farr_
     case 56: /* create segment */
 
       p->segn = i_arr[0];
+      if (p->ranges_valid) add_range(p->segn, p->nbytes, -1);
+      if (p->state == GKS_K_WS_ACTIVE) write_state(p->segn);
       break;
 
     case 57: /* close segment */
 
+      if (p->ranges_valid && p->nranges > 0) p->ranges[p->nranges - 1].end = p->nbytes;
       p->segn = 0;
       break;
 
     case 58: /* delete segment */
 
       delete_seg(p->buffer, i_arr[0]);
+      p->ranges_valid = 0;
       break;
     }
 }
 
-static void interp(char *str, int segn)
+static void interp(char *str, int start, int end, int segn)
 {
   char *s;
   gks_state_list_t *gkss = NULL;
-  int sp = 0, *len, *sgnum, *fctid, sx = 1, sy = 1;
+  int sp = start, *len, *sgnum, *fctid, sx = 1, sy = 1;
   int *i_arr = NULL, *dx = NULL, *dy = NULL, *dimx = NULL, *len_c_arr = NULL;
   int *n = NULL, *primid = NULL, *ldr = NULL;
   double *f_arr_1 = NULL, *f_arr_2 = NULL;
@@ -462,11 +629,12 @@ static void interp(char *str, int segn)
 
   s = str;
 
-  saved_sp = sp;
-  RESOLVE(len, int, sizeof(int));
-
-  while (*len)
+  while (sp < end)
     {
+      saved_sp = sp;
+      RESOLVE(len, int, sizeof(int));
+      if (*len == 0) break;
+
       RESOLVE(sgnum, int, sizeof(int));
       RESOLVE(fctid, int, sizeof(int));
 
@@ -553,7 +721,8 @@ static void interp(char *str, int segn)
           RESOLVE(f_arr_1, double, sizeof(double));
           break;
 
-        case 32: /* set character up vector */
+        case 32:  /* set character up vector */
+        case 212: /* set clip sector */
 
           RESOLVE(f_arr_1, double, sizeof(double));
           RESOLVE(f_arr_2, double, sizeof(double));
@@ -742,17 +911,31 @@ static void interp(char *str, int segn)
             case 211:
               gks_set_clip_region(i_arr[0]);
               break;
+            case 212:
+              gks_set_clip_sector(f_arr_1[0], f_arr_2[0]);
+              break;
             }
         }
-
-      saved_sp = sp;
-      RESOLVE(len, int, sizeof(int));
     }
 }
 
 void gks_wiss_dispatch(int fctid, int wkid, int segn)
 {
+  int i;
   GKS_UNUSED(fctid);
   GKS_UNUSED(wkid);
-  interp(p->buffer, segn);
+
+  if (segn == 0)
+    {
+      interp(p->buffer, 0, p->nbytes, 0);
+      return;
+    }
+
+  /* only interpret the parts of the segment storage which belong to the requested segment */
+  if (!p->ranges_valid) rebuild_ranges();
+  for (i = 0; i < p->nranges; i++)
+    {
+      if (p->ranges[i].segn == segn)
+        interp(p->buffer, p->ranges[i].start, p->ranges[i].end >= 0 ? p->ranges[i].end : p->nbytes, segn);
+    }
 }
@@ -9,6 +9,7 @@
 #include "gkscore.h"
 #include "gr.h"
 #include "contour.h"
+#include "delaunay.h"
 
 #ifndef min
 #define min(a, b) ((a) < (b) ? (a) : (b))
@@ -1527,55 +1528,61 @@ static void convert_segments_to_polylines(int nsegments, vertex_t *segments, int
   *lines = lin;
 }
 
-static void march_triangles(double *x, double *y, double *z, int ntri, int *triangles, double isolevel, int *nlines,
+static void march_triangles(const triangulation_t *triangulation, double isolevel, vertex_t *lin, int *nlines,
                             polyline_t **lines)
 {
+  triangulation_priv_t *priv = triangulation->priv;
   int i, j;
   vertex_t cur_line[2];
   int cur_nlines;
-  vertex_t *lin;
-  double nlin;
   int cur_lin_index;
 
-  lin = (vertex_t *)malloc(ntri * 2 * sizeof(vertex_t));
-  if (lin == NULL)
-    {
-      fprintf(stderr, "out of virtual memory\n");
-      return;
-    }
+  /* triangles are sorted by their minimum Z value, so the first one above the level ends the search */
   cur_lin_index = 0;
-  for (i = 0; i < ntri; ++i)
+  for (i = 0; i < triangulation->ntri && priv->zmin[i] <= isolevel; ++i)
     {
-      interpolate_line_segment(x, y, z, &triangles[3 * i], isolevel, &cur_nlines, cur_line);
+      if (priv->zmax[i] <= isolevel) continue;
+      interpolate_line_segment(priv->x, priv->y, priv->z, &triangulation->triangles[3 * i], isolevel, &cur_nlines,
+                               cur_line);
       for (j = 0; j < 2 * cur_nlines; (j++, cur_lin_index++))
         {
           lin[cur_lin_index].x = cur_line[j].x;
           lin[cur_lin_index].y = cur_line[j].y;
         }
     }
-  lin = realloc(lin, cur_lin_index * sizeof(vertex_t));
-  nlin = cur_lin_index / 2;
 
-  convert_segments_to_polylines(nlin, lin, nlines, lines);
+  if (cur_lin_index > 0) convert_segments_to_polylines(cur_lin_index / 2, lin, nlines, lines);
 }
 
-void gr_draw_tricont(int npoints, double *x, double *y, double *z, int nlevels, double *levels, int *colors)
+void gr_draw_tricont(const triangulation_t *triangulation, int nlevels, double *levels, int *colors)
 {
   int i, l;
-  int ntri, *triangles;
   int nlines = 0;
   polyline_t *lines = NULL;
+  vertex_t *lin;
 
-  gr_delaunay(npoints, x, y, &ntri, &triangles);
+  lin = (vertex_t *)malloc((triangulation->ntri > 0 ? triangulation->ntri : 1) * 2 * sizeof(vertex_t));
+  if (lin == NULL)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      return;
+    }
 
   for (l = 0; l < nlevels; l++)
     {
-      march_triangles(x, y, z, ntri, triangles, levels[l], &nlines, &lines);
+      nlines = 0;
+      lines = NULL;
+      march_triangles(triangulation, levels[l], lin, &nlines, &lines);
 
       gr_setlinecolorind(colors[l]);
-      for (i = 0; i < nlines; i++) gr_polyline(lines[i].npoints, lines[i].x, lines[i].y);
+      for (i = 0; i < nlines; i++)
+        {
+          gr_polyline(lines[i].npoints, lines[i].x, lines[i].y);
+          free(lines[i].x);
+          free(lines[i].y);
+        }
 
       free(lines);
     }
-  free(triangles);
+  free(lin);
 }
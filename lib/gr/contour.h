@@ -6,7 +6,7 @@ extern "C" {
 #endif
 
 void gr_draw_contours(int, int, int, double *, double *, double *, double *, int);
-void gr_draw_tricont(int, double *, double *, double *, int, double *, int *);
+void gr_draw_tricont(const triangulation_t *, int, double *, int *);
 
 #ifdef __cplusplus
 }
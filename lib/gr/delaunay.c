@@ -5,6 +5,7 @@
 #include "libqhull_r/qhull_ra.h"
 
 #include "gr.h"
+#include "delaunay.h"
 
 #ifdef isnan
 #define is_nan(a) isnan(a)
@@ -107,3 +108,156 @@ void gr_delaunay(int npoints, const double *x, const double *y, int *ntri, int *
   else
     fprintf(stderr, "Could not allocate point array\n");
 }
+
+typedef struct
+{
+  double zmin;
+  int index;
+} triangle_key_t;
+
+static int compare_triangle_keys(const void *a, const void *b)
+{
+  const triangle_key_t *ka = (const triangle_key_t *)a, *kb = (const triangle_key_t *)b;
+
+  if (ka->zmin < kb->zmin) return -1;
+  if (ka->zmin > kb->zmin) return 1;
+  return ka->index - kb->index;
+}
+
+/*!
+ * Compute the Delaunay triangulation of a point set with Z values once, so that it can be drawn several times with
+ * `gr_tricontour_triangulation` and `gr_trisurface_triangulation`. The coordinates are copied, points with NaN
+ * coordinates are ignored, but the triangle indices refer to the original point order.
+ *
+ * \param[in] npoints The number of points
+ * \param[in] x A pointer to the X coordinates
+ * \param[in] y A pointer to the Y coordinates
+ * \param[in] z A pointer to the Z coordinates
+ * \returns The triangulation or NULL on error. It must be freed with `gr_freetriangulation`.
+ */
+triangulation_t *gr_triangulate(int npoints, const double *x, const double *y, const double *z)
+{
+  triangulation_t *triangulation;
+  triangulation_priv_t *priv;
+  double *cx, *cy, zi, zmin, zmax;
+  int *map, *tri, ntri = 0, cnt = 0;
+  triangle_key_t *keys;
+  int i, j;
+
+  if (npoints < 3)
+    {
+      fprintf(stderr, "invalid number of points\n");
+      return NULL;
+    }
+
+  triangulation = (triangulation_t *)calloc(1, sizeof(triangulation_t));
+  priv = (triangulation_priv_t *)calloc(1, sizeof(triangulation_priv_t));
+  cx = (double *)malloc(2 * npoints * sizeof(double));
+  map = (int *)malloc(npoints * sizeof(int));
+  if (triangulation == NULL || priv == NULL || cx == NULL || map == NULL)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      free(map);
+      free(cx);
+      free(priv);
+      free(triangulation);
+      return NULL;
+    }
+  triangulation->priv = priv;
+  triangulation->npoints = npoints;
+
+  /* gr_delaunay skips points with NaN coordinates, remember the original index of every remaining point */
+  cy = cx + npoints;
+  for (i = 0; i < npoints; i++)
+    {
+      if (is_nan(x[i]) || is_nan(y[i])) continue;
+      cx[cnt] = x[i];
+      cy[cnt] = y[i];
+      map[cnt++] = i;
+    }
+  gr_delaunay(cnt, cx, cy, &ntri, &tri);
+  free(cx);
+  if (ntri == 0 || tri == NULL)
+    {
+      free(map);
+      free(tri);
+      gr_freetriangulation(triangulation);
+      return NULL;
+    }
+
+  priv->x = (double *)malloc(3 * npoints * sizeof(double));
+  priv->zmin = (double *)malloc(2 * ntri * sizeof(double));
+  triangulation->triangles = (int *)malloc(3 * ntri * sizeof(int));
+  keys = (triangle_key_t *)malloc(ntri * sizeof(triangle_key_t));
+  if (priv->x == NULL || priv->zmin == NULL || triangulation->triangles == NULL || keys == NULL)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      free(keys);
+      free(map);
+      free(tri);
+      gr_freetriangulation(triangulation);
+      return NULL;
+    }
+  priv->y = priv->x + npoints;
+  priv->z = priv->y + npoints;
+  priv->zmax = priv->zmin + ntri;
+  for (i = 0; i < npoints; i++)
+    {
+      priv->x[i] = x[i];
+      priv->y[i] = y[i];
+      priv->z[i] = z[i];
+    }
+
+  /* NaN values never lie above a contour level, so they count as -inf for the Z range of a triangle */
+  for (i = 0; i < ntri; i++)
+    {
+      zmin = HUGE_VAL;
+      zmax = -HUGE_VAL;
+      for (j = 0; j < 3; j++)
+        {
+          tri[3 * i + j] = map[tri[3 * i + j]];
+          zi = z[tri[3 * i + j]];
+          if (is_nan(zi)) zi = -HUGE_VAL;
+          if (zi < zmin) zmin = zi;
+          if (zi > zmax) zmax = zi;
+        }
+      keys[i].zmin = zmin;
+      keys[i].index = i;
+      priv->zmax[i] = zmax;
+    }
+  free(map);
+
+  /* sort the triangles by their minimum Z value, so a contour level only needs to visit a prefix of the triangles */
+  qsort(keys, ntri, sizeof(triangle_key_t), compare_triangle_keys);
+  for (i = 0; i < ntri; i++)
+    {
+      for (j = 0; j < 3; j++) triangulation->triangles[3 * i + j] = tri[3 * keys[i].index + j];
+      priv->zmin[i] = keys[i].zmin;
+    }
+  for (i = 0; i < ntri; i++) keys[i].zmin = priv->zmax[keys[i].index];
+  for (i = 0; i < ntri; i++) priv->zmax[i] = keys[i].zmin;
+  triangulation->ntri = ntri;
+
+  free(keys);
+  free(tri);
+
+  return triangulation;
+}
+
+/*!
+ * Free a triangulation created by `gr_triangulate`.
+ *
+ * \param[in] triangulation The triangulation
+ */
+void gr_freetriangulation(triangulation_t *triangulation)
+{
+  if (triangulation == NULL) return;
+  if (triangulation->priv != NULL)
+    {
+      free(triangulation->priv->x);
+      free(triangulation->priv->zmin);
+      free(triangulation->priv);
+    }
+  free(triangulation->triangles);
+  free(triangulation);
+}
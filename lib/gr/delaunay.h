@@ -0,0 +1,18 @@
+#ifndef _DELAUNAY_H_
+#define _DELAUNAY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct triangulation_priv
+{
+  double *x, *y, *z;
+  double *zmin, *zmax;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -63,6 +63,8 @@ typedef SSIZE_T ssize_t;
 #include "text.h"
 #include "spline.h"
 #include "gridit.h"
+#include "griddata.h"
+#include "delaunay.h"
 #include "contour.h"
 #include "contourf.h"
 #include "strlib.h"
@@ -193,12 +195,6 @@ typedef struct
   ssize_t max_non_null_id;
 } state_list_vector;
 
-typedef struct
-{
-  int a, b, c;
-  double sp;
-} triangle_with_distance;
-
 struct ray_casting_attr
 {
   int nx, ny, nz;
@@ -366,6 +362,9 @@ static unsigned int rgb[MAX_COLOR], used[MAX_COLOR];
 
 #define POINT_INC 2048
 
+#define HEXBIN_MIN_POINTS_PER_THREAD 100000
+#define DEPTH_SORT_MIN_ITEMS_PER_THREAD 50000
+
 #define RESOLUTION_X 4096
 #define BACKGROUND 0
 
@@ -970,6 +969,146 @@ static char *xrealloc(void *ptr, int size)
   return (result);
 }
 
+static int system_processor_count(void)
+{
+#ifdef _WIN32
+#ifndef _SC_NPROCESSORS_ONLN
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+#define sysconf(a) info.dwNumberOfProcessors
+#define _SC_NPROCESSORS_ONLN
+#endif
+#endif
+  return (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+static int thread_count(void)
+{
+  int count;
+
+#ifndef NO_THREADS
+  count = vt.max_threads > 0 ? vt.max_threads : system_processor_count();
+  if (count > 256) count = 256;
+#else
+  count = 1;
+#endif
+  return max(1, count);
+}
+
+typedef void (*range_worker_t)(void *arg, int start, int end);
+
+typedef struct
+{
+  range_worker_t worker;
+  void *arg;
+  int start, end;
+} range_job_t;
+
+static void *run_range_job(void *arg)
+{
+  range_job_t *job = (range_job_t *)arg;
+
+  job->worker(job->arg, job->start, job->end);
+  return NULL;
+}
+
+/*
+ * Call `worker` for consecutive ranges covering [0, n). The ranges are processed by up to `thread_count()` threads,
+ * each of which gets at least `min_per_thread` items.
+ */
+static void parallel_for(int n, int min_per_thread, range_worker_t worker, void *arg)
+{
+  range_job_t *jobs;
+  int nthreads, i;
+
+  nthreads = min(thread_count(), n / max(1, min_per_thread));
+  if (nthreads <= 1)
+    {
+      if (n > 0) worker(arg, 0, n);
+      return;
+    }
+
+  jobs = (range_job_t *)xmalloc(nthreads * sizeof(range_job_t));
+  for (i = 0; i < nthreads; i++)
+    {
+      jobs[i].worker = worker;
+      jobs[i].arg = arg;
+      jobs[i].start = (int)((double)i * n / nthreads);
+      jobs[i].end = (int)((double)(i + 1) * n / nthreads);
+    }
+  threadpool_run_jobs(run_range_job, jobs, sizeof(range_job_t), nthreads);
+  free(jobs);
+}
+
+/*
+ * Compute the permutation that sorts `key` in ascending order. The keys are quantized to 32 bits and sorted with a
+ * stable LSD radix sort, which is much faster than qsort for the millions of faces of large meshes. Only finite keys
+ * are quantized: NaN keys and negative infinite keys come first, positive infinite keys come last.
+ */
+static void sort_by_key(int n, const double *key, int *index)
+{
+  unsigned int *qbuf, *qkey, *qtmp, *qswap, digit;
+  int *ibuf, *src, *dst, *iswap, count[256], sum, c, i, pass;
+  double kmin = DBL_MAX, kmax = -DBL_MAX, scale;
+
+  for (i = 0; i < n; i++)
+    {
+      /* the range of the keys only includes finite values, so the scaled keys always fit in 32 bits */
+      if (!(key[i] >= -DBL_MAX && key[i] <= DBL_MAX)) continue;
+      if (key[i] < kmin) kmin = key[i];
+      if (key[i] > kmax) kmax = key[i];
+    }
+  scale = kmax > kmin && kmax - kmin < DBL_MAX ? 4294967040.0 / (kmax - kmin) : 0;
+
+  qbuf = (unsigned int *)xmalloc(2 * (size_t)max(n, 1) * sizeof(unsigned int));
+  ibuf = (int *)xmalloc((size_t)max(n, 1) * sizeof(int));
+  qkey = qbuf;
+  qtmp = qbuf + max(n, 1);
+  src = index;
+  dst = ibuf;
+  for (i = 0; i < n; i++)
+    {
+      if (key[i] > kmax)
+        qkey[i] = 0xffffffffu;
+      else if (key[i] >= kmin)
+        qkey[i] = (unsigned int)((key[i] - kmin) * scale);
+      else
+        qkey[i] = 0;
+      src[i] = i;
+    }
+
+  for (pass = 0; pass < 4; pass++)
+    {
+      memset(count, 0, sizeof(count));
+      for (i = 0; i < n; i++) count[(qkey[i] >> (8 * pass)) & 0xff]++;
+      /* skip digits that are equal for all keys */
+      if (n == 0 || count[(qkey[0] >> (8 * pass)) & 0xff] == n) continue;
+      sum = 0;
+      for (i = 0; i < 256; i++)
+        {
+          c = count[i];
+          count[i] = sum;
+          sum += c;
+        }
+      for (i = 0; i < n; i++)
+        {
+          digit = (qkey[i] >> (8 * pass)) & 0xff;
+          qtmp[count[digit]] = qkey[i];
+          dst[count[digit]++] = src[i];
+        }
+      qswap = qkey;
+      qkey = qtmp;
+      qtmp = qswap;
+      iswap = src;
+      src = dst;
+      dst = iswap;
+    }
+  if (src != index) memcpy(index, src, n * sizeof(int));
+
+  free(ibuf);
+  free(qbuf);
+}
+
 static void reallocate(int npoints)
 {
   while (npoints >= maxpath) maxpath += POINT_INC;
@@ -1816,14 +1955,8 @@ static void print_int_array(char *name, int n, int *data)
 
 static void print_float_array(char *name, int n, double *data)
 {
-  int i;
-
   gr_writestream(" %s=\"", name);
-  for (i = 0; i < n; i++)
-    {
-      if (i > 0) gr_writestream(" ");
-      gr_writestream("%g", data[i]);
-    }
+  gr_writestream_doubles(n, data);
   gr_writestream("\"");
 }
 
@@ -2950,16 +3083,19 @@ void gr_gridit(int nd, double *xd, double *yd, double *zd, int nx, int ny, doubl
       y[i] = ymin + i / (double)(ny - 1) * (ymax - ymin);
     }
 
-  /* CALL THE SMOOTH SURFACE FIT ROUTINE */
+  /* CALL THE SMOOTH SURFACE FIT ROUTINE, LINEAR INTERPOLATION IS USED FOR MORE THAN 100 DATA POINTS */
   md = 1;
   ncp = 4;
-  iwk = (int *)xcalloc(31 * nd + nx * ny, sizeof(int));
-  wk = (double *)xcalloc(6 * (nd + 1), sizeof(double));
+  if (griddata(nd > 100, ncp, nd, xd, yd, zd, nx, ny, x, y, z, thread_count()) != 0)
+    {
+      iwk = (int *)xcalloc(31 * nd + nx * ny, sizeof(int));
+      wk = (double *)xcalloc(6 * (nd + 1), sizeof(double));
 
-  idsfft(&md, &ncp, &nd, xd, yd, zd, &nx, &ny, x, y, z, iwk, wk);
+      idsfft(&md, &ncp, &nd, xd, yd, zd, &nx, &ny, x, y, z, iwk, wk);
 
-  free(wk);
-  free(iwk);
+      free(wk);
+      free(iwk);
+    }
 }
 
 /*!
@@ -9409,52 +9545,105 @@ void gr_surface(int nx, int ny, double *px, double *py, double *pz, int option)
     }
 }
 
-static const double *xp, *yp;
+typedef struct
+{
+  const double *px, *py, *pz;
+  const int *triangles;
+  double *x, *y, *z, *zlin, *key;
+  double f[3];
+  double xmin, xscale, ymin, yscale;
+} trisurface_job_t;
 
-static int compar(const void *a, const void *b)
+static void project_trisurface_points(void *arg, int start, int end)
 {
-  /* TODO: Implement a version which works for every case. At the moment the GR_PROJECTION_DEFAULT has the problem, that
-  the current camera position is not considered. For the other projection types the algorithm has some mistakes at the
-  edge of the surface. */
-  int ret = -1;
-  if (GR_PROJECTION_DEFAULT == gpx.projection_type)
+  trisurface_job_t *job = (trisurface_job_t *)arg;
+  int i;
+
+  for (i = start; i < end; i++)
     {
-      if (xp[*(int *)a] > xp[*(int *)b]) ret = 1;
-      if (yp[*(int *)a] < yp[*(int *)b]) ret = 1;
+      job->x[i] = x_lin(job->px[i]);
+      job->y[i] = y_lin(job->py[i]);
+      job->z[i] = job->zlin[i] = z_lin(job->pz[i]);
+      apply_world_xform(job->x + i, job->y + i, job->z + i);
     }
-  else
+}
+
+static void compute_trisurface_depths(void *arg, int start, int end)
+{
+  trisurface_job_t *job = (trisurface_job_t *)arg;
+  double x_cord, y_cord, z_cord, edge_01_scalar, edge_12_scalar, edge_20_scalar, nearest_edge_distance;
+  double xa[3], ya[3], za[3];
+  const double *f = job->f;
+  int i, j;
+
+  for (i = start; i < end; i++)
     {
-      if (((triangle_with_distance *)b)->sp > ((triangle_with_distance *)a)->sp)
+      if (gpx.projection_type != GR_PROJECTION_ORTHOGRAPHIC && gpx.projection_type != GR_PROJECTION_PERSPECTIVE)
         {
-          ret = 1;
+          /* TODO: Implement a version which works for every case. At the moment the GR_PROJECTION_DEFAULT has the
+          problem, that the current camera position is not considered. Triangles are drawn from small X and large Y
+          values of their first point to large X and small Y values. */
+          j = job->triangles[3 * i];
+          job->key[i] = (job->px[j] - job->xmin) * job->xscale - (job->py[j] - job->ymin) * job->yscale;
+          continue;
         }
+
+      /* simplify the access for each triangle point */
+      for (j = 0; j < 3; j++)
+        {
+          xa[j] = job->px[job->triangles[3 * i + j]];
+          ya[j] = job->py[job->triangles[3 * i + j]];
+          za[j] = job->pz[job->triangles[3 * i + j]];
+        }
+
+      /* calculate the distance of each edge midpoint */
+      x_cord = (xa[1] + xa[0]) / 2;
+      y_cord = (ya[1] + ya[0]) / 2;
+      z_cord = (za[1] + za[0]) / 2;
+      edge_01_scalar =
+          (x_cord - tx.camera_pos_x) * f[0] + (y_cord - tx.camera_pos_y) * f[1] + (z_cord - tx.camera_pos_z) * f[2];
+
+      x_cord = (xa[1] + xa[2]) / 2;
+      y_cord = (ya[1] + ya[2]) / 2;
+      z_cord = (za[1] + za[2]) / 2;
+      edge_12_scalar =
+          (x_cord - tx.camera_pos_x) * f[0] + (y_cord - tx.camera_pos_y) * f[1] + (z_cord - tx.camera_pos_z) * f[2];
+
+      x_cord = (xa[0] + xa[2]) / 2;
+      y_cord = (ya[0] + ya[2]) / 2;
+      z_cord = (za[0] + za[2]) / 2;
+      edge_20_scalar =
+          (x_cord - tx.camera_pos_x) * f[0] + (y_cord - tx.camera_pos_y) * f[1] + (z_cord - tx.camera_pos_z) * f[2];
+
+      nearest_edge_distance = edge_01_scalar;
+      if (nearest_edge_distance > edge_12_scalar)
+        {
+          nearest_edge_distance = edge_12_scalar;
+        }
+      if (nearest_edge_distance > edge_20_scalar)
+        {
+          nearest_edge_distance = edge_20_scalar;
+        }
+
+      /* draw the most distant triangles first */
+      job->key[i] = -nearest_edge_distance;
     }
-  return ret;
 }
 
-/*!
- * Draw a triangular surface plot for the given data points.
- *
- * \param[in] n The number of points
- * \param[in] px A pointer to the X coordinates
- * \param[in] py A pointer to the Y coordinates
- * \param[in] pz A pointer to the Z coordinates
- */
-void gr_trisurface(int n, double *px, double *py, double *pz)
+static void draw_trisurface(const triangulation_t *triangulation)
 {
   int errind, tnr, coli, int_style;
   int modern_projection_type;
-  int ntri, *triangles = NULL;
-  double x[4], y[4], z[4], meanz;
-  int i, j, color;
+  int npoints, ntri, *order;
+  const int *triangles;
+  trisurface_job_t job;
+  double x[4], y[4], meanz;
+  int i, j, k, color;
+  minmax_t xrange, yrange;
 
-  if (n < 3)
-    {
-      fprintf(stderr, "invalid number of points\n");
-      return;
-    }
-
-  check_autoinit;
+  npoints = triangulation->npoints;
+  ntri = triangulation->ntri;
+  triangles = triangulation->triangles;
 
   gks_inq_current_xformno(&errind, &tnr);
 
@@ -9480,96 +9669,40 @@ void gr_trisurface(int n, double *px, double *py, double *pz)
 
   gks_set_fill_int_style(GKS_K_INTSTYLE_SOLID);
 
-  gr_delaunay(n, px, py, &ntri, &triangles);
-
-  if (gpx.projection_type == GR_PROJECTION_ORTHOGRAPHIC || gpx.projection_type == GR_PROJECTION_PERSPECTIVE)
-    {
-      triangle_with_distance *ps = (triangle_with_distance *)gks_malloc(ntri * (sizeof(triangle_with_distance)));
-      double f[3];
-      f[0] = tx.focus_point_x - tx.camera_pos_x;
-      f[1] = tx.focus_point_y - tx.camera_pos_y;
-      f[2] = tx.focus_point_z - tx.camera_pos_z;
-
-      for (i = 0; i < ntri; i++)
-        {
-          double x_cord, y_cord, z_cord, edge_01_scalar, edge_12_scalar, edge_20_scalar, nearest_edge_distance;
-          double xa[3], ya[3], za[3];
-
-          /* simplify the access for each triangle point */
-          for (j = 0; j < 3; j++)
-            {
-              xa[j] = px[triangles[3 * i + j]];
-              ya[j] = py[triangles[3 * i + j]];
-              za[j] = pz[triangles[3 * i + j]];
-            }
-          if (is_nan(xa[0]) || is_nan(xa[1]) || is_nan(xa[2])) continue;
-          if (is_nan(ya[0]) || is_nan(ya[1]) || is_nan(ya[2])) continue;
-
-          /* calculate the distance of each edge midpoint */
-          x_cord = (xa[1] + xa[0]) / 2;
-          y_cord = (ya[1] + ya[0]) / 2;
-          z_cord = (za[1] + za[0]) / 2;
-          edge_01_scalar =
-              (x_cord - tx.camera_pos_x) * f[0] + (y_cord - tx.camera_pos_y) * f[1] + (z_cord - tx.camera_pos_z) * f[2];
-
-          x_cord = (xa[1] + xa[2]) / 2;
-          y_cord = (ya[1] + ya[2]) / 2;
-          z_cord = (za[1] + za[2]) / 2;
-          edge_12_scalar =
-              (x_cord - tx.camera_pos_x) * f[0] + (y_cord - tx.camera_pos_y) * f[1] + (z_cord - tx.camera_pos_z) * f[2];
-
-          x_cord = (xa[0] + xa[2]) / 2;
-          y_cord = (ya[0] + ya[2]) / 2;
-          z_cord = (za[0] + za[2]) / 2;
-          edge_20_scalar =
-              (x_cord - tx.camera_pos_x) * f[0] + (y_cord - tx.camera_pos_y) * f[1] + (z_cord - tx.camera_pos_z) * f[2];
-
-          nearest_edge_distance = edge_01_scalar;
-          if (nearest_edge_distance > edge_12_scalar)
-            {
-              nearest_edge_distance = edge_12_scalar;
-            }
-          if (nearest_edge_distance > edge_20_scalar)
-            {
-              nearest_edge_distance = edge_20_scalar;
-            }
-
-          /* create now ntri triangles with the nearest distance attribut */
-          ps[i].a = triangles[3 * i + 0];
-          ps[i].b = triangles[3 * i + 1];
-          ps[i].c = triangles[3 * i + 2];
-          ps[i].sp = nearest_edge_distance;
-        }
-
-      qsort(ps, ntri, sizeof(triangle_with_distance), compar);
-      /* uses the sorted ps to get the sorted triangle which is need for the next steps */
-      for (i = 0; i < ntri; i++)
-        {
-          triangles[3 * i + 0] = ps[i].a;
-          triangles[3 * i + 1] = ps[i].b;
-          triangles[3 * i + 2] = ps[i].c;
-        }
-      gks_free(ps);
-    }
-  else
-    {
-      xp = px;
-      yp = py;
-
-      qsort(triangles, ntri, 3 * sizeof(int), compar);
-    }
+  /* project every point once and sort the triangles by depth through an index, leaving the triangulation untouched */
+  job.px = triangulation->priv->x;
+  job.py = triangulation->priv->y;
+  job.pz = triangulation->priv->z;
+  job.triangles = triangles;
+  job.x = (double *)xmalloc(4 * npoints * sizeof(double));
+  job.y = job.x + npoints;
+  job.z = job.y + npoints;
+  job.zlin = job.z + npoints;
+  job.key = (double *)xmalloc(max(ntri, 1) * sizeof(double));
+  order = (int *)xmalloc(max(ntri, 1) * sizeof(int));
+  job.f[0] = tx.focus_point_x - tx.camera_pos_x;
+  job.f[1] = tx.focus_point_y - tx.camera_pos_y;
+  job.f[2] = tx.focus_point_z - tx.camera_pos_z;
+  xrange = find_minmax(npoints, (double *)job.px);
+  yrange = find_minmax(npoints, (double *)job.py);
+  job.xmin = xrange.min;
+  job.xscale = xrange.max > xrange.min ? 1 / (xrange.max - xrange.min) : 0;
+  job.ymin = yrange.min;
+  job.yscale = yrange.max > yrange.min ? 1 / (yrange.max - yrange.min) : 0;
+
+  parallel_for(npoints, DEPTH_SORT_MIN_ITEMS_PER_THREAD, project_trisurface_points, &job);
+  parallel_for(ntri, DEPTH_SORT_MIN_ITEMS_PER_THREAD, compute_trisurface_depths, &job);
+  sort_by_key(ntri, job.key, order);
 
   for (i = 0; i < ntri; i++)
     {
       meanz = 0.0;
       for (j = 0; j < 3; j++)
         {
-          x[j] = x_lin(px[triangles[3 * i + j]]);
-          y[j] = y_lin(py[triangles[3 * i + j]]);
-          z[j] = z_lin(pz[triangles[3 * i + j]]);
-          meanz += z[j];
-
-          apply_world_xform(x + j, y + j, z + j);
+          k = triangles[3 * order[i] + j];
+          x[j] = job.x[k];
+          y[j] = job.y[k];
+          meanz += job.zlin[k];
         }
       meanz /= 3.0;
 
@@ -9596,8 +9729,13 @@ void gr_trisurface(int n, double *px, double *py, double *pz)
   gks_set_fill_int_style(int_style);
   gks_set_fill_color_index(coli);
 
-  free(triangles);
+  free(order);
+  free(job.key);
+  free(job.x);
+}
 
+static void write_trisurface_stream(int n, double *px, double *py, double *pz)
+{
   if (flag_stream)
     {
       gr_writestream("<trisurface len=\"%d\"", n);
@@ -9608,6 +9746,59 @@ void gr_trisurface(int n, double *px, double *py, double *pz)
     }
 }
 
+/*!
+ * Draw a triangular surface plot for the given data points.
+ *
+ * \param[in] n The number of points
+ * \param[in] px A pointer to the X coordinates
+ * \param[in] py A pointer to the Y coordinates
+ * \param[in] pz A pointer to the Z coordinates
+ */
+void gr_trisurface(int n, double *px, double *py, double *pz)
+{
+  triangulation_t *triangulation;
+
+  if (n < 3)
+    {
+      fprintf(stderr, "invalid number of points\n");
+      return;
+    }
+
+  check_autoinit;
+
+  triangulation = gr_triangulate(n, px, py, pz);
+  if (triangulation != NULL)
+    {
+      draw_trisurface(triangulation);
+      gr_freetriangulation(triangulation);
+    }
+
+  write_trisurface_stream(n, px, py, pz);
+}
+
+/*!
+ * Draw a triangular surface plot for a triangulation created by `gr_triangulate`.
+ *
+ * \param[in] triangulation The triangulation
+ */
+void gr_trisurface_triangulation(const triangulation_t *triangulation)
+{
+  triangulation_priv_t *priv;
+
+  if (triangulation == NULL)
+    {
+      fprintf(stderr, "invalid triangulation\n");
+      return;
+    }
+
+  check_autoinit;
+
+  priv = triangulation->priv;
+  draw_trisurface(triangulation);
+
+  write_trisurface_stream(triangulation->npoints, priv->x, priv->y, priv->z);
+}
+
 void gr_gradient(int nx, int ny, double *x, double *y, double *z, double *u, double *v)
 {
   int im1, i, ip1, jm1, j, jp1;
@@ -10061,6 +10252,39 @@ void gr_contourf(int nx, int ny, int nh, double *px, double *py, double *h, doub
     }
 }
 
+static void draw_tricontour(const triangulation_t *triangulation, int nlevels, double *levels)
+{
+  int i, *colors;
+
+  colors = (int *)xmalloc(nlevels * sizeof(int));
+  if (nlevels > 1)
+    {
+      for (i = 0; i < nlevels; i++)
+        {
+          colors[i] = first_color + (int)((double)i / (nlevels - 1) * (last_color - first_color));
+        }
+    }
+  else
+    colors[0] = 1;
+
+  gr_draw_tricont(triangulation, nlevels, levels, colors);
+
+  free(colors);
+}
+
+static void write_tricontour_stream(int npoints, double *x, double *y, double *z, int nlevels, double *levels)
+{
+  if (flag_stream)
+    {
+      gr_writestream("<tricont npoints=\"%d\"", npoints);
+      print_float_array("x", npoints, x);
+      print_float_array("y", npoints, y);
+      print_float_array("z", npoints, z);
+      print_float_array("levels", nlevels, levels);
+      gr_writestream("/>\n");
+    }
+}
+
 /*!
  * Draw a contour plot for the given triangle mesh.
  *
@@ -10073,7 +10297,7 @@ void gr_contourf(int nx, int ny, int nh, double *px, double *py, double *h, doub
  */
 void gr_tricontour(int npoints, double *x, double *y, double *z, int nlevels, double *levels)
 {
-  int i, *colors;
+  triangulation_t *triangulation;
 
   if (npoints < 3)
     {
@@ -10091,88 +10315,144 @@ void gr_tricontour(int npoints, double *x, double *y, double *z, int nlevels, do
 
   setscale(lx.scale_options);
 
-  colors = (int *)xmalloc(nlevels * sizeof(int));
-  if (nlevels > 1)
+  triangulation = gr_triangulate(npoints, x, y, z);
+  if (triangulation != NULL)
     {
-      for (i = 0; i < nlevels; i++)
-        {
-          colors[i] = first_color + (int)((double)i / (nlevels - 1) * (last_color - first_color));
-        }
+      draw_tricontour(triangulation, nlevels, levels);
+      gr_freetriangulation(triangulation);
     }
-  else
-    colors[0] = 1;
 
-  gr_draw_tricont(npoints, x, y, z, nlevels, levels, colors);
+  write_tricontour_stream(npoints, x, y, z, nlevels, levels);
+}
 
-  free(colors);
+/*!
+ * Draw a contour plot for a triangulation created by `gr_triangulate`. The triangulation can be reused for any number
+ * of calls, only the contour lines of the given levels are computed.
+ *
+ * \param[in] triangulation The triangulation
+ * \param[in] nlevels The number of contour levels
+ * \param[in] levels A pointer to the contour levels
+ */
+void gr_tricontour_triangulation(const triangulation_t *triangulation, int nlevels, double *levels)
+{
+  triangulation_priv_t *priv;
 
-  if (flag_stream)
+  if (triangulation == NULL)
     {
-      gr_writestream("<tricont npoints=\"%d\"", npoints);
-      print_float_array("x", npoints, x);
-      print_float_array("y", npoints, y);
-      print_float_array("z", npoints, z);
-      print_float_array("levels", nlevels, levels);
-      gr_writestream("/>\n");
+      fprintf(stderr, "invalid triangulation\n");
+      return;
+    }
+
+  if (nlevels < 1)
+    {
+      fprintf(stderr, "invalid number of iso levels\n");
+      return;
     }
+
+  check_autoinit;
+
+  setscale(lx.scale_options);
+
+  priv = triangulation->priv;
+  draw_tricontour(triangulation, nlevels, levels);
+
+  write_tricontour_stream(triangulation->npoints, priv->x, priv->y, priv->z, nlevels, levels);
 }
 
-static int binning(double x[], double y[], int *cell, int *cnt, double size, double shape, double rx[2], double ry[2],
-                   int bnd[2], int n, double ycorr)
+typedef struct
 {
-  int nc;
-  double xi, yi;
-  int i, i1, i2, iinc;
-  int j1, j2, jinc;
-  int L, lmax, lat;
-  double c1, c2, con1, con2, dist1;
-  double sx, sy, xmin, ymin, xr, yr;
-
-  xmin = rx[0];
-  ymin = ry[0] + ycorr;
-  xr = rx[1] - xmin;
-  yr = ry[1] + ycorr - ymin;
-  c1 = size / xr;
-  c2 = size * shape / (yr * sqrt(3.));
+  double *x, *y;
+  int start, end;
+  int *cnt;
+  double c1, c2, xmin, ymin;
+  int iinc, lat;
+} hexbin_job_t;
 
-  jinc = bnd[1];
-  lat = jinc + 1;
-  iinc = 2 * jinc;
-  lmax = bnd[0] * bnd[1];
-  con1 = 0.25;
-  con2 = 1. / 3.;
+static void *bin_points(void *arg)
+{
+  hexbin_job_t *job = (hexbin_job_t *)arg;
+  double xi, yi, sx, sy, dist1;
+  int i, i1, i2, j1, j2, L;
+  const double con1 = 0.25, con2 = 1. / 3.;
 
-  for (i = 0; i < n; i++)
+  for (i = job->start; i < job->end; i++)
     {
-      if (is_nan(x[i]) || is_nan(y[i])) continue;
-      xi = x[i];
-      yi = y[i];
-      gr_wctondc(&xi, &yi);
+      if (is_nan(job->x[i]) || is_nan(job->y[i])) continue;
+      xi = nx.a * x_lin(job->x[i]) + nx.b;
+      yi = nx.c * y_lin(job->y[i]) + nx.d;
       if (xi < vxmin || xi > vxmax || yi < vymin || yi > vymax)
         {
           continue;
         }
-      sx = c1 * (xi - xmin);
-      sy = c2 * (yi - ymin);
+      sx = job->c1 * (xi - job->xmin);
+      sy = job->c2 * (yi - job->ymin);
       j1 = sx + 0.5;
       i1 = sy + 0.5;
-      dist1 = pow((sx - j1), 2) + 3.0 * pow((sy - i1), 2);
+      dist1 = (sx - j1) * (sx - j1) + 3.0 * (sy - i1) * (sy - i1);
       if (dist1 < con1)
-        L = i1 * iinc + j1 + 1;
+        L = i1 * job->iinc + j1 + 1;
       else if (dist1 > con2)
-        L = (int)sy * iinc + (int)sx + lat;
+        L = (int)sy * job->iinc + (int)sx + job->lat;
       else
         {
           j2 = sx;
           i2 = sy;
-          if (dist1 <= pow((sx - j2 - 0.5), 2) + 3.0 * pow((sy - i2 - 0.5), 2))
-            L = i1 * iinc + j1 + 1;
+          if (dist1 <= (sx - j2 - 0.5) * (sx - j2 - 0.5) + 3.0 * (sy - i2 - 0.5) * (sy - i2 - 0.5))
+            L = i1 * job->iinc + j1 + 1;
           else
-            L = i2 * iinc + j2 + lat;
+            L = i2 * job->iinc + j2 + job->lat;
         }
 
-      cnt[L] = cnt[L] + 1;
+      job->cnt[L] += 1;
+    }
+
+  return NULL;
+}
+
+static int binning(double x[], double y[], int *cell, int *cnt, double size, double shape, double rx[2], double ry[2],
+                   int bnd[2], int n, double ycorr)
+{
+  int nc;
+  int L, lmax, nthreads, i;
+  double xmin, ymin, xr, yr;
+  hexbin_job_t *jobs;
+  int *partial_cnt = NULL;
+
+  lmax = bnd[0] * bnd[1];
+
+  /* every thread accumulates into its own count array, which are summed up afterwards */
+  nthreads = min(thread_count(), n / HEXBIN_MIN_POINTS_PER_THREAD);
+  if (nthreads < 1) nthreads = 1;
+  jobs = (hexbin_job_t *)xmalloc(nthreads * sizeof(hexbin_job_t));
+  if (nthreads > 1) partial_cnt = (int *)xcalloc((size_t)(nthreads - 1) * (lmax + 1), sizeof(int));
+
+  xmin = rx[0];
+  ymin = ry[0] + ycorr;
+  xr = rx[1] - xmin;
+  yr = ry[1] + ycorr - ymin;
+  for (i = 0; i < nthreads; i++)
+    {
+      jobs[i].x = x;
+      jobs[i].y = y;
+      jobs[i].start = (int)((double)i * n / nthreads);
+      jobs[i].end = (int)((double)(i + 1) * n / nthreads);
+      jobs[i].cnt = i == 0 ? cnt : partial_cnt + (size_t)(i - 1) * (lmax + 1);
+      jobs[i].xmin = xmin;
+      jobs[i].ymin = ymin;
+      jobs[i].c1 = size / xr;
+      jobs[i].c2 = size * shape / (yr * sqrt(3.));
+      jobs[i].iinc = 2 * bnd[1];
+      jobs[i].lat = bnd[1] + 1;
+    }
+
+  threadpool_run_jobs(bin_points, jobs, sizeof(hexbin_job_t), nthreads);
+
+  for (i = 1; i < nthreads; i++)
+    {
+      for (L = 1; L <= lmax; L++) cnt[L] += jobs[i].cnt[L];
     }
+  free(partial_cnt);
+  free(jobs);
 
   nc = 0;
   for (L = 1; L <= lmax; L++)
@@ -10227,6 +10507,20 @@ int gr_hexbin(int n, double *x, double *y, int nbins)
   return cntmax;
 }
 
+/*!
+ * Draw a hexagon binning plot in two passes. The first pass (`context == NULL`) bins the points and returns a context
+ * with the number of cells and the maximum count, e.g. to set up a colorbar. The second pass draws the cells of the
+ * given context. Its `action` field controls whether the cells are rendered and whether the context is freed
+ * afterwards. If `GR_2PASS_CLEANUP` is not set, the binned counts are kept and the context can be drawn again, e.g.
+ * with a different colormap, without binning the points again.
+ *
+ * \param[in] n The number of points
+ * \param[in] x A pointer to the X coordinates
+ * \param[in] y A pointer to the Y coordinates
+ * \param[in] nbins The number of bins in X direction
+ * \param[in] context NULL for the first pass, or the context returned by the first pass
+ * \returns The context of the first pass or NULL
+ */
 const hexbin_2pass_t *gr_hexbin_2pass(int n, double *x, double *y, int nbins, const hexbin_2pass_t *context)
 {
   hexbin_2pass_t *context_;
@@ -10344,10 +10638,6 @@ const hexbin_2pass_t *gr_hexbin_2pass(int n, double *x, double *y, int nbins, co
               gks_fillarea(6, xlist, ylist);
               gks_polyline(7, xlist, ylist);
             }
-          free(ycm);
-          free(xcm);
-          free(cnt);
-          free(cell);
           /* restore fill area interior style and color index */
 
           gks_set_fill_int_style(int_style);
@@ -10363,6 +10653,10 @@ const hexbin_2pass_t *gr_hexbin_2pass(int n, double *x, double *y, int nbins, co
 
       if (context->action & GR_2PASS_CLEANUP)
         {
+          free(context->priv->ycm);
+          free(context->priv->xcm);
+          free(context->priv->cnt);
+          free(context->priv->cell);
           free(context->priv);
           free((hexbin_2pass_t *)context);
         }
@@ -14753,7 +15047,7 @@ static void bilinear_interpolation(double c00, double c10, double c01, double c1
 
 /*!
  * Set the number of threads which can run parallel. The default value is the number of threads the cpu has.
- * The only usage right now is inside `gr_cpubasedvolume` and `gr_volume_nogrid`.
+ * It is used by `gr_cpubasedvolume`, `gr_volume_nogrid`, `gr_gridit` and `gr_interp2`.
  *
  * \param[in] num number of threads
  */
@@ -14767,6 +15061,17 @@ void gr_setthreadnumber(int num)
   if (flag_stream) gr_writestream("<setthreadnumber num=\"%i\"/>\n", num);
 }
 
+/*!
+ * Inquire the number of threads used by parallel routines. If no thread number has been set with `gr_setthreadnumber`,
+ * this is the number of processors of the system.
+ *
+ * \param[out] num number of threads
+ */
+void gr_inqthreadnumber(int *num)
+{
+  *num = thread_count();
+}
+
 /*!
  * Set the width and height of the resulting picture. These values are only used for the volume rendering methods.
  * The default values are 1000 for both.
@@ -15562,19 +15867,6 @@ static void ray_casting_thread(void *arg)
     }
 }
 
-static int system_processor_count(void)
-{
-#ifdef _WIN32
-#ifndef _SC_NPROCESSORS_ONLN
-  SYSTEM_INFO info;
-  GetSystemInfo(&info);
-#define sysconf(a) info.dwNumberOfProcessors
-#define _SC_NPROCESSORS_ONLN
-#endif
-#endif
-  return (int)sysconf(_SC_NPROCESSORS_ONLN);
-}
-
 /*!
  * Draw volume data with raycasting using the given algorithm and apply the current GR colormap.
  *
@@ -15862,85 +16154,91 @@ static double mean(const double *a, const int len, const int *connections)
   return sum / len;
 }
 
-static int compare_depth(const void *_a, const void *_b)
+typedef struct
 {
-  double a = *(double *)_a, b = *(double *)_b;
-  return a > b ? 1 : a < b ? -1 : 0;
-}
+  const double *px, *py, *pz;
+  const int *connections, *offsets;
+  double *x, *y, *z, *depth;
+} polygonmesh_job_t;
 
-void gr_polygonmesh3d(int num_points, const double *px, const double *py, const double *pz, int num_connections,
-                      const int *connections, const int *colors)
+static void project_polygonmesh_points(void *arg, int start, int end)
 {
-  int i, j, k, len, maxlen = 0, len_connections;
-  double *x, *y, *z;
-  int *faces, *faceP, *attributes;
-  double cam_x, cam_y, cam_z, up_x, up_y, up_z, foc_x, foc_y, foc_z, depth;
+  polygonmesh_job_t *job = (polygonmesh_job_t *)arg;
+  int i;
 
-  x = (double *)xcalloc(num_points, sizeof(double));
-  y = (double *)xcalloc(num_points, sizeof(double));
-  z = (double *)xcalloc(num_points, sizeof(double));
-  for (i = 0; i < num_points; i++)
+  for (i = start; i < end; i++)
     {
-      x[i] = px[i];
-      y[i] = py[i];
-      z[i] = pz[i];
-      gr_wc3towc(&x[i], &y[i], &z[i]);
+      job->x[i] = job->px[i];
+      job->y[i] = job->py[i];
+      job->z[i] = job->pz[i];
+      apply_world_xform(job->x + i, job->y + i, job->z + i);
     }
+}
 
-  j = 0;
-  for (i = 0; i < num_connections; i++)
+static void compute_polygonmesh_depths(void *arg, int start, int end)
+{
+  polygonmesh_job_t *job = (polygonmesh_job_t *)arg;
+  int i, j;
+
+  for (i = start; i < end; i++)
     {
-      len = connections[j++];
-      if (len > maxlen) maxlen = len;
-      j += len;
+      j = job->offsets[i];
+      job->depth[i] = mean(job->z, job->connections[j], job->connections + j + 1);
     }
-  len_connections = j;
+}
+
+void gr_polygonmesh3d(int num_points, const double *px, const double *py, const double *pz, int num_connections,
+                      const int *connections, const int *colors)
+{
+  int i, j, k, len, len_connections;
+  int *offsets, *order, *attributes;
+  polygonmesh_job_t job;
 
-  faces = (int *)xcalloc(num_connections, sizeof(double) + (1 + maxlen + 1) * sizeof(int));
-  gr_inqtransformationparameters(&cam_x, &cam_y, &cam_z, &up_x, &up_y, &up_z, &foc_x, &foc_y, &foc_z);
+  check_autoinit;
 
+  offsets = (int *)xmalloc(max(num_connections, 1) * sizeof(int));
   j = 0;
-  faceP = faces;
   for (i = 0; i < num_connections; i++)
     {
-      len = connections[j++];
-      depth = mean(z, len, connections + j);
-      memcpy(faceP, &depth, sizeof(double));
-      faceP += sizeof(double) / sizeof(int);
-      memcpy(faceP, &len, sizeof(int));
-      faceP += 1;
-      memcpy(faceP, connections + j, len * sizeof(int));
-      faceP += maxlen;
-      memcpy(faceP, &colors[i], sizeof(int));
-      faceP += 1;
-      j += len;
-    }
-  qsort(faces, num_connections, (sizeof(double) + (1 + maxlen + 1) * sizeof(int)), compare_depth);
-
-  attributes = (int *)xcalloc(num_connections, (1 + maxlen + 1) * sizeof(int));
+      offsets[i] = j;
+      j += 1 + connections[j];
+    }
+  len_connections = j;
+
+  /* project the points and compute the face depths in parallel, then draw the faces through a sorted index */
+  job.px = px;
+  job.py = py;
+  job.pz = pz;
+  job.connections = connections;
+  job.offsets = offsets;
+  job.x = (double *)xmalloc(3 * max(num_points, 1) * sizeof(double));
+  job.y = job.x + num_points;
+  job.z = job.y + num_points;
+  job.depth = (double *)xmalloc(max(num_connections, 1) * sizeof(double));
+  order = (int *)xmalloc(max(num_connections, 1) * sizeof(int));
+
+  parallel_for(num_points, DEPTH_SORT_MIN_ITEMS_PER_THREAD, project_polygonmesh_points, &job);
+  parallel_for(num_connections, DEPTH_SORT_MIN_ITEMS_PER_THREAD, compute_polygonmesh_depths, &job);
+  sort_by_key(num_connections, job.depth, order);
+
+  attributes = (int *)xmalloc(max(len_connections + num_connections, 1) * sizeof(int));
   k = 0;
-  faceP = faces;
   for (i = 0; i < num_connections; i++)
     {
-      faceP += sizeof(double) / sizeof(int);
-      len = attributes[k++] = *faceP;
-      faceP += 1;
-      for (j = 0; j < len; j++)
-        {
-          attributes[k++] = faceP[j];
-        }
-      faceP += maxlen;
-      attributes[k++] = *faceP;
-      faceP += 1;
+      j = offsets[order[i]];
+      len = connections[j];
+      memcpy(attributes + k, connections + j, (1 + len) * sizeof(int));
+      k += 1 + len;
+      attributes[k++] = colors[order[i]];
     }
 
-  gks_gdp(num_points, x, y, GKS_K_GDP_FILL_POLYGONS, k, attributes);
+  gks_gdp(num_points, job.x, job.y, GKS_K_GDP_FILL_POLYGONS, k, attributes);
 
   free(attributes);
-  free(faces);
-  free(z);
-  free(y);
-  free(x);
+  free(order);
+  free(job.depth);
+  free(job.x);
+  free(offsets);
 
   if (flag_stream)
     {
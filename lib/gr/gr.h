@@ -123,6 +123,9 @@ typedef enum
   GR_INTERP2_CUBIC
 } interp2_method_t;
 
+/*! Precomputed stencils of `gr_interp2` for a fixed source and target grid, see `gr_createinterp2plan` */
+typedef struct interp2_plan interp2_plan_t;
+
 typedef struct
 {
   double x, y;
@@ -174,6 +177,17 @@ typedef struct
   hexbin_2pass_priv_t *priv;
 } hexbin_2pass_t;
 
+typedef struct triangulation_priv triangulation_priv_t;
+/*! Delaunay triangulation of a point set that can be reused by `gr_tricontour_triangulation` and
+ * `gr_trisurface_triangulation` */
+typedef struct
+{
+  int npoints;                /*!< Number of points, including points with NaN coordinates */
+  int ntri;                   /*!< Number of triangles */
+  int *triangles;             /*!< Point indices of the triangles (3 * ntri), sorted by the minimum Z value */
+  triangulation_priv_t *priv; /*!< Point coordinates and the per-triangle Z ranges */
+} triangulation_t;
+
 typedef struct
 {
   int scientific;
@@ -379,10 +393,19 @@ DLLEXPORT int gr_uselinespec(char *);
 DLLEXPORT void gr_delaunay(int, const double *, const double *, int *, int **);
 DLLEXPORT void gr_reducepoints(int, const double *, const double *, int, double *, double *);
 DLLEXPORT void gr_trisurface(int, double *, double *, double *);
+DLLEXPORT triangulation_t *gr_triangulate(int, const double *, const double *, const double *);
+DLLEXPORT void gr_tricontour_triangulation(const triangulation_t *, int, double *);
+DLLEXPORT void gr_trisurface_triangulation(const triangulation_t *);
+DLLEXPORT void gr_freetriangulation(triangulation_t *);
 DLLEXPORT void gr_gradient(int, int, double *, double *, double *, double *, double *);
 DLLEXPORT void gr_quiver(int, int, double *, double *, double *, double *, int);
 DLLEXPORT void gr_interp2(int nx, int ny, const double *x, const double *y, const double *z, int nxq, int nyq,
                           const double *xq, const double *yq, double *zq, interp2_method_t method, double extrapval);
+DLLEXPORT interp2_plan_t *gr_createinterp2plan(int nx, int ny, const double *x, const double *y, int nxq, int nyq,
+                                               const double *xq, const double *yq, interp2_method_t method,
+                                               double extrapval);
+DLLEXPORT void gr_applyinterp2plan(const interp2_plan_t *plan, const double *z, double *zq);
+DLLEXPORT void gr_freeinterp2plan(interp2_plan_t *plan);
 DLLEXPORT const char *gr_version(void);
 DLLEXPORT void gr_shade(int, double *, double *, int, int, double *, int, int, int *);
 DLLEXPORT void gr_shadepoints(int, double *, double *, int, int, int);
@@ -421,6 +444,7 @@ DLLEXPORT void gr_inqtextencoding(int *);
 DLLEXPORT void gr_loadfont(char *, int *);
 DLLEXPORT void gr_setcallback(char *(*)(const char *));
 DLLEXPORT void gr_setthreadnumber(int);
+DLLEXPORT void gr_inqthreadnumber(int *);
 DLLEXPORT void gr_setpicturesizeforvolume(int, int);
 DLLEXPORT void gr_setvolumebordercalculation(int);
 DLLEXPORT void gr_setapproximativecalculation(int);
@@ -0,0 +1,949 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "gr.h"
+#include "kdtree.h"
+#include "griddata.h"
+#include "threadpool.h"
+
+#ifdef isnan
+#define is_nan(a) isnan(a)
+#else
+#define is_nan(x) ((x) != (x))
+#endif
+
+/*
+ * Scattered data gridding based on the Delaunay triangulation computed by qhull. This implements the interpolation
+ * modes of Akima's IDSFFT (see gridit.c): piecewise linear interpolation inside the triangles, or bivariate quintic
+ * interpolation with partial derivatives estimated from the NCP closest data points and extrapolation outside of the
+ * convex hull. Nearest neighbors are found with a k-d tree, grid points are located by scanning the triangles row by
+ * row, and the output grid is evaluated in parallel horizontal bands.
+ */
+
+typedef struct
+{
+  double x0, y0;
+  double ap, bp, cp, dp;
+  double p[6][6];
+} patch_t;
+
+typedef struct
+{
+  int a, b;
+  int from, to;
+} edge_t;
+
+typedef struct
+{
+  int linear;
+  int ndp;
+  double *xd, *yd, *zd;
+  double *pd;
+  int ntri;
+  int *tri;
+  int nborder;
+  int *border;
+  int nxi, nyi;
+  const double *xi, *yi;
+  double *zi;
+  unsigned char *done;
+  int nbands;
+  int *band_start;
+  int *bucket_start;
+  int *bucket;
+} griddata_context_t;
+
+typedef struct
+{
+  griddata_context_t *ctx;
+  int band;
+} griddata_job_t;
+
+static int lower_bound(const double *a, int n, double v)
+{
+  int lo = 0, hi = n, mid;
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (a[mid] < v)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return lo;
+}
+
+static int upper_bound(const double *a, int n, double v)
+{
+  int lo = 0, hi = n, mid;
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (a[mid] <= v)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return lo;
+}
+
+static int is_collinear(const griddata_context_t *ctx, int ip, int n, const int *ipc)
+{
+  double x1 = ctx->xd[ip], y1 = ctx->yd[ip];
+  double dx12, dy12, dx13, dy13;
+  int j;
+
+  dx12 = ctx->xd[ipc[0]] - x1;
+  dy12 = ctx->yd[ipc[0]] - y1;
+  for (j = 1; j < n; j++)
+    {
+      dx13 = ctx->xd[ipc[j]] - x1;
+      dy13 = ctx->yd[ipc[j]] - y1;
+      if (fabs(dy13 * dx12 - dx13 * dy12) > 1e-12) return 0;
+    }
+  return 1;
+}
+
+/*
+ * Check if all data points lie on a line, in which case qhull cannot triangulate them.
+ */
+static int all_collinear(const griddata_context_t *ctx)
+{
+  double dx12 = 0, dy12 = 0, dx13, dy13;
+  int i, second = -1;
+
+  for (i = 1; i < ctx->ndp && second < 0; i++)
+    {
+      if (ctx->xd[i] != ctx->xd[0] || ctx->yd[i] != ctx->yd[0]) second = i;
+    }
+  if (second < 0) return 1;
+  dx12 = ctx->xd[second] - ctx->xd[0];
+  dy12 = ctx->yd[second] - ctx->yd[0];
+  for (i = second + 1; i < ctx->ndp; i++)
+    {
+      dx13 = ctx->xd[i] - ctx->xd[0];
+      dy13 = ctx->yd[i] - ctx->yd[0];
+      if (fabs(dy13 * dx12 - dx13 * dy12) > 1e-12) return 0;
+    }
+  return 1;
+}
+
+/*
+ * Select the NCP data points closest to each data point (IDCLDP). If all of them are collinear with the data point,
+ * the farthest one is replaced by the closest noncollinear point.
+ */
+static int closest_points(const griddata_context_t *ctx, const kdtree_t *tree, int ncp, int *ipc)
+{
+  int *indices;
+  double *dist2;
+  int ip, i, j, k, n, found;
+
+  indices = (int *)malloc(ctx->ndp * sizeof(int));
+  dist2 = (double *)malloc(ctx->ndp * sizeof(double));
+  if (indices == NULL || dist2 == NULL)
+    {
+      free(indices);
+      free(dist2);
+      fprintf(stderr, "out of virtual memory\n");
+      return -1;
+    }
+
+  for (ip = 0; ip < ctx->ndp; ip++)
+    {
+      n = kdtree_nearest(tree, ctx->xd[ip], ctx->yd[ip], ncp + 1, indices, dist2);
+      for (i = 0, j = 0; i < n && j < ncp; i++)
+        {
+          if (indices[i] != ip) ipc[ip * ncp + j++] = indices[i];
+        }
+
+      if (is_collinear(ctx, ip, ncp, ipc + ip * ncp))
+        {
+          found = -1;
+          for (k = 2 * (ncp + 1); found < 0; k *= 2)
+            {
+              if (k > ctx->ndp) k = ctx->ndp;
+              n = kdtree_nearest(tree, ctx->xd[ip], ctx->yd[ip], k, indices, dist2);
+              for (i = 0; i < n && found < 0; i++)
+                {
+                  ipc[ip * ncp + ncp - 1] = indices[i];
+                  if (indices[i] != ip && !is_collinear(ctx, ip, ncp, ipc + ip * ncp)) found = indices[i];
+                }
+              if (k == ctx->ndp) break;
+            }
+          if (found < 0)
+            {
+              free(indices);
+              free(dist2);
+              return -1;
+            }
+        }
+    }
+
+  free(indices);
+  free(dist2);
+  return 0;
+}
+
+/*
+ * Estimate the partial derivatives ZX, ZY, ZXX, ZXY and ZYY at all data points (IDPDRV).
+ */
+static int estimate_derivatives(griddata_context_t *ctx, int ncp)
+{
+  const double *xd = ctx->xd, *yd = ctx->yd, *zd = ctx->zd;
+  double *pd;
+  int *ipc;
+  kdtree_t *tree;
+  int ip0, ic1, ic2, ipi;
+  double x0, y0, z0, zx0, zy0, dx1, dy1, dz1, dx2, dy2, dz2;
+  double dzx1, dzy1, dzx2, dzy2, dnmx, dnmy, dnmz, dnmxx, dnmxy, dnmyx, dnmyy;
+  double nmx, nmy, nmz, nmxx, nmxy, nmyx, nmyy;
+
+  tree = kdtree_new(ctx->ndp, xd, yd);
+  ipc = (int *)malloc(ncp * ctx->ndp * sizeof(int));
+  pd = (double *)malloc(5 * ctx->ndp * sizeof(double));
+  if (tree == NULL || ipc == NULL || pd == NULL || closest_points(ctx, tree, ncp, ipc) != 0)
+    {
+      if (tree == NULL || ipc == NULL || pd == NULL) fprintf(stderr, "out of virtual memory\n");
+      kdtree_delete(tree);
+      free(ipc);
+      free(pd);
+      return -1;
+    }
+  kdtree_delete(tree);
+
+  for (ip0 = 0; ip0 < ctx->ndp; ip0++)
+    {
+      x0 = xd[ip0];
+      y0 = yd[ip0];
+      z0 = zd[ip0];
+      nmx = nmy = nmz = 0;
+      for (ic1 = 0; ic1 < ncp - 1; ic1++)
+        {
+          ipi = ipc[ncp * ip0 + ic1];
+          dx1 = xd[ipi] - x0;
+          dy1 = yd[ipi] - y0;
+          dz1 = zd[ipi] - z0;
+          for (ic2 = ic1 + 1; ic2 < ncp; ic2++)
+            {
+              ipi = ipc[ncp * ip0 + ic2];
+              dx2 = xd[ipi] - x0;
+              dy2 = yd[ipi] - y0;
+              dnmz = dx1 * dy2 - dy1 * dx2;
+              if (fabs(dnmz) > 1e-12)
+                {
+                  dz2 = zd[ipi] - z0;
+                  dnmx = dy1 * dz2 - dz1 * dy2;
+                  dnmy = dz1 * dx2 - dx1 * dz2;
+                  if (dnmz < 0)
+                    {
+                      dnmx = -dnmx;
+                      dnmy = -dnmy;
+                      dnmz = -dnmz;
+                    }
+                  nmx += dnmx;
+                  nmy += dnmy;
+                  nmz += dnmz;
+                }
+            }
+        }
+      pd[5 * ip0] = -nmx / nmz;
+      pd[5 * ip0 + 1] = -nmy / nmz;
+    }
+
+  for (ip0 = 0; ip0 < ctx->ndp; ip0++)
+    {
+      x0 = xd[ip0];
+      y0 = yd[ip0];
+      zx0 = pd[5 * ip0];
+      zy0 = pd[5 * ip0 + 1];
+      nmxx = nmxy = nmyx = nmyy = nmz = 0;
+      for (ic1 = 0; ic1 < ncp - 1; ic1++)
+        {
+          ipi = ipc[ncp * ip0 + ic1];
+          dx1 = xd[ipi] - x0;
+          dy1 = yd[ipi] - y0;
+          dzx1 = pd[5 * ipi] - zx0;
+          dzy1 = pd[5 * ipi + 1] - zy0;
+          for (ic2 = ic1 + 1; ic2 < ncp; ic2++)
+            {
+              ipi = ipc[ncp * ip0 + ic2];
+              dx2 = xd[ipi] - x0;
+              dy2 = yd[ipi] - y0;
+              dnmz = dx1 * dy2 - dy1 * dx2;
+              if (fabs(dnmz) > 1e-12)
+                {
+                  dzx2 = pd[5 * ipi] - zx0;
+                  dzy2 = pd[5 * ipi + 1] - zy0;
+                  dnmxx = dy1 * dzx2 - dzx1 * dy2;
+                  dnmxy = dzx1 * dx2 - dx1 * dzx2;
+                  dnmyx = dy1 * dzy2 - dzy1 * dy2;
+                  dnmyy = dzy1 * dx2 - dx1 * dzy2;
+                  if (dnmz < 0)
+                    {
+                      dnmxx = -dnmxx;
+                      dnmxy = -dnmxy;
+                      dnmyx = -dnmyx;
+                      dnmyy = -dnmyy;
+                      dnmz = -dnmz;
+                    }
+                  nmxx += dnmxx;
+                  nmxy += dnmxy;
+                  nmyx += dnmyx;
+                  nmyy += dnmyy;
+                  nmz += dnmz;
+                }
+            }
+        }
+      pd[5 * ip0 + 2] = -nmxx / nmz;
+      pd[5 * ip0 + 3] = -(nmxy + nmyx) / (nmz * 2);
+      pd[5 * ip0 + 4] = -nmyy / nmz;
+    }
+
+  free(ipc);
+  ctx->pd = pd;
+  return 0;
+}
+
+static void clear_patch(patch_t *patch)
+{
+  int i, j;
+
+  for (i = 0; i < 6; i++)
+    for (j = 0; j < 6; j++) patch->p[i][j] = 0;
+}
+
+static double eval_patch(const patch_t *patch, double x, double y)
+{
+  double dx = x - patch->x0, dy = y - patch->y0;
+  double u = patch->ap * dx + patch->bp * dy;
+  double v = patch->cp * dx + patch->dp * dy;
+  double z = 0, row;
+  int i, j;
+
+  for (i = 5; i >= 0; i--)
+    {
+      row = 0;
+      for (j = 5 - i; j >= 0; j--) row = patch->p[i][j] + v * row;
+      z = row + u * z;
+    }
+  return z;
+}
+
+/*
+ * Compute the coefficients of the quintic polynomial inside a triangle (IDPTIP, interpolation).
+ */
+static void triangle_patch(const griddata_context_t *ctx, int t, patch_t *patch)
+{
+  double x[3], y[3], z[3], pd[15], zu[3], zv[3], zuu[3], zuv[3], zvv[3];
+  double a, b, c, d, ad, bc, dlt, aa, act2, cc, ab, adbc, cd, bb, bdt2, dd, ac;
+  double h1, h2, h3, lu, lv, thxu, thuv, csuv, thus, thsv, g1, g2;
+  double p00, p10, p01, p20, p11, p02, p05, p50, p41, p14, p22;
+  int i, k, idp;
+
+  for (i = 0; i < 3; i++)
+    {
+      idp = ctx->tri[3 * t + i];
+      x[i] = ctx->xd[idp];
+      y[i] = ctx->yd[idp];
+      z[i] = ctx->zd[idp];
+      for (k = 0; k < 5; k++) pd[5 * i + k] = ctx->pd[5 * idp + k];
+    }
+
+  clear_patch(patch);
+  patch->x0 = x[0];
+  patch->y0 = y[0];
+  a = x[1] - x[0];
+  b = x[2] - x[0];
+  c = y[1] - y[0];
+  d = y[2] - y[0];
+  ad = a * d;
+  bc = b * c;
+  dlt = ad - bc;
+  patch->ap = d / dlt;
+  patch->bp = -b / dlt;
+  patch->cp = -c / dlt;
+  patch->dp = a / dlt;
+
+  aa = a * a;
+  act2 = a * 2. * c;
+  cc = c * c;
+  ab = a * b;
+  adbc = ad + bc;
+  cd = c * d;
+  bb = b * b;
+  bdt2 = b * 2. * d;
+  dd = d * d;
+  for (i = 0; i < 3; i++)
+    {
+      zu[i] = a * pd[5 * i] + c * pd[5 * i + 1];
+      zv[i] = b * pd[5 * i] + d * pd[5 * i + 1];
+      zuu[i] = aa * pd[5 * i + 2] + act2 * pd[5 * i + 3] + cc * pd[5 * i + 4];
+      zuv[i] = ab * pd[5 * i + 2] + adbc * pd[5 * i + 3] + cd * pd[5 * i + 4];
+      zvv[i] = bb * pd[5 * i + 2] + bdt2 * pd[5 * i + 3] + dd * pd[5 * i + 4];
+    }
+
+  p00 = patch->p[0][0] = z[0];
+  p10 = patch->p[1][0] = zu[0];
+  p01 = patch->p[0][1] = zv[0];
+  p20 = patch->p[2][0] = zuu[0] * .5;
+  p11 = patch->p[1][1] = zuv[0];
+  p02 = patch->p[0][2] = zvv[0] * .5;
+  h1 = z[1] - p00 - p10 - p20;
+  h2 = zu[1] - p10 - zuu[0];
+  h3 = zuu[1] - zuu[0];
+  patch->p[3][0] = h1 * 10. - h2 * 4. + h3 * .5;
+  patch->p[4][0] = h1 * -15. + h2 * 7. - h3;
+  p50 = patch->p[5][0] = h1 * 6. - h2 * 3. + h3 * .5;
+  h1 = z[2] - p00 - p01 - p02;
+  h2 = zv[2] - p01 - zvv[0];
+  h3 = zvv[2] - zvv[0];
+  patch->p[0][3] = h1 * 10. - h2 * 4. + h3 * .5;
+  patch->p[0][4] = h1 * -15. + h2 * 7. - h3;
+  p05 = patch->p[0][5] = h1 * 6. - h2 * 3. + h3 * .5;
+  lu = sqrt(aa + cc);
+  lv = sqrt(bb + dd);
+  thxu = atan2(c, a);
+  thuv = atan2(d, b) - thxu;
+  csuv = cos(thuv);
+  p41 = patch->p[4][1] = lv * 5. * csuv / lu * p50;
+  p14 = patch->p[1][4] = lu * 5. * csuv / lv * p05;
+  h1 = zv[1] - p01 - p11 - p41;
+  h2 = zuv[1] - p11 - p41 * 4.;
+  patch->p[2][1] = h1 * 3. - h2;
+  patch->p[3][1] = h1 * -2. + h2;
+  h1 = zu[2] - p10 - p11 - p14;
+  h2 = zuv[2] - p11 - p14 * 4.;
+  patch->p[1][2] = h1 * 3. - h2;
+  patch->p[1][3] = h1 * -2. + h2;
+  thus = atan2(d - c, b - a) - thxu;
+  thsv = thuv - thus;
+  aa = sin(thsv) / lu;
+  bb = -cos(thsv) / lu;
+  cc = sin(thus) / lv;
+  dd = cos(thus) / lv;
+  ac = aa * cc;
+  ad = aa * dd;
+  bc = bb * cc;
+  g1 = aa * ac * (bc * 3. + ad * 2.);
+  g2 = cc * ac * (ad * 3. + bc * 2.);
+  h1 = -aa * aa * aa * (aa * 5. * bb * p50 + (bc * 4. + ad) * p41) -
+       cc * cc * cc * (cc * 5. * dd * p05 + (ad * 4. + bc) * p14);
+  h2 = zvv[1] * .5 - p02 - patch->p[1][2];
+  h3 = zuu[2] * .5 - p20 - patch->p[2][1];
+  p22 = patch->p[2][2] = (g1 * h2 + g2 * h3 - h1) / (g1 + g2);
+  patch->p[3][2] = h2 - p22;
+  patch->p[2][3] = h3 - p22;
+}
+
+/*
+ * Compute the coefficients for extrapolation in the semi-infinite rectangle outside of a border line segment (IDPTIP,
+ * extrapolation in the rectangle).
+ */
+static void segment_patch(const griddata_context_t *ctx, int ip1, int ip2, patch_t *patch)
+{
+  double x[2], y[2], z[2], pd[10], zu[2], zv[2], zuu[2], zuv[2], zvv[2];
+  double a, b, c, d, ad, bc, dlt, aa, act2, cc, ab, adbc, cd, bb, bdt2, dd;
+  double h1, h2, h3, p00, p10, p01, p11, p02, p23;
+  int i, k, idp;
+
+  for (i = 0; i < 2; i++)
+    {
+      idp = i == 0 ? ip1 : ip2;
+      x[i] = ctx->xd[idp];
+      y[i] = ctx->yd[idp];
+      z[i] = ctx->zd[idp];
+      for (k = 0; k < 5; k++) pd[5 * i + k] = ctx->pd[5 * idp + k];
+    }
+
+  clear_patch(patch);
+  patch->x0 = x[0];
+  patch->y0 = y[0];
+  a = y[1] - y[0];
+  b = x[1] - x[0];
+  c = -b;
+  d = a;
+  ad = a * d;
+  bc = b * c;
+  dlt = ad - bc;
+  patch->ap = d / dlt;
+  patch->bp = -b / dlt;
+  patch->cp = -patch->bp;
+  patch->dp = patch->ap;
+
+  aa = a * a;
+  act2 = a * 2. * c;
+  cc = c * c;
+  ab = a * b;
+  adbc = ad + bc;
+  cd = c * d;
+  bb = b * b;
+  bdt2 = b * 2. * d;
+  dd = d * d;
+  for (i = 0; i < 2; i++)
+    {
+      zu[i] = a * pd[5 * i] + c * pd[5 * i + 1];
+      zv[i] = b * pd[5 * i] + d * pd[5 * i + 1];
+      zuu[i] = aa * pd[5 * i + 2] + act2 * pd[5 * i + 3] + cc * pd[5 * i + 4];
+      zuv[i] = ab * pd[5 * i + 2] + adbc * pd[5 * i + 3] + cd * pd[5 * i + 4];
+      zvv[i] = bb * pd[5 * i + 2] + bdt2 * pd[5 * i + 3] + dd * pd[5 * i + 4];
+    }
+
+  p00 = patch->p[0][0] = z[0];
+  p10 = patch->p[1][0] = zu[0];
+  p01 = patch->p[0][1] = zv[0];
+  patch->p[2][0] = zuu[0] * .5;
+  p11 = patch->p[1][1] = zuv[0];
+  p02 = patch->p[0][2] = zvv[0] * .5;
+  h1 = z[1] - p00 - p01 - p02;
+  h2 = zv[1] - p01 - zvv[0];
+  h3 = zvv[1] - zvv[0];
+  patch->p[0][3] = h1 * 10. - h2 * 4. + h3 * .5;
+  patch->p[0][4] = h1 * -15. + h2 * 7. - h3;
+  patch->p[0][5] = h1 * 6. - h2 * 3. + h3 * .5;
+  h1 = zu[1] - p10 - p11;
+  h2 = zuv[1] - p11;
+  patch->p[1][2] = h1 * 3. - h2;
+  patch->p[1][3] = h1 * -2. + h2;
+  patch->p[2][1] = 0.;
+  p23 = patch->p[2][3] = -zuu[1] + zuu[0];
+  patch->p[2][2] = p23 * -1.5;
+}
+
+/*
+ * Compute the coefficients for extrapolation in the semi-infinite triangle outside of a border vertex (IDPTIP,
+ * extrapolation in the triangle).
+ */
+static void vertex_patch(const griddata_context_t *ctx, int ip, patch_t *patch)
+{
+  const double *pd = ctx->pd + 5 * ip;
+
+  clear_patch(patch);
+  patch->x0 = ctx->xd[ip];
+  patch->y0 = ctx->yd[ip];
+  patch->ap = patch->dp = 1;
+  patch->bp = patch->cp = 0;
+  patch->p[0][0] = ctx->zd[ip];
+  patch->p[1][0] = pd[0];
+  patch->p[0][1] = pd[1];
+  patch->p[2][0] = pd[2] * .5;
+  patch->p[1][1] = pd[3];
+  patch->p[0][2] = pd[4] * .5;
+}
+
+static int compare_edges(const void *a, const void *b)
+{
+  const edge_t *ea = (const edge_t *)a, *eb = (const edge_t *)b;
+
+  if (ea->a != eb->a) return ea->a < eb->a ? -1 : 1;
+  if (ea->b != eb->b) return ea->b < eb->b ? -1 : 1;
+  return 0;
+}
+
+/*
+ * Collect the edges that belong to only one triangle. Since all triangles are oriented counterclockwise, the data area
+ * is to the left of every border line segment.
+ */
+static int find_border(griddata_context_t *ctx)
+{
+  edge_t *edges;
+  int nedges = 3 * ctx->ntri;
+  int t, i, j, from, to;
+
+  edges = (edge_t *)malloc(nedges * sizeof(edge_t));
+  ctx->border = (int *)malloc(2 * nedges * sizeof(int));
+  if (edges == NULL || ctx->border == NULL)
+    {
+      free(edges);
+      fprintf(stderr, "out of virtual memory\n");
+      return -1;
+    }
+  for (t = 0; t < ctx->ntri; t++)
+    {
+      for (i = 0; i < 3; i++)
+        {
+          from = ctx->tri[3 * t + i];
+          to = ctx->tri[3 * t + (i + 1) % 3];
+          edges[3 * t + i].a = from < to ? from : to;
+          edges[3 * t + i].b = from < to ? to : from;
+          edges[3 * t + i].from = from;
+          edges[3 * t + i].to = to;
+        }
+    }
+  qsort(edges, nedges, sizeof(edge_t), compare_edges);
+
+  ctx->nborder = 0;
+  for (i = 0; i < nedges; i = j)
+    {
+      for (j = i + 1; j < nedges && compare_edges(edges + i, edges + j) == 0; j++)
+        ;
+      if (j - i == 1)
+        {
+          ctx->border[2 * ctx->nborder] = edges[i].from;
+          ctx->border[2 * ctx->nborder + 1] = edges[i].to;
+          ctx->nborder++;
+        }
+    }
+  free(edges);
+
+  return 0;
+}
+
+/*
+ * Extrapolate at a point outside of the convex hull from the closest border line segment if the point lies in its
+ * semi-infinite rectangle or from the closest border vertex otherwise.
+ */
+static double extrapolate(const griddata_context_t *ctx, double x, double y, int *feature, patch_t *patch)
+{
+  int i, ip1, ip2, best = -1;
+  double dx, dy, s, px, py, dist2, best_dist2 = 0, best_s = 0;
+
+  for (i = 0; i < ctx->nborder; i++)
+    {
+      ip1 = ctx->border[2 * i];
+      ip2 = ctx->border[2 * i + 1];
+      dx = ctx->xd[ip2] - ctx->xd[ip1];
+      dy = ctx->yd[ip2] - ctx->yd[ip1];
+      s = ((x - ctx->xd[ip1]) * dx + (y - ctx->yd[ip1]) * dy) / (dx * dx + dy * dy);
+      if (s < 0) s = 0;
+      if (s > 1) s = 1;
+      px = ctx->xd[ip1] + s * dx - x;
+      py = ctx->yd[ip1] + s * dy - y;
+      dist2 = px * px + py * py;
+      if (best < 0 || dist2 < best_dist2)
+        {
+          best = i;
+          best_dist2 = dist2;
+          best_s = s;
+        }
+    }
+
+  ip1 = ctx->border[2 * best];
+  ip2 = ctx->border[2 * best + 1];
+  if (best_s > 0 && best_s < 1)
+    {
+      if (*feature != best)
+        {
+          segment_patch(ctx, ip1, ip2, patch);
+          *feature = best;
+        }
+    }
+  else
+    {
+      i = ctx->nborder + (best_s <= 0 ? ip1 : ip2);
+      if (*feature != i)
+        {
+          vertex_patch(ctx, i - ctx->nborder, patch);
+          *feature = i;
+        }
+    }
+
+  return eval_patch(patch, x, y);
+}
+
+static void *evaluate_band(void *arg)
+{
+  griddata_job_t *job = (griddata_job_t *)arg;
+  griddata_context_t *ctx = job->ctx;
+  const double *xd = ctx->xd, *yd = ctx->yd, *zd = ctx->zd, *xi = ctx->xi, *yi = ctx->yi;
+  int nxi = ctx->nxi, row_start = ctx->band_start[job->band], row_end = ctx->band_start[job->band + 1];
+  int k, t, i, r, r0, r1, c, c0, c1, ip1, ip2, ip3, have_patch, feature;
+  double x1, y1, z1, x2, y2, x3, y3, xii, yii, xmin, xmax, ymin, ymax, xl, xr, xs, w0, w1, w2;
+  double ex[3], ey[3], fx[3], fy[3];
+  patch_t patch;
+
+  for (k = ctx->bucket_start[job->band]; k < ctx->bucket_start[job->band + 1]; k++)
+    {
+      t = ctx->bucket[k];
+      ip1 = ctx->tri[3 * t];
+      ip2 = ctx->tri[3 * t + 1];
+      ip3 = ctx->tri[3 * t + 2];
+      x1 = xd[ip1];
+      y1 = yd[ip1];
+      z1 = zd[ip1];
+      x2 = xd[ip2];
+      y2 = yd[ip2];
+      x3 = xd[ip3];
+      y3 = yd[ip3];
+      ymin = y1 < y2 ? (y1 < y3 ? y1 : y3) : (y2 < y3 ? y2 : y3);
+      ymax = y1 > y2 ? (y1 > y3 ? y1 : y3) : (y2 > y3 ? y2 : y3);
+      xmin = x1 < x2 ? (x1 < x3 ? x1 : x3) : (x2 < x3 ? x2 : x3);
+      xmax = x1 > x2 ? (x1 > x3 ? x1 : x3) : (x2 > x3 ? x2 : x3);
+      r0 = lower_bound(yi, ctx->nyi, ymin);
+      r1 = upper_bound(yi, ctx->nyi, ymax);
+      if (r0 < row_start) r0 = row_start;
+      if (r1 > row_end) r1 = row_end;
+
+      ex[0] = x1, ey[0] = y1, fx[0] = x2, fy[0] = y2;
+      ex[1] = x2, ey[1] = y2, fx[1] = x3, fy[1] = y3;
+      ex[2] = x3, ey[2] = y3, fx[2] = x1, fy[2] = y1;
+      w0 = w1 = w2 = 0;
+      have_patch = 0;
+
+      for (r = r0; r < r1; r++)
+        {
+          yii = yi[r];
+          xl = xmax;
+          xr = xmin;
+          for (i = 0; i < 3; i++)
+            {
+              if ((ey[i] <= yii && yii <= fy[i]) || (fy[i] <= yii && yii <= ey[i]))
+                {
+                  if (ey[i] == fy[i])
+                    {
+                      if (ex[i] < xl) xl = ex[i];
+                      if (ex[i] > xr) xr = ex[i];
+                      xs = fx[i];
+                    }
+                  else
+                    xs = ex[i] + (yii - ey[i]) * (fx[i] - ex[i]) / (fy[i] - ey[i]);
+                  if (xs < xl) xl = xs;
+                  if (xs > xr) xr = xs;
+                }
+            }
+          if (xl > xr) continue;
+          c0 = lower_bound(xi, nxi, xl) - 1;
+          c1 = upper_bound(xi, nxi, xr) + 1;
+          if (c0 < 0) c0 = 0;
+          if (c1 > nxi) c1 = nxi;
+
+          for (c = c0; c < c1; c++)
+            {
+              if (ctx->done[r * nxi + c]) continue;
+              xii = xi[c];
+              if ((x1 - xii) * (y2 - yii) - (y1 - yii) * (x2 - xii) < 0) continue;
+              if ((x2 - xii) * (y3 - yii) - (y2 - yii) * (x3 - xii) < 0) continue;
+              if ((x3 - xii) * (y1 - yii) - (y3 - yii) * (x1 - xii) < 0) continue;
+
+              if (!have_patch)
+                {
+                  if (ctx->linear)
+                    {
+                      w0 = (y2 - y1) * (zd[ip3] - z1) - (y3 - y1) * (zd[ip2] - z1);
+                      w1 = (x3 - x1) * (zd[ip2] - z1) - (x2 - x1) * (zd[ip3] - z1);
+                      w2 = (x3 - x1) * (y2 - y1) - (x2 - x1) * (y3 - y1);
+                    }
+                  else
+                    triangle_patch(ctx, t, &patch);
+                  have_patch = 1;
+                }
+              if (ctx->linear)
+                ctx->zi[r * nxi + c] = (w0 * (xii - x1) + w1 * (yii - y1)) / w2 + z1;
+              else
+                ctx->zi[r * nxi + c] = eval_patch(&patch, xii, yii);
+              ctx->done[r * nxi + c] = 1;
+            }
+        }
+    }
+
+  /* grid points outside of the convex hull are only extrapolated in the quintic mode */
+  if (!ctx->linear)
+    {
+      feature = -1;
+      for (r = row_start; r < row_end; r++)
+        {
+          for (c = 0; c < nxi; c++)
+            {
+              if (!ctx->done[r * nxi + c]) ctx->zi[r * nxi + c] = extrapolate(ctx, xi[c], yi[r], &feature, &patch);
+            }
+        }
+    }
+
+  return NULL;
+}
+
+static int band_of_row(const griddata_context_t *ctx, int row)
+{
+  int lo = 0, hi = ctx->nbands - 1, mid;
+
+  while (lo < hi)
+    {
+      mid = (lo + hi + 1) / 2;
+      if (ctx->band_start[mid] <= row)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+  return lo;
+}
+
+/*
+ * Sort the triangles into the horizontal bands of grid rows they overlap. Within a band the triangles keep their
+ * original order, so grid points on shared edges are always assigned to the same triangle.
+ */
+static int bucket_triangles(griddata_context_t *ctx)
+{
+  int pass, t, b, r0, r1;
+  double ymin, ymax, y;
+  int *fill;
+
+  ctx->bucket_start = (int *)calloc(ctx->nbands + 1, sizeof(int));
+  fill = (int *)calloc(ctx->nbands, sizeof(int));
+  if (ctx->bucket_start == NULL || fill == NULL)
+    {
+      free(fill);
+      fprintf(stderr, "out of virtual memory\n");
+      return -1;
+    }
+
+  for (pass = 0; pass < 2; pass++)
+    {
+      for (t = 0; t < ctx->ntri; t++)
+        {
+          ymin = ymax = ctx->yd[ctx->tri[3 * t]];
+          y = ctx->yd[ctx->tri[3 * t + 1]];
+          if (y < ymin) ymin = y;
+          if (y > ymax) ymax = y;
+          y = ctx->yd[ctx->tri[3 * t + 2]];
+          if (y < ymin) ymin = y;
+          if (y > ymax) ymax = y;
+          r0 = lower_bound(ctx->yi, ctx->nyi, ymin);
+          r1 = upper_bound(ctx->yi, ctx->nyi, ymax);
+          if (r0 >= r1) continue;
+          for (b = band_of_row(ctx, r0); b < ctx->nbands && ctx->band_start[b] < r1; b++)
+            {
+              if (pass == 0)
+                ctx->bucket_start[b + 1]++;
+              else
+                ctx->bucket[ctx->bucket_start[b] + fill[b]++] = t;
+            }
+        }
+      if (pass == 0)
+        {
+          for (b = 0; b < ctx->nbands; b++) ctx->bucket_start[b + 1] += ctx->bucket_start[b];
+          ctx->bucket = (int *)malloc((ctx->bucket_start[ctx->nbands] > 0 ? ctx->bucket_start[ctx->nbands] : 1) *
+                                      sizeof(int));
+          if (ctx->bucket == NULL)
+            {
+              free(fill);
+              fprintf(stderr, "out of virtual memory\n");
+              return -1;
+            }
+        }
+    }
+  free(fill);
+
+  return 0;
+}
+
+/*!
+ * Interpolate scattered data on a rectangular grid using the Delaunay triangulation of the data points.
+ *
+ * \param[in] linear Use piecewise linear interpolation if non-zero, quintic interpolation and extrapolation otherwise
+ * \param[in] ncp The number of closest data points used to estimate the partial derivatives (quintic mode only)
+ * \param[in] ndp The number of data points
+ * \param[in] xd A pointer to the X coordinates of the data points
+ * \param[in] yd A pointer to the Y coordinates of the data points
+ * \param[in] zd A pointer to the values of the data points
+ * \param[in] nxi The number of grid points in X direction
+ * \param[in] nyi The number of grid points in Y direction
+ * \param[in] xi A pointer to the ascending X coordinates of the grid
+ * \param[in] yi A pointer to the ascending Y coordinates of the grid
+ * \param[out] zi A pointer to the nxi x nyi interpolated values. In the linear mode, values outside of the convex hull
+ *                of the data points are left unchanged.
+ * \param[in] nthreads The number of threads used to evaluate the grid
+ * \returns 0 on success, -1 if the data could not be triangulated. Invalid data is not reported since the caller falls
+ *          back to IDSFFT, which prints the appropriate message.
+ */
+int griddata(int linear, int ncp, int ndp, const double *xd, const double *yd, const double *zd, int nxi, int nyi,
+             const double *xi, const double *yi, double *zi, int nthreads)
+{
+  griddata_context_t ctx;
+  griddata_job_t *jobs = NULL;
+  int i, t, tmp, result = -1;
+  double x1, y1;
+
+  ctx.linear = linear;
+  ctx.xd = (double *)malloc(3 * (ndp > 0 ? ndp : 1) * sizeof(double));
+  ctx.pd = NULL;
+  ctx.tri = NULL;
+  ctx.border = NULL;
+  ctx.done = NULL;
+  ctx.band_start = NULL;
+  ctx.bucket_start = NULL;
+  ctx.bucket = NULL;
+  if (ctx.xd == NULL)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      return -1;
+    }
+  ctx.yd = ctx.xd + ndp;
+  ctx.zd = ctx.yd + ndp;
+
+  /* gr_delaunay skips NaN coordinates, so the point indices refer to the compacted data */
+  ctx.ndp = 0;
+  for (i = 0; i < ndp; i++)
+    {
+      if (is_nan(xd[i]) || is_nan(yd[i])) continue;
+      ctx.xd[ctx.ndp] = xd[i];
+      ctx.yd[ctx.ndp] = yd[i];
+      ctx.zd[ctx.ndp] = zd[i];
+      ctx.ndp++;
+    }
+
+  ctx.nxi = nxi;
+  ctx.nyi = nyi;
+  ctx.xi = xi;
+  ctx.yi = yi;
+  ctx.zi = zi;
+
+  if (ctx.ndp < 3 || (!linear && ncp >= ctx.ndp) || all_collinear(&ctx)) goto cleanup;
+
+  gr_delaunay(ctx.ndp, ctx.xd, ctx.yd, &ctx.ntri, &ctx.tri);
+  if (ctx.ntri == 0 || ctx.tri == NULL) goto cleanup;
+
+  for (t = 0; t < ctx.ntri; t++)
+    {
+      x1 = ctx.xd[ctx.tri[3 * t]];
+      y1 = ctx.yd[ctx.tri[3 * t]];
+      if ((ctx.xd[ctx.tri[3 * t + 1]] - x1) * (ctx.yd[ctx.tri[3 * t + 2]] - y1) -
+              (ctx.yd[ctx.tri[3 * t + 1]] - y1) * (ctx.xd[ctx.tri[3 * t + 2]] - x1) <
+          0)
+        {
+          tmp = ctx.tri[3 * t + 1];
+          ctx.tri[3 * t + 1] = ctx.tri[3 * t + 2];
+          ctx.tri[3 * t + 2] = tmp;
+        }
+    }
+
+  if (!linear)
+    {
+      if (find_border(&ctx) != 0 || estimate_derivatives(&ctx, ncp) != 0) goto cleanup;
+    }
+
+  if (nthreads < 1) nthreads = 1;
+  ctx.nbands = nthreads < nyi ? nthreads : nyi;
+  ctx.band_start = (int *)malloc((ctx.nbands + 1) * sizeof(int));
+  ctx.done = (unsigned char *)calloc((size_t)nxi * nyi, sizeof(unsigned char));
+  jobs = (griddata_job_t *)malloc(ctx.nbands * sizeof(griddata_job_t));
+  if (ctx.band_start == NULL || ctx.done == NULL || jobs == NULL)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      goto cleanup;
+    }
+  for (i = 0; i <= ctx.nbands; i++) ctx.band_start[i] = (int)((double)i * nyi / ctx.nbands);
+  if (bucket_triangles(&ctx) != 0) goto cleanup;
+
+  for (i = 0; i < ctx.nbands; i++)
+    {
+      jobs[i].ctx = &ctx;
+      jobs[i].band = i;
+    }
+  threadpool_run_jobs(evaluate_band, jobs, sizeof(griddata_job_t), ctx.nbands);
+  result = 0;
+
+cleanup:
+  free(jobs);
+  free(ctx.bucket);
+  free(ctx.bucket_start);
+  free(ctx.done);
+  free(ctx.band_start);
+  free(ctx.border);
+  free(ctx.pd);
+  free(ctx.tri);
+  free(ctx.xd);
+
+  return result;
+}
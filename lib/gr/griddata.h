@@ -0,0 +1,15 @@
+#ifndef _GRIDDATA_H_
+#define _GRIDDATA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int griddata(int linear, int ncp, int ndp, const double *xd, const double *yd, const double *zd, int nxi, int nyi,
+             const double *xi, const double *yi, double *zi, int nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
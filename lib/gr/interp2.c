@@ -1,10 +1,50 @@
-
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "gr.h"
+#include "threadpool.h"
+
+#ifdef isnan
+#define is_nan(a) isnan(a)
+#else
+#define is_nan(x) ((x) != (x))
+#endif
 
+/* below this number of target points a plan is applied in the calling thread only */
+#define MIN_PARALLEL_POINTS 16384
+
+/*
+ * An interpolation plan stores a separable stencil for every target coordinate: the index of the first source point,
+ * the number of source points (0 outside of the source grid) and their weights. Applying the plan to a new z array
+ * only sums weighted source values. For natural cubic splines the stencil holds the interval index and the offset
+ * `xq - x[ix]`, since the spline coefficients depend on z. The spline coefficients, the scratch space of every band
+ * and the job descriptions are allocated with the plan, so applying it does not allocate memory.
+ */
+typedef struct
+{
+  const interp2_plan_t *plan;
+  const double *z;
+  double *zq;
+  double *splines;
+  double *work;
+  int start, end;
+} interp2_job_t;
+
+struct interp2_plan
+{
+  int nx, ny, nxq, nyq;
+  interp2_method_t method;
+  double extrapval;
+  int nthreads;
+  double *x, *y;
+  int *xstart, *xcount, *ystart, *ycount;
+  double *xweight, *yweight;
+  double *splines, *work;
+  size_t work_size;
+  interp2_job_t *jobs;
+};
 
 static char *xmalloc(int size)
 {
@@ -18,131 +58,89 @@ static char *xmalloc(int size)
 }
 
 /*!
- * Cubic interpolation at position `x = xq` using four supporting points.
- *
- * \param[in] x Pointer to the supporting points' x-values
- * \param[in] y Pointer to the supporting points' y-values
- * \param[in] xq The x-coordinate to interpolate at
- *
- * \returns The resulting y-value
- */
-static double cubic_interp(const double *x, const double *y, double xq)
-{
-  double a[4], result;
-
-  a[0] = y[0];
-  a[1] = (y[1] - a[0]) / (x[1] - x[0]);
-  a[2] = (y[2] - a[0] - a[1] * (x[2] - x[0])) / ((x[2] - x[0]) * (x[2] - x[1]));
-  a[3] = (y[3] - a[0] - a[1] * (x[3] - x[0]) - a[2] * (x[3] - x[0]) * (x[3] - x[1])) /
-         ((x[3] - x[0]) * (x[3] - x[1]) * (x[3] - x[2]));
-  /* Horner's method */
-  result = a[3];
-  result = result * (xq - x[2]) + a[2];
-  result = result * (xq - x[1]) + a[1];
-  result = result * (xq - x[0]) + a[0];
-
-  return result;
-}
-
-/*!
- * Bilinear interpolation at position (`xq`, `yq`).
+ * Find the interval of the supporting points containing `xq`, which must lie inside of `[x[0], x[n - 1]]`.
  *
- * \param[in] x Pointer to the supporting points' x-values
- * \param[in] y Pointer to the supporting points' y-values
- * \param[in] z Pointer to the supporting points' z-values
- * \param[in] ix Index of next x-value less than `xq`
- * \param[in] iy Index of next y-value less than `yq`
- * \param[in] nx Number of given x-values
- * \param[in] xq x-coordinate to interpolate at
- * \param[in] yq y-coordinate to interpolate at
+ * \param[in] x Pointer to the ascending supporting points
+ * \param[in] n Number of supporting points
+ * \param[in] xq The coordinate to search for
  *
- * \returns The resulting y-value
+ * \returns The index of the next supporting point less than `xq`, at most `n - 2`
  */
-static double bilinear_interp(const double *x, const double *y, const double *z, int ix, int iy, int nx, double xq,
-                              double yq)
+static int find_interval(const double *x, int n, double xq)
 {
-  double f1, f2;
-
-  f1 = ((x[ix + 1] - xq) / (x[ix + 1] - x[ix])) * z[iy * nx + ix];
-  f1 += ((xq - x[ix]) / (x[ix + 1] - x[ix])) * z[iy * nx + ix + 1];
-  f2 = ((x[ix + 1] - xq) / (x[ix + 1] - x[ix])) * z[(iy + 1) * nx + ix];
-  f2 += ((xq - x[ix]) / (x[ix + 1] - x[ix])) * z[(iy + 1) * nx + ix + 1];
+  int lo = 0, hi = n - 2, mid;
 
-  return ((y[iy + 1] - yq) / (y[iy + 1] - y[iy])) * f1 + ((yq - y[iy]) / (y[iy + 1] - y[iy])) * f2;
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (x[mid + 1] < xq)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return lo;
 }
 
 /*!
- * Linear interpolation of the value at `x = xq`, using two supporting points.
+ * Compute the one-dimensional stencil of a target coordinate.
  *
- * \param[in] x Pointer to left neighbour's x-value in supporting points,
- *              `x + 1` has to be a pointer to the left neighbour's x-value
- * \param[in] y Pointer to left neighbour's y-value in supporting points,
- *              `y + 1` has to be a pointer to the left neighbour's y-value
- * \param[in] xq The x-coordinate to interpolate at
- *
- * \returns The resulting y-value
+ * \param[in] x Pointer to the ascending supporting points
+ * \param[in] n Number of supporting points
+ * \param[in] xq The coordinate to interpolate at
+ * \param[in] method Used method for interpolation
+ * \param[out] start Index of the first supporting point of the stencil
+ * \param[out] count Number of supporting points, 0 if `xq` is outside of the grid
+ * \param[out] w Pointer to the four weights of the stencil
  */
-static double linear_interp(const double *x, const double *y, double xq)
+static void create_stencil(const double *x, int n, double xq, interp2_method_t method, int *start, int *count,
+                           double *w)
 {
-  return y[0] + ((y[1] - y[0]) / (x[1] - x[0])) * (xq - x[0]);
-}
+  int ix, i, j;
 
-/*!
- * Bicubic interpolation at (`xq`, `yq`).  Uses linear interpolation as a
- * fallback if cubic interpolation is not applicable.
- *
- * \param[in] x Pointer to the supporting points' x-values
- * \param[in] y Pointer to the supporting points' y-values
- * \param[in] z Pointer to the supporting points' z-values
- * \param[in] ix Index of next x-value less than `xq`
- * \param[in] iy Index of next y-value less than `yq`
- * \param[in] nx Number of given x-values
- * \param[in] ny Number of given y-values
- * \param[in] xq The x-coordinate to interpolate at
- * \param[in] yq The y-coordinate to interpolate at
- *
- * \returns The resulting z-value
- */
-static double bicubic_interp(const double *x, const double *y, const double *z, int ix, int iy, int nx, int ny,
-                             double xq, double yq)
-{
-  double a[4];
+  w[0] = w[1] = w[2] = w[3] = 0;
+  if (is_nan(xq) || xq > x[n - 1] || xq < x[0])
+    {
+      /* location outside of grid */
+      *start = 0;
+      *count = 0;
+      return;
+    }
 
-  if (ix + 2 >= nx || ix - 1 < 0)
+  ix = find_interval(x, n, xq);
+  if (method == GR_INTERP2_NEAREST)
     {
-      if (iy + 2 >= ny || iy - 1 < 0)
-        {
-          /* fallback: linear interpolation */
-          return bilinear_interp(x, y, z, ix, iy, nx, xq, yq);
-        }
-      else
+      if (xq - x[ix] > x[ix + 1] - xq) ix++;
+      *start = ix;
+      *count = 1;
+      w[0] = 1;
+    }
+  else if (method == GR_INTERP2_SPLINE)
+    {
+      *start = ix;
+      *count = 1;
+      w[0] = xq - x[ix];
+    }
+  else if (method == GR_INTERP2_CUBIC && ix - 1 >= 0 && ix + 2 < n)
+    {
+      /* Lagrange weights of the cubic polynomial through the four surrounding points */
+      *start = ix - 1;
+      *count = 4;
+      for (i = 0; i < 4; i++)
         {
-          /* linear interpolation in X direction, cubic in Y direction */
-          a[0] = linear_interp(x + ix, z + ((iy - 1) * nx + ix), xq);
-          a[1] = linear_interp(x + ix, z + (iy * nx + ix), xq);
-          a[2] = linear_interp(x + ix, z + ((iy + 1) * nx + ix), xq);
-          a[3] = linear_interp(x + ix, z + ((iy + 2) * nx + ix), xq);
-          return cubic_interp(y + iy - 1, a, yq);
+          w[i] = 1;
+          for (j = 0; j < 4; j++)
+            {
+              if (j != i) w[i] *= (xq - x[ix - 1 + j]) / (x[ix - 1 + i] - x[ix - 1 + j]);
+            }
         }
     }
   else
     {
-      if (iy + 2 >= ny || iy - 1 < 0)
-        {
-          /* cubic interpolation in Y direction, linear in Y direction */
-          a[0] = cubic_interp(x + ix - 1, z + (iy * nx + ix - 1), xq);
-          a[1] = cubic_interp(x + ix - 1, z + ((iy + 1) * nx + ix - 1), xq);
-          return linear_interp(y + iy, a, yq);
-        }
-      else
-        {
-          /* cubic interpolation in both directions */
-          a[0] = cubic_interp(x + ix - 1, z + ((iy - 1) * nx + ix - 1), xq);
-          a[1] = cubic_interp(x + ix - 1, z + (iy * nx + ix - 1), xq);
-          a[2] = cubic_interp(x + ix - 1, z + ((iy + 1) * nx + ix - 1), xq);
-          a[3] = cubic_interp(x + ix - 1, z + ((iy + 2) * nx + ix - 1), xq);
-          return cubic_interp(y + iy - 1, a, yq);
-        }
+      /* linear interpolation, also the fallback of cubic interpolation at the grid borders */
+      *start = ix;
+      *count = 2;
+      w[0] = (x[ix + 1] - xq) / (x[ix + 1] - x[ix]);
+      w[1] = (xq - x[ix]) / (x[ix + 1] - x[ix]);
     }
 }
 
@@ -154,24 +152,25 @@ static double bicubic_interp(const double *x, const double *y, const double *z,
  * \param[in] n Number of nodes/supporting points
  * \param[out] spline Memory location of the `n * 4`
  *                    target-array containing the splines
+ * \param[in] work Memory location of `5 * n` doubles used as scratch space
  */
-static void create_splines(const double *x, const double *y, int n, double **spline)
+static void create_splines(const double *x, const double *y, int n, double *spline, double *work)
 {
   int i;
   double *h, *l, *m, *z, *alpha;
 
-  h = (double *)xmalloc((n - 1) * sizeof(double));
-  l = (double *)xmalloc(n * sizeof(double));
-  m = (double *)xmalloc((n - 1) * sizeof(double));
-  z = (double *)xmalloc(n * sizeof(double));
-  alpha = (double *)xmalloc((n - 1) * sizeof(double));
+  h = work;
+  l = h + n;
+  m = l + n;
+  z = m + n;
+  alpha = z + n;
 
   for (i = 0; i < n - 1; i++)
     {
       h[i] = x[i + 1] - x[i];
-      spline[i][0] = y[i];
+      spline[4 * i] = y[i];
     }
-  spline[n - 1][0] = y[n - 1];
+  spline[4 * (n - 1)] = y[n - 1];
   for (i = 1; i < n - 1; i++)
     {
       alpha[i] = (3. / h[i]) * (y[i + 1] - y[i]) - (3. / (h[i - 1])) * (y[i] - y[i - 1]);
@@ -187,25 +186,300 @@ static void create_splines(const double *x, const double *y, int n, double **spl
     }
   l[n - 1] = 1;
   z[n - 1] = 0;
-  spline[n - 1][2] = 0;
+  spline[4 * (n - 1) + 2] = 0;
   for (i = n - 2; i >= 0; i--)
     {
-      spline[i][2] = z[i] - m[i] * spline[i + 1][2];
-      spline[i][1] = (spline[i + 1][0] - spline[i][0]) / h[i] - h[i] * ((spline[i + 1][2] + 2 * spline[i][2]) / 3);
-      spline[i][3] = (spline[i + 1][2] - spline[i][2]) / (3 * h[i]);
+      spline[4 * i + 2] = z[i] - m[i] * spline[4 * (i + 1) + 2];
+      spline[4 * i + 1] =
+          (spline[4 * (i + 1)] - spline[4 * i]) / h[i] - h[i] * ((spline[4 * (i + 1) + 2] + 2 * spline[4 * i + 2]) / 3);
+      spline[4 * i + 3] = (spline[4 * (i + 1) + 2] - spline[4 * i + 2]) / (3 * h[i]);
+    }
+}
+
+/*!
+ * Evaluate a spline segment with Horner's method.
+ */
+static double eval_spline(const double *spline, double diff)
+{
+  double result;
+
+  result = spline[3];
+  result = result * diff + spline[2];
+  result = result * diff + spline[1];
+  result = result * diff + spline[0];
+
+  return result;
+}
+
+/*!
+ * Apply the stencils of the target rows `[start, end)`.
+ */
+static void apply_rows(const interp2_plan_t *plan, const double *z, double *zq, int start, int end)
+{
+  int nx = plan->nx, nxq = plan->nxq;
+  const int *xstart = plan->xstart, *xcount = plan->xcount;
+  const double *xw = plan->xweight;
+  const double *row, *wy;
+  double *out, f;
+  int iyq, ixq, i, j, k, ycount;
+
+  for (iyq = start; iyq < end; iyq++)
+    {
+      out = zq + (size_t)iyq * nxq;
+      ycount = plan->ycount[iyq];
+      if (ycount == 0)
+        {
+          for (ixq = 0; ixq < nxq; ixq++) out[ixq] = plan->extrapval;
+          continue;
+        }
+      row = z + (size_t)plan->ystart[iyq] * nx;
+      wy = plan->yweight + 4 * iyq;
+
+      if (plan->method == GR_INTERP2_NEAREST)
+        {
+          for (ixq = 0; ixq < nxq; ixq++) out[ixq] = xcount[ixq] ? row[xstart[ixq]] : plan->extrapval;
+        }
+      else if (plan->method == GR_INTERP2_LINEAR)
+        {
+          for (ixq = 0; ixq < nxq; ixq++)
+            {
+              k = xstart[ixq];
+              out[ixq] = xcount[ixq] ? wy[0] * (xw[4 * ixq] * row[k] + xw[4 * ixq + 1] * row[k + 1]) +
+                                           wy[1] * (xw[4 * ixq] * row[nx + k] + xw[4 * ixq + 1] * row[nx + k + 1])
+                                     : plan->extrapval;
+            }
+        }
+      else
+        {
+          for (ixq = 0; ixq < nxq; ixq++)
+            {
+              if (xcount[ixq] == 0)
+                {
+                  out[ixq] = plan->extrapval;
+                  continue;
+                }
+              out[ixq] = 0;
+              for (j = 0; j < ycount; j++)
+                {
+                  f = 0;
+                  for (i = 0; i < xcount[ixq]; i++) f += xw[4 * ixq + i] * row[j * nx + xstart[ixq] + i];
+                  out[ixq] += wy[j] * f;
+                }
+            }
+        }
     }
-  free(h);
-  free(l);
-  free(m);
-  free(z);
-  free(alpha);
+}
+
+/*!
+ * Compute the splines in X direction for the source rows `[start, end)`.
+ */
+static void create_row_splines(const interp2_plan_t *plan, const double *z, double *splines, double *work, int start,
+                               int end)
+{
+  int iy;
+
+  for (iy = start; iy < end; iy++)
+    {
+      create_splines(plan->x, z + (size_t)iy * plan->nx, plan->nx, splines + (size_t)iy * plan->nx * 4, work);
+    }
+}
+
+/*!
+ * Spline interpolation of the target columns `[start, end)`. The X spline values of a column are the same for all
+ * target rows, so the spline in Y direction is computed only once per column.
+ */
+static void apply_spline_columns(const interp2_plan_t *plan, double *zq, const double *splines, double *a, int start,
+                                 int end)
+{
+  int nx = plan->nx, ny = plan->ny, nxq = plan->nxq;
+  double *spline, *work;
+  int ixq, iyq, iy;
+
+  spline = a + ny;
+  work = spline + 4 * ny;
+  for (ixq = start; ixq < end; ixq++)
+    {
+      if (plan->xcount[ixq] == 0)
+        {
+          for (iyq = 0; iyq < plan->nyq; iyq++) zq[(size_t)iyq * nxq + ixq] = plan->extrapval;
+          continue;
+        }
+      /* interpolation in X direction: */
+      for (iy = 0; iy < ny; iy++)
+        {
+          a[iy] = eval_spline(splines + ((size_t)iy * nx + plan->xstart[ixq]) * 4, plan->xweight[4 * ixq]);
+        }
+      /* interpolation in Y direction: */
+      create_splines(plan->y, a, ny, spline, work);
+      for (iyq = 0; iyq < plan->nyq; iyq++)
+        {
+          zq[(size_t)iyq * nxq + ixq] = plan->ycount[iyq] ? eval_spline(spline + 4 * plan->ystart[iyq],
+                                                                        plan->yweight[4 * iyq])
+                                                          : plan->extrapval;
+        }
+    }
+}
+
+static void *apply_job(void *arg)
+{
+  interp2_job_t *job = (interp2_job_t *)arg;
+
+  if (job->plan->method != GR_INTERP2_SPLINE)
+    apply_rows(job->plan, job->z, job->zq, job->start, job->end);
+  else if (job->zq == NULL)
+    create_row_splines(job->plan, job->z, job->splines, job->work, job->start, job->end);
+  else
+    apply_spline_columns(job->plan, job->zq, job->splines, job->work, job->start, job->end);
+
+  return NULL;
+}
+
+/*!
+ * Split `n` items into bands and run `apply_job` for each of them, using up to `plan->nthreads` threads.
+ */
+static void run_jobs(const interp2_plan_t *plan, const double *z, double *zq, int n)
+{
+  interp2_job_t *jobs = plan->jobs;
+  int nbands, i;
+
+  nbands = (size_t)plan->nxq * plan->nyq < MIN_PARALLEL_POINTS ? 1 : plan->nthreads;
+  if (nbands > n) nbands = n;
+  if (nbands < 1) return;
+
+  for (i = 0; i < nbands; i++)
+    {
+      jobs[i].plan = plan;
+      jobs[i].z = z;
+      jobs[i].zq = zq;
+      jobs[i].splines = plan->splines;
+      jobs[i].work = (plan->work != NULL) ? plan->work + i * plan->work_size : NULL;
+      jobs[i].start = (int)((double)i * n / nbands);
+      jobs[i].end = (int)((double)(i + 1) * n / nbands);
+    }
+  threadpool_run_jobs(apply_job, jobs, sizeof(interp2_job_t), nbands);
+}
+
+/*!
+ * Create a plan for interpolating values on the grid described by `nx`, `ny`, `x` and `y` onto the target grid
+ * described by `nxq`, `nyq`, `xq` and `yq`. The plan stores the enclosing intervals and interpolation weights of all
+ * target coordinates, so it can be applied to any number of z arrays with `gr_applyinterp2plan`. The coordinates are
+ * copied. See `gr_interp2` for the available methods. The plan also holds the scratch space used while applying it,
+ * so a plan must not be applied by several threads at the same time.
+ *
+ * \param[in] nx The number of the input grid's x-values
+ * \param[in] ny The number of the input grid's y-values
+ * \param[in] x Pointer to the input grid's ascending x-values
+ * \param[in] y Pointer to the input grid's ascending y-values
+ * \param[in] nxq The number of the target grid's x-values
+ * \param[in] nyq The number of the target grid's y-values
+ * \param[in] xq Pointer to the target grid's x-values
+ * \param[in] yq Pointer to the target grid's y-values
+ * \param[in] method Used method for interpolation
+ * \param[in] extrapval The extrapolation value
+ *
+ * \returns The plan or NULL if the grid is invalid. It must be freed with `gr_freeinterp2plan`.
+ */
+interp2_plan_t *gr_createinterp2plan(int nx, int ny, const double *x, const double *y, int nxq, int nyq,
+                                     const double *xq, const double *yq, interp2_method_t method, double extrapval)
+{
+  interp2_plan_t *plan;
+  int i;
+
+  if (nx < 2 || ny < 2 || nxq < 0 || nyq < 0)
+    {
+      fprintf(stderr, "invalid number of points\n");
+      return NULL;
+    }
+
+  plan = (interp2_plan_t *)xmalloc(sizeof(interp2_plan_t));
+  plan->nx = nx;
+  plan->ny = ny;
+  plan->nxq = nxq;
+  plan->nyq = nyq;
+  plan->method = method;
+  plan->extrapval = extrapval;
+  gr_inqthreadnumber(&plan->nthreads);
+  if (plan->nthreads < 1) plan->nthreads = 1;
+
+  /* all coordinates, stencil indices and weights are stored in two contiguous blocks */
+  plan->x = (double *)xmalloc((nx + ny + 4 * (nxq + nyq)) * sizeof(double));
+  plan->y = plan->x + nx;
+  plan->xweight = plan->y + ny;
+  plan->yweight = plan->xweight + 4 * nxq;
+  plan->xstart = (int *)xmalloc((2 * (nxq + nyq) + 1) * sizeof(int));
+  plan->xcount = plan->xstart + nxq;
+  plan->ystart = plan->xcount + nxq;
+  plan->ycount = plan->ystart + nyq;
+
+  memcpy(plan->x, x, nx * sizeof(double));
+  memcpy(plan->y, y, ny * sizeof(double));
+  for (i = 0; i < nxq; i++)
+    {
+      create_stencil(x, nx, xq[i], method, plan->xstart + i, plan->xcount + i, plan->xweight + 4 * i);
+    }
+  for (i = 0; i < nyq; i++)
+    {
+      create_stencil(y, ny, yq[i], method, plan->ystart + i, plan->ycount + i, plan->yweight + 4 * i);
+    }
+
+  plan->jobs = (interp2_job_t *)xmalloc(plan->nthreads * sizeof(interp2_job_t));
+  plan->splines = NULL;
+  plan->work = NULL;
+  plan->work_size = 0;
+  if (method == GR_INTERP2_SPLINE)
+    {
+      /* a band needs 5 * nx values to create the row splines and 10 * ny values to interpolate a column */
+      plan->work_size = 5 * nx > 10 * ny ? 5 * nx : 10 * ny;
+      plan->splines = (double *)xmalloc((size_t)nx * ny * 4 * sizeof(double));
+      plan->work = (double *)xmalloc(plan->nthreads * plan->work_size * sizeof(double));
+    }
+
+  return plan;
+}
+
+/*!
+ * Interpolate the given values of the source grid onto the target grid of an interpolation plan. The target rows are
+ * distributed over the threads set with `gr_setthreadnumber`.
+ *
+ * \param[in] plan The interpolation plan
+ * \param[in] z Pointer to the input grid's z-values (num. of values: nx * ny)
+ * \param[out] zq Pointer to the target grids's z-values, used for output (num. of values: nxq * nyq)
+ */
+void gr_applyinterp2plan(const interp2_plan_t *plan, const double *z, double *zq)
+{
+  if (plan == NULL) return;
+
+  if (plan->method == GR_INTERP2_SPLINE)
+    {
+      run_jobs(plan, z, NULL, plan->ny);
+      run_jobs(plan, z, zq, plan->nxq);
+    }
+  else
+    run_jobs(plan, z, zq, plan->nyq);
+}
+
+/*!
+ * Free an interpolation plan created by `gr_createinterp2plan`.
+ *
+ * \param[in] plan The interpolation plan
+ */
+void gr_freeinterp2plan(interp2_plan_t *plan)
+{
+  if (plan == NULL) return;
+  free(plan->x);
+  free(plan->xstart);
+  free(plan->jobs);
+  free(plan->splines);
+  free(plan->work);
+  free(plan);
 }
 
 /*!
  * Interpolation in two dimensions using one of four different methods.
  * The input points are located on a grid, described by `nx`, `ny`, `x`, `y` and `z`.
  * The target grid ist described by `nxq`, `nyq`, `xq` and `yq` and the output
- * is written to `zq` as a field of `nxq * nyq` values.
+ * is written to `zq` as a field of `nxq * nyq` values. To resample several z arrays between the same grids, create
+ * an interpolation plan once with `gr_createinterp2plan` instead.
  *
  * \verbatim embed:rst:leading-asterisk
  *
@@ -239,125 +513,9 @@ static void create_splines(const double *x, const double *y, int n, double **spl
 void gr_interp2(int nx, int ny, const double *x, const double *y, const double *z, int nxq, int nyq, const double *xq,
                 const double *yq, double *zq, interp2_method_t method, double extrapval)
 {
-  int ixq, iyq, ix, iy, ind, i;
-  double ***x_splines = NULL, **spline = NULL, *a = NULL, diff;
-
-  if (method == GR_INTERP2_SPLINE)
-    {
-      x_splines = (double ***)xmalloc(ny * sizeof(double **));
-      spline = (double **)xmalloc(ny * sizeof(double *));
-      for (ind = 0; ind < ny; ind++)
-        {
-          x_splines[ind] = (double **)xmalloc(ny * sizeof(double *));
-          for (i = 0; i < nx; i++)
-            {
-              x_splines[ind][i] = (double *)xmalloc(4 * sizeof(double));
-            }
-          spline[ind] = (double *)xmalloc(4 * sizeof(double));
-          create_splines(x, z + ind * nx, nx, x_splines[ind]);
-        }
-      a = (double *)xmalloc(ny * sizeof(double));
-    }
-  for (iyq = 0; iyq < nyq; iyq++)
-    {
-      for (ixq = 0; ixq < nxq; ixq++)
-        {
-          if ((xq[ixq] > x[nx - 1] || xq[ixq] < x[0]) || (yq[iyq] > y[ny - 1] || yq[iyq] < y[0]))
-            {
-              /* location outside of grid */
-              zq[iyq * nxq + ixq] = extrapval;
-            }
-          else
-            {
-              if (xq[ixq] > x[nx - 2])
-                {
-                  /* index of next X value less than xq[ixq] is the second last */
-                  ix = nx - 2;
-                }
-              else
-                {
-                  ix = 0;
-                  while (ix + 1 < nx && x[ix + 1] < xq[ixq])
-                    {
-                      /* searching for index of next X value less than xq[ixq] */
-                      ix++;
-                    }
-                }
-
-              if (yq[iyq] > y[ny - 2])
-                {
-                  /* index of next Y value less than yq[iyq] is the second last */
-                  iy = ny - 2;
-                }
-              else
-                {
-                  iy = 0;
-                  while (iy + 1 < ny && y[iy + 1] < yq[iyq])
-                    {
-                      /* searching for index of next Y value less than yq[iyq] */
-                      iy++;
-                    }
-                }
+  interp2_plan_t *plan;
 
-              if (method == GR_INTERP2_NEAREST)
-                {
-                  if (ix + 1 < nx && xq[ixq] - x[ix] > x[ix + 1] - xq[ixq])
-                    {
-                      ix++;
-                    }
-                  if (iy + 1 < ny && yq[iyq] - y[iy] > y[iy + 1] - yq[iyq])
-                    {
-                      iy++;
-                    }
-                  zq[iyq * nxq + ixq] = z[iy * nx + ix];
-                }
-              else if (method == GR_INTERP2_SPLINE)
-                {
-                  /* interpolation in X direction: */
-                  diff = xq[ixq] - x[ix];
-                  for (ind = 0; ind < ny; ind++)
-                    {
-                      /* Horner's method */
-                      a[ind] = x_splines[ind][ix][3];
-                      a[ind] = a[ind] * diff + x_splines[ind][ix][2];
-                      a[ind] = a[ind] * diff + x_splines[ind][ix][1];
-                      a[ind] = a[ind] * diff + x_splines[ind][ix][0];
-                    }
-
-                  /* interpolation in Y direction: */
-                  create_splines(y, a, ny, spline);
-                  diff = yq[iyq] - y[iy];
-                  /* Horner's method */
-                  zq[iyq * nxq + ixq] = spline[iy][3];
-                  zq[iyq * nxq + ixq] = zq[iyq * nxq + ixq] * diff + spline[iy][2];
-                  zq[iyq * nxq + ixq] = zq[iyq * nxq + ixq] * diff + spline[iy][1];
-                  zq[iyq * nxq + ixq] = zq[iyq * nxq + ixq] * diff + spline[iy][0];
-                }
-              else if (method == GR_INTERP2_CUBIC)
-                {
-                  zq[iyq * nxq + ixq] = bicubic_interp(x, y, z, ix, iy, nx, ny, xq[ixq], yq[iyq]);
-                }
-              else if (method == GR_INTERP2_LINEAR)
-                {
-                  zq[iyq * nxq + ixq] = bilinear_interp(x, y, z, ix, iy, nx, xq[ixq], yq[iyq]);
-                }
-            }
-        }
-    }
-  if (method == GR_INTERP2_SPLINE)
-    {
-      /* free allocated memory */
-      for (ind = 0; ind < ny; ind++)
-        {
-          for (i = 0; i < nx; i++)
-            {
-              free(x_splines[ind][i]);
-            }
-          free(x_splines[ind]);
-          free(spline[ind]);
-        }
-      free(x_splines);
-      free(spline);
-      free(a);
-    }
+  plan = gr_createinterp2plan(nx, ny, x, y, nxq, nyq, xq, yq, method, extrapval);
+  gr_applyinterp2plan(plan, z, zq);
+  gr_freeinterp2plan(plan);
 }
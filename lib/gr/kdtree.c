@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "kdtree.h"
+
+/*
+ * A static two-dimensional k-d tree. The tree is stored implicitly in a permutation of the point indices: every range
+ * [lo, hi) of the permutation is a subtree whose root is the median element at (lo + hi) / 2. Points left of the median
+ * have a smaller or equal coordinate along the split axis, points to the right a larger or equal one.
+ */
+
+typedef struct
+{
+  const kdtree_t *tree;
+  double x, y;
+  int k, count;
+  int *indices;
+  double *dist2;
+} kdtree_query_t;
+
+static double coordinate(const kdtree_t *tree, int i, int axis)
+{
+  return axis == 0 ? tree->x[i] : tree->y[i];
+}
+
+static void select_median(const kdtree_t *tree, int lo, int hi, int axis)
+{
+  int *index = tree->index;
+  int mid = (lo + hi) / 2;
+  int i, j, tmp;
+  double pivot;
+
+  hi -= 1;
+  while (lo < hi)
+    {
+      pivot = coordinate(tree, index[(lo + hi) / 2], axis);
+      i = lo;
+      j = hi;
+      while (i <= j)
+        {
+          while (coordinate(tree, index[i], axis) < pivot) i++;
+          while (coordinate(tree, index[j], axis) > pivot) j--;
+          if (i <= j)
+            {
+              tmp = index[i];
+              index[i] = index[j];
+              index[j] = tmp;
+              i++;
+              j--;
+            }
+        }
+      if (mid <= j)
+        hi = j;
+      else if (mid >= i)
+        lo = i;
+      else
+        break;
+    }
+}
+
+static void build(kdtree_t *tree, int lo, int hi)
+{
+  int i, mid, axis;
+  double xmin, xmax, ymin, ymax, x, y;
+
+  if (hi - lo < 2) return;
+
+  xmin = xmax = tree->x[tree->index[lo]];
+  ymin = ymax = tree->y[tree->index[lo]];
+  for (i = lo + 1; i < hi; i++)
+    {
+      x = tree->x[tree->index[i]];
+      y = tree->y[tree->index[i]];
+      if (x < xmin) xmin = x;
+      if (x > xmax) xmax = x;
+      if (y < ymin) ymin = y;
+      if (y > ymax) ymax = y;
+    }
+  axis = (ymax - ymin > xmax - xmin) ? 1 : 0;
+
+  mid = (lo + hi) / 2;
+  select_median(tree, lo, hi, axis);
+  tree->axis[mid] = (unsigned char)axis;
+
+  build(tree, lo, mid);
+  build(tree, mid + 1, hi);
+}
+
+/*!
+ * Build a k-d tree for the given points. The coordinate arrays are referenced, not copied, and must stay valid for the
+ * lifetime of the tree.
+ *
+ * \param[in] n The number of points
+ * \param[in] x A pointer to the X coordinates of the points
+ * \param[in] y A pointer to the Y coordinates of the points
+ * \returns The new tree or NULL if memory could not be allocated
+ */
+kdtree_t *kdtree_new(int n, const double *x, const double *y)
+{
+  kdtree_t *tree;
+  int i;
+
+  tree = (kdtree_t *)malloc(sizeof(kdtree_t));
+  if (tree == NULL) return NULL;
+  tree->n = n;
+  tree->x = x;
+  tree->y = y;
+  tree->index = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+  tree->axis = (unsigned char *)calloc(n > 0 ? n : 1, sizeof(unsigned char));
+  if (tree->index == NULL || tree->axis == NULL)
+    {
+      kdtree_delete(tree);
+      return NULL;
+    }
+  for (i = 0; i < n; i++) tree->index[i] = i;
+  build(tree, 0, n);
+
+  return tree;
+}
+
+void kdtree_delete(kdtree_t *tree)
+{
+  if (tree == NULL) return;
+  free(tree->index);
+  free(tree->axis);
+  free(tree);
+}
+
+static void insert_candidate(kdtree_query_t *q, int i, double d)
+{
+  int j;
+
+  if (q->count == q->k)
+    {
+      if (d >= q->dist2[q->k - 1]) return;
+      j = q->k - 1;
+    }
+  else
+    {
+      j = q->count++;
+    }
+  while (j > 0 && q->dist2[j - 1] > d)
+    {
+      q->dist2[j] = q->dist2[j - 1];
+      q->indices[j] = q->indices[j - 1];
+      j--;
+    }
+  q->dist2[j] = d;
+  q->indices[j] = i;
+}
+
+static void search(kdtree_query_t *q, int lo, int hi)
+{
+  const kdtree_t *tree = q->tree;
+  int mid, i;
+  double dx, dy, diff;
+
+  if (lo >= hi) return;
+
+  mid = (lo + hi) / 2;
+  i = tree->index[mid];
+  dx = tree->x[i] - q->x;
+  dy = tree->y[i] - q->y;
+  insert_candidate(q, i, dx * dx + dy * dy);
+  if (hi - lo == 1) return;
+
+  diff = tree->axis[mid] == 0 ? q->x - tree->x[i] : q->y - tree->y[i];
+  if (diff < 0)
+    {
+      search(q, lo, mid);
+      if (q->count < q->k || diff * diff < q->dist2[q->count - 1]) search(q, mid + 1, hi);
+    }
+  else
+    {
+      search(q, mid + 1, hi);
+      if (q->count < q->k || diff * diff < q->dist2[q->count - 1]) search(q, lo, mid);
+    }
+}
+
+/*!
+ * Find the k points closest to (x, y). The query only reads the tree and may be run concurrently from several threads.
+ *
+ * \param[in] tree The k-d tree
+ * \param[in] x The X coordinate of the query point
+ * \param[in] y The Y coordinate of the query point
+ * \param[in] k The number of neighbors to find
+ * \param[out] indices A pointer to an array of size k receiving the point indices in ascending order of distance
+ * \param[out] dist2 A pointer to an array of size k receiving the squared distances
+ * \returns The number of neighbors found, which is less than k only if the tree has fewer than k points
+ */
+int kdtree_nearest(const kdtree_t *tree, double x, double y, int k, int *indices, double *dist2)
+{
+  kdtree_query_t q;
+
+  if (k < 1) return 0;
+  q.tree = tree;
+  q.x = x;
+  q.y = y;
+  q.k = k;
+  q.count = 0;
+  q.indices = indices;
+  q.dist2 = dist2;
+  search(&q, 0, tree->n);
+
+  return q.count;
+}
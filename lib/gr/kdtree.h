@@ -0,0 +1,24 @@
+#ifndef _KDTREE_H_
+#define _KDTREE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  int n;
+  const double *x, *y;
+  int *index;
+  unsigned char *axis;
+} kdtree_t;
+
+kdtree_t *kdtree_new(int n, const double *x, const double *y);
+void kdtree_delete(kdtree_t *tree);
+int kdtree_nearest(const kdtree_t *tree, double x, double y, int k, int *indices, double *dist2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -189,10 +189,8 @@ static int sendstream(char *string)
   return status;
 }
 
-static void append(char *string)
+static void reserve(int len)
 {
-  int len = strlen(string);
-
   if (buffer == NULL)
     {
       buffer = (char *)malloc(BUFSIZ + 1);
@@ -206,6 +204,13 @@ static void append(char *string)
 
       buffer = (char *)realloc(buffer, size + 1);
     }
+}
+
+static void append(char *string)
+{
+  int len = strlen(string);
+
+  reserve(len);
 
   memcpy(buffer + nbytes, string, len);
   nbytes += len;
@@ -270,6 +275,36 @@ void gr_writestream(char *string, ...)
   if (stream != NULL) append(s);
 }
 
+/*
+ * Write `n` space separated numbers in their shortest representation that reads back as the same double. The numbers
+ * are formatted directly into the stream buffer.
+ */
+void gr_writestream_doubles(int n, const double *values)
+{
+  char s[GKS_DTOA_BUFFER_SIZE + 1], *p;
+  int i, len, debug = gr_debug();
+
+  if (stream == NULL && !debug) return;
+
+  for (i = 0; i < n; i++)
+    {
+      if (stream != NULL)
+        {
+          reserve(GKS_DTOA_BUFFER_SIZE + 1);
+          p = buffer + nbytes;
+        }
+      else
+        p = s;
+
+      len = 0;
+      if (i > 0) p[len++] = ' ';
+      len += gks_dtoa(p + len, values[i], 0);
+
+      if (debug) fprintf(stdout, "%s", p);
+      if (stream != NULL) nbytes += len;
+    }
+}
+
 void gr_flushstream(int discard)
 {
   if (buffer != NULL)
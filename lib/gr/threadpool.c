@@ -1,11 +1,50 @@
 #ifdef _MSC_VER
 #define NO_THREADS 1
 #endif
-#ifndef NO_THREADS
-#include <assert.h>
+
+#include <stdlib.h>
 
 #include "threadpool.h"
 
+/*
+ * Run `func` for each of the `njobs` job structures of `job_size` bytes starting at `jobs`. The first job runs on the
+ * calling thread and every other job on a thread of its own. A job whose thread cannot be created runs on the calling
+ * thread instead, so all jobs are finished when this function returns.
+ */
+void threadpool_run_jobs(void *(*func)(void *), void *jobs, size_t job_size, int njobs)
+{
+#ifndef NO_THREADS
+  pthread_t *threads;
+  int *started;
+#endif
+  int i;
+
+  if (njobs < 1) return;
+#ifndef NO_THREADS
+  threads = (pthread_t *)malloc(njobs * sizeof(pthread_t));
+  started = (int *)calloc(njobs, sizeof(int));
+  for (i = 1; i < njobs; i++)
+    {
+      void *job = (char *)jobs + i * job_size;
+
+      if (threads != NULL && started != NULL) started[i] = pthread_create(threads + i, NULL, func, job) == 0;
+      if (started == NULL || !started[i]) func(job);
+    }
+  func(jobs);
+  for (i = 1; i < njobs; i++)
+    {
+      if (started != NULL && started[i]) pthread_join(threads[i], NULL);
+    }
+  free(started);
+  free(threads);
+#else
+  for (i = 0; i < njobs; i++) func((char *)jobs + i * job_size);
+#endif
+}
+
+#ifndef NO_THREADS
+#include <assert.h>
+
 #ifndef max
 #define max(a, b) ((a) > (b) ? (a) : (b))
 #endif
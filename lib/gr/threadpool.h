@@ -4,6 +4,11 @@
 #ifdef _MSC_VER
 #define NO_THREADS 1
 #endif
+
+#include <stddef.h>
+
+void threadpool_run_jobs(void *(*func)(void *), void *jobs, size_t job_size, int njobs);
+
 #ifndef NO_THREADS
 
 #include <stdbool.h>
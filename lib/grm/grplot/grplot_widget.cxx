@@ -214,10 +214,8 @@ GRPlotWidget::GRPlotWidget(QMainWindow *parent, int argc, char **argv)
   if (strcmp(argv[1], "--listen") == 0)
     {
       in_listen_mode = true;
-      qRegisterMetaType<grm_args_t_wrapper>("grm_args_t_wrapper");
       receiver = new Receiver();
-      QObject::connect(receiver, SIGNAL(resultReady(grm_args_t_wrapper)), this, SLOT(received(grm_args_t_wrapper)),
-                       Qt::QueuedConnection);
+      QObject::connect(receiver, SIGNAL(resultReady()), this, SLOT(received()), Qt::QueuedConnection);
       QObject::connect(this, SIGNAL(pixmapRedrawn()), receiver, SLOT(dataProcessed()), Qt::QueuedConnection);
       receiver->start();
 
@@ -2475,19 +2473,25 @@ void GRPlotWidget::add_element_slot()
     }
 }
 
-void GRPlotWidget::received(grm_args_t_wrapper args)
+void GRPlotWidget::received()
 {
+  std::vector<grm_args_t *> messages = receiver->takeMessages();
+
   if (!isVisible())
     {
       window()->show();
     }
-  if (args_)
+  grm_switch(1);
+  /* all messages which arrived since the last frame are applied before the plot is redrawn once */
+  for (auto args : messages)
     {
-      grm_args_delete(args_);
+      if (args_)
+        {
+          grm_args_delete(args_);
+        }
+      args_ = args;
+      grm_merge(args_);
     }
-  grm_switch(1);
-  args_ = args.get_wrapper();
-  grm_merge(args_);
 
   redraw();
 }
@@ -116,7 +116,7 @@ private slots:
   void load_file_slot();
   void enable_editor_functions();
   void add_element_slot();
-  void received(grm_args_t_wrapper args);
+  void received();
   void screenChanged();
   void showContextSlot();
   void addContextSlot();
@@ -1,7 +1,81 @@
 #include "receiver_thread.h"
+#include <cstdlib>
+#include <cstring>
+#include <QMutexLocker>
+
+/* messages received for a single frame, so a continuous stream of messages cannot stall rendering */
+#define MAX_MESSAGES_PER_FRAME 1000
+#define DEFAULT_MAX_FPS 60
+
+static void getMessageIds(const grm_args_t *args, int *plot_id, int *subplot_id, int *series_id)
+{
+  const char *combined_id;
+
+  /* same rules as in `grm_merge`: the combined id has the form `plot:subplot.series` with optional parts */
+  *plot_id = -1;
+  *subplot_id = 0;
+  *series_id = 0;
+  if (grm_args_values(args, "id", "s", &combined_id))
+    {
+      int *ids[] = {plot_id, subplot_id, series_id};
+      for (int *id : ids)
+        {
+          size_t segment_length = strcspn(combined_id, ":.");
+          if (segment_length > 0)
+            {
+              *id = atoi(combined_id);
+            }
+          if (combined_id[segment_length] == '\0')
+            {
+              break;
+            }
+          combined_id += segment_length + 1;
+        }
+    }
+  else
+    {
+      grm_args_values(args, "plot_id", "i", plot_id);
+      grm_args_values(args, "subplot_id", "i", subplot_id);
+      grm_args_values(args, "series_id", "i", series_id);
+    }
+}
+
+static bool replacesMessage(const grm_args_t *args, const grm_args_t *pending_args)
+{
+  /*
+   * `grm_merge` only updates the keys of a message, so a pending message can only be dropped if the new message sets
+   * all of its keys again. Argument containers (`subplots`, `series`, ...) are merged element-wise, so messages which
+   * contain them are never replaced.
+   */
+  const grm_args_t *messages[] = {args, pending_args};
+  grm_args_iterator_t *it;
+  arg_t *arg;
+  bool replaces = true;
+
+  for (const grm_args_t *message : messages)
+    {
+      it = grm_args_iter(message);
+      while (replaces && (arg = it->next(it)) != nullptr)
+        {
+          if (strpbrk(arg->value_format, "aA") != nullptr ||
+              (message == pending_args && !grm_args_contains(args, arg->key)))
+            {
+              replaces = false;
+            }
+        }
+      grm_args_iter_delete(it);
+    }
+
+  return replaces;
+}
 
 Receiver::Receiver()
 {
+  const char *max_fps = getenv("GRPLOT_MAX_FPS");
+  int fps = (max_fps != nullptr) ? atoi(max_fps) : DEFAULT_MAX_FPS;
+
+  min_frame_interval_ms_ = (fps > 0) ? 1000 / fps : 0;
+  log_stats_ = getenv("GRPLOT_RECEIVER_STATS") != nullptr;
   moveToThread(&thread_);
   connect(&thread_, &QThread::started, this, &Receiver::receiveData);
 }
@@ -12,6 +86,10 @@ Receiver::~Receiver()
     {
       grm_close(grm_receiver_handle_);
     }
+  for (auto &message : messages_)
+    {
+      grm_args_delete(message.args);
+    }
   /*
    * TODO: Actually, we should call
    *   thread_.quit();
@@ -26,21 +104,40 @@ void Receiver::start()
   thread_.start();
 }
 
+std::vector<grm_args_t *> Receiver::takeMessages()
+{
+  QMutexLocker locker(&messages_mutex_);
+  std::vector<grm_args_t *> args;
+
+  args.reserve(messages_.size());
+  for (auto &message : messages_)
+    {
+      args.push_back(message.args);
+    }
+  messages_.clear();
+
+  return args;
+}
+
 void Receiver::dataProcessed()
 {
+  if (log_stats_)
+    {
+      qDebug() << "frame" << frame_count_ << ":" << received_count_ << "messages received," << merged_count_
+               << "merged," << frame_timer_.elapsed() << "ms to render";
+    }
   receiveData();
 }
 
-void Receiver::receiveData()
+grm_args_t *Receiver::waitForMessage()
 {
-  grm_args_t_wrapper args;
-  bool received_data = false;
+  grm_args_t *args = nullptr;
 
   /*
    * `gr_startlistener` opens and immediately closes a connection to test if `grplot` is running. Thus, we need to
    * repeat `grm_open` and `grm_recv` calls until a *real* data connection is established.
    */
-  while (!received_data)
+  while (args == nullptr)
     {
       if (grm_receiver_handle_ == nullptr)
         {
@@ -61,17 +158,77 @@ void Receiver::receiveData()
             }
         }
 
-      args.set_wrapper(grm_recv(grm_receiver_handle_, nullptr));
-      if (args.get_wrapper() != nullptr)
+      args = grm_recv(grm_receiver_handle_, nullptr);
+      if (args == nullptr)
+        {
+          grm_close(grm_receiver_handle_);
+          grm_receiver_handle_ = nullptr;
+        }
+    }
+
+  return args;
+}
+
+void Receiver::addMessage(grm_args_t *args)
+{
+  QMutexLocker locker(&messages_mutex_);
+  Message message = {args, true, -1, 0, 0};
+  int append;
+
+  ++received_count_;
+  /* appended data and requests must not be dropped */
+  if (grm_args_contains(args, "request") || (grm_args_values(args, "append", "i", &append) && append))
+    {
+      message.can_be_merged = false;
+    }
+  else
+    {
+      getMessageIds(args, &message.plot_id, &message.subplot_id, &message.series_id);
+      /*
+       * Only the last pending message can be replaced since the order of the merges decides which plot is rendered.
+       * Messages without a plot id could add a new plot each (`append_plots`), so they are never replaced.
+       */
+      if (!messages_.empty())
         {
-          received_data = true;
+          Message &pending_message = messages_.back();
+          if (pending_message.can_be_merged && message.plot_id > 0 && pending_message.plot_id == message.plot_id &&
+              pending_message.subplot_id == message.subplot_id && pending_message.series_id == message.series_id &&
+              replacesMessage(args, pending_message.args))
+            {
+              grm_args_delete(pending_message.args);
+              pending_message.args = args;
+              ++merged_count_;
+              return;
+            }
         }
-      else
+    }
+  messages_.push_back(message);
+}
+
+void Receiver::receiveData()
+{
+  received_count_ = 0;
+  merged_count_ = 0;
+  addMessage(waitForMessage());
+
+  /* messages arriving until the next frame is due are merged with the pending ones */
+  if (frame_timer_.isValid() && frame_timer_.elapsed() < min_frame_interval_ms_)
+    {
+      QThread::msleep(min_frame_interval_ms_ - frame_timer_.elapsed());
+    }
+  while (received_count_ < MAX_MESSAGES_PER_FRAME && grm_recv_pending(grm_receiver_handle_))
+    {
+      grm_args_t *args = grm_recv(grm_receiver_handle_, nullptr);
+      if (args == nullptr)
         {
           grm_close(grm_receiver_handle_);
           grm_receiver_handle_ = nullptr;
+          break;
         }
+      addMessage(args);
     }
 
-  emit resultReady(args);
+  ++frame_count_;
+  frame_timer_.start();
+  emit resultReady();
 }
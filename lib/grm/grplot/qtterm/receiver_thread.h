@@ -2,11 +2,23 @@
 #define RECEIVER_THREAD_H_INCLUDED
 
 #include "grm.h"
-#include "grm_args_t_wrapper.h"
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QThread>
 #include <QDebug>
+#include <vector>
 
 
+/*
+ * Receives messages on a separate thread. When a message has arrived, all further messages which are already pending
+ * are received, too, and are applied before the next frame is rendered. A message which sets all keys of the previous
+ * unprocessed message for the same plot, subplot and series replaces it. So, if a sender is faster than grplot can
+ * render, its messages are not processed one frame at a time and repeated updates of a plot are only merged once.
+ *
+ * Environment variables:
+ * - `GRPLOT_MAX_FPS`: maximum number of frames per second (default: 60, `0` disables the limit)
+ * - `GRPLOT_RECEIVER_STATS`: log the number of merged messages and the render time of each frame
+ */
 class Receiver : public QObject
 {
   Q_OBJECT
@@ -15,17 +27,38 @@ public:
   Receiver();
   virtual ~Receiver();
   void start();
+  std::vector<grm_args_t *> takeMessages();
 
 signals:
-  void resultReady(grm_args_t_wrapper args);
+  void resultReady();
 
 private slots:
   void receiveData();
   void dataProcessed();
 
 private:
+  struct Message
+  {
+    grm_args_t *args;
+    bool can_be_merged;
+    int plot_id;
+    int subplot_id;
+    int series_id;
+  };
+
+  grm_args_t *waitForMessage();
+  void addMessage(grm_args_t *args);
+
   QThread thread_;
   void *grm_receiver_handle_ = nullptr;
+  QMutex messages_mutex_;
+  std::vector<Message> messages_;
+  int min_frame_interval_ms_ = 0;
+  bool log_stats_ = false;
+  QElapsedTimer frame_timer_;
+  unsigned long frame_count_ = 0;
+  unsigned int received_count_ = 0;
+  unsigned int merged_count_ = 0;
 };
 
 #endif /* ifndef RECEIVER_THREAD_H_INCLUDED */
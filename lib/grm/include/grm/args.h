@@ -40,6 +40,12 @@ typedef struct _grm_args_t grm_args_t;
 
 typedef grm_args_t *grm_args_ptr_t;
 
+typedef enum
+{
+  GRM_ARGS_TAKE_OWNERSHIP,
+  GRM_ARGS_BORROW
+} grm_args_ownership_t;
+
 /* ------------------------- argument iterator ---------------------------------------------------------------------- */
 
 struct _args_iterator_private_t;
@@ -82,6 +88,8 @@ EXPORT void grm_args_delete(grm_args_t *args);
 EXPORT int grm_args_push(grm_args_t *args, const char *key, const char *value_format, ...);
 EXPORT int grm_args_push_buf(grm_args_t *args, const char *key, const char *value_format, const void *buffer,
                              int apply_padding);
+EXPORT int grm_args_push_buf_nocopy(grm_args_t *args, const char *key, const char *value_format, const void *buffer,
+                                    int apply_padding, grm_args_ownership_t ownership);
 
 EXPORT int grm_args_contains(const grm_args_t *args, const char *keyword);
 
@@ -95,6 +103,7 @@ EXPORT void grm_args_clear(grm_args_t *args);
 EXPORT void grm_args_remove(grm_args_t *args, const char *key);
 
 EXPORT grm_args_iterator_t *grm_args_iter(const grm_args_t *args);
+EXPORT void grm_args_iter_delete(grm_args_iterator_t *args_iterator);
 
 
 /* ------------------------- utilities ------------------------------------------------------------------------------ */
@@ -15,6 +15,9 @@ public:
   void draw();
   int zIndex;
   int insertionIndex; /* used to order drawables with the same zIndex in the order of insertion */
+  int segment = 0;         /* GKS segment holding the recorded output of this drawable or 0 if it is not recorded */
+  int segmentPosition = 0; /* position of this drawable among the drawables recorded in the segment */
+  int segmentLength = 0;   /* number of drawables recorded in the segment */
   int getGrContextId() const;
   const std::shared_ptr<GRM::Element> &getElement() const;
 
@@ -2,6 +2,7 @@
 #define GR_MANAGEGRCONTEXTIDS_HXX
 
 #include <queue>
+#include <set>
 
 class ManageGRContextIds
 {
@@ -10,6 +11,7 @@ public:
   int getUnusedGRContextId();
   void markIdAsUnused(int id);
   void markAllIdsAsUnused();
+  void markAllIdsAsUnused(const std::set<int> &retained_ids);
 
 private:
   std::queue<int> available_gr_context_ids = {};
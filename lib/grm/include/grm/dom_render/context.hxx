@@ -1,8 +1,11 @@
 #ifndef CONTEXT_HXX
 #define CONTEXT_HXX
 
+#include <atomic>
+#include <cstddef>
 #include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 #include <iostream>
 #include <string>
@@ -16,6 +19,47 @@
 namespace GRM
 {
 
+template <class T> class Span
+{
+  /*!
+   * A non-owning view of a contiguous array, similar to C++20's std::span.
+   *
+   * Spans are used to read the data stored in a GRM::Context without copying it:
+   * >>> auto x = GRM::get_span<double>(c["x"]);
+   *
+   * A span is invalidated when the data stored under its key is replaced or deleted.
+   */
+
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = std::size_t;
+  using iterator = T *;
+
+  Span() noexcept : data_(nullptr), size_(0) {}
+  Span(T *data, size_type size) noexcept : data_(data), size_(size) {}
+  Span(std::vector<value_type> &vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+  template <class U = T, class = std::enable_if_t<std::is_const_v<U>>>
+  Span(const std::vector<value_type> &vec) noexcept : data_(vec.data()), size_(vec.size())
+  {
+  }
+
+  T *data() const noexcept { return data_; }
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  T &operator[](size_type i) const { return data_[i]; }
+  T &front() const { return data_[0]; }
+  T &back() const { return data_[size_ - 1]; }
+  Span subspan(size_type offset) const noexcept { return Span(data_ + offset, size_ - offset); }
+
+  iterator begin() const noexcept { return data_; }
+  iterator end() const noexcept { return data_ + size_; }
+
+private:
+  T *data_;
+  size_type size_;
+};
 
 class EXPORT Context
 {
@@ -47,6 +91,7 @@ public:
     Context *context;
     std::string key;
     void increment_key(const std::string &);
+    void loadDeferred() const;
 
   public:
     Inner(Context &context, std::string key);
@@ -74,6 +119,8 @@ public:
     explicit operator std::vector<std::string> *();
     explicit operator const std::vector<std::string> *() const;
 
+    Span<const double> doubleSpan() const;
+
     bool intUsed();
     bool doubleUsed();
     bool stringUsed();
@@ -82,8 +129,27 @@ public:
     void decrement_key(const std::string &);
   };
 
+  /*!
+   * A source of context entries which are only decoded when they are accessed for the first time, e.g. the serialized
+   * context of a loaded graphics tree.
+   */
+  class EXPORT DeferredEntries
+  {
+  public:
+    virtual ~DeferredEntries() = default;
+
+    /*!
+     * Decode the entry `key` and store it in `context`. Entries are decoded while the graphics tree is rendered, so
+     * this function must not throw; an entry which cannot be decoded is left out of the context.
+     */
+    virtual void load(Context &context, const std::string &key) noexcept = 0;
+  };
+
   Context();
 
+  void deferEntries(const std::vector<std::string> &keys, const std::shared_ptr<DeferredEntries> &entries);
+  void loadDeferredEntries();
+
   Inner operator[](const std::string &str);
   const Inner operator[](const std::string &str) const;
 
@@ -136,12 +202,31 @@ public:
   Iterator begin();
   Iterator end();
 
+  std::size_t getModificationCount() const;
+  void appendDoubles(const std::string &key, const double *values, std::size_t count, std::size_t max_length = 0);
+
+  static std::size_t bytesCopied();
+  static void resetBytesCopied();
+  static void countCopiedBytes(std::size_t bytes);
+
 private:
   friend class Inner;
+  void loadDeferredEntry(const std::string &key);
+  void dropWindowValues(const std::string &key);
+  void dropAllWindowValues();
+  const std::vector<double> &windowDoubles(const std::string &key);
+
+  static std::atomic<std::size_t> bytes_copied;
   std::map<std::string, std::vector<double>> tableDouble;
   std::map<std::string, std::vector<int>> tableInt;
   std::map<std::string, std::vector<std::string>> tableString;
   std::map<std::string, int> referenceNumberOfKeys;
+  std::map<std::string, std::shared_ptr<DeferredEntries>> deferredEntries;
+  /* number of values at the front of a double vector which were pushed out of a rolling window by `appendDoubles` */
+  std::map<std::string, std::size_t> windowOffsets;
+  /* copies of the kept values of rolling windows which were requested as a whole through a const accessor */
+  std::map<std::string, std::vector<double>> windowCopies;
+  std::size_t modificationCount = 0;
 };
 
 bool operator==(const Context::Iterator &a, const Context::Iterator &b);
@@ -307,6 +392,51 @@ template <class T> static const T *get_if(const Context::Inner &data)
     }
 }
 
+template <class T> static Span<const T> get_span(const Context::Inner &data)
+{
+  /*!
+   * The GRM::get_span function is used to read the data of a GRM::Context::Inner object without copying it
+   * Uses GRM::Context::Inner custom conversions
+   *
+   * \param[in] data const GRM::Context::Inner
+   * \returns a read-only view of the stored std::vector<T>
+   */
+  if constexpr (std::is_same_v<T, double>)
+    {
+      return data.doubleSpan();
+    }
+  else
+    {
+      return Span<const T>(static_cast<const std::vector<T> &>(data));
+    }
+}
+
+template <class T> static std::vector<T> get_copy(const Context::Inner &data)
+{
+  /*!
+   * The GRM::get_copy function is used to get a modifiable copy of the data of a GRM::Context::Inner object. The copied
+   * bytes are added to GRM::Context::bytesCopied, so copies in performance critical code paths can be detected.
+   *
+   * \param[in] data const GRM::Context::Inner
+   * \returns a copy of the stored std::vector<T>
+   */
+  const auto &vec = static_cast<const std::vector<T> &>(data);
+  Context::countCopiedBytes(vec.size() * sizeof(T));
+  return vec;
+}
+
+template <class T> static std::vector<T> get_copy(Span<const T> data)
+{
+  /*!
+   * Overload of GRM::get_copy for data that has already been read with GRM::get_span
+   *
+   * \param[in] data read-only view of context data
+   * \returns a copy of the viewed elements
+   */
+  Context::countCopiedBytes(data.size() * sizeof(T));
+  return std::vector<T>(data.begin(), data.end());
+}
+
 } // namespace GRM
 
 #endif
@@ -0,0 +1,68 @@
+#ifndef GRM_GRAPHICS_TREE_INTERFACE_ATTRIBUTE_KEY_HXX
+#define GRM_GRAPHICS_TREE_INTERFACE_ATTRIBUTE_KEY_HXX
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <grm/util.h>
+
+namespace GRM
+{
+/*!
+ * An interned attribute name. All attribute names are stored once in a global atom table, so keys can be compared and
+ * hashed as integers. Keys for names which are used in hot paths should be created once and be reused.
+ */
+class EXPORT AttributeKey
+{
+public:
+  explicit AttributeKey(const std::string &name);
+
+  explicit AttributeKey(const char *name);
+
+  /*!
+   * Look up a name without adding it to the atom table.
+   *
+   * \param[in] name The attribute name
+   * \returns The key of `name` if it has been interned before
+   */
+  static std::optional<AttributeKey> find(const std::string &name);
+
+  /*! The number of different attribute names which have been interned so far */
+  static std::size_t count();
+
+  const std::string &name() const;
+
+  unsigned int id() const
+  {
+    return m_id;
+  }
+
+  bool operator==(const AttributeKey &other) const
+  {
+    return m_id == other.m_id;
+  }
+
+  bool operator!=(const AttributeKey &other) const
+  {
+    return m_id != other.m_id;
+  }
+
+private:
+  explicit AttributeKey(unsigned int id) : m_id(id) {}
+
+  unsigned int m_id;
+};
+} // namespace GRM
+
+namespace std
+{
+template <> struct hash<GRM::AttributeKey>
+{
+  std::size_t operator()(const GRM::AttributeKey &key) const noexcept
+  {
+    return key.id();
+  }
+};
+} // namespace std
+
+#endif
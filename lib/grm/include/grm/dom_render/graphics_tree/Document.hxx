@@ -3,7 +3,10 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include <grm/dom_render/graphics_tree/AttributeKey.hxx>
 #include <grm/dom_render/graphics_tree/Node.hxx>
 #include <grm/dom_render/graphics_tree/Value.hxx>
 #include <grm/util.h>
@@ -83,6 +86,16 @@ public:
   std::vector<std::shared_ptr<const Element>> querySelectorsAll(const std::string &selectors) const;
   std::shared_ptr<Element> querySelectors(const std::string &selectors);
   std::shared_ptr<const Element> querySelectors(const std::string &selectors) const;
+  std::vector<std::shared_ptr<Element>> querySelectorsAll(const std::shared_ptr<Selector> &selector);
+  std::vector<std::shared_ptr<const Element>> querySelectorsAll(const std::shared_ptr<Selector> &selector) const;
+  std::shared_ptr<Element> querySelectors(const std::shared_ptr<Selector> &selector);
+  std::shared_ptr<const Element> querySelectors(const std::shared_ptr<Selector> &selector) const;
+
+  // Index of the elements owned by this document, connected or not (not part of the DOM interface)
+
+  std::size_t elementCountByTagName(const std::string &localName) const;
+
+  std::size_t elementCountByAttribute(const AttributeKey &key) const;
 
   // virtual functions
   std::string nodeName() const override;
@@ -101,9 +114,19 @@ protected:
   Document();
 
 private:
+  friend class Element;
+  friend class Node;
+
   std::shared_ptr<Node> cloneIndividualNode() override;
 
   std::shared_ptr<Document> shared();
+
+  void indexElement(const Element &element, bool add);
+
+  void indexAttribute(const AttributeKey &key, bool add);
+
+  std::unordered_map<std::string, std::size_t> m_tag_name_counts;
+  std::vector<std::size_t> m_attribute_counts;
 };
 
 EXPORT std::shared_ptr<Document> createDocument();
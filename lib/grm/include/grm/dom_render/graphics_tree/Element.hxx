@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include <grm/dom_render/graphics_tree/AttributeKey.hxx>
 #include <grm/dom_render/graphics_tree/Node.hxx>
 #include <grm/dom_render/graphics_tree/Value.hxx>
 #include <grm/util.h>
@@ -15,8 +16,13 @@ class Document;
 class EXPORT Element : public Node
 {
 public:
+  ~Element() override;
+
   // Element interface
-  std::string localName() const;
+  const std::string &localName() const;
+
+  /*! The local name interned into the attribute key table, so element types can be compared as integers */
+  unsigned int localNameId() const;
 
   std::string tagName() const;
 
@@ -26,10 +32,16 @@ public:
 
   std::unordered_set<std::string> getAttributeNames() const;
 
+  std::vector<AttributeKey> getAttributeKeys() const;
+
   Value getAttribute(const std::string &qualifiedName) const;
 
+  Value getAttribute(const AttributeKey &key) const;
+
   void setAttribute(const std::string &qualifiedName, const Value &value);
 
+  void setAttribute(const AttributeKey &key, const Value &value);
+
   void setAttribute(const std::string &qualifiedName, const std::string &value);
 
   void setAttribute(const std::string &qualifiedName, const double &value);
@@ -38,12 +50,16 @@ public:
 
   void removeAttribute(const std::string &qualifiedName);
 
+  void removeAttribute(const AttributeKey &key);
+
   bool toggleAttribute(const std::string &qualifiedName);
 
   bool toggleAttribute(const std::string &qualifiedName, bool force);
 
   bool hasAttribute(const std::string &qualifiedName) const;
 
+  bool hasAttribute(const AttributeKey &key) const;
+
   std::vector<std::shared_ptr<Element>> getElementsByTagName(const std::string &qualifiedName);
 
   std::vector<std::shared_ptr<const Element>> getElementsByTagName(const std::string &qualifiedName) const;
@@ -66,6 +82,13 @@ public:
 
   std::vector<std::shared_ptr<const Element>> children() const;
 
+  /*! Fill a caller provided buffer with the child elements, so the buffer can be reused for several elements */
+  void children(std::vector<std::shared_ptr<Element>> &child_elements);
+
+  ChildElementRange childElements();
+
+  ConstChildElementRange childElements() const;
+
   std::shared_ptr<Element> firstChildElement();
 
   std::shared_ptr<const Element> firstChildElement() const;
@@ -101,6 +124,10 @@ public:
   std::vector<std::shared_ptr<const Element>> querySelectorsAll(const std::string &selectors) const;
   std::shared_ptr<Element> querySelectors(const std::string &selectors);
   std::shared_ptr<const Element> querySelectors(const std::string &selectors) const;
+  std::vector<std::shared_ptr<Element>> querySelectorsAll(const std::shared_ptr<Selector> &selector);
+  std::vector<std::shared_ptr<const Element>> querySelectorsAll(const std::shared_ptr<Selector> &selector) const;
+  std::shared_ptr<Element> querySelectors(const std::shared_ptr<Selector> &selector);
+  std::shared_ptr<const Element> querySelectors(const std::shared_ptr<Selector> &selector) const;
 
   // NonDocumentTypeChildNode interface
 
@@ -128,8 +155,12 @@ private:
 
   std::shared_ptr<const Element> shared() const;
 
+  const Value *findAttribute(const AttributeKey &key) const;
+
   std::string m_local_name;
-  std::unordered_map<std::string, Value> m_attributes;
+  AttributeKey m_local_name_key;
+  /* elements only have a few attributes, so a linear search over interned keys is faster than hashing the names */
+  std::vector<std::pair<AttributeKey, Value>> m_attributes;
 
   std::shared_ptr<Node> cloneIndividualNode() override;
 };
@@ -1,6 +1,8 @@
 #ifndef GRM_GRAPHICS_TREE_INTERFACE_NODE_HXX
 #define GRM_GRAPHICS_TREE_INTERFACE_NODE_HXX
 
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <list>
 #include <vector>
@@ -25,6 +27,93 @@ public:
     DOCUMENT_NODE = 9
   };
 
+  /*!
+   * Iterator over the element children of a node. It walks the child list of the node in place, so neither a vector
+   * nor copies of the child pointers are created. Children must not be added to or removed from the node while it is
+   * being iterated.
+   */
+  template <typename T, typename ListIterator> class ElementIterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    ElementIterator(ListIterator it, ListIterator end) : m_it(it), m_end(end)
+    {
+      skipNonElements();
+    }
+
+    reference operator*() const
+    {
+      return static_cast<reference>(**m_it);
+    }
+
+    pointer operator->() const
+    {
+      return &**this;
+    }
+
+    ElementIterator &operator++()
+    {
+      ++m_it;
+      skipNonElements();
+      return *this;
+    }
+
+    ElementIterator operator++(int)
+    {
+      auto previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const ElementIterator &other) const
+    {
+      return m_it == other.m_it;
+    }
+
+    bool operator!=(const ElementIterator &other) const
+    {
+      return m_it != other.m_it;
+    }
+
+  private:
+    void skipNonElements()
+    {
+      while (m_it != m_end && (*m_it)->nodeType() != Type::ELEMENT_NODE) ++m_it;
+    }
+
+    ListIterator m_it;
+    ListIterator m_end;
+  };
+
+  template <typename Iterator> class ElementRange
+  {
+  public:
+    ElementRange(Iterator begin, Iterator end) : m_begin(begin), m_end(end) {}
+
+    Iterator begin() const
+    {
+      return m_begin;
+    }
+
+    Iterator end() const
+    {
+      return m_end;
+    }
+
+  private:
+    Iterator m_begin;
+    Iterator m_end;
+  };
+
+  using ChildElementRange = ElementRange<ElementIterator<Element, std::list<std::shared_ptr<Node>>::const_iterator>>;
+  using ConstChildElementRange =
+      ElementRange<ElementIterator<const Element, std::list<std::shared_ptr<Node>>::const_iterator>>;
+
   virtual ~Node() = default;
 
   Type nodeType() const;
@@ -89,6 +178,16 @@ public:
 
   std::shared_ptr<Node> removeChild(std::shared_ptr<Node> child);
 
+  // Dirty tracking used by the renderer to skip unchanged subtrees (not part of the DOM interface)
+
+  bool isDirty() const;
+
+  bool isModified() const;
+
+  void markDirty();
+
+  void clearDirty();
+
 protected:
   Node(Type type, const std::shared_ptr<Document> &owner_document);
 
@@ -101,6 +200,12 @@ protected:
 
   std::vector<std::shared_ptr<const Element>> children_impl() const;
 
+  void children_impl(std::vector<std::shared_ptr<Element>> &child_elements);
+
+  ChildElementRange childElements_impl();
+
+  ConstChildElementRange childElements_impl() const;
+
   std::shared_ptr<Element> firstChildElement_impl();
 
   std::shared_ptr<const Element> firstChildElement_impl() const;
@@ -117,12 +222,15 @@ protected:
 
   void replaceChildren_impl(const std::vector<std::shared_ptr<Node>> &nodes);
 
+  /* `max_matches` is an upper bound for the number of matching elements, the traversal stops once it is reached */
   void querySelectorsAll_impl(const std::shared_ptr<GRM::Selector> &selector,
                               std::vector<std::shared_ptr<GRM::Element>> &found_elements,
-                              std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map);
+                              std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map,
+                              std::size_t &max_matches);
   void querySelectorsAll_impl(const std::shared_ptr<GRM::Selector> &selector,
                               std::vector<std::shared_ptr<const GRM::Element>> &found_elements,
-                              std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const;
+                              std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map,
+                              std::size_t &max_matches) const;
   std::shared_ptr<Element>
   querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map);
@@ -161,6 +269,8 @@ private:
   std::weak_ptr<Document> m_owner_document;
   std::weak_ptr<Node> m_parent_node;
   std::list<std::shared_ptr<Node>> m_child_nodes;
+  bool m_dirty = true;
+  bool m_modified = true;
 };
 } // namespace GRM
 
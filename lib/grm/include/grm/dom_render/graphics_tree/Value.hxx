@@ -25,6 +25,16 @@ public:
 
   explicit Value(std::string value);
 
+  Value(const Value &other);
+
+  Value(Value &&other) noexcept;
+
+  ~Value();
+
+  Value &operator=(const Value &other);
+
+  Value &operator=(Value &&other) noexcept;
+
   bool isType(Type type) const;
 
   bool isUndefined() const;
@@ -48,10 +58,30 @@ public:
   bool operator!=(const Value &other) const;
 
 private:
+  /* strings up to this length are stored inside the value without an allocation */
+  static constexpr std::size_t small_string_capacity = 14;
+
+  const char *stringData() const;
+
+  std::size_t stringSize() const;
+
+  void assignString(const char *data, std::size_t size);
+
+  void release();
+
   Type m_type;
-  int m_int_value;
-  double m_double_value;
-  std::string m_string_value;
+  bool m_small_string;
+  union
+  {
+    int m_int_value;
+    double m_double_value;
+    struct
+    {
+      char *data;
+      std::size_t size;
+    } m_heap_string;
+    char m_small_string_value[small_string_capacity + 2];
+  };
 };
 } // namespace GRM
 
@@ -1,6 +1,7 @@
 #ifndef GRM_GRAPHICS_TREE_INTERFACE_UTIL_HXX
 #define GRM_GRAPHICS_TREE_INTERFACE_UTIL_HXX
 
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <memory>
@@ -38,21 +39,37 @@ EXPORT std::string toupper(std::string string);
 EXPORT std::vector<std::string> split(const std::string &string, const std::string &token);
 EXPORT std::string strip(const std::string &string);
 
-EXPORT void normalize_vec(std::vector<double> x, std::vector<double> *normalized_x);
-EXPORT void normalize_vec_int(std::vector<double> x, std::vector<unsigned int> *normalized_x, unsigned int sum);
+EXPORT void normalize_vec(const std::vector<double> &x, std::vector<double> *normalized_x);
+EXPORT void normalize_vec_int(const std::vector<double> &x, std::vector<unsigned int> *normalized_x, unsigned int sum);
 
 class EXPORT Selector
 {
 public:
+  virtual ~Selector() = default;
+
   bool matchElement(const GRM::Element &element,
                     std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const;
 
+  /*!
+   * An upper bound for the number of elements of `document` which can match this selector, taken from the tag name and
+   * attribute index of the document. Queries use it to return early.
+   */
+  virtual std::size_t maxMatches(const GRM::Document &document) const;
+
+  /*! Simple selectors are cheaper to evaluate again than to look up in the match map */
+  virtual bool isMemoized() const;
+
 protected:
   virtual bool
   doMatchElement(const GRM::Element &element,
                  std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const = 0;
 };
 EXPORT std::shared_ptr<GRM::Selector> parseSelectors(const std::string &selectors);
+/*!
+ * Like `parseSelectors` but the parsed selectors are cached, so repeated queries with the same selector string only
+ * parse it once. Selector objects can also be kept by the caller and be passed to `querySelectors(All)` directly.
+ */
+EXPORT std::shared_ptr<GRM::Selector> compileSelectors(const std::string &selectors);
 
 // `overloaded` utility taken from <https://en.cppreference.com/w/cpp/utility/variant/visit>
 template <class... Ts> struct overloaded : Ts...
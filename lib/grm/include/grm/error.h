@@ -142,7 +142,11 @@ extern "C" {
   X(ERROR_LAYOUT_INVALID_ARGUMENT_RANGE, 59)          \
   X(ERROR_LAYOUT_COMPONENT_LENGTH_MISMATCH, 60)       \
   X(ERROR_TMP_DIR_CREATION, 61)                       \
-  Y(ERROR_NOT_IMPLEMENTED, 62)
+  X(ERROR_NOT_IMPLEMENTED, 62)                        \
+  X(ERROR_SNAPSHOT_IO, 63)                            \
+  X(ERROR_SNAPSHOT_INVALID_FORMAT, 64)                \
+  X(ERROR_SNAPSHOT_COMPRESSION, 65)                   \
+  Y(ERROR_IMPORT_INVALID_FORMAT, 66)
 
 #define ENUM_VALUE(name, value) name = value,
 #define ENUM_LAST_VALUE(name, value) name = value
@@ -35,4 +35,4 @@ EXPORT int grm_plot_from_file(int argc, char **argv);
 EXPORT int grm_context_data_from_file(const std::shared_ptr<GRM::Context> &context, const std::string &path,
                                       bool interpret_matrix_as_one_column = false);
 #endif
-#endif // GRM_IMPORT_H_INCLUDED
+#endif /* ifndef GRM_IMPORT_H_INCLUDED */
@@ -33,20 +33,21 @@ EXPORT void grm_finalize(void);
 EXPORT int grm_clear(void);
 EXPORT void grm_dump_graphics_tree(FILE *f);
 EXPORT char *grm_dump_graphics_tree_str(void);
+EXPORT int grm_dump_graphics_tree_snapshot(FILE *f, int compress);
 EXPORT unsigned int grm_max_plotid(void);
 EXPORT int grm_merge(const grm_args_t *args);
 EXPORT int grm_merge_extended(const grm_args_t *args, int hold, const char *identificator);
 EXPORT int grm_merge_hold(const grm_args_t *args);
 EXPORT int grm_merge_named(const grm_args_t *args, const char *identificator);
+EXPORT int grm_append(const grm_args_t *args);
 EXPORT int grm_plot(const grm_args_t *args);
 EXPORT int grm_render(void);
 EXPORT int grm_process_tree(void);
 EXPORT int grm_export(const char *file_path);
 EXPORT int grm_switch(unsigned int id);
 
-#if !defined(NO_XERCES_C)
 EXPORT int grm_load_graphics_tree(FILE *file);
-#endif
+EXPORT int grm_load_graphics_tree_trusted(FILE *file);
 EXPORT int grm_validate(void);
 
 #ifdef __cplusplus
@@ -679,6 +679,9 @@ arg_t *args_create_args(const char *key, const char *value_format, const void *b
       return NULL;
     }
   arg->priv->reference_count = 1;
+  arg->priv->owns_arrays = 1;
+  arg->priv->array_capacity = 0;
+  arg->priv->array_offset = 0;
 
   return arg;
 }
@@ -952,6 +955,10 @@ void args_decrease_arg_reference_count(args_node_t *args_node)
           /* use a char pointer since chars have no memory alignment restrictions */
           if (value_it->is_array)
             {
+              if (!args_node->arg->priv->owns_arrays)
+                {
+                  continue;
+                }
               if (argparse_format_to_delete_callback[(int)value_it->format] != NULL)
                 {
                   char **current_value_ptr = *(char ***)value_it->value_ptr;
@@ -963,7 +970,9 @@ void args_decrease_arg_reference_count(args_node_t *args_node)
                           (char **)((char *)current_value_ptr + argparse_format_to_size[(int)value_it->format]);
                     }
                 }
-              free(*(char ***)value_it->value_ptr);
+              /* values dropped from a rolling window are still part of the allocation */
+              free(*(char **)value_it->value_ptr -
+                   args_node->arg->priv->array_offset * argparse_format_to_size[tolower(value_it->format)]);
             }
           else if (argparse_format_to_delete_callback[(int)value_it->format] != NULL)
             {
@@ -1045,8 +1054,29 @@ err_t arg_increase_array(arg_t *arg, size_t increment)
   current_buffer_ptr = (void ***)(current_size_ptr + 1);
 
   new_size = *current_size_ptr + increment;
-  new_buffer = realloc(*current_buffer_ptr, sizeof(void *) * (new_size + (has_array_terminator ? 1 : 0)));
-  return_error_if(new_buffer == NULL, ERROR_MALLOC);
+  if (arg->priv->owns_arrays)
+    {
+      if (arg->priv->array_offset > 0)
+        {
+          /* move the array to the start of its allocation, so it can be resized */
+          size_t element_size = argparse_format_to_size[tolower(arg->value_format[1])];
+          char *allocation = (char *)*current_buffer_ptr - arg->priv->array_offset * element_size;
+          memmove(allocation, *current_buffer_ptr, *current_size_ptr * element_size);
+          *current_buffer_ptr = (void **)allocation;
+          arg->priv->array_offset = 0;
+        }
+      new_buffer = realloc(*current_buffer_ptr, sizeof(void *) * (new_size + (has_array_terminator ? 1 : 0)));
+      return_error_if(new_buffer == NULL, ERROR_MALLOC);
+    }
+  else
+    {
+      /* borrowed arrays must not be resized in place, so they are copied into a new buffer first */
+      new_buffer = malloc(sizeof(void *) * (new_size + (has_array_terminator ? 1 : 0)));
+      return_error_if(new_buffer == NULL, ERROR_MALLOC);
+      memcpy(new_buffer, *current_buffer_ptr, sizeof(void *) * *current_size_ptr);
+      arg->priv->owns_arrays = 1;
+    }
+  arg->priv->array_capacity = 0;
 
   if (has_array_terminator)
     {
@@ -1063,6 +1093,128 @@ err_t arg_increase_array(arg_t *arg, size_t increment)
   return ERROR_NONE;
 }
 
+static err_t arg_array_layout(arg_t *arg, size_t count, size_t max_length, size_t *element_size, size_t *offset,
+                              size_t *kept_count, size_t *capacity)
+{
+  /* Compute the layout of a one dimensional array after appending `count` values with `arg_append_array`: `offset` is
+   * the number of dropped elements in front of the `kept_count` values which stay visible. `capacity` is the number of
+   * elements which must be allocated, the kept values are moved to the front of the allocation if `offset` is reset to
+   * 0. */
+  size_t old_size, needed_capacity;
+
+  return_error_if(arg->value_format[0] != 'n', ERROR_ARGS_INCREASING_NON_ARRAY_VALUE);
+  return_error_if(strlen(arg->value_format) != 2, ERROR_ARGS_INCREASING_MULTI_DIMENSIONAL_ARRAY);
+  return_error_if(strchr("DIC", arg->value_format[1]) == NULL, ERROR_UNSUPPORTED_DATATYPE);
+  return_error_if(!arg->priv->owns_arrays || arg->priv->reference_count > 1, ERROR_UNSUPPORTED_OPERATION);
+
+  *element_size = argparse_format_to_size[tolower(arg->value_format[1])];
+  old_size = *(size_t *)arg->value_ptr;
+  *offset = arg->priv->array_offset;
+  *capacity = (arg->priv->array_capacity > 0) ? arg->priv->array_capacity : *offset + old_size;
+  *kept_count = old_size;
+  if (max_length > 0 && count >= max_length)
+    {
+      *offset += old_size;
+      *kept_count = 0;
+    }
+  else if (max_length > 0 && old_size + count > max_length)
+    {
+      *offset += old_size + count - max_length;
+      *kept_count = max_length - count;
+    }
+  if (max_length > 0 && count > max_length)
+    {
+      count = max_length;
+    }
+  needed_capacity = *offset + *kept_count + count;
+  if (needed_capacity > *capacity)
+    {
+      /* a rolling window keeps up to one window of dropped values in front of the visible values, so the kept values
+       * are only moved to the front once per window */
+      needed_capacity = next_or_equal_power2(needed_capacity);
+      if (max_length > 0 && needed_capacity > 2 * max_length)
+        {
+          needed_capacity = 2 * max_length;
+        }
+      if (needed_capacity > *capacity)
+        {
+          *capacity = needed_capacity;
+        }
+      if (*offset + *kept_count + count > *capacity)
+        {
+          *offset = 0;
+        }
+    }
+
+  return ERROR_NONE;
+}
+
+err_t arg_reserve_array(arg_t *arg, size_t count, size_t max_length)
+{
+  /* Allocate the memory which is needed to append `count` values with `arg_append_array` with the same `max_length`,
+   * so the following append cannot fail. The values of the array are not changed. */
+  size_t element_size, offset, kept_count, capacity;
+  char **current_buffer_ptr, *allocation;
+  err_t error;
+
+  if ((error = arg_array_layout(arg, count, max_length, &element_size, &offset, &kept_count, &capacity)) !=
+      ERROR_NONE)
+    {
+      return error;
+    }
+  current_buffer_ptr = (char **)((size_t *)arg->value_ptr + 1);
+  if (capacity == ((arg->priv->array_capacity > 0) ? arg->priv->array_capacity
+                                                     : arg->priv->array_offset + *(size_t *)arg->value_ptr))
+    {
+      return ERROR_NONE;
+    }
+  allocation = realloc(*current_buffer_ptr - arg->priv->array_offset * element_size, capacity * element_size);
+  return_error_if(allocation == NULL, ERROR_MALLOC);
+  *current_buffer_ptr = allocation + arg->priv->array_offset * element_size;
+  arg->priv->array_capacity = capacity;
+
+  return ERROR_NONE;
+}
+
+err_t arg_append_array(arg_t *arg, const void *values, size_t count, size_t max_length)
+{
+  /* Append `count` values to a one dimensional array of plain data (`nD`, `nI` or `nC`). The array grows by doubling its
+   * capacity, so appending is amortized constant per value. If `max_length` is greater than 0, the oldest values are
+   * dropped to keep at most `max_length` values. Dropped values stay in front of the array until they make room for a
+   * whole window, so the kept values are not moved on every append. The argument must be writable (see
+   * `args_at_writable`). */
+  size_t *current_size_ptr, element_size, offset, kept_count, capacity;
+  char **current_buffer_ptr, *allocation;
+  err_t error;
+
+  if ((error = arg_reserve_array(arg, count, max_length)) != ERROR_NONE)
+    {
+      return error;
+    }
+  arg_array_layout(arg, count, max_length, &element_size, &offset, &kept_count, &capacity);
+  current_size_ptr = (size_t *)arg->value_ptr;
+  current_buffer_ptr = (char **)(current_size_ptr + 1);
+  allocation = *current_buffer_ptr - arg->priv->array_offset * element_size;
+  if (max_length > 0 && count > max_length)
+    {
+      values = (const char *)values + (count - max_length) * element_size;
+      count = max_length;
+    }
+  if (offset != arg->priv->array_offset + *current_size_ptr - kept_count)
+    {
+      /* the allocation is too small to keep the dropped values, so the kept values are moved to the front */
+      memmove(allocation + offset * element_size,
+              *current_buffer_ptr + (*current_size_ptr - kept_count) * element_size, kept_count * element_size);
+    }
+  memcpy(allocation + (offset + kept_count) * element_size, values, count * element_size);
+  *current_buffer_ptr = allocation + offset * element_size;
+  *current_size_ptr = kept_count + count;
+  arg->priv->array_offset = offset;
+  arg->priv->array_capacity = capacity;
+
+  return ERROR_NONE;
+}
+
 int(arg_first_value)(const arg_t *arg, const char *first_value_format, void *first_value, unsigned int *array_length)
 {
   char *transformed_first_value_format = NULL;
@@ -1297,6 +1449,8 @@ void args_init(grm_args_t *args)
   args->kwargs_head = NULL;
   args->kwargs_tail = NULL;
   args->count = 0;
+  args->index = NULL;
+  args->index_capacity = 0;
 }
 
 void args_finalize(grm_args_t *args)
@@ -1321,26 +1475,13 @@ grm_args_t *args_flatcopy(const grm_args_t *copy_args)
   it = grm_args_iter(copy_args);
   while ((copy_arg = it->next(it)) != NULL)
     {
-      ++(copy_arg->priv->reference_count);
-      args_node = malloc(sizeof(args_node_t));
+      args_node = args_new_node(copy_arg);
       if (args_node == NULL)
         {
-          debug_print_malloc_error();
           goto error_cleanup;
         }
-      args_node->arg = copy_arg;
-      args_node->next = NULL;
-
-      if (args->kwargs_head == NULL)
-        {
-          args->kwargs_head = args_node;
-        }
-      else
-        {
-          args->kwargs_tail->next = args_node;
-        }
-      args->kwargs_tail = args_node;
-      ++(args->count);
+      ++(copy_arg->priv->reference_count);
+      args_append_node(args, args_node);
     }
   args_iterator_delete(it);
 
@@ -1432,26 +1573,13 @@ grm_args_t *args_copy_extended(const grm_args_t *copy_args, const char **keys_co
         }
       else
         {
-          ++(copy_arg->priv->reference_count);
-          args_node = malloc(sizeof(args_node_t));
+          args_node = args_new_node(copy_arg);
           if (args_node == NULL)
             {
-              debug_print_malloc_error();
               goto error_cleanup;
             }
-          args_node->arg = copy_arg;
-          args_node->next = NULL;
-
-          if (args->kwargs_head == NULL)
-            {
-              args->kwargs_head = args_node;
-            }
-          else
-            {
-              args->kwargs_tail->next = args_node;
-            }
-          args->kwargs_tail = args_node;
-          ++(args->count);
+          ++(copy_arg->priv->reference_count);
+          args_append_node(args, args_node);
         }
     }
   goto cleanup;
@@ -1494,43 +1622,94 @@ err_t args_push_common(grm_args_t *args, const char *key, const char *value_form
                        int apply_padding)
 {
   arg_t *arg;
-  args_node_t *args_node;
 
   if ((arg = args_create_args(key, value_format, buffer, vl, apply_padding)) == NULL)
     {
       return ERROR_MALLOC;
     }
 
-  if ((args_node = args_find_node(args, key)) != NULL)
+  return args_insert_new_arg(args, arg);
+}
+
+err_t args_push_arrays_nocopy(grm_args_t *args, const char *key, size_t array_count, const char *formats,
+                              const size_t *lengths, void *const *arrays, int owns_arrays)
+{
+  /* The arrays are handed over to the argument container without copying them. If `owns_arrays` is set, they must be
+   * allocated with `malloc` and string and argument container arrays need an additional `NULL` terminator. On failure,
+   * the ownership of the arrays stays with the caller. Otherwise, the arrays are only borrowed and must contain plain
+   * data (no strings or argument containers) which stays valid as long as the argument is referenced. */
+  arg_t *arg;
+  char *value_format;
+  void *value_ptr;
+  size_t i;
+  err_t error;
+
+  arg = malloc(sizeof(arg_t));
+  if (arg == NULL)
+    {
+      debug_print_malloc_error();
+      return ERROR_MALLOC;
+    }
+  arg->key = gks_strdup(key);
+  value_format = malloc(2 * array_count + 1);
+  arg->value_ptr = malloc(array_count * (sizeof(size_t) + sizeof(void *)));
+  arg->priv = malloc(sizeof(arg_private_t));
+  if (arg->key == NULL || value_format == NULL || arg->value_ptr == NULL || arg->priv == NULL)
+    {
+      debug_print_malloc_error();
+      free((char *)arg->key);
+      free(value_format);
+      free(arg->value_ptr);
+      free(arg->priv);
+      free(arg);
+      return ERROR_MALLOC;
+    }
+  for (i = 0; i < array_count; ++i)
+    {
+      /* the value buffer contains the length and data pointer of each array, like `argparse_read_params` creates it */
+      char *array_slot = (char *)arg->value_ptr + i * (sizeof(size_t) + sizeof(void *));
+      value_format[2 * i] = 'n';
+      value_format[2 * i + 1] = toupper(formats[i]);
+      memcpy(array_slot, &lengths[i], sizeof(size_t));
+      memcpy(array_slot + sizeof(size_t), &arrays[i], sizeof(void *));
+    }
+  value_format[2 * array_count] = '\0';
+  arg->value_format = value_format;
+  arg->priv->reference_count = 1;
+  arg->priv->owns_arrays = owns_arrays;
+  arg->priv->array_capacity = 0;
+  arg->priv->array_offset = 0;
+
+  value_ptr = arg->value_ptr;
+  if ((error = args_insert_new_arg(args, arg)) != ERROR_NONE)
+    {
+      /* `arg` itself is already freed at this point */
+      free(value_ptr);
+    }
+  return error;
+}
+
+err_t args_insert_new_arg(grm_args_t *args, arg_t *arg)
+{
+  args_node_t *args_node;
+
+  if ((args_node = args_find_node(args, arg->key)) != NULL)
     {
       args_decrease_arg_reference_count(args_node);
       args_node->arg = arg;
     }
   else
     {
-      args_node = malloc(sizeof(args_node_t));
+      args_node = args_new_node(arg);
       if (args_node == NULL)
         {
-          debug_print_malloc_error();
           free((char *)arg->key);
           free((char *)arg->value_format);
           free(arg->priv);
           free(arg);
           return ERROR_MALLOC;
         }
-      args_node->arg = arg;
-      args_node->next = NULL;
-      if (args->kwargs_head == NULL)
-        {
-          args->kwargs_head = args_node;
-          args->kwargs_tail = args_node;
-        }
-      else
-        {
-          args->kwargs_tail->next = args_node;
-          args->kwargs_tail = args_node;
-        }
-      ++(args->count);
+      args_append_node(args, args_node);
     }
 
   return ERROR_NONE;
@@ -1543,61 +1722,27 @@ err_t args_push_vl(grm_args_t *args, const char *key, const char *value_format,
 
 err_t args_push_arg(grm_args_t *args, arg_t *arg)
 {
-  args_node_t *args_node = NULL, *previous_node_by_keyword = NULL;
-  err_t error = ERROR_NONE;
-
-  ++(arg->priv->reference_count);
-  args_node = malloc(sizeof(args_node_t));
-  error_cleanup_and_set_error_if(args_node == NULL, ERROR_MALLOC);
-  args_node->arg = arg;
-  args_node->next = NULL;
+  args_node_t *args_node, *previous_node_by_keyword;
 
-  if (args->kwargs_head == NULL)
+  args_node = args_new_node(arg);
+  if (args_node == NULL)
     {
-      args->kwargs_head = args_node;
-      args->kwargs_tail = args_node;
-      ++(args->count);
+      return ERROR_MALLOC;
     }
-  else if (args_find_previous_node(args, arg->key, &previous_node_by_keyword))
+  ++(arg->priv->reference_count);
+  if ((previous_node_by_keyword = args_find_node(args, arg->key)) != NULL)
     {
-      if (previous_node_by_keyword == NULL)
-        {
-          args_node->next = args->kwargs_head->next;
-          if (args->kwargs_head == args->kwargs_tail)
-            {
-              args->kwargs_tail = args_node;
-            }
-          args_decrease_arg_reference_count(args->kwargs_head);
-          free(args->kwargs_head);
-          args->kwargs_head = args_node;
-        }
-      else
-        {
-          args_node->next = previous_node_by_keyword->next->next;
-          args_decrease_arg_reference_count(previous_node_by_keyword->next);
-          free(previous_node_by_keyword->next);
-          previous_node_by_keyword->next = args_node;
-          if (args_node->next == NULL)
-            {
-              args->kwargs_tail = args_node;
-            }
-        }
+      /* the new argument takes the position of the previous one */
+      args_replace_node(args, previous_node_by_keyword, args_node);
+      args_decrease_arg_reference_count(previous_node_by_keyword);
+      free(previous_node_by_keyword);
     }
   else
     {
-      args->kwargs_tail->next = args_node;
-      args->kwargs_tail = args_node;
-      ++(args->count);
+      args_append_node(args, args_node);
     }
 
   return ERROR_NONE;
-
-error_cleanup:
-  if (args_node != NULL)
-    {
-      free(args_node);
-    }
-  return error;
 }
 
 err_t args_update_many(grm_args_t *args, const grm_args_t *update_args)
@@ -1743,6 +1888,7 @@ void args_clear(grm_args_t *args, const char **exclude_keys)
             {
               last_excluded_node->next = current_node;
             }
+          current_node->prev = last_excluded_node;
           last_excluded_node = current_node;
         }
       else
@@ -1762,22 +1908,120 @@ void args_clear(grm_args_t *args, const char **exclude_keys)
     {
       args->kwargs_tail->next = NULL;
     }
+  args_index_rebuild(args);
 }
 
 err_t args_increase_array(grm_args_t *args, const char *key, size_t increment)
 {
   arg_t *arg;
 
-  arg = args_at(args, key);
+  arg = args_at_writable(args, key);
   return_error_if(arg == NULL, ERROR_ARGS_INVALID_KEY);
   return arg_increase_array(arg, increment);
 }
 
+arg_t *args_at_writable(grm_args_t *args, const char *keyword)
+{
+  /* Array values are shared between argument containers (see `args_copy` and `args_merge`) or borrowed from the
+   * caller, so they are treated as immutable. Before an array is modified, the argument is cloned if it is referenced
+   * more than once or does not own its arrays (copy-on-write). Arguments with argument containers cannot be cloned
+   * since the containers would be shared by both arguments. Returns `NULL` if the key does not exist or the value
+   * cannot be cloned. */
+  args_node_t *args_node;
+  arg_t *arg, *writable_arg;
+
+  if ((args_node = args_find_node(args, keyword)) == NULL)
+    {
+      return NULL;
+    }
+  arg = args_node->arg;
+  if (arg->priv->reference_count == 1 && arg->priv->owns_arrays)
+    {
+      return arg;
+    }
+  if (strchr(arg->value_format, 'a') != NULL || strchr(arg->value_format, 'A') != NULL)
+    {
+      return NULL;
+    }
+  /* the value buffer of an argument is laid out like a padded buffer for `grm_args_push_buf` */
+  if ((writable_arg = args_create_args(arg->key, arg->value_format, arg->value_ptr, NULL, 1)) == NULL)
+    {
+      return NULL;
+    }
+  args_decrease_arg_reference_count(args_node);
+  args_node->arg = writable_arg;
+
+  return writable_arg;
+}
+
 unsigned int args_count(const grm_args_t *args)
 {
   return args->count;
 }
 
+size_t args_estimate_serialized_size(const grm_args_t *args, int as_text)
+{
+  /*
+   * Estimates the number of bytes needed to serialize `args`, e.g. to reserve a memwriter buffer up front. Numbers are
+   * counted with their in-memory size (like in `argparse_calculate_needed_buffer_size`) for binary serializations and
+   * with `ARGS_TEXT_NUMBER_SIZE_ESTIMATE` characters for text serializations, strings with their length. Keys and
+   * formats are included as a small overhead per value. The iterators live on the stack, so no memory is allocated.
+   */
+  grm_args_iterator_t it;
+  args_iterator_private_t it_priv;
+  grm_args_value_iterator_t value_iterator;
+  args_value_iterator_private_t value_iterator_priv;
+  grm_args_value_iterator_t *value_it = &value_iterator;
+  arg_t *arg;
+  size_t estimated_size = 0;
+
+  argparse_init_static_variables();
+  it.priv = &it_priv;
+  args_iterator_init(&it, args->kwargs_head, NULL);
+  value_iterator.priv = &value_iterator_priv;
+  while ((arg = it.next(&it)) != NULL)
+    {
+      args_value_iterator_init(value_it, arg);
+      estimated_size += strlen(arg->key) + strlen(arg->value_format) + 8;
+      while (value_it->next(value_it) != NULL)
+        {
+          size_t length = value_it->array_length;
+          size_t i;
+          switch (value_it->format)
+            {
+            case 'i':
+            case 'd':
+              estimated_size += length * (as_text ? ARGS_TEXT_NUMBER_SIZE_ESTIMATE
+                                                  : argparse_format_to_size[(unsigned char)value_it->format]);
+              break;
+            case 's':
+              for (i = 0; i < length; ++i)
+                {
+                  const char *str = value_it->is_array ? (*(char ***)value_it->value_ptr)[i]
+                                                       : *(char **)value_it->value_ptr;
+                  estimated_size += (str != NULL) ? strlen(str) + 8 : 8;
+                }
+              break;
+            case 'a':
+              for (i = 0; i < length; ++i)
+                {
+                  const grm_args_t *nested_args = value_it->is_array ? (*(grm_args_t ***)value_it->value_ptr)[i]
+                                                                     : *(grm_args_t **)value_it->value_ptr;
+                  estimated_size += (nested_args != NULL) ? args_estimate_serialized_size(nested_args, as_text) : 8;
+                }
+              break;
+            default:
+              estimated_size += length;
+              break;
+            }
+        }
+      args_value_iterator_finalize(value_it);
+    }
+  args_iterator_finalize(&it);
+
+  return estimated_size;
+}
+
 arg_t *args_at(const grm_args_t *args, const char *keyword)
 {
   args_node_t *current_node;
@@ -1828,6 +2072,11 @@ args_node_t *args_find_node(const grm_args_t *args, const char *keyword)
 {
   args_node_t *current_node;
 
+  if (args->index != NULL)
+    {
+      /* the slot contains the node of `keyword` or is empty */
+      return args->index[args_index_slot(args, keyword, djb2_hash(keyword))];
+    }
   current_node = args->kwargs_head;
   while (current_node != NULL && strcmp(current_node->arg->key, keyword) != 0)
     {
@@ -1837,24 +2086,184 @@ args_node_t *args_find_node(const grm_args_t *args, const char *keyword)
   return current_node;
 }
 
-int args_find_previous_node(const grm_args_t *args, const char *keyword, args_node_t **previous_node)
+args_node_t *args_new_node(arg_t *arg)
 {
-  args_node_t *prev_node, *current_node;
+  args_node_t *args_node;
 
-  prev_node = NULL;
-  current_node = args->kwargs_head;
-  while (current_node != NULL && strcmp(current_node->arg->key, keyword) != 0)
+  args_node = malloc(sizeof(args_node_t));
+  if (args_node == NULL)
     {
-      prev_node = current_node;
-      current_node = current_node->next;
+      debug_print_malloc_error();
+      return NULL;
     }
+  args_node->arg = arg;
+  args_node->next = NULL;
+  args_node->prev = NULL;
+  args_node->key_hash = djb2_hash(arg->key);
 
-  if (current_node != NULL)
+  return args_node;
+}
+
+void args_append_node(grm_args_t *args, args_node_t *args_node)
+{
+  args_node->next = NULL;
+  args_node->prev = args->kwargs_tail;
+  if (args->kwargs_head == NULL)
+    {
+      args->kwargs_head = args_node;
+    }
+  else
     {
-      *previous_node = prev_node;
-      return 1;
+      args->kwargs_tail->next = args_node;
+    }
+  args->kwargs_tail = args_node;
+  ++(args->count);
+  args_index_insert(args, args_node);
+}
+
+void args_replace_node(grm_args_t *args, args_node_t *old_node, args_node_t *new_node)
+{
+  /* `new_node` must have the same key as `old_node` */
+  new_node->prev = old_node->prev;
+  new_node->next = old_node->next;
+  if (old_node->prev == NULL)
+    {
+      args->kwargs_head = new_node;
+    }
+  else
+    {
+      old_node->prev->next = new_node;
+    }
+  if (old_node->next == NULL)
+    {
+      args->kwargs_tail = new_node;
+    }
+  else
+    {
+      old_node->next->prev = new_node;
+    }
+  if (args->index != NULL)
+    {
+      args->index[args_index_node_slot(args, old_node)] = new_node;
+    }
+}
+
+void args_remove_node(grm_args_t *args, args_node_t *args_node)
+{
+  /* unlinks `args_node`, the caller is responsible for deleting it */
+  args_index_remove(args, args_node);
+  if (args_node->prev == NULL)
+    {
+      args->kwargs_head = args_node->next;
+    }
+  else
+    {
+      args_node->prev->next = args_node->next;
+    }
+  if (args_node->next == NULL)
+    {
+      args->kwargs_tail = args_node->prev;
+    }
+  else
+    {
+      args_node->next->prev = args_node->prev;
+    }
+  --(args->count);
+}
+
+size_t args_index_slot(const grm_args_t *args, const char *keyword, size_t key_hash)
+{
+  /* returns the slot of the node with `keyword` or the empty slot where it would be inserted */
+  size_t mask = args->index_capacity - 1, slot = key_hash & mask;
+
+  while (args->index[slot] != NULL &&
+         (args->index[slot]->key_hash != key_hash || strcmp(args->index[slot]->arg->key, keyword) != 0))
+    {
+      slot = (slot + 1) & mask;
+    }
+
+  return slot;
+}
+
+size_t args_index_node_slot(const grm_args_t *args, const args_node_t *args_node)
+{
+  /* `args_node` must be contained in the index, its key is not compared since its argument may be deleted already */
+  size_t mask = args->index_capacity - 1, slot = args_node->key_hash & mask;
+
+  while (args->index[slot] != args_node)
+    {
+      slot = (slot + 1) & mask;
+    }
+
+  return slot;
+}
+
+void args_index_rebuild(grm_args_t *args)
+{
+  args_node_t *current_node;
+  size_t capacity;
+
+  free(args->index);
+  args->index = NULL;
+  args->index_capacity = 0;
+  if (args->count <= ARGS_INDEX_MIN_COUNT)
+    {
+      return;
+    }
+  capacity = next_or_equal_power2(4 * (unsigned long)args->count);
+  args->index = calloc(capacity, sizeof(args_node_t *));
+  if (args->index == NULL)
+    {
+      /* not an error, keys are searched in the list instead */
+      debug_print_malloc_error();
+      return;
+    }
+  args->index_capacity = capacity;
+  for (current_node = args->kwargs_head; current_node != NULL; current_node = current_node->next)
+    {
+      args->index[args_index_slot(args, current_node->arg->key, current_node->key_hash)] = current_node;
+    }
+}
+
+void args_index_insert(grm_args_t *args, args_node_t *args_node)
+{
+  /* `args_node` must be appended to the list already */
+  if (args->index == NULL || 2 * (size_t)args->count > args->index_capacity)
+    {
+      /* the index is created when the container gets large enough and it is grown before it gets more than half full,
+       * in both cases all nodes of the list (including `args_node`) are inserted */
+      if (args->count > ARGS_INDEX_MIN_COUNT)
+        {
+          args_index_rebuild(args);
+        }
+      return;
+    }
+  args->index[args_index_slot(args, args_node->arg->key, args_node->key_hash)] = args_node;
+}
+
+void args_index_remove(grm_args_t *args, const args_node_t *args_node)
+{
+  size_t mask, slot, next_slot, home_slot;
+
+  if (args->index == NULL)
+    {
+      return;
+    }
+  /* Backward shift deletion: following nodes of the same probe sequence are moved into the gap, so no tombstones are
+   * needed. A node can be moved if the gap lies (cyclically) between its home slot and its current slot. */
+  mask = args->index_capacity - 1;
+  slot = args_index_node_slot(args, args_node);
+  args->index[slot] = NULL;
+  for (next_slot = (slot + 1) & mask; args->index[next_slot] != NULL; next_slot = (next_slot + 1) & mask)
+    {
+      home_slot = args->index[next_slot]->key_hash & mask;
+      if (((next_slot - home_slot) & mask) >= ((next_slot - slot) & mask))
+        {
+          args->index[slot] = args->index[next_slot];
+          args->index[next_slot] = NULL;
+          slot = next_slot;
+        }
     }
-  return 0;
 }
 
 grm_args_iterator_t *grm_args_iter(const grm_args_t *args)
@@ -1862,6 +2271,11 @@ grm_args_iterator_t *grm_args_iter(const grm_args_t *args)
   return args_iterator_new(args->kwargs_head, NULL);
 }
 
+void grm_args_iter_delete(grm_args_iterator_t *args_iterator)
+{
+  args_iterator_delete(args_iterator);
+}
+
 
 /* ------------------------- argument iterator ---------------------------------------------------------------------- */
 
@@ -2098,6 +2512,66 @@ int grm_args_push_buf(grm_args_t *args, const char *key, const char *value_forma
   return error == ERROR_NONE;
 }
 
+int grm_args_push_buf_nocopy(grm_args_t *args, const char *key, const char *value_format, const void *buffer,
+                             int apply_padding, grm_args_ownership_t ownership)
+{
+  /* Only one or more plain data arrays (`nD`, `nI` or `nC`) are supported, each given by its length (`size_t`) and a
+   * pointer to the data in `buffer`, like for `grm_args_push_buf`. */
+  size_t array_count, i, offset = 0;
+  size_t *lengths = NULL;
+  void **arrays = NULL;
+  char *formats = NULL;
+  err_t error = ERROR_NONE;
+
+  array_count = strlen(value_format) / 2;
+  if (array_count == 0 || strlen(value_format) % 2 != 0)
+    {
+      return 0;
+    }
+  for (i = 0; i < array_count; ++i)
+    {
+      if (value_format[2 * i] != 'n' || strchr("DIC", value_format[2 * i + 1]) == NULL)
+        {
+          return 0;
+        }
+    }
+  lengths = malloc(array_count * sizeof(size_t));
+  arrays = malloc(array_count * sizeof(void *));
+  formats = malloc(array_count + 1);
+  if (lengths == NULL || arrays == NULL || formats == NULL)
+    {
+      debug_print_malloc_error();
+      error = ERROR_MALLOC;
+      goto cleanup;
+    }
+  for (i = 0; i < array_count; ++i)
+    {
+      if (apply_padding)
+        {
+          offset += (sizeof(size_t) - offset % sizeof(size_t)) % sizeof(size_t);
+        }
+      memcpy(&lengths[i], (const char *)buffer + offset, sizeof(size_t));
+      offset += sizeof(size_t);
+      if (apply_padding)
+        {
+          offset += (sizeof(void *) - offset % sizeof(void *)) % sizeof(void *);
+        }
+      memcpy(&arrays[i], (const char *)buffer + offset, sizeof(void *));
+      offset += sizeof(void *);
+      formats[i] = value_format[2 * i + 1];
+    }
+  formats[array_count] = '\0';
+  error = args_push_arrays_nocopy(args, key, array_count, formats, lengths, arrays,
+                                  ownership == GRM_ARGS_TAKE_OWNERSHIP);
+
+cleanup:
+  free(lengths);
+  free(arrays);
+  free(formats);
+
+  return error == ERROR_NONE;
+}
+
 int grm_args_contains(const grm_args_t *args, const char *keyword)
 {
   return args_at(args, keyword) != NULL;
@@ -2110,33 +2584,13 @@ void grm_args_clear(grm_args_t *args)
 
 void grm_args_remove(grm_args_t *args, const char *key)
 {
-  args_node_t *tmp_node, *previous_node_by_keyword;
+  args_node_t *args_node;
 
-  if (args_find_previous_node(args, key, &previous_node_by_keyword))
+  if ((args_node = args_find_node(args, key)) != NULL)
     {
-      if (previous_node_by_keyword == NULL)
-        {
-          tmp_node = args->kwargs_head->next;
-          args_decrease_arg_reference_count(args->kwargs_head);
-          free(args->kwargs_head);
-          args->kwargs_head = tmp_node;
-          if (tmp_node == NULL)
-            {
-              args->kwargs_tail = NULL;
-            }
-        }
-      else
-        {
-          tmp_node = previous_node_by_keyword->next->next;
-          args_decrease_arg_reference_count(previous_node_by_keyword->next);
-          free(previous_node_by_keyword->next);
-          previous_node_by_keyword->next = tmp_node;
-          if (tmp_node == NULL)
-            {
-              args->kwargs_tail = previous_node_by_keyword;
-            }
-        }
-      --(args->count);
+      args_remove_node(args, args_node);
+      args_decrease_arg_reference_count(args_node);
+      free(args_node);
     }
 }
 
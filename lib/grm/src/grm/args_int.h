@@ -22,6 +22,16 @@ typedef SSIZE_T ssize_t;
 
 /* ######################### internal interface ##################################################################### */
 
+/* ========================= macros ================================================================================= */
+
+/* ------------------------- argument container --------------------------------------------------------------------- */
+
+/* containers with more entries than this get a hash index, a linear search is faster for fewer entries */
+#define ARGS_INDEX_MIN_COUNT 8
+/* estimated number of characters of a number in a text (JSON) serialization, see `args_estimate_serialized_size` */
+#define ARGS_TEXT_NUMBER_SIZE_ESTIMATE 20
+
+
 /* ========================= datatypes ============================================================================== */
 
 /* ------------------------- argument ------------------------------------------------------------------------------- */
@@ -29,6 +39,14 @@ typedef SSIZE_T ssize_t;
 struct _arg_private_t
 {
   unsigned int reference_count;
+  /* array buffers pushed with `GRM_ARGS_BORROW` belong to the caller and are never modified or freed */
+  int owns_arrays;
+  /* number of elements allocated for a single array value which grows with `arg_append_array`, 0 if the allocated
+   * size equals the array length */
+  size_t array_capacity;
+  /* number of elements in front of the array value which were dropped from a rolling window by `arg_append_array`,
+   * the allocation starts this many elements before the stored array pointer */
+  size_t array_offset;
 };
 
 
@@ -60,13 +78,22 @@ struct _args_node_t
 {
   arg_t *arg;
   struct _args_node_t *next;
+  struct _args_node_t *prev;
+  size_t key_hash;
 };
 
 struct _grm_args_t
 {
+  /* the list keeps the insertion order of all arguments */
   args_node_t *kwargs_head;
   args_node_t *kwargs_tail;
   unsigned int count;
+  /*
+   * Open addressing hash table (linear probing) of all list nodes, only present if `count` exceeds
+   * `ARGS_INDEX_MIN_COUNT`. It is kept at most half full. If it cannot be allocated, keys are searched in the list.
+   */
+  args_node_t **index;
+  size_t index_capacity;
 };
 
 /* ------------------------- argument iterator ---------------------------------------------------------------------- */
@@ -127,6 +154,8 @@ void *copy_value(char format, void *value_ptr);
 /* ------------------------- argument ------------------------------------------------------------------------------- */
 
 err_t arg_increase_array(arg_t *arg, size_t increment);
+err_t arg_reserve_array(arg_t *arg, size_t count, size_t max_length);
+err_t arg_append_array(arg_t *arg, const void *values, size_t count, size_t max_length);
 
 int arg_first_value(const arg_t *arg, const char *first_value_format, void *first_value, unsigned int *array_length);
 #define arg_first_value(arg, first_value_format, first_value, array_length) \
@@ -146,6 +175,9 @@ grm_args_t *args_copy_extended(const grm_args_t *copy_args, const char **keys_co
 err_t args_push_common(grm_args_t *args, const char *key, const char *value_format, const void *buffer, va_list *vl,
                        int apply_padding);
 err_t args_push_vl(grm_args_t *args, const char *key, const char *value_format, va_list *vl);
+err_t args_push_arrays_nocopy(grm_args_t *args, const char *key, size_t array_count, const char *formats,
+                              const size_t *lengths, void *const *arrays, int owns_arrays);
+err_t args_insert_new_arg(grm_args_t *args, arg_t *arg);
 err_t args_push_arg(grm_args_t *args, arg_t *arg);
 err_t args_update_many(grm_args_t *args, const grm_args_t *update_args) UNUSED;
 err_t args_merge(grm_args_t *args, const grm_args_t *merge_args, const char *const *merge_keys);
@@ -160,12 +192,24 @@ void args_clear(grm_args_t *args, const char **exclude_keys);
 
 err_t args_increase_array(grm_args_t *args, const char *key, size_t increment) UNUSED;
 
+arg_t *args_at_writable(grm_args_t *args, const char *keyword);
+
 unsigned int args_count(const grm_args_t *args) UNUSED;
+size_t args_estimate_serialized_size(const grm_args_t *args, int as_text);
 
 arg_t *args_at(const grm_args_t *args, const char *keyword);
 
 args_node_t *args_find_node(const grm_args_t *args, const char *keyword);
-int args_find_previous_node(const grm_args_t *args, const char *keyword, args_node_t **previous_node);
+args_node_t *args_new_node(arg_t *arg);
+void args_append_node(grm_args_t *args, args_node_t *args_node);
+void args_replace_node(grm_args_t *args, args_node_t *old_node, args_node_t *new_node);
+void args_remove_node(grm_args_t *args, args_node_t *args_node);
+
+size_t args_index_slot(const grm_args_t *args, const char *keyword, size_t key_hash);
+size_t args_index_node_slot(const grm_args_t *args, const args_node_t *args_node);
+void args_index_rebuild(grm_args_t *args);
+void args_index_insert(grm_args_t *args, args_node_t *args_node);
+void args_index_remove(grm_args_t *args, const args_node_t *args_node);
 
 
 /* ------------------------- argument iterator ---------------------------------------------------------------------- */
@@ -28,6 +28,16 @@
 #define DBL_DECIMAL_DIG 17
 #endif
 
+/* ------------------------- bson serializer ------------------------------------------------------------------------ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TOBSON_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define TOBSON_THREAD_LOCAL __declspec(thread)
+#else
+#define TOBSON_THREAD_LOCAL
+#endif
+
 
 /* ========================= static variables ======================================================================= */
 
@@ -41,7 +51,11 @@ static int frombson_static_variables_initialized = 0;
 
 static err_t (*tobson_datatype_to_func[128])(tobson_state_t *);
 static int tobson_static_variables_initialized = 0;
-static tobson_permanent_state_t tobson_permanent_state = {complete, 0, NULL};
+/*
+ * The state of incomplete messages and the recorded array references belong to the serialization in progress, so each
+ * thread gets its own state and messages can be serialized in several threads at once.
+ */
+static TOBSON_THREAD_LOCAL tobson_permanent_state_t tobson_permanent_state = {complete, 0, NULL, 0, NULL, 0, 0};
 static char tobson_datatype_to_byte[128];
 static char null = 0x00;
 
@@ -234,6 +248,12 @@ err_t frombson_read_length(frombson_state_t *state, int *length)
   return ERROR_NONE;
 }
 
+int frombson_remaining_object_bytes(const frombson_state_t *state)
+{
+  /* the number of bytes up to and including the null byte which terminates the current object */
+  return state->object_infos->length - (state->num_read_bytes - state->object_infos->num_bytes_read_before);
+}
+
 
 err_t frombson_read_double_value(frombson_state_t *state, double *d)
 {
@@ -546,6 +566,7 @@ cleanup:
 err_t frombson_parse_optimized_array(frombson_state_t *state)
 {
   int length, num_elements, elem_size;
+  size_t array_length;
   char value_type;
   char final_value_type[3] = "\0";
   frombson_array_infos_t array_infos;
@@ -563,6 +584,12 @@ err_t frombson_parse_optimized_array(frombson_state_t *state)
     {
       goto cleanup;
     }
+  /* the length includes the already read length field and must leave room for the end of the enclosing object */
+  if (length < 7 || length - (int)sizeof(int) >= frombson_remaining_object_bytes(state))
+    {
+      error = ERROR_PARSE_ARRAY;
+      goto cleanup;
+    }
 
   /* checking subtype */
   if (*state->cur_byte != (char)0x80)
@@ -587,12 +614,16 @@ err_t frombson_parse_optimized_array(frombson_state_t *state)
     case 'd':
       elem_size = 8;
       break;
+    default:
+      error = ERROR_UNSUPPORTED_DATATYPE;
+      goto cleanup;
     }
 
   state->cur_value_buf = malloc(length - 7); /* array length minus length, subtype, valuetype, null */
   if (state->cur_value_buf == NULL)
     {
       debug_print_malloc_error();
+      error = ERROR_MALLOC;
       goto cleanup;
     }
   memory_allocated = 1;
@@ -625,7 +656,13 @@ err_t frombson_parse_optimized_array(frombson_state_t *state)
       goto cleanup;
     }
 
-  grm_args_push(state->args, state->cur_key, final_value_type, num_elements, state->cur_value_buf);
+  /* the decoded values are handed over to the argument container, so they are only copied once */
+  array_length = num_elements;
+  if ((error = args_push_arrays_nocopy(state->args, state->cur_key, 1, final_value_type + 1, &array_length,
+                                       &state->cur_value_buf, 1)) == ERROR_NONE)
+    {
+      memory_allocated = 0;
+    }
 
 cleanup:
   if (memory_allocated)
@@ -661,6 +698,11 @@ err_t frombson_parse_object(frombson_state_t *state)
       return error;
     }
 
+  if (length < 5 || length - (int)sizeof(int) >= frombson_remaining_object_bytes(state))
+    {
+      grm_args_delete(new_args);
+      return ERROR_PARSE_OBJECT;
+    }
   object_infos.length = length;
   object_infos.num_bytes_read_before = num_bytes_read_before;
 
@@ -1075,6 +1117,57 @@ void frombson_init_static_variables(void)
 
 /* ------------------------- bson serializer ------------------------------------------------------------------------ */
 
+static err_t tobson_add_array_ref(memwriter_t *memwriter, const void *data, size_t size)
+{
+  tobson_array_ref_t *array_ref;
+
+  if (tobson_permanent_state.array_ref_count == tobson_permanent_state.array_ref_capacity)
+    {
+      size_t new_capacity =
+          (tobson_permanent_state.array_ref_capacity > 0) ? 2 * tobson_permanent_state.array_ref_capacity : 8;
+      tobson_array_ref_t *new_array_refs =
+          realloc(tobson_permanent_state.array_refs, new_capacity * sizeof(tobson_array_ref_t));
+      if (new_array_refs == NULL)
+        {
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
+        }
+      tobson_permanent_state.array_refs = new_array_refs;
+      tobson_permanent_state.array_ref_capacity = new_capacity;
+    }
+  array_ref = &tobson_permanent_state.array_refs[tobson_permanent_state.array_ref_count++];
+  array_ref->offset = memwriter_size(memwriter);
+  array_ref->data = data;
+  array_ref->size = size;
+
+  return ERROR_NONE;
+}
+
+static size_t tobson_array_ref_size_after(size_t offset)
+{
+  /* total size of all referenced arrays which belong behind `offset` */
+  size_t size = 0, i = tobson_permanent_state.array_ref_count;
+
+  while (i > 0 && tobson_permanent_state.array_refs[i - 1].offset > offset)
+    {
+      size += tobson_permanent_state.array_refs[--i].size;
+    }
+
+  return size;
+}
+
+static size_t tobson_array_ref_size_before(size_t offset)
+{
+  size_t size = 0, i;
+
+  for (i = 0; i < tobson_permanent_state.array_ref_count && tobson_permanent_state.array_refs[i].offset <= offset; ++i)
+    {
+      size += tobson_permanent_state.array_refs[i].size;
+    }
+
+  return size;
+}
+
 err_t tobson_int_value(memwriter_t *memwriter, int value)
 {
   char *bytes;
@@ -1416,7 +1509,7 @@ err_t tobson_int_array(tobson_state_t *state)
       return error;
     }
   /* Set length of object*/
-  int_to_bytes(state->memwriter->size - size_before, &length_as_bytes);
+  int_to_bytes(state->memwriter->size - size_before + tobson_array_ref_size_after(size_before), &length_as_bytes);
   placeholder_pos = state->memwriter->buf + size_before;
   memcpy(placeholder_pos, length_as_bytes, 4);
   free(length_as_bytes);
@@ -1513,7 +1606,7 @@ err_t tobson_double_array(tobson_state_t *state)
       return error;
     }
   /* Set length of object*/
-  int_to_bytes(state->memwriter->size - size_before, &length_as_bytes);
+  int_to_bytes(state->memwriter->size - size_before + tobson_array_ref_size_after(size_before), &length_as_bytes);
   placeholder_pos = state->memwriter->buf + size_before;
   memcpy(placeholder_pos, length_as_bytes, 4);
   free(length_as_bytes);
@@ -1600,7 +1693,16 @@ err_t tobson_optimized_array(tobson_state_t *state)
   /* values */
   if (is_little_endian())
     {
-      if ((error = memwriter_memcpy(state->memwriter, values, length * elem_size)) != ERROR_NONE)
+      if (tobson_permanent_state.array_ref_min_size > 0 &&
+          (size_t)length * elem_size >= tobson_permanent_state.array_ref_min_size)
+        {
+          error = tobson_add_array_ref(state->memwriter, values, (size_t)length * elem_size);
+        }
+      else
+        {
+          error = memwriter_memcpy(state->memwriter, values, length * elem_size);
+        }
+      if (error != ERROR_NONE)
         {
           return error;
         }
@@ -1772,7 +1874,7 @@ err_t tobson_string_array(tobson_state_t *state)
       return error;
     }
   /* Set length of object*/
-  int_to_bytes(state->memwriter->size - size_before, &length_as_bytes);
+  int_to_bytes(state->memwriter->size - size_before + tobson_array_ref_size_after(size_before), &length_as_bytes);
   placeholder_pos = state->memwriter->buf + size_before;
   memcpy(placeholder_pos, length_as_bytes, 4);
   free(length_as_bytes);
@@ -1870,7 +1972,7 @@ err_t tobson_bool_array(tobson_state_t *state)
       return error;
     }
   /* Set length of object*/
-  int_to_bytes(state->memwriter->size - size_before, &length_as_bytes);
+  int_to_bytes(state->memwriter->size - size_before + tobson_array_ref_size_after(size_before), &length_as_bytes);
   placeholder_pos = state->memwriter->buf + size_before;
   memcpy(placeholder_pos, length_as_bytes, 4);
   free(length_as_bytes);
@@ -1968,7 +2070,7 @@ err_t tobson_args_array(tobson_state_t *state)
       return error;
     }
   /* Set length of object*/
-  int_to_bytes(state->memwriter->size - size_before, &length_as_bytes);
+  int_to_bytes(state->memwriter->size - size_before + tobson_array_ref_size_after(size_before), &length_as_bytes);
   placeholder_pos = state->memwriter->buf + size_before;
   memcpy(placeholder_pos, length_as_bytes, 4);
   free(length_as_bytes);
@@ -2203,7 +2305,7 @@ err_t tobson_close_object(tobson_state_t *state)
     }
 
   /* Set length of object*/
-  int_to_bytes(state->memwriter->size - size_before, &length_as_bytes);
+  int_to_bytes(state->memwriter->size - size_before + tobson_array_ref_size_after(size_before), &length_as_bytes);
   placeholder_pos = state->memwriter->buf + size_before;
   memcpy(placeholder_pos, length_as_bytes, 4);
   free(length_as_bytes);
@@ -2630,3 +2732,70 @@ int tobson_struct_nested_level(void)
 {
   return tobson_permanent_state.struct_nested_level;
 }
+
+void tobson_set_array_ref_min_size(size_t min_size)
+{
+  /* Optimized arrays with at least `min_size` bytes are only referenced instead of being copied into the memwriter,
+   * `0` disables array references. References are only used on little endian machines (the data is sent as is) and
+   * must be consumed (`tobson_array_refs`) or resolved (`tobson_resolve_array_refs`) while the arrays are valid. */
+  tobson_permanent_state.array_ref_min_size = min_size;
+}
+
+const tobson_array_ref_t *tobson_array_refs(size_t *count)
+{
+  *count = tobson_permanent_state.array_ref_count;
+  return tobson_permanent_state.array_refs;
+}
+
+void tobson_clear_array_refs(void)
+{
+  free(tobson_permanent_state.array_refs);
+  tobson_permanent_state.array_refs = NULL;
+  tobson_permanent_state.array_ref_count = 0;
+  tobson_permanent_state.array_ref_capacity = 0;
+}
+
+err_t tobson_resolve_array_refs(memwriter_t *memwriter)
+{
+  tobson_array_ref_t *array_refs = tobson_permanent_state.array_refs;
+  size_t total_size = 0, end, shift, i;
+  err_t error;
+
+  if (tobson_permanent_state.array_ref_count == 0)
+    {
+      return ERROR_NONE;
+    }
+  for (i = 0; i < tobson_permanent_state.array_ref_count; ++i)
+    {
+      total_size += array_refs[i].size;
+    }
+  if ((error = memwriter_ensure_buf(memwriter, total_size)) != ERROR_NONE)
+    {
+      return error;
+    }
+  /* objects which are still open must be patched at their new position */
+  if (tobson_permanent_state.memwriter_object_start_offset_stack != NULL)
+    {
+      size_t_list_node_t *node;
+      for (node = tobson_permanent_state.memwriter_object_start_offset_stack->head; node != NULL; node = node->next)
+        {
+          node->entry += tobson_array_ref_size_before(node->entry);
+        }
+    }
+  /* insert the arrays from back to front, so every byte is moved only once */
+  end = memwriter->size;
+  shift = total_size;
+  i = tobson_permanent_state.array_ref_count;
+  while (i-- > 0)
+    {
+      memmove(memwriter->buf + array_refs[i].offset + shift, memwriter->buf + array_refs[i].offset,
+              end - array_refs[i].offset);
+      shift -= array_refs[i].size;
+      memcpy(memwriter->buf + array_refs[i].offset + shift, array_refs[i].data, array_refs[i].size);
+      end = array_refs[i].offset;
+    }
+  memwriter->size += total_size;
+  tobson_clear_array_refs();
+
+  return ERROR_NONE;
+}
@@ -82,11 +82,26 @@ typedef struct
   tobson_shared_state_t *shared;
 } tobson_state_t;
 
+/*!
+ * An array which is part of the serialized message but not copied into the memwriter. Its data belongs at `offset` of
+ * the memwriter buffer and must be sent from `data` directly (see `tobson_set_array_ref_min_size`).
+ */
+typedef struct
+{
+  size_t offset;
+  const void *data;
+  size_t size;
+} tobson_array_ref_t;
+
 typedef struct
 {
   tojson_serialization_result_t serial_result;
   unsigned int struct_nested_level;
   size_t_list_t *memwriter_object_start_offset_stack;
+  size_t array_ref_min_size;
+  tobson_array_ref_t *array_refs;
+  size_t array_ref_count;
+  size_t array_ref_capacity;
 } tobson_permanent_state_t;
 
 /* ========================= small helper functions ================================================================= */
@@ -112,6 +127,7 @@ err_t frombson_read_value_format(frombson_state_t *state, char *value_format);
 err_t frombson_read_key(frombson_state_t *state, const char **key);
 err_t frombson_skip_key(frombson_state_t *state);
 err_t frombson_read_length(frombson_state_t *state, int *length);
+int frombson_remaining_object_bytes(const frombson_state_t *state);
 
 err_t frombson_read_double_value(frombson_state_t *state, double *d);
 err_t frombson_read_int_value(frombson_state_t *state, int *i);
@@ -178,6 +194,10 @@ err_t tobson_write_arg(memwriter_t *memwriter, const arg_t *arg);
 err_t tobson_write_args(memwriter_t *memwriter, const grm_args_t *args);
 int tobson_is_complete(void);
 int tobson_struct_nested_level(void);
+void tobson_set_array_ref_min_size(size_t min_size);
+const tobson_array_ref_t *tobson_array_refs(size_t *count);
+void tobson_clear_array_refs(void);
+err_t tobson_resolve_array_refs(memwriter_t *memwriter);
 
 
 #ifdef __cplusplus
@@ -44,3 +44,12 @@ void ManageGRContextIds::markAllIdsAsUnused()
       available_gr_context_ids.push(id);
     }
 }
+
+void ManageGRContextIds::markAllIdsAsUnused(const std::set<int> &retained_ids)
+{
+  available_gr_context_ids = {};
+  for (int id = 1; id <= no_currently_allocated_gr_contexts; ++id)
+    {
+      if (retained_ids.count(id) == 0) available_gr_context_ids.push(id);
+    }
+}
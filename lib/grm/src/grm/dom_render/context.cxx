@@ -10,6 +10,189 @@
 
 GRM::Context::Context() = default; /*! default constructor for GRM::Context*/
 
+std::atomic<std::size_t> GRM::Context::bytes_copied{0};
+
+std::size_t GRM::Context::getModificationCount() const
+{
+  /*!
+   * Get a counter which is increased whenever data of this GRM::Context could have been modified, either by assigning a
+   * vector or by handing out a non-const reference or pointer to a stored vector
+   *
+   * \returns the modification counter
+   */
+  return modificationCount;
+}
+
+void GRM::Context::appendDoubles(const std::string &key, const double *values, std::size_t count,
+                                 std::size_t max_length)
+{
+  /*!
+   * Append values to a stored double vector in place. Like assignments, appending counts as a modification of the
+   * context; the caller must mark the elements which reference `key` as modified in addition.
+   *
+   * Values which are pushed out of a rolling window are not removed immediately. They are skipped by `get_span` and
+   * the const accessors, and only erased when they make up a whole window or the vector is accessed through a
+   * non-const accessor, so appending to a window does not move the kept values each time.
+   *
+   * \param[in] key The key of the double vector, it is created if it does not exist
+   * \param[in] values The values to append
+   * \param[in] count The number of values
+   * \param[in] max_length If greater than 0, the oldest values are dropped to keep at most `max_length` values
+   */
+  if (!deferredEntries.empty()) loadDeferredEntry(key);
+  modificationCount++;
+  windowCopies.erase(key);
+  auto &vec = tableDouble[key];
+  if (max_length == 0)
+    {
+      dropWindowValues(key);
+      vec.insert(vec.end(), values, values + count);
+      return;
+    }
+  if (count >= max_length)
+    {
+      windowOffsets.erase(key);
+      vec.assign(values + (count - max_length), values + count);
+      return;
+    }
+  auto offset_it = windowOffsets.find(key);
+  std::size_t offset = (offset_it != windowOffsets.end()) ? offset_it->second : 0;
+  std::size_t kept_count = vec.size() - offset;
+  if (kept_count + count > max_length) offset += kept_count + count - max_length;
+  if (offset >= max_length)
+    {
+      vec.erase(vec.begin(), vec.begin() + offset);
+      offset = 0;
+    }
+  vec.insert(vec.end(), values, values + count);
+  if (offset > 0)
+    {
+      windowOffsets[key] = offset;
+    }
+  else if (offset_it != windowOffsets.end())
+    {
+      windowOffsets.erase(offset_it);
+    }
+}
+
+void GRM::Context::dropWindowValues(const std::string &key)
+{
+  /*!
+   * Erase the values which were pushed out of the rolling window of `key`, so the stored vector only contains the
+   * values of the window again.
+   *
+   * \param[in] key The key of the entry
+   */
+  auto offset_it = windowOffsets.find(key);
+  if (offset_it == windowOffsets.end()) return;
+  auto &vec = tableDouble[key];
+  vec.erase(vec.begin(), vec.begin() + offset_it->second);
+  windowOffsets.erase(offset_it);
+  windowCopies.erase(key);
+}
+
+void GRM::Context::dropAllWindowValues()
+{
+  /*!
+   * Erase the values which were pushed out of rolling windows for all entries
+   */
+  while (!windowOffsets.empty())
+    {
+      dropWindowValues(windowOffsets.begin()->first);
+    }
+}
+
+const std::vector<double> &GRM::Context::windowDoubles(const std::string &key)
+{
+  /*!
+   * Get the values of the double vector `key` without the values which were pushed out of its rolling window. The
+   * stored vector is not changed, so spans of it stay valid; a rolling window is returned as a cached copy instead.
+   *
+   * \param[in] key The key of an existing double vector
+   * \returns the kept values
+   */
+  const auto &vec = tableDouble.at(key);
+  auto offset_it = windowOffsets.find(key);
+  if (offset_it == windowOffsets.end()) return vec;
+  auto copy_it = windowCopies.find(key);
+  if (copy_it == windowCopies.end())
+    {
+      copy_it = windowCopies.emplace(key, std::vector<double>(vec.begin() + offset_it->second, vec.end())).first;
+    }
+  return copy_it->second;
+}
+
+std::size_t GRM::Context::bytesCopied()
+{
+  /*!
+   * Get the number of bytes copied out of all GRM::Context objects with GRM::get_copy since the last reset
+   *
+   * \returns the number of copied bytes
+   */
+  return bytes_copied.load(std::memory_order_relaxed);
+}
+
+void GRM::Context::resetBytesCopied()
+{
+  /*!
+   * Reset the counter of bytes copied out of GRM::Context objects
+   */
+  bytes_copied.store(0, std::memory_order_relaxed);
+}
+
+void GRM::Context::countCopiedBytes(std::size_t bytes)
+{
+  /*!
+   * Add bytes to the counter of bytes copied out of GRM::Context objects
+   *
+   * \param[in] bytes The number of copied bytes
+   */
+  bytes_copied.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void GRM::Context::deferEntries(const std::vector<std::string> &keys, const std::shared_ptr<DeferredEntries> &entries)
+{
+  /*!
+   * Register entries which are decoded by `entries` when they are accessed for the first time. Assigning to one of
+   * these keys before it has been accessed discards the deferred entry.
+   *
+   * \param[in] keys The keys which are provided by `entries`
+   * \param[in] entries The source which decodes the entries on demand
+   */
+  for (const auto &key : keys)
+    {
+      deferredEntries[key] = entries;
+    }
+}
+
+void GRM::Context::loadDeferredEntries()
+{
+  /*!
+   * Decode all deferred entries, e.g. before the whole context is iterated
+   */
+  while (!deferredEntries.empty())
+    {
+      loadDeferredEntry(deferredEntries.begin()->first);
+    }
+}
+
+void GRM::Context::loadDeferredEntry(const std::string &key)
+{
+  /*!
+   * Decode a deferred entry if `key` refers to one. Decoding does not count as modification of the context since the
+   * stored data is not changed from the perspective of its users.
+   *
+   * \param[in] key The key of the entry
+   */
+  auto it = deferredEntries.find(key);
+  if (it == deferredEntries.end()) return;
+  auto entries = std::move(it->second);
+  deferredEntries.erase(it);
+  auto modification_count = modificationCount;
+  entries->load(*this, key);
+  modificationCount = modification_count;
+}
+
 GRM::Context::Inner::Inner(Context &context, std::string key) : context(&context), key(std::move(key))
 {
   /*!
@@ -30,6 +213,15 @@ GRM::Context::Inner::Inner(const Context &context, std::string key)
    */
 }
 
+void GRM::Context::Inner::loadDeferred() const
+{
+  /*!
+   * Decode the entry of this Inner's key if it has been deferred. Values which were pushed out of a rolling window are
+   * kept, so views of the stored vector stay valid.
+   */
+  if (!context->deferredEntries.empty()) context->loadDeferredEntry(key);
+}
+
 bool GRM::Context::Inner::intUsed()
 {
   /*!
@@ -38,6 +230,7 @@ bool GRM::Context::Inner::intUsed()
    *
    * \returns a bool indicating the usage of GRM::Context::Inner::key by GRM::Context::tableInt
    */
+  loadDeferred();
   return context->tableInt.find(key) != context->tableInt.end();
 }
 
@@ -49,6 +242,7 @@ bool GRM::Context::Inner::doubleUsed()
    *
    * \returns a bool indicating the usage of GRM::Context::Inner::key by GRM::Context::tableDouble
    */
+  loadDeferred();
   return context->tableDouble.find(key) != context->tableDouble.end();
 }
 
@@ -60,6 +254,7 @@ bool GRM::Context::Inner::stringUsed()
    *
    * \returns a bool indicating the usage of GRM::Context::Inner::key by GRM::Context::tableString
    */
+  loadDeferred();
   return context->tableString.find(key) != context->tableString.end();
 }
 
@@ -71,12 +266,16 @@ GRM::Context::Inner &GRM::Context::Inner::operator=(std::vector<double> vec)
    * Stores the vector in GRM::Context::tableDouble with GRM::Context::Inner's key
    * Throws a TypeError if the GRM::Context::Inner key is already used by other GRM::Context tableTYPES
    */
+  context->deferredEntries.erase(key);
   if (intUsed() || stringUsed())
     {
       throw TypeError("Wrong Type: std::vector<double> expected\n");
     }
   else
     {
+      context->modificationCount++;
+      context->windowOffsets.erase(key);
+      context->windowCopies.erase(key);
       context->tableDouble[key] = std::move(vec);
       return *this;
     }
@@ -89,12 +288,14 @@ GRM::Context::Inner &GRM::Context::Inner::operator=(std::vector<int> vec)
    * Stores the vector in GRM::Context::tableInt with GRM::Context::Inner's key
    * Throws a TypeError if the GRM::Context::Inner key is already used by other GRM::Context tableTYPES
    */
+  context->deferredEntries.erase(key);
   if (doubleUsed() || stringUsed())
     {
       throw TypeError("Wrong type: std::vector<int> expected\n");
     }
   else
     {
+      context->modificationCount++;
       context->tableInt[key] = std::move(vec);
       return *this;
     }
@@ -108,12 +309,14 @@ GRM::Context::Inner &GRM::Context::Inner::operator=(std::vector<std::string> vec
    * Stores the vector in GRM::Context::tableString with GRM::Context::Inner's key
    * Throws a TypeError if the GRM::Context::Inner is already used by other GRM::Context tableTYPES
    */
+  context->deferredEntries.erase(key);
   if (intUsed() || doubleUsed())
     {
       throw TypeError("Wrong type: std::vector<std::string> expected\n");
     }
   else
     {
+      context->modificationCount++;
       context->tableString[key] = std::move(vec);
       return *this;
     }
@@ -128,6 +331,8 @@ GRM::Context::Inner::operator std::vector<int> &()
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  loadDeferred();
+  context->modificationCount++;
   if (context->tableInt.find(key) != context->tableInt.end())
     {
       return context->tableInt[key];
@@ -144,6 +349,7 @@ GRM::Context::Inner::operator const std::vector<int> &() const
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  loadDeferred();
   if (context->tableInt.find(key) != context->tableInt.end())
     {
       return context->tableInt[key];
@@ -160,8 +366,11 @@ GRM::Context::Inner::operator std::vector<double> &()
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  loadDeferred();
+  context->modificationCount++;
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
+      context->dropWindowValues(key);
       return context->tableDouble[key];
     }
   std::string msg = "No double value found for given key: " + key;
@@ -176,14 +385,35 @@ GRM::Context::Inner::operator const std::vector<double> &() const
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  loadDeferred();
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
-      return context->tableDouble[key];
+      return context->windowDoubles(key);
     }
   std::string msg = "No double value found for given key: " + key;
   throw NotFoundError(msg);
 }
 
+GRM::Span<const double> GRM::Context::Inner::doubleSpan() const
+{
+  /*!
+   * Get a read-only view of the double vector with Inner's key without erasing values which were pushed out of its
+   * rolling window. This function is used in GRM::get_span
+   *
+   * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
+   */
+  if (!context->deferredEntries.empty()) context->loadDeferredEntry(key);
+  auto vec_it = context->tableDouble.find(key);
+  if (vec_it == context->tableDouble.end())
+    {
+      std::string msg = "No double value found for given key: " + key;
+      throw NotFoundError(msg);
+    }
+  auto offset_it = context->windowOffsets.find(key);
+  std::size_t offset = (offset_it != context->windowOffsets.end()) ? offset_it->second : 0;
+  return Span<const double>(vec_it->second.data() + offset, vec_it->second.size() - offset);
+}
+
 GRM::Context::Inner::operator std::vector<std::string> &()
 {
   /*!
@@ -192,6 +422,8 @@ GRM::Context::Inner::operator std::vector<std::string> &()
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  loadDeferred();
+  context->modificationCount++;
   if (context->tableString.find(key) != context->tableString.end())
     {
       return context->tableString[key];
@@ -208,6 +440,7 @@ GRM::Context::Inner::operator const std::vector<std::string> &() const
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  loadDeferred();
   if (context->tableString.find(key) != context->tableString.end())
     {
       return context->tableString[key];
@@ -224,6 +457,8 @@ GRM::Context::Inner::operator std::vector<int> *()
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  loadDeferred();
+  context->modificationCount++;
   if (context->tableInt.find(key) != context->tableInt.end())
     {
       return &context->tableInt[key];
@@ -240,6 +475,7 @@ GRM::Context::Inner::operator const std::vector<int> *() const
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  loadDeferred();
   if (context->tableInt.find(key) != context->tableInt.end())
     {
       return &context->tableInt[key];
@@ -257,8 +493,11 @@ GRM::Context::Inner::operator std::vector<double> *()
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  loadDeferred();
+  context->modificationCount++;
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
+      context->dropWindowValues(key);
       return &context->tableDouble[key];
     }
   std::string msg = "No double value found for given key: " + key;
@@ -273,9 +512,10 @@ GRM::Context::Inner::operator const std::vector<double> *() const
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  loadDeferred();
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
-      return &context->tableDouble[key];
+      return &context->windowDoubles(key);
     }
   std::string msg = "No double value found for given key: " + key;
   throw NotFoundError(msg);
@@ -289,6 +529,8 @@ GRM::Context::Inner::operator std::vector<std::string> *()
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  loadDeferred();
+  context->modificationCount++;
   if (context->tableString.find(key) != context->tableString.end())
     {
       return &context->tableString[key];
@@ -305,6 +547,7 @@ GRM::Context::Inner::operator const std::vector<std::string> *() const
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  loadDeferred();
   if (context->tableString.find(key) != context->tableString.end())
     {
       return &context->tableString[key];
@@ -315,7 +558,7 @@ GRM::Context::Inner::operator const std::vector<std::string> *() const
 
 void GRM::Context::Inner::delete_key(const std::string &context_key)
 {
-  bool erased = false;
+  bool erased = context->deferredEntries.erase(context_key) > 0;
   if (context->tableString.find(context_key) != context->tableString.end())
     {
       context->tableString.erase(context_key);
@@ -324,6 +567,8 @@ void GRM::Context::Inner::delete_key(const std::string &context_key)
   if (context->tableDouble.find(context_key) != context->tableDouble.end())
     {
       context->tableDouble.erase(context_key);
+      context->windowOffsets.erase(context_key);
+      context->windowCopies.erase(context_key);
       erased = true;
     }
   if (context->tableInt.find(context_key) != context->tableInt.end())
@@ -502,6 +747,8 @@ GRM::Context::Iterator::next_iterator()
  */
 GRM::Context::Iterator GRM::Context::begin()
 {
+  loadDeferredEntries();
+  dropAllWindowValues();
   return Iterator(*this);
 }
 
@@ -0,0 +1,83 @@
+#include <grm/dom_render/graphics_tree/AttributeKey.hxx>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+struct AtomTable
+{
+  static constexpr std::size_t chunk_size = 1024;
+  static constexpr std::size_t max_chunks = 4096;
+
+  /*
+   * Names are interned rarely but looked up for every attribute access by name, so lookups only take a shared lock and
+   * do not block each other. Adding a name needs the exclusive lock.
+   */
+  std::shared_mutex mutex;
+  std::unordered_map<std::string, unsigned int> ids;
+  /*
+   * The keys of a node based map keep their address, so names can be looked up by id. The name pointers are stored in
+   * chunks which are never moved or changed after an id has been handed out, so `name()` can read them without locking:
+   * every key has been created while holding the mutex after its name was stored.
+   */
+  std::unique_ptr<const std::string *[]> names[max_chunks];
+  std::size_t count = 0;
+};
+
+static AtomTable &atomTable()
+{
+  static AtomTable table;
+  return table;
+}
+
+GRM::AttributeKey::AttributeKey(const std::string &name)
+{
+  auto &table = atomTable();
+  {
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    auto search = table.ids.find(name);
+    if (search != table.ids.end())
+      {
+        m_id = search->second;
+        return;
+      }
+  }
+  /* another thread may have added the name in the meantime, so it is searched again */
+  std::unique_lock<std::shared_mutex> lock(table.mutex);
+  auto search = table.ids.find(name);
+  if (search == table.ids.end())
+    {
+      auto chunk = table.count / AtomTable::chunk_size;
+      if (chunk == AtomTable::max_chunks) throw std::length_error("Too many different attribute names");
+      if (!table.names[chunk]) table.names[chunk].reset(new const std::string *[AtomTable::chunk_size]);
+      search = table.ids.emplace(name, static_cast<unsigned int>(table.count)).first;
+      table.names[chunk][table.count % AtomTable::chunk_size] = &search->first;
+      table.count++;
+    }
+  m_id = search->second;
+}
+
+GRM::AttributeKey::AttributeKey(const char *name) : AttributeKey(std::string(name)) {}
+
+std::optional<GRM::AttributeKey> GRM::AttributeKey::find(const std::string &name)
+{
+  auto &table = atomTable();
+  std::shared_lock<std::shared_mutex> lock(table.mutex);
+  auto search = table.ids.find(name);
+  if (search == table.ids.end()) return std::nullopt;
+  return AttributeKey(search->second);
+}
+
+std::size_t GRM::AttributeKey::count()
+{
+  auto &table = atomTable();
+  std::shared_lock<std::shared_mutex> lock(table.mutex);
+  return table.count;
+}
+
+const std::string &GRM::AttributeKey::name() const
+{
+  const auto &table = atomTable();
+  return *table.names[m_id / AtomTable::chunk_size][m_id % AtomTable::chunk_size];
+}
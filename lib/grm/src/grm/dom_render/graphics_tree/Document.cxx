@@ -34,6 +34,7 @@ std::shared_ptr<const GRM::Element> GRM::Document::documentElement() const
 std::shared_ptr<GRM::Element> GRM::Document::createElement(const std::string &localName)
 {
   auto result = std::shared_ptr<GRM::Element>(new GRM::Element(localName, shared()));
+  indexElement(*result, true);
   return result;
 }
 
@@ -125,6 +126,9 @@ std::shared_ptr<GRM::Node> GRM::Document::cloneIndividualNode()
 {
   auto document = GRM::Document::createDocument();
   *document = *this;
+  // the elements counted in the index still belong to this document, clones are counted when they are adopted
+  document->m_tag_name_counts.clear();
+  document->m_attribute_counts.clear();
   return document;
 }
 
@@ -209,31 +213,104 @@ std::shared_ptr<GRM::Document> GRM::createDocument()
 }
 
 std::vector<std::shared_ptr<GRM::Element>> GRM::Document::querySelectorsAll(const std::string &selectors)
+{
+  return querySelectorsAll(compileSelectors(selectors));
+}
+
+std::vector<std::shared_ptr<const GRM::Element>> GRM::Document::querySelectorsAll(const std::string &selectors) const
+{
+  return querySelectorsAll(compileSelectors(selectors));
+}
+
+std::shared_ptr<GRM::Element> GRM::Document::querySelectors(const std::string &selectors)
+{
+  return querySelectors(compileSelectors(selectors));
+}
+
+std::shared_ptr<const GRM::Element> GRM::Document::querySelectors(const std::string &selectors) const
+{
+  return querySelectors(compileSelectors(selectors));
+}
+
+std::vector<std::shared_ptr<GRM::Element>>
+GRM::Document::querySelectorsAll(const std::shared_ptr<GRM::Selector> &selector)
 {
   std::vector<std::shared_ptr<GRM::Element>> found_elements;
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  querySelectorsAll_impl(parseSelectors(selectors), found_elements, match_map);
+  auto max_matches = selector->maxMatches(*this);
+  querySelectorsAll_impl(selector, found_elements, match_map, max_matches);
   return found_elements;
 }
 
-std::vector<std::shared_ptr<const GRM::Element>> GRM::Document::querySelectorsAll(const std::string &selectors) const
+std::vector<std::shared_ptr<const GRM::Element>>
+GRM::Document::querySelectorsAll(const std::shared_ptr<GRM::Selector> &selector) const
 {
   std::vector<std::shared_ptr<const GRM::Element>> found_elements;
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  querySelectorsAll_impl(parseSelectors(selectors), found_elements, match_map);
+  auto max_matches = selector->maxMatches(*this);
+  querySelectorsAll_impl(selector, found_elements, match_map, max_matches);
   return found_elements;
 }
 
-std::shared_ptr<GRM::Element> GRM::Document::querySelectors(const std::string &selectors)
+std::shared_ptr<GRM::Element> GRM::Document::querySelectors(const std::shared_ptr<GRM::Selector> &selector)
 {
+  if (selector->maxMatches(*this) == 0)
+    {
+      return nullptr;
+    }
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  return querySelectors_impl(parseSelectors(selectors), match_map);
+  return querySelectors_impl(selector, match_map);
 }
 
-std::shared_ptr<const GRM::Element> GRM::Document::querySelectors(const std::string &selectors) const
+std::shared_ptr<const GRM::Element> GRM::Document::querySelectors(const std::shared_ptr<GRM::Selector> &selector) const
 {
+  if (selector->maxMatches(*this) == 0)
+    {
+      return nullptr;
+    }
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  return querySelectors_impl(parseSelectors(selectors), match_map);
+  return querySelectors_impl(selector, match_map);
+}
+
+std::size_t GRM::Document::elementCountByTagName(const std::string &localName) const
+{
+  auto search = m_tag_name_counts.find(localName);
+  return search != m_tag_name_counts.end() ? search->second : 0;
+}
+
+std::size_t GRM::Document::elementCountByAttribute(const GRM::AttributeKey &key) const
+{
+  return key.id() < m_attribute_counts.size() ? m_attribute_counts[key.id()] : 0;
+}
+
+void GRM::Document::indexElement(const GRM::Element &element, bool add)
+{
+  if (add)
+    {
+      ++m_tag_name_counts[element.m_local_name];
+    }
+  else
+    {
+      auto search = m_tag_name_counts.find(element.m_local_name);
+      if (search != m_tag_name_counts.end() && --search->second == 0) m_tag_name_counts.erase(search);
+    }
+  for (const auto &attribute : element.m_attributes)
+    {
+      indexAttribute(attribute.first, add);
+    }
+}
+
+void GRM::Document::indexAttribute(const GRM::AttributeKey &key, bool add)
+{
+  if (key.id() >= m_attribute_counts.size()) m_attribute_counts.resize(key.id() + 1, 0);
+  if (add)
+    {
+      ++m_attribute_counts[key.id()];
+    }
+  else if (m_attribute_counts[key.id()] > 0)
+    {
+      --m_attribute_counts[key.id()];
+    }
 }
 
 void GRM::Document::setUpdateFct(void (*ren)(), void (*upt)(const std::shared_ptr<GRM::Element> &, const std::string &,
@@ -2,15 +2,24 @@
 #include <grm/dom_render/graphics_tree/Document.hxx>
 #include <grm/dom_render/graphics_tree/util.hxx>
 #include <grm/dom_render/graphics_tree/HierarchyRequestError.hxx>
+#include <algorithm>
 #include <iterator>
+#include <limits>
 #include <grm/utilcpp_int.hxx>
 #include <grm/dom_render/graphics_tree/TypeError.hxx>
 
 GRM::Element::Element(std::string local_name, const std::shared_ptr<GRM::Document> &owner_document)
-    : GRM::Node(GRM::Node::Type::ELEMENT_NODE, owner_document), m_local_name(std::move(local_name))
+    : GRM::Node(GRM::Node::Type::ELEMENT_NODE, owner_document), m_local_name(std::move(local_name)),
+      m_local_name_key(m_local_name)
 {
 }
 
+GRM::Element::~Element()
+{
+  auto owner_document = ownerDocument();
+  if (owner_document) owner_document->indexElement(*this, false);
+}
+
 std::string GRM::Element::nodeName() const
 {
   return tagName();
@@ -26,11 +35,16 @@ std::string GRM::Element::tagName() const
   return GRM::toupper(this->m_local_name);
 }
 
-std::string GRM::Element::localName() const
+const std::string &GRM::Element::localName() const
 {
   return this->m_local_name;
 }
 
+unsigned int GRM::Element::localNameId() const
+{
+  return m_local_name_key.id();
+}
+
 bool GRM::Element::hasAttributes() const
 {
   return !this->m_attributes.empty();
@@ -42,40 +56,83 @@ std::unordered_set<std::string> GRM::Element::getAttributeNames() const
   keys.reserve(this->m_attributes.size());
   for (const auto &key : this->m_attributes)
     {
-      keys.insert(key.first);
+      keys.insert(key.first.name());
     }
   return keys;
 }
 
+std::vector<GRM::AttributeKey> GRM::Element::getAttributeKeys() const
+{
+  std::vector<GRM::AttributeKey> keys;
+  keys.reserve(this->m_attributes.size());
+  for (const auto &attribute : this->m_attributes)
+    {
+      keys.push_back(attribute.first);
+    }
+  return keys;
+}
+
+const GRM::Value *GRM::Element::findAttribute(const GRM::AttributeKey &key) const
+{
+  for (const auto &attribute : m_attributes)
+    {
+      if (attribute.first == key) return &attribute.second;
+    }
+  return nullptr;
+}
+
 GRM::Value GRM::Element::getAttribute(const std::string &qualifiedName) const
 {
-  if (!this->hasAttribute(qualifiedName)) return {};
-  return this->m_attributes.at(qualifiedName);
+  auto key = GRM::AttributeKey::find(qualifiedName);
+  if (!key) return {};
+  return getAttribute(*key);
+}
+
+GRM::Value GRM::Element::getAttribute(const GRM::AttributeKey &key) const
+{
+  auto value = findAttribute(key);
+  if (!value) return {};
+  return *value;
 }
 
 void GRM::Element::setAttribute(const std::string &qualifiedName, const GRM::Value &value)
 {
+  setAttribute(GRM::AttributeKey(qualifiedName), value);
+}
+
+void GRM::Element::setAttribute(const GRM::AttributeKey &key, const GRM::Value &value)
+{
+  static const GRM::AttributeKey viewport_keys[] = {
+      GRM::AttributeKey("viewport_x_min"), GRM::AttributeKey("viewport_x_max"), GRM::AttributeKey("viewport_y_min"),
+      GRM::AttributeKey("viewport_y_max")};
+  const std::string &qualifiedName = key.name();
   GRM::Value old_value;
   void (*render)() = nullptr;
   void (*update)(const std::shared_ptr<GRM::Element> &, const std::string &, const std::string &) = nullptr;
   void (*contextUpdate)(const std::shared_ptr<GRM::Element> &, const std::string &, const GRM::Value &) = nullptr;
   void (*contextDelete)(const std::shared_ptr<GRM::Element> &) = nullptr;
-  ownerDocument()->getUpdateFct(&render, &update);
-  ownerDocument()->getContextFct(&contextDelete, &contextUpdate);
+  auto owner_document = ownerDocument();
+  owner_document->getUpdateFct(&render, &update);
+  owner_document->getContextFct(&contextDelete, &contextUpdate);
 
-  if (hasAttribute(qualifiedName)) old_value = this->m_attributes[qualifiedName];
-
-  this->m_attributes[qualifiedName] = value;
+  auto attribute = std::find_if(m_attributes.begin(), m_attributes.end(),
+                                [&key](const std::pair<AttributeKey, Value> &entry) { return entry.first == key; });
+  if (attribute != m_attributes.end())
+    {
+      old_value = std::move(attribute->second);
+      attribute->second = value;
+    }
+  else
+    {
+      m_attributes.emplace_back(key, value);
+      owner_document->indexAttribute(key, true);
+    }
   if (value != old_value)
     {
+      markDirty();
       auto elem_p = std::static_pointer_cast<Element>(shared_from_this());
       if (contextUpdate) contextUpdate(elem_p, qualifiedName, old_value);
-      if (qualifiedName == "kind")
-        {
-          ;
-        }
-      if (qualifiedName == "viewport_x_min" || qualifiedName == "viewport_x_max" || qualifiedName == "viewport_y_min" ||
-          qualifiedName == "viewport_y_max")
+      if (std::find(std::begin(viewport_keys), std::end(viewport_keys), key) != std::end(viewport_keys))
         {
           if (update) update(elem_p, qualifiedName, std::to_string(static_cast<double>(old_value)));
         }
@@ -104,7 +161,25 @@ void GRM::Element::setAttribute(const std::string &qualifiedName, const int &val
 
 void GRM::Element::removeAttribute(const std::string &qualifiedName)
 {
-  this->m_attributes.erase(qualifiedName);
+  auto key = GRM::AttributeKey::find(qualifiedName);
+  if (key) removeAttribute(*key);
+}
+
+void GRM::Element::removeAttribute(const GRM::AttributeKey &key)
+{
+  for (auto it = m_attributes.begin(); it != m_attributes.end(); ++it)
+    {
+      if (it->first == key)
+        {
+          // the order of the attributes is not significant
+          if (it != m_attributes.end() - 1) *it = std::move(m_attributes.back());
+          m_attributes.pop_back();
+          auto owner_document = ownerDocument();
+          if (owner_document) owner_document->indexAttribute(key, false);
+          markDirty();
+          return;
+        }
+    }
 }
 
 bool GRM::Element::toggleAttribute(const std::string &qualifiedName)
@@ -143,7 +218,13 @@ bool GRM::Element::toggleAttribute(const std::string &qualifiedName, bool force)
 
 bool GRM::Element::hasAttribute(const std::string &qualifiedName) const
 {
-  return this->m_attributes.find(qualifiedName) != GRM::Element::m_attributes.end();
+  auto key = GRM::AttributeKey::find(qualifiedName);
+  return key && findAttribute(*key) != nullptr;
+}
+
+bool GRM::Element::hasAttribute(const GRM::AttributeKey &key) const
+{
+  return findAttribute(key) != nullptr;
 }
 
 template <typename T>
@@ -151,13 +232,13 @@ static std::vector<std::shared_ptr<T>> getElementsByTagName_impl(T &element, con
 {
   std::string local_name = qualifiedName;
   std::vector<std::shared_ptr<T>> found_elements;
-  for (const auto &child_element : element.children())
+  for (auto &child_element : element.childElements())
     {
-      if (local_name == "*" || child_element->localName() == local_name)
+      if (local_name == "*" || child_element.localName() == local_name)
         {
-          found_elements.push_back(child_element);
+          found_elements.push_back(std::static_pointer_cast<T>(child_element.shared_from_this()));
         }
-      auto child_found_elements = child_element->getElementsByTagName(qualifiedName);
+      auto child_found_elements = child_element.getElementsByTagName(qualifiedName);
       found_elements.insert(found_elements.end(), child_found_elements.begin(), child_found_elements.end());
     }
   return found_elements;
@@ -246,6 +327,21 @@ std::vector<std::shared_ptr<const GRM::Element>> GRM::Element::children() const
   return children_impl();
 }
 
+void GRM::Element::children(std::vector<std::shared_ptr<GRM::Element>> &child_elements)
+{
+  children_impl(child_elements);
+}
+
+GRM::Node::ChildElementRange GRM::Element::childElements()
+{
+  return childElements_impl();
+}
+
+GRM::Node::ConstChildElementRange GRM::Element::childElements() const
+{
+  return childElements_impl();
+}
+
 std::shared_ptr<GRM::Element> GRM::Element::firstChildElement()
 {
   return firstChildElement_impl();
@@ -324,8 +420,10 @@ std::shared_ptr<const GRM::Element> GRM::Element::shared() const
 
 std::shared_ptr<GRM::Node> GRM::Element::cloneIndividualNode()
 {
-  auto element = std::shared_ptr<GRM::Element>(new GRM::Element(m_local_name, ownerDocument()));
+  auto owner_document = ownerDocument();
+  auto element = std::shared_ptr<GRM::Element>(new GRM::Element(m_local_name, owner_document));
   *element = *this;
+  if (owner_document) owner_document->indexElement(*element, true);
   return element;
 }
 
@@ -346,11 +444,8 @@ bool GRM::Element::isEqualNode(const std::shared_ptr<const GRM::Node> &otherNode
     }
   for (const auto &attribute_entry : other_node_as_element->m_attributes)
     {
-      if (m_attributes.find(attribute_entry.first) == m_attributes.end())
-        {
-          return false;
-        }
-      if (m_attributes.at(attribute_entry.first) != attribute_entry.second)
+      auto value = findAttribute(attribute_entry.first);
+      if (value == nullptr || *value != attribute_entry.second)
         {
           return false;
         }
@@ -379,29 +474,68 @@ std::shared_ptr<const GRM::Element> GRM::Element::nextElementSibling() const
 }
 
 std::vector<std::shared_ptr<GRM::Element>> GRM::Element::querySelectorsAll(const std::string &selectors)
+{
+  return querySelectorsAll(compileSelectors(selectors));
+}
+
+std::vector<std::shared_ptr<const GRM::Element>> GRM::Element::querySelectorsAll(const std::string &selectors) const
+{
+  return querySelectorsAll(compileSelectors(selectors));
+}
+
+std::shared_ptr<GRM::Element> GRM::Element::querySelectors(const std::string &selectors)
+{
+  return querySelectors(compileSelectors(selectors));
+}
+
+std::shared_ptr<const GRM::Element> GRM::Element::querySelectors(const std::string &selectors) const
+{
+  return querySelectors(compileSelectors(selectors));
+}
+
+static std::size_t maxSelectorMatches(const GRM::Element &element, const std::shared_ptr<GRM::Selector> &selector)
+{
+  auto owner_document = element.ownerDocument();
+  if (!owner_document) return std::numeric_limits<std::size_t>::max();
+  return selector->maxMatches(*owner_document);
+}
+
+std::vector<std::shared_ptr<GRM::Element>>
+GRM::Element::querySelectorsAll(const std::shared_ptr<GRM::Selector> &selector)
 {
   std::vector<std::shared_ptr<GRM::Element>> found_elements;
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  querySelectorsAll_impl(parseSelectors(selectors), found_elements, match_map);
+  auto max_matches = maxSelectorMatches(*this, selector);
+  querySelectorsAll_impl(selector, found_elements, match_map, max_matches);
   return found_elements;
 }
 
-std::vector<std::shared_ptr<const GRM::Element>> GRM::Element::querySelectorsAll(const std::string &selectors) const
+std::vector<std::shared_ptr<const GRM::Element>>
+GRM::Element::querySelectorsAll(const std::shared_ptr<GRM::Selector> &selector) const
 {
   std::vector<std::shared_ptr<const GRM::Element>> found_elements;
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  querySelectorsAll_impl(parseSelectors(selectors), found_elements, match_map);
+  auto max_matches = maxSelectorMatches(*this, selector);
+  querySelectorsAll_impl(selector, found_elements, match_map, max_matches);
   return found_elements;
 }
 
-std::shared_ptr<GRM::Element> GRM::Element::querySelectors(const std::string &selectors)
+std::shared_ptr<GRM::Element> GRM::Element::querySelectors(const std::shared_ptr<GRM::Selector> &selector)
 {
+  if (maxSelectorMatches(*this, selector) == 0)
+    {
+      return nullptr;
+    }
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  return querySelectors_impl(parseSelectors(selectors), match_map);
+  return querySelectors_impl(selector, match_map);
 }
 
-std::shared_ptr<const GRM::Element> GRM::Element::querySelectors(const std::string &selectors) const
+std::shared_ptr<const GRM::Element> GRM::Element::querySelectors(const std::shared_ptr<GRM::Selector> &selector) const
 {
+  if (maxSelectorMatches(*this, selector) == 0)
+    {
+      return nullptr;
+    }
   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> match_map;
-  return querySelectors_impl(parseSelectors(selectors), match_map);
+  return querySelectors_impl(selector, match_map);
 }
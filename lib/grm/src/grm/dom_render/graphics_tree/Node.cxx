@@ -193,6 +193,8 @@ std::shared_ptr<GRM::Node> GRM::Node::cloneNode(bool deep)
 {
   auto clone = cloneIndividualNode();
   clone->m_parent_node = {};
+  clone->m_dirty = true;
+  clone->m_modified = true;
   if (deep)
     {
       clone->m_child_nodes.clear();
@@ -273,6 +275,7 @@ std::shared_ptr<GRM::Node> GRM::Node::insertBefore(std::shared_ptr<GRM::Node> no
       m_child_nodes.push_back(node);
     }
   node->m_parent_node = shared_from_this();
+  markDirty();
   return node;
 }
 
@@ -322,6 +325,7 @@ std::shared_ptr<GRM::Node> GRM::Node::replaceChild(std::shared_ptr<GRM::Node> no
   *it = node;
   node->m_parent_node = shared_from_this();
   child->m_parent_node = {};
+  markDirty();
   return node;
 }
 
@@ -337,9 +341,55 @@ std::shared_ptr<GRM::Node> GRM::Node::removeChild(std::shared_ptr<GRM::Node> chi
     }
   m_child_nodes.remove(child);
   child->m_parent_node = {};
+  markDirty();
   return child;
 }
 
+bool GRM::Node::isDirty() const
+{
+  /*!
+   * \returns true if this node or one of its descendants has been modified since the last call of clearDirty
+   */
+  return m_dirty;
+}
+
+bool GRM::Node::isModified() const
+{
+  /*!
+   * \returns true if the attributes or the children of this node have been modified since the last call of clearDirty
+   */
+  return m_modified;
+}
+
+void GRM::Node::markDirty()
+{
+  /*!
+   * Mark this node as modified and this node and all of its ancestors as dirty. The ancestors of a dirty node are always
+   * dirty, so the walk can stop at the first node which is already marked.
+   */
+  m_modified = true;
+  if (m_dirty) return;
+  m_dirty = true;
+  for (auto node = parentNode(); node && !node->m_dirty; node = node->parentNode())
+    {
+      node->m_dirty = true;
+    }
+}
+
+void GRM::Node::clearDirty()
+{
+  /*!
+   * Reset the dirty and modified flags of this node and all of its dirty descendants. Clean subtrees are not visited.
+   */
+  if (!m_dirty) return;
+  m_dirty = false;
+  m_modified = false;
+  for (const auto &child_node : m_child_nodes)
+    {
+      child_node->clearDirty();
+    }
+}
+
 void GRM::Node::prepend_impl(const std::vector<std::shared_ptr<GRM::Node>> &nodes)
 {
   auto previous_first_child = firstChild();
@@ -371,12 +421,20 @@ void GRM::Node::replaceChildren_impl(const std::vector<std::shared_ptr<GRM::Node
       node->m_parent_node = {};
     }
   m_child_nodes.clear();
+  markDirty();
   append_impl(nodes);
 }
 
 void GRM::Node::set_owner_document_recursive(const std::shared_ptr<GRM::Node> &node,
                                              const std::shared_ptr<GRM::Document> &document)
 {
+  if (node->nodeType() == Type::ELEMENT_NODE)
+    {
+      auto &element = static_cast<const GRM::Element &>(*node);
+      auto old_document = node->m_owner_document.lock();
+      if (old_document) old_document->indexElement(element, false);
+      if (document) document->indexElement(element, true);
+    }
   node->m_owner_document = document;
   for (const auto &child_node : node->m_child_nodes)
     {
@@ -435,6 +493,28 @@ std::vector<std::shared_ptr<const GRM::Element>> GRM::Node::children_impl() cons
   return ::children_impl<const GRM::Element>(m_child_nodes);
 }
 
+void GRM::Node::children_impl(std::vector<std::shared_ptr<GRM::Element>> &child_elements)
+{
+  child_elements.clear();
+  for (const auto &child_node : m_child_nodes)
+    {
+      if (child_node->nodeType() == GRM::Node::Type::ELEMENT_NODE)
+        {
+          child_elements.push_back(std::static_pointer_cast<GRM::Element>(child_node));
+        }
+    }
+}
+
+GRM::Node::ChildElementRange GRM::Node::childElements_impl()
+{
+  return {{m_child_nodes.cbegin(), m_child_nodes.cend()}, {m_child_nodes.cend(), m_child_nodes.cend()}};
+}
+
+GRM::Node::ConstChildElementRange GRM::Node::childElements_impl() const
+{
+  return {{m_child_nodes.cbegin(), m_child_nodes.cend()}, {m_child_nodes.cend(), m_child_nodes.cend()}};
+}
+
 template <typename T, typename U> static std::shared_ptr<T> firstChildElement_impl(U &child_nodes)
 {
   for (const auto &child_node : child_nodes)
@@ -618,39 +698,57 @@ GRM::Node::getElementsByClassName_impl(const std::string &classNames) const
 bool GRM::Node::matchSelector(const std::shared_ptr<GRM::Selector> &selector,
                               std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
 {
-  auto element = dynamic_cast<const GRM::Element *>(this);
-  if (nodeType() != GRM::Node::Type::ELEMENT_NODE || !element)
+  if (nodeType() != GRM::Node::Type::ELEMENT_NODE)
     {
       return false;
     }
-  return selector->matchElement(*element, match_map);
+  return selector->matchElement(static_cast<const GRM::Element &>(*this), match_map);
 }
 
 void GRM::Node::querySelectorsAll_impl(
     const std::shared_ptr<GRM::Selector> &selector, std::vector<std::shared_ptr<GRM::Element>> &found_elements,
-    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map)
+    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map, std::size_t &max_matches)
 {
+  if (max_matches == 0)
+    {
+      return;
+    }
   if (matchSelector(selector, match_map))
     {
-      found_elements.push_back(std::dynamic_pointer_cast<Element>(shared_from_this()));
+      found_elements.push_back(std::static_pointer_cast<Element>(shared_from_this()));
+      --max_matches;
     }
   for (auto &child_node : m_child_nodes)
     {
-      child_node->querySelectorsAll_impl(selector, found_elements, match_map);
+      if (max_matches == 0)
+        {
+          break;
+        }
+      child_node->querySelectorsAll_impl(selector, found_elements, match_map, max_matches);
     }
 }
 
 void GRM::Node::querySelectorsAll_impl(
     const std::shared_ptr<GRM::Selector> &selector, std::vector<std::shared_ptr<const GRM::Element>> &found_elements,
-    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
+    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map,
+    std::size_t &max_matches) const
 {
+  if (max_matches == 0)
+    {
+      return;
+    }
   if (matchSelector(selector, match_map))
     {
-      found_elements.push_back(std::dynamic_pointer_cast<const Element>(shared_from_this()));
+      found_elements.push_back(std::static_pointer_cast<const Element>(shared_from_this()));
+      --max_matches;
     }
   for (auto &child_node : m_child_nodes)
     {
-      child_node->querySelectorsAll_impl(selector, found_elements, match_map);
+      if (max_matches == 0)
+        {
+          break;
+        }
+      child_node->querySelectorsAll_impl(selector, found_elements, match_map, max_matches);
     }
 }
 
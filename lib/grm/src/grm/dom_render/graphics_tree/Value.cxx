@@ -1,16 +1,106 @@
 #include <grm/dom_render/graphics_tree/Value.hxx>
+#include <cstring>
 #include <stdexcept>
 #include <limits>
 
-GRM::Value::Value() : m_type(Type::UNDEFINED), m_int_value(0), m_double_value(0), m_string_value() {}
+GRM::Value::Value() : m_type(Type::UNDEFINED), m_small_string(false), m_double_value(0) {}
 
-GRM::Value::Value(int value) : m_type(Type::INT), m_int_value(value), m_double_value(0), m_string_value() {}
+GRM::Value::Value(int value) : m_type(Type::INT), m_small_string(false), m_int_value(value) {}
 
-GRM::Value::Value(double value) : m_type(Type::DOUBLE), m_int_value(0), m_double_value(value), m_string_value() {}
+GRM::Value::Value(double value) : m_type(Type::DOUBLE), m_small_string(false), m_double_value(value) {}
 
-GRM::Value::Value(std::string value)
-    : m_type(Type::STRING), m_int_value(0), m_double_value(0), m_string_value(std::move(value))
+GRM::Value::Value(std::string value) : m_type(Type::UNDEFINED), m_small_string(false), m_double_value(0)
 {
+  assignString(value.data(), value.size());
+}
+
+GRM::Value::Value(const GRM::Value &other) : m_type(Type::UNDEFINED), m_small_string(false), m_double_value(0)
+{
+  *this = other;
+}
+
+GRM::Value::Value(GRM::Value &&other) noexcept : m_type(Type::UNDEFINED), m_small_string(false), m_double_value(0)
+{
+  *this = std::move(other);
+}
+
+GRM::Value::~Value()
+{
+  release();
+}
+
+GRM::Value &GRM::Value::operator=(const GRM::Value &other)
+{
+  if (this == &other) return *this;
+  if (other.m_type == Type::STRING)
+    {
+      assignString(other.stringData(), other.stringSize());
+      return *this;
+    }
+  release();
+  m_type = other.m_type;
+  if (m_type == Type::INT)
+    m_int_value = other.m_int_value;
+  else
+    m_double_value = other.m_double_value;
+  return *this;
+}
+
+GRM::Value &GRM::Value::operator=(GRM::Value &&other) noexcept
+{
+  if (this == &other) return *this;
+  release();
+  m_type = other.m_type;
+  m_small_string = other.m_small_string;
+  /* all members of the union are trivially copyable, so the heap string is simply taken over */
+  std::memcpy(m_small_string_value, other.m_small_string_value, sizeof(m_small_string_value));
+  other.m_type = Type::UNDEFINED;
+  other.m_small_string = false;
+  return *this;
+}
+
+const char *GRM::Value::stringData() const
+{
+  return m_small_string ? m_small_string_value : m_heap_string.data;
+}
+
+std::size_t GRM::Value::stringSize() const
+{
+  return m_small_string ? static_cast<unsigned char>(m_small_string_value[small_string_capacity + 1])
+                        : m_heap_string.size;
+}
+
+void GRM::Value::assignString(const char *data, std::size_t size)
+{
+  if (size <= small_string_capacity)
+    {
+      /* `data` may point into this value, so it is copied before the old string is released */
+      char buffer[small_string_capacity + 1];
+      std::memcpy(buffer, data, size);
+      release();
+      std::memcpy(m_small_string_value, buffer, size);
+      m_small_string_value[size] = '\0';
+      m_small_string_value[small_string_capacity + 1] = static_cast<char>(size);
+      m_small_string = true;
+    }
+  else
+    {
+      char *heap_data = new char[size + 1];
+      std::memcpy(heap_data, data, size);
+      heap_data[size] = '\0';
+      release();
+      m_heap_string.data = heap_data;
+      m_heap_string.size = size;
+      m_small_string = false;
+    }
+  m_type = Type::STRING;
+}
+
+void GRM::Value::release()
+{
+  if (m_type == Type::STRING && !m_small_string) delete[] m_heap_string.data;
+  m_type = Type::UNDEFINED;
+  m_small_string = false;
 }
 
 bool GRM::Value::isType(Type type) const
@@ -58,7 +148,7 @@ bool GRM::Value::operator==(const GRM::Value &other) const
     case Type::DOUBLE:
       return m_double_value == other.m_double_value;
     case Type::STRING:
-      return m_string_value == other.m_string_value;
+      return stringSize() == other.stringSize() && std::memcmp(stringData(), other.stringData(), stringSize()) == 0;
     }
   return false;
 }
@@ -74,8 +164,8 @@ GRM::Value::operator int() const
     case Type::STRING:
       {
         char *end = nullptr;
-        long result = std::strtol(m_string_value.c_str(), &end, 10);
-        if (end != m_string_value.c_str() + m_string_value.size())
+        long result = std::strtol(stringData(), &end, 10);
+        if (end != stringData() + stringSize())
           {
             return 0;
           }
@@ -105,8 +195,8 @@ GRM::Value::operator double() const
     case Type::STRING:
       {
         char *end = nullptr;
-        double result = std::strtod(m_string_value.c_str(), &end);
-        if (end == m_string_value.c_str() + m_string_value.size())
+        double result = std::strtod(stringData(), &end);
+        if (end == stringData() + stringSize())
           {
             return result;
           }
@@ -126,7 +216,7 @@ GRM::Value::operator std::string() const
     case Type::DOUBLE:
       return std::to_string(m_double_value);
     case Type::STRING:
-      return m_string_value;
+      return std::string(stringData(), stringSize());
     default:
       return "";
     }
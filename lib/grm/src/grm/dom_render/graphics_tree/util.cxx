@@ -6,6 +6,9 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
 #include "grm/base64_int.h"
 #include "grm/bson_int.h"
 #include "grm/memwriter_int.h"
@@ -301,22 +304,38 @@ bool GRM::Selector::matchElement(
     const GRM::Element &element,
     std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
 {
-  auto element_ptr = std::dynamic_pointer_cast<const Element>(element.shared_from_this()).get();
-  if (match_map.find(std::tuple<const GRM::Element *, const GRM::Selector *>{element_ptr, this}) != match_map.end())
+  if (!isMemoized())
     {
-      return match_map[std::tuple<const GRM::Element *, const GRM::Selector *>{element_ptr, this}];
+      return doMatchElement(element, match_map);
+    }
+  auto key = std::tuple<const GRM::Element *, const GRM::Selector *>{&element, this};
+  auto search = match_map.find(key);
+  if (search != match_map.end())
+    {
+      return search->second;
     }
   bool result = doMatchElement(element, match_map);
-  match_map[std::tuple<const GRM::Element *, const GRM::Selector *>{element_ptr, this}] = result;
+  match_map.emplace(key, result);
   return result;
 }
 
+std::size_t GRM::Selector::maxMatches(const GRM::Document &document) const
+{
+  (void)document;
+  return std::numeric_limits<std::size_t>::max();
+}
+
+bool GRM::Selector::isMemoized() const
+{
+  return true;
+}
+
 /*!
  * Normalize a given vector of doubles so all values sum up to 1.0
  *
  * \param[in] x A vector that should be normalized
  */
-void GRM::normalize_vec(std::vector<double> x, std::vector<double> *normalized_x)
+void GRM::normalize_vec(const std::vector<double> &x, std::vector<double> *normalized_x)
 {
   double sum;
   int n = size(x);
@@ -339,7 +358,7 @@ void GRM::normalize_vec(std::vector<double> x, std::vector<double> *normalized_x
  * All values are converted to unsigned integers. It is guaranteed that
  * the sum of all values is always `sum` (rounding errors are handled).
  */
-void GRM::normalize_vec_int(std::vector<double> x, std::vector<unsigned int> *normalized_x, unsigned int sum)
+void GRM::normalize_vec_int(const std::vector<double> &x, std::vector<unsigned int> *normalized_x, unsigned int sum)
 {
   double sum_x;
   unsigned int actual_sum;
@@ -403,6 +422,13 @@ public:
   {
   }
 
+  bool isMemoized() const override
+  {
+    // only combinators need the match map, a combination of simple selectors is evaluated again instead
+    return std::any_of(m_part_selectors.begin(), m_part_selectors.end(),
+                       [](const std::shared_ptr<Selector> &part_selector) { return part_selector->isMemoized(); });
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -421,6 +447,20 @@ protected:
     return true;
   }
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    if (m_part_selectors.empty())
+      {
+        return 0;
+      }
+    auto max_matches = std::numeric_limits<std::size_t>::max();
+    for (const auto &parsed_selector : m_part_selectors)
+      {
+        max_matches = std::min(max_matches, parsed_selector->maxMatches(document));
+      }
+    return max_matches;
+  }
+
 private:
   std::vector<std::shared_ptr<Selector>> m_part_selectors;
 };
@@ -432,6 +472,12 @@ public:
   {
   }
 
+  bool isMemoized() const override
+  {
+    return std::any_of(m_part_selectors.begin(), m_part_selectors.end(),
+                       [](const std::shared_ptr<Selector> &part_selector) { return part_selector->isMemoized(); });
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -450,6 +496,21 @@ protected:
     return false;
   }
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    std::size_t max_matches = 0;
+    for (const auto &parsed_selector : m_part_selectors)
+      {
+        auto part_max_matches = parsed_selector->maxMatches(document);
+        if (part_max_matches > std::numeric_limits<std::size_t>::max() - max_matches)
+          {
+            return std::numeric_limits<std::size_t>::max();
+          }
+        max_matches += part_max_matches;
+      }
+    return max_matches;
+  }
+
 private:
   std::vector<std::shared_ptr<Selector>> m_part_selectors;
 };
@@ -477,6 +538,11 @@ protected:
     return false;
   }
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    return m_local_selector->maxMatches(document);
+  }
+
 private:
   std::shared_ptr<Selector> m_ancestor_selector;
   std::shared_ptr<Selector> m_local_selector;
@@ -502,6 +568,11 @@ protected:
     return m_parent_selector->matchElement(*parent, match_map) && m_local_selector->matchElement(element, match_map);
   }
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    return m_local_selector->maxMatches(document);
+  }
+
 private:
   std::shared_ptr<Selector> m_parent_selector;
   std::shared_ptr<Selector> m_local_selector;
@@ -535,12 +606,23 @@ protected:
     return false;
   }
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    return m_local_selector->maxMatches(document);
+  }
+
 private:
   std::shared_ptr<Selector> m_sibling_selector;
   std::shared_ptr<Selector> m_local_selector;
 };
 class FalseSelector : public Selector
 {
+public:
+  bool isMemoized() const override
+  {
+    return false;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -551,6 +633,12 @@ protected:
 };
 class RootSelector : public Selector
 {
+public:
+  bool isMemoized() const override
+  {
+    return false;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -714,6 +802,24 @@ class TagSelector : public Selector
 public:
   explicit TagSelector(const std::string &tag_name) : m_local_name(GRM::tolower(tag_name)) {}
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    if (m_local_name.empty())
+      {
+        return 0;
+      }
+    if (m_local_name == "*")
+      {
+        return Selector::maxMatches(document);
+      }
+    return document.elementCountByTagName(m_local_name);
+  }
+
+  bool isMemoized() const override
+  {
+    return false;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -727,42 +833,88 @@ private:
 class HasAttributeSelector : public Selector
 {
 public:
-  explicit HasAttributeSelector(const std::string &attribute_name) : m_attribute_name(GRM::tolower(attribute_name)) {}
+  explicit HasAttributeSelector(const std::string &attribute_name)
+      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_key(m_attribute_name)
+  {
+  }
+
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    return !m_attribute_name.empty() ? document.elementCountByAttribute(m_attribute_key) : 0;
+  }
+
+  bool isMemoized() const override
+  {
+    return false;
+  }
 
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
   {
-    return !m_attribute_name.empty() && element.hasAttribute(m_attribute_name);
+    return !m_attribute_name.empty() && element.hasAttribute(m_attribute_key);
   }
 
 private:
   std::string m_attribute_name;
+  GRM::AttributeKey m_attribute_key;
 };
-class AttributeEqualsSelector : public Selector
+/*!
+ * Common base of the selectors which compare the value of an attribute, e.g. `[name="value"]` or `[name^="value"]`.
+ */
+class AttributeSelector : public Selector
 {
 public:
-  AttributeEqualsSelector(const std::string &attribute_name, std::string attribute_value)
-      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_value(std::move(attribute_value))
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    if (m_attribute_name.empty())
+      {
+        return 0;
+      }
+    // an empty value also matches elements without the attribute
+    if (m_attribute_value.empty())
+      {
+        return Selector::maxMatches(document);
+      }
+    return document.elementCountByAttribute(m_attribute_key);
+  }
+
+  bool isMemoized() const override
   {
+    return false;
   }
 
 protected:
-  bool doMatchElement(const GRM::Element &element,
-                      std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
+  AttributeSelector(const std::string &attribute_name, std::string attribute_value)
+      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_value(std::move(attribute_value)),
+        m_attribute_key(m_attribute_name)
   {
-    return !m_attribute_name.empty() && (std::string)element.getAttribute(m_attribute_name) == m_attribute_value;
   }
 
-private:
   std::string m_attribute_name;
   std::string m_attribute_value;
+  GRM::AttributeKey m_attribute_key;
 };
-class AttributeStartsWithSelector : public Selector
+class AttributeEqualsSelector : public AttributeSelector
+{
+public:
+  AttributeEqualsSelector(const std::string &attribute_name, std::string attribute_value)
+      : AttributeSelector(attribute_name, std::move(attribute_value))
+  {
+  }
+
+protected:
+  bool doMatchElement(const GRM::Element &element,
+                      std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
+  {
+    return !m_attribute_name.empty() && (std::string)element.getAttribute(m_attribute_key) == m_attribute_value;
+  }
+};
+class AttributeStartsWithSelector : public AttributeSelector
 {
 public:
   AttributeStartsWithSelector(const std::string &attribute_name, std::string attribute_value)
-      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_value(std::move(attribute_value))
+      : AttributeSelector(attribute_name, std::move(attribute_value))
   {
   }
 
@@ -771,19 +923,26 @@ protected:
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
   {
     return !m_attribute_name.empty() &&
-           (((std::string)element.getAttribute(m_attribute_name)).find(m_attribute_value) == 0);
+           (((std::string)element.getAttribute(m_attribute_key)).find(m_attribute_value) == 0);
     ;
   }
-
-private:
-  std::string m_attribute_name;
-  std::string m_attribute_value;
 };
 class IDSelector : public Selector
 {
 public:
   explicit IDSelector(const std::string &id) : m_id(GRM::tolower(id)) {}
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    static const GRM::AttributeKey id_key("id");
+    return !m_id.empty() ? document.elementCountByAttribute(id_key) : 0;
+  }
+
+  bool isMemoized() const override
+  {
+    return false;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -794,11 +953,11 @@ protected:
 private:
   std::string m_id;
 };
-class AttributeEndsWithSelector : public Selector
+class AttributeEndsWithSelector : public AttributeSelector
 {
 public:
   AttributeEndsWithSelector(const std::string &attribute_name, std::string attribute_value)
-      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_value(std::move(attribute_value))
+      : AttributeSelector(attribute_name, std::move(attribute_value))
   {
   }
 
@@ -810,21 +969,17 @@ protected:
       {
         return false;
       }
-    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_name);
+    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_key);
     auto attribute_value_position = element_attribute_string.find(m_attribute_value);
     return (attribute_value_position != std::string::npos) &&
            (attribute_value_position == element_attribute_string.size() - m_attribute_value.size());
   }
-
-private:
-  std::string m_attribute_name;
-  std::string m_attribute_value;
 };
-class AttributeContainsSelector : public Selector
+class AttributeContainsSelector : public AttributeSelector
 {
 public:
   AttributeContainsSelector(const std::string &attribute_name, std::string attribute_value)
-      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_value(std::move(attribute_value))
+      : AttributeSelector(attribute_name, std::move(attribute_value))
   {
   }
 
@@ -836,20 +991,16 @@ protected:
       {
         return false;
       }
-    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_name);
+    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_key);
     auto attribute_value_position = element_attribute_string.find(m_attribute_value);
     return (attribute_value_position != std::string::npos);
   }
-
-private:
-  std::string m_attribute_name;
-  std::string m_attribute_value;
 };
-class AttributeContainsWordSelector : public Selector
+class AttributeContainsWordSelector : public AttributeSelector
 {
 public:
   AttributeContainsWordSelector(const std::string &attribute_name, std::string attribute_value)
-      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_value(std::move(attribute_value))
+      : AttributeSelector(attribute_name, std::move(attribute_value))
   {
   }
 
@@ -861,21 +1012,17 @@ protected:
       {
         return false;
       }
-    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_name);
+    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_key);
     auto element_attribute_words = GRM::split(element_attribute_string, " ");
     return (std::find(element_attribute_words.begin(), element_attribute_words.end(), m_attribute_value) !=
             element_attribute_words.end());
   }
-
-private:
-  std::string m_attribute_name;
-  std::string m_attribute_value;
 };
-class AttributeContainsPrefixSelector : public Selector
+class AttributeContainsPrefixSelector : public AttributeSelector
 {
 public:
   AttributeContainsPrefixSelector(const std::string &attribute_name, std::string attribute_value)
-      : m_attribute_name(GRM::tolower(attribute_name)), m_attribute_value(std::move(attribute_value))
+      : AttributeSelector(attribute_name, std::move(attribute_value))
   {
   }
 
@@ -887,7 +1034,7 @@ protected:
       {
         return false;
       }
-    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_name);
+    auto element_attribute_string = (std::string)element.getAttribute(m_attribute_key);
     auto element_attribute_words = GRM::split(element_attribute_string, " ");
     for (const auto &word : element_attribute_words)
       {
@@ -900,16 +1047,23 @@ protected:
       }
     return false;
   }
-
-private:
-  std::string m_attribute_name;
-  std::string m_attribute_value;
 };
 class ClassSelector : public Selector
 {
 public:
   explicit ClassSelector(std::string class_name) : m_class_name(std::move(class_name)) {}
 
+  std::size_t maxMatches(const GRM::Document &document) const override
+  {
+    static const GRM::AttributeKey class_key("class");
+    return !m_class_name.empty() ? document.elementCountByAttribute(class_key) : 0;
+  }
+
+  bool isMemoized() const override
+  {
+    return false;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -1393,3 +1547,25 @@ std::shared_ptr<GRM::Selector> GRM::parseSelectors(const std::string &selectors)
     }
   return std::make_shared<GRM::OrCombinedSelector>(parsed_individual_selectors);
 }
+
+std::shared_ptr<GRM::Selector> GRM::compileSelectors(const std::string &selectors)
+{
+  /* selectors which are built at runtime (e.g. with a changing `_child_id`) would let the cache grow without limit */
+  static const std::size_t max_cache_size = 1024;
+  static std::mutex cache_mutex;
+  static std::unordered_map<std::string, std::shared_ptr<GRM::Selector>> cache;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto search = cache.find(selectors);
+  if (search != cache.end())
+    {
+      return search->second;
+    }
+  if (cache.size() >= max_cache_size)
+    {
+      cache.clear();
+    }
+  auto selector = parseSelectors(selectors);
+  cache.emplace(selectors, selector);
+  return selector;
+}
@@ -10,6 +10,7 @@
 #define _USE_MATH_DEFINES
 
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -68,6 +69,34 @@ ManageGRContextIds gr_context_id_manager;
 ManageZIndex z_index_manager;
 ManageCustomColorIndex custom_color_index_manager;
 
+/* The drawables of every plot are remembered, so they can be pushed to the z-queue again without processing the plot
+ * subtree as long as nothing inside the plot and no context data has been modified since the last pass */
+struct CachedPlot
+{
+  std::vector<std::shared_ptr<Drawable>> drawables;
+  /* segment holding everything which was drawn directly while the plot was processed in a pass which draws to the
+   * workstation, 0 if the plot was last processed without drawing */
+  int segment = 0;
+};
+static std::map<std::shared_ptr<GRM::Element>, CachedPlot> plot_drawable_cache;
+static std::vector<std::shared_ptr<Drawable>> *recorded_drawables = nullptr;
+static bool record_plot_drawables = false;
+static bool reuse_plot_drawables = false;
+static bool ancestor_modified = false;
+static std::size_t rendered_context_modification_count = 0;
+
+/* While drawing, the graphics of every plot are recorded into GKS segments of a WISS workstation: one segment for the
+ * output created while processing the plot and one for each run of consecutive drawables of the plot in the z-queue.
+ * Unmodified plots are replayed with `gr_copysegws` instead of being drawn again. The WISS workstation gets the lowest
+ * workstation id which is not in use when it is opened; the ids of GR's default and print workstations are skipped */
+#define DEFAULT_WKID 1
+#define PRINT_WKID 6
+static int segment_store_wkid = 0;
+static std::map<const Drawable *, const GRM::Element *> drawable_to_plot;
+static std::set<int> recorded_segments;
+static int next_segment = 1;
+static bool segment_store_unavailable = false;
+
 //! This vector is used for storing element types which children get processed. Other types' children will be ignored
 static std::set<std::string> parent_types = {
     "angle_line",
@@ -440,23 +469,23 @@ static bool isUniformData(const std::shared_ptr<GRM::Element> &element, const st
   if (kind == "heatmap" && (!element->hasAttribute("x") || !element->hasAttribute("y")))
     {
       auto z_key = static_cast<std::string>(element->getAttribute("z"));
-      std::vector<double> z_vec = GRM::get<std::vector<double>>((*context)[z_key]);
+      auto z_vec = GRM::get_span<double>((*context)[z_key]);
       if (!element->hasAttribute("x") && !element->hasAttribute("y"))
         {
           auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
-          auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+          auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
           return z_dims_vec[0] == z_dims_vec[1];
         }
       else if (!element->hasAttribute("x"))
         {
           y_key = static_cast<std::string>(element->getAttribute("y"));
-          std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
+          auto y_vec = GRM::get_span<double>((*context)[y_key]);
           return z_vec.size() / y_vec.size() == y_vec.size();
         }
       else if (!element->hasAttribute("y"))
         {
           x_key = static_cast<std::string>(element->getAttribute("x"));
-          std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x_key]);
+          auto x_vec = GRM::get_span<double>((*context)[x_key]);
           return z_vec.size() / x_vec.size() == x_vec.size();
         }
     }
@@ -470,8 +499,8 @@ static bool isUniformData(const std::shared_ptr<GRM::Element> &element, const st
       y_key = static_cast<std::string>(element->getAttribute("y"));
     }
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x_key]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
+  auto x_vec = GRM::get_span<double>((*context)[x_key]);
+  auto y_vec = GRM::get_span<double>((*context)[y_key]);
   return x_vec.size() == y_vec.size();
 }
 
@@ -730,7 +759,7 @@ static void clearOldChildren(del_values *del, const std::shared_ptr<GRM::Element
 static void legendSize(const std::shared_ptr<GRM::Element> &element, double *w, double *h)
 {
   double tbx[4], tby[4];
-  std::vector<std::string> labels;
+  GRM::Span<const std::string> labels;
 
   *w = 0;
   *h = 0;
@@ -739,18 +768,18 @@ static void legendSize(const std::shared_ptr<GRM::Element> &element, double *w,
     {
       auto context = render->getContext();
       auto key = static_cast<std::string>(element->getAttribute("labels"));
-      labels = GRM::get<std::vector<std::string>>((*context)[key]);
+      labels = GRM::get_span<std::string>((*context)[key]);
     }
 
   for (auto current_label : labels)
     {
-      gr_inqtext(0, 0, current_label.data(), tbx, tby);
+      gr_inqtext(0, 0, const_cast<char *>(current_label.c_str()), tbx, tby);
       *w = grm_max(*w, tbx[2] - tbx[0]);
       *h += grm_max(tby[2] - tby[0], 0.03);
     }
 }
 
-static void legendSize(const std::vector<std::string> &labels, double *w, double *h)
+static void legendSize(GRM::Span<const std::string> labels, double *w, double *h)
 {
   double tbx[4], tby[4];
 
@@ -761,7 +790,7 @@ static void legendSize(const std::vector<std::string> &labels, double *w, double
     {
       for (auto current_label : labels)
         {
-          gr_inqtext(0, 0, current_label.data(), tbx, tby);
+          gr_inqtext(0, 0, const_cast<char *>(current_label.c_str()), tbx, tby);
           *w = grm_max(*w, tbx[2] - tbx[0]);
           *h += grm_max(tby[2] - tby[0], 0.03);
         }
@@ -1259,7 +1288,7 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
               if (!uniform_data) break;
             }
           if (kind == "marginal_heatmap" && uniform_data)
-            uniform_data = isUniformData(plot_parent->children()[0], render->getContext());
+            uniform_data = isUniformData(plot_parent->firstChildElement(), render->getContext());
           if (uniform_data)
             {
               double border =
@@ -1398,7 +1427,7 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
               if (!uniform_data) break;
             }
           if (kind == "marginal_heatmap" && uniform_data)
-            uniform_data = isUniformData(plot_parent->children()[0], render->getContext());
+            uniform_data = isUniformData(plot_parent->firstChildElement(), render->getContext());
           if (uniform_data)
             {
               double border =
@@ -1486,7 +1515,7 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
       double scale_factor = 1.0, start_aspect_ratio_ws;
       const std::shared_ptr<GRM::Context> &context = render->getContext();
       std::string kind, labels_key = static_cast<std::string>(element->getAttribute("labels"));
-      auto labels = GRM::get<std::vector<std::string>>((*context)[labels_key]);
+      auto labels = GRM::get_span<std::string>((*context)[labels_key]);
       std::shared_ptr<GRM::Element> central_region;
       bool keep_aspect_ratio = false;
 
@@ -1619,7 +1648,7 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
           h = 0;
           for (auto current_label : labels)
             {
-              gr_inqtext(0, 0, current_label.data(), tbx, tby);
+              gr_inqtext(0, 0, const_cast<char *>(current_label.c_str()), tbx, tby);
               w += tbx[2] - tbx[0];
               h = grm_max(h, tby[2] - tby[0]);
             }
@@ -2017,15 +2046,10 @@ int getVolumeAlgorithm(const std::shared_ptr<GRM::Element> &element)
   return algorithm;
 }
 
-PushDrawableToZQueue::PushDrawableToZQueue(
-    std::function<void(const std::shared_ptr<GRM::Element> &, const std::shared_ptr<GRM::Context> &)> draw_function)
-    : drawFunction(std::move(draw_function))
-{
-  ;
-}
-
-void PushDrawableToZQueue::operator()(const std::shared_ptr<GRM::Element> &element,
-                                      const std::shared_ptr<GRM::Context> &context)
+static void pushDrawableToZQueue(
+    const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context,
+    const std::function<void(const std::shared_ptr<GRM::Element> &, const std::shared_ptr<GRM::Context> &)>
+        &draw_function)
 {
   int context_id;
   auto parent = element->parentElement();
@@ -2040,10 +2064,24 @@ void PushDrawableToZQueue::operator()(const std::shared_ptr<GRM::Element> &eleme
       gr_savecontext(context_id);
       parent_to_context[parent] = context_id;
     }
-  auto drawable = std::make_shared<Drawable>(element, context, context_id, z_index_manager.getZIndex(), drawFunction);
+  auto drawable = std::make_shared<Drawable>(element, context, context_id, z_index_manager.getZIndex(), draw_function);
   drawable->insertionIndex = (int)z_queue.size();
   custom_color_index_manager.savecontext(context_id);
   z_queue.push(drawable);
+  if (recorded_drawables) recorded_drawables->push_back(drawable);
+}
+
+PushDrawableToZQueue::PushDrawableToZQueue(
+    std::function<void(const std::shared_ptr<GRM::Element> &, const std::shared_ptr<GRM::Context> &)> draw_function)
+    : drawFunction(std::move(draw_function))
+{
+  ;
+}
+
+void PushDrawableToZQueue::operator()(const std::shared_ptr<GRM::Element> &element,
+                                      const std::shared_ptr<GRM::Context> &context)
+{
+  pushDrawableToZQueue(element, context, drawFunction);
 }
 
 static double autoTick(double min, double max)
@@ -2173,8 +2211,8 @@ static void markerHelper(const std::shared_ptr<GRM::Element> &element, const std
    * \param[in] str The std::string that specifies what GRM Routine should be called (polymarker)
    *
    */
-  std::vector<int> type, color_ind;
-  std::vector<double> size;
+  GRM::Span<const int> type, color_ind;
+  GRM::Span<const double> size;
   std::string x_key, y_key, z_key;
   int skip_color_ind = -1000;
   auto parent = element->parentElement();
@@ -2183,42 +2221,42 @@ static void markerHelper(const std::shared_ptr<GRM::Element> &element, const std
 
   if (attr.isString())
     {
-      type = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+      type = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
     }
   else if (group)
     {
       attr = parent->getAttribute("marker_types");
       if (attr.isString())
         {
-          type = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+          type = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
         }
     }
 
   attr = element->getAttribute("marker_color_indices");
   if (attr.isString())
     {
-      color_ind = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+      color_ind = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
     }
   else if (group)
     {
       attr = parent->getAttribute("marker_color_indices");
       if (attr.isString())
         {
-          color_ind = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+          color_ind = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
         }
     }
 
   attr = element->getAttribute("marker_sizes");
   if (attr.isString())
     {
-      size = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(attr)]);
+      size = GRM::get_span<double>((*context)[static_cast<std::string>(attr)]);
     }
   else if (group)
     {
       attr = parent->getAttribute("marker_sizes");
       if (attr.isString())
         {
-          size = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(attr)]);
+          size = GRM::get_span<double>((*context)[static_cast<std::string>(attr)]);
         }
     }
 
@@ -2226,10 +2264,10 @@ static void markerHelper(const std::shared_ptr<GRM::Element> &element, const std
   y_key = static_cast<std::string>(element->getAttribute("y"));
   if (element->hasAttribute("z")) z_key = static_cast<std::string>(element->getAttribute("z"));
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x_key]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
-  std::vector<double> z_vec;
-  if (auto z_ptr = GRM::get_if<std::vector<double>>((*context)[z_key])) z_vec = *z_ptr;
+  auto x_vec = GRM::get_span<double>((*context)[x_key]);
+  auto y_vec = GRM::get_span<double>((*context)[y_key]);
+  GRM::Span<const double> z_vec;
+  if (auto z_ptr = GRM::get_if<std::vector<double>>(std::as_const(*context)[z_key])) z_vec = *z_ptr;
 
   auto n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
 
@@ -2281,11 +2319,13 @@ static void markerHelper(const std::shared_ptr<GRM::Element> &element, const std
       applyMoveTransformation(element);
       if (str == "polymarker")
         {
-          if (redraw_ws) gr_polymarker(1, (double *)&(x_vec[i]), (double *)&(y_vec[i]));
+          if (redraw_ws) gr_polymarker(1, const_cast<double *>(&x_vec[i]), const_cast<double *>(&y_vec[i]));
         }
       else if (str == "polymarker_3d")
         {
-          if (redraw_ws) gr_polymarker3d(1, (double *)&(x_vec[i]), (double *)&(y_vec[i]), (double *)&(z_vec[i]));
+          if (redraw_ws)
+            gr_polymarker3d(1, const_cast<double *>(&x_vec[i]), const_cast<double *>(&y_vec[i]),
+                            const_cast<double *>(&z_vec[i]));
         }
     }
 }
@@ -2302,8 +2342,8 @@ static void lineHelper(const std::shared_ptr<GRM::Element> &element, const std::
    *
    *
    */
-  std::vector<int> type, color_ind;
-  std::vector<double> width;
+  GRM::Span<const int> type, color_ind;
+  GRM::Span<const double> width;
   std::string x_key, y_key, z_key;
 
   auto parent = element->parentElement();
@@ -2312,42 +2352,42 @@ static void lineHelper(const std::shared_ptr<GRM::Element> &element, const std::
   auto attr = element->getAttribute("line_types");
   if (attr.isString())
     {
-      type = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+      type = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
     }
   else if (group)
     {
       attr = parent->getAttribute("line_types");
       if (attr.isString())
         {
-          type = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+          type = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
         }
     }
 
   attr = element->getAttribute("line_color_indices");
   if (attr.isString())
     {
-      color_ind = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+      color_ind = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
     }
   else if (group)
     {
       attr = parent->getAttribute("line_color_indices");
       if (attr.isString())
         {
-          color_ind = GRM::get<std::vector<int>>((*context)[static_cast<std::string>(attr)]);
+          color_ind = GRM::get_span<int>((*context)[static_cast<std::string>(attr)]);
         }
     }
 
   attr = element->getAttribute("line_widths");
   if (attr.isString())
     {
-      width = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(attr)]);
+      width = GRM::get_span<double>((*context)[static_cast<std::string>(attr)]);
     }
   else if (group)
     {
       attr = parent->getAttribute("line_widths");
       if (attr.isString())
         {
-          width = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(attr)]);
+          width = GRM::get_span<double>((*context)[static_cast<std::string>(attr)]);
         }
     }
 
@@ -2355,11 +2395,11 @@ static void lineHelper(const std::shared_ptr<GRM::Element> &element, const std::
   y_key = static_cast<std::string>(element->getAttribute("y"));
   if (element->hasAttribute("z")) z_key = static_cast<std::string>(element->getAttribute("z"));
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x_key]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
-  std::vector<double> z_vec;
+  auto x_vec = GRM::get_span<double>((*context)[x_key]);
+  auto y_vec = GRM::get_span<double>((*context)[y_key]);
+  GRM::Span<const double> z_vec;
 
-  if (auto z_ptr = GRM::get_if<std::vector<double>>((*context)[z_key])) z_vec = *z_ptr;
+  if (auto z_ptr = GRM::get_if<std::vector<double>>(std::as_const(*context)[z_key])) z_vec = *z_ptr;
 
   auto n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
   for (int i = 0; i < n; ++i)
@@ -2401,11 +2441,13 @@ static void lineHelper(const std::shared_ptr<GRM::Element> &element, const std::
       applyMoveTransformation(element);
       if (str == "polyline")
         {
-          if (redraw_ws) gr_polyline(2, (double *)&(x_vec[i]), (double *)&(y_vec[i]));
+          if (redraw_ws) gr_polyline(2, const_cast<double *>(&x_vec[i]), const_cast<double *>(&y_vec[i]));
         }
       else if (str == "polyline_3d")
         {
-          if (redraw_ws) gr_polyline3d(2, (double *)&(x_vec[i]), (double *)&(y_vec[i]), (double *)&(z_vec[i]));
+          if (redraw_ws)
+            gr_polyline3d(2, const_cast<double *>(&x_vec[i]), const_cast<double *>(&y_vec[i]),
+                          const_cast<double *>(&z_vec[i]));
         }
     }
 }
@@ -2474,7 +2516,7 @@ static void getTickSize(const std::shared_ptr<GRM::Element> &element, double &ti
               if (!uniform_data) break;
             }
           if (kind == "marginal_heatmap" && uniform_data)
-            uniform_data = isUniformData(plot_parent->children()[0], render->getContext());
+            uniform_data = isUniformData(plot_parent->firstChildElement(), render->getContext());
         }
 
       if ((keep_aspect_ratio && uniform_data && only_quadratic_aspect_ratio) || !keep_aspect_ratio)
@@ -2497,7 +2539,7 @@ static void getTickSize(const std::shared_ptr<GRM::Element> &element, double &ti
           auto kind = static_cast<std::string>(plot_parent->getAttribute("_kind"));
 
           central_region_parent = plot_parent;
-          if (kind == "marginal_heatmap") central_region_parent = plot_parent->children()[0];
+          if (kind == "marginal_heatmap") central_region_parent = plot_parent->firstChildElement();
           for (const auto &child : central_region_parent->children())
             {
               if (child->localName() == "central_region")
@@ -2538,7 +2580,7 @@ static void getTickSize(const std::shared_ptr<GRM::Element> &element, double &ti
       auto kind = static_cast<std::string>(plot_element->getAttribute("_kind"));
 
       central_region_parent = plot_element;
-      if (kind == "marginal_heatmap") central_region_parent = plot_element->children()[0];
+      if (kind == "marginal_heatmap") central_region_parent = plot_element->firstChildElement();
       for (const auto &child : central_region_parent->children())
         {
           if (child->localName() == "central_region")
@@ -2593,7 +2635,7 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
   auto kind = static_cast<std::string>(plot_element->getAttribute("_kind"));
 
   central_region_parent = plot_element;
-  if (kind == "marginal_heatmap") central_region_parent = plot_element->children()[0];
+  if (kind == "marginal_heatmap") central_region_parent = plot_element->firstChildElement();
   for (const auto &child : central_region_parent->children())
     {
       if (child->localName() == "central_region")
@@ -2631,8 +2673,8 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
               for (const auto &barplot : barplots)
                 {
                   auto y_key = static_cast<std::string>(barplot->getAttribute("y"));
-                  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
-                  if (size(y_vec) > 20 || xmax - xmin > 20) // 20 based on the looking of the resulting plots
+                  auto y_vec = GRM::get_span<double>((*context)[y_key]);
+                  if (y_vec.size() > 20 || xmax - xmin > 20) // 20 based on the looking of the resulting plots
                     {
                       problematic_bar_num = true;
                       break;
@@ -3019,7 +3061,7 @@ static bool getLimitsForColorbar(const std::shared_ptr<GRM::Element> &element, d
   return limits_found;
 }
 
-static double findMaxStep(unsigned int n, std::vector<double> x)
+static double findMaxStep(unsigned int n, GRM::Span<const double> x)
 {
   double max_step = 0.0;
   unsigned int i;
@@ -3516,7 +3558,8 @@ static void processFont(const std::shared_ptr<GRM::Element> &element)
 static void processIntegral(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
 {
   double int_lim_low = 0, int_lim_high;
-  std::vector<double> x_vec, y_vec, f1, f2;
+  std::vector<double> f1, f2;
+  GRM::Span<const double> x_vec, y_vec;
   int x_length;
   del_values del = del_values::update_without_default;
   int child_id = 0, id, i;
@@ -3570,10 +3613,10 @@ static void processIntegral(const std::shared_ptr<GRM::Element> &element, const
     }
 
   auto y = static_cast<std::string>(series_element->getAttribute("y"));
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  y_vec = GRM::get_span<double>((*context)[y]);
 
   auto x = static_cast<std::string>(series_element->getAttribute("x"));
-  x_vec = GRM::get<std::vector<double>>((*context)[x]);
+  x_vec = GRM::get_span<double>((*context)[x]);
   x_length = static_cast<int>(x_vec.size());
 
   /* get all points for the fill area from the current line */
@@ -3699,7 +3742,7 @@ static void processIntegral(const std::shared_ptr<GRM::Element> &element, const
 static void processIntegralGroup(const std::shared_ptr<GRM::Element> &element,
                                  const std::shared_ptr<GRM::Context> &context)
 {
-  std::vector<double> int_limits_high_vec, int_limits_low_vec;
+  GRM::Span<const double> int_limits_high_vec, int_limits_low_vec;
   int limits_high_num = 0, limits_low_num = 0;
   del_values del = del_values::update_without_default;
   int child_id = 0;
@@ -3712,12 +3755,12 @@ static void processIntegralGroup(const std::shared_ptr<GRM::Element> &element,
   /* the following 2 attributes are required, so they must be set */
   if (!element->hasAttribute("int_limits_high")) throw NotFoundError("Missing required attribute int_limits_high");
   auto limits_high_key = static_cast<std::string>(element->getAttribute("int_limits_high"));
-  int_limits_high_vec = GRM::get<std::vector<double>>((*context)[limits_high_key]);
+  int_limits_high_vec = GRM::get_span<double>((*context)[limits_high_key]);
   limits_high_num = (int)int_limits_high_vec.size();
 
   if (!element->hasAttribute("int_limits_low")) throw NotFoundError("Missing required attribute int_limits_low");
   auto limits_low_key = static_cast<std::string>(element->getAttribute("int_limits_low"));
-  int_limits_low_vec = GRM::get<std::vector<double>>((*context)[limits_low_key]);
+  int_limits_low_vec = GRM::get_span<double>((*context)[limits_low_key]);
   limits_low_num = (int)int_limits_low_vec.size();
 
   if (limits_low_num != limits_high_num) throw std::length_error("Both limits must have the same number of arguments");
@@ -3785,10 +3828,10 @@ static void processMarginalHeatmapKind(const std::shared_ptr<GRM::Element> &elem
               auto ymin = static_cast<double>(element->getAttribute("y_range_min"));
               auto ymax = static_cast<double>(element->getAttribute("y_range_max"));
 
-              auto z = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(element->getAttribute("z"))]);
-              auto y = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(element->getAttribute("y"))]);
-              auto xi = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(series->getAttribute("xi"))]);
-              auto x = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(element->getAttribute("x"))]);
+              auto z = GRM::get_span<double>((*context)[static_cast<std::string>(element->getAttribute("z"))]);
+              auto y = GRM::get_copy<double>((*context)[static_cast<std::string>(element->getAttribute("y"))]);
+              auto xi = GRM::get_copy<double>((*context)[static_cast<std::string>(series->getAttribute("xi"))]);
+              auto x = GRM::get_span<double>((*context)[static_cast<std::string>(element->getAttribute("x"))]);
               auto y_length = (int)y.size();
               auto x_length = (int)xi.size();
 
@@ -4371,7 +4414,7 @@ static void processRelativeCharHeight(const std::shared_ptr<GRM::Element> &eleme
           if (!uniform_data) break;
         }
       if (kind == "marginal_heatmap" && uniform_data)
-        uniform_data = isUniformData(plot_element->children()[0], render->getContext());
+        uniform_data = isUniformData(plot_element->firstChildElement(), render->getContext());
       if (uniform_data)
         {
           double border =
@@ -5134,7 +5177,7 @@ void GRM::Render::calculateCharHeight(const std::shared_ptr<GRM::Element> &eleme
           if (!uniform_data) break;
         }
       if (kind == "marginal_heatmap" && uniform_data)
-        uniform_data = isUniformData(plot_parent->children()[0], render->getContext());
+        uniform_data = isUniformData(plot_parent->firstChildElement(), render->getContext());
       if (uniform_data)
         {
           double border =
@@ -5315,8 +5358,25 @@ void GRM::Render::processAttributes(const std::shared_ptr<GRM::Element> &element
           {std::string("colorrep"), processColorRep},
       };
 
-  for (const auto &attribute : element->getAttributeNames())
+  /* the handlers are looked up by interned attribute keys, so the attribute names of every element which is processed
+   * don't have to be copied and hashed */
+  using AttributeHandler = std::function<void(const std::shared_ptr<GRM::Element> &)>;
+  static const auto toKeyMap = [](const std::map<std::string, AttributeHandler> &handlers) {
+    std::unordered_map<GRM::AttributeKey, AttributeHandler> key_map;
+    for (const auto &entry : handlers) key_map.emplace(GRM::AttributeKey(entry.first), entry.second);
+    return key_map;
+  };
+  static const auto keyToFunc = toKeyMap(attrStringToFunc);
+  static const auto keyToFuncPost = toKeyMap(attrStringToFuncPost);
+
+  for (const auto &key : element->getAttributeKeys())
     {
+      if (auto search = keyToFunc.find(key); search != keyToFunc.end())
+        {
+          search->second(element);
+          continue;
+        }
+      const auto &attribute = key.name();
       auto start = 0U;
       auto end = attribute.find('.');
       if (end != std::string::npos) /* element can hold more than one attribute of this kind */
@@ -5325,15 +5385,11 @@ void GRM::Render::processAttributes(const std::shared_ptr<GRM::Element> &element
           if (multiAttrStringToFunc.find(attributeKind) != multiAttrStringToFunc.end())
             multiAttrStringToFunc[attributeKind](element, attribute);
         }
-      else if (attrStringToFunc.find(attribute) != attrStringToFunc.end())
-        {
-          attrStringToFunc[attribute](element);
-        }
     }
 
-  for (auto &attribute : element->getAttributeNames()) // Post process attribute run
+  for (const auto &key : element->getAttributeKeys()) // Post process attribute run
     {
-      if (attrStringToFuncPost.find(attribute) != attrStringToFuncPost.end()) attrStringToFuncPost[attribute](element);
+      if (auto search = keyToFuncPost.find(key); search != keyToFuncPost.end()) search->second(element);
     }
 }
 
@@ -5352,7 +5408,7 @@ static void drawYLine(const std::shared_ptr<GRM::Element> &element, const std::s
   auto kind = static_cast<std::string>(plot_element->getAttribute("_kind"));
 
   central_region_parent = plot_element;
-  if (kind == "marginal_heatmap") central_region_parent = plot_element->children()[0];
+  if (kind == "marginal_heatmap") central_region_parent = plot_element->firstChildElement();
   for (const auto &child : central_region_parent->children())
     {
       if (child->localName() == "central_region")
@@ -5500,7 +5556,7 @@ static void processCellArray(const std::shared_ptr<GRM::Element> &element, const
   applyMoveTransformation(element);
   if (redraw_ws)
     gr_cellarray(xmin, xmax, ymin, ymax, dimx, dimy, scol, srow, ncol, nrow,
-                 (int *)&(GRM::get<std::vector<int>>((*context)[color])[0]));
+                 const_cast<int *>(GRM::get_span<int>((*context)[color]).data()));
 }
 
 static void processColorbar(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
@@ -5749,9 +5805,10 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
    */
 
   /* plot level */
+  static const double unset_color_rgb[3] = {-1, -1, -1};
   int bar_color = 989, edge_color = 1;
-  std::vector<double> bar_color_rgb = {-1, -1, -1};
-  std::vector<double> edge_color_rgb = {-1, -1, -1};
+  GRM::Span<const double> bar_color_rgb(unset_color_rgb, 3);
+  GRM::Span<const double> edge_color_rgb(unset_color_rgb, 3);
   double bar_width = 0.8, edge_width = 1.0, bar_shift = 1;
   std::string style = "default", orientation = PLOT_DEFAULT_ORIENTATION, line_spec = SERIES_DEFAULT_SPEC;
   double wfac;
@@ -5763,9 +5820,9 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
 
   /* series level */
   unsigned int y_length, c_length, c_rgb_length;
-  std::vector<int> c;
-  std::vector<double> c_rgb;
-  std::vector<std::string> ylabels;
+  GRM::Span<const int> c;
+  GRM::Span<const double> c_rgb;
+  GRM::Span<const std::string> ylabels;
   unsigned int ylabels_left = 0, ylabels_length = 0;
   /* style variance */
   double pos_vertical_change = 0, neg_vertical_change = 0;
@@ -5795,7 +5852,7 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
   if (element->hasAttribute("fill_color_rgb"))
     {
       auto bar_color_rgb_key = static_cast<std::string>(element->getAttribute("fill_color_rgb"));
-      bar_color_rgb = GRM::get<std::vector<double>>((*context)[bar_color_rgb_key]);
+      bar_color_rgb = GRM::get_span<double>((*context)[bar_color_rgb_key]);
     }
   if (element->hasAttribute("bar_width")) bar_width = static_cast<double>(element->getAttribute("bar_width"));
   if (element->hasAttribute("style"))
@@ -5830,21 +5887,21 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
   if (!element->hasAttribute("y")) throw NotFoundError("Barplot series is missing y.\n");
 
   auto y_key = static_cast<std::string>(element->getAttribute("y"));
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
-  y_length = size(y_vec);
+  auto y_vec = GRM::get_span<double>((*context)[y_key]);
+  y_length = y_vec.size();
 
   if (!element->hasAttribute("indices")) throw NotFoundError("Barplot series is missing indices\n");
   auto indices = static_cast<std::string>(element->getAttribute("indices"));
-  std::vector<int> indices_vec = GRM::get<std::vector<int>>((*context)[indices]);
+  auto indices_vec = GRM::get_span<int>((*context)[indices]);
 
-  inner_series = size(indices_vec) != y_length;
+  inner_series = indices_vec.size() != y_length;
 
   wfac = 0.9 * bar_width;
 
   if (element->hasAttribute("line_color_rgb"))
     {
       auto edge_color_rgb_key = static_cast<std::string>(element->getAttribute("line_color_rgb"));
-      edge_color_rgb = GRM::get<std::vector<double>>((*context)[edge_color_rgb_key]);
+      edge_color_rgb = GRM::get_span<double>((*context)[edge_color_rgb_key]);
     }
   if (element->hasAttribute("line_color_ind")) edge_color = static_cast<int>(element->getAttribute("line_color_ind"));
   if (element->hasAttribute("edge_width")) edge_width = static_cast<double>(element->getAttribute("edge_width"));
@@ -5863,19 +5920,19 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
   if (element->hasAttribute("color_ind_values"))
     {
       auto c_key = static_cast<std::string>(element->getAttribute("color_ind_values"));
-      c = GRM::get<std::vector<int>>((*context)[c_key]);
-      c_length = size(c);
+      c = GRM::get_span<int>((*context)[c_key]);
+      c_length = c.size();
     }
   if (element->hasAttribute("color_rgb_values"))
     {
       auto c_rgb_key = static_cast<std::string>(element->getAttribute("color_rgb_values"));
-      c_rgb = GRM::get<std::vector<double>>((*context)[c_rgb_key]);
-      c_rgb_length = size(c_rgb);
+      c_rgb = GRM::get_span<double>((*context)[c_rgb_key]);
+      c_rgb_length = c_rgb.size();
     }
   if (element->hasAttribute("y_labels"))
     {
       auto ylabels_key = static_cast<std::string>(element->getAttribute("y_labels"));
-      ylabels = GRM::get<std::vector<std::string>>((*context)[ylabels_key]);
+      ylabels = GRM::get_span<std::string>((*context)[ylabels_key]);
       ylabels_length = size(ylabels);
 
       ylabels_left = ylabels_length;
@@ -5916,7 +5973,7 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
             {
               inner_c = true;
             }
-          else if (c_length != size(indices_vec))
+          else if (c_length != indices_vec.size())
             {
               throw std::length_error("For a barplot series c_length must be >= y_length.\n");
             }
@@ -5932,7 +5989,7 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
             {
               inner_c_rgb = true;
             }
-          else if (c_rgb_length != size(indices_vec) * 3)
+          else if (c_rgb_length != indices_vec.size() * 3)
             {
               throw std::length_error("For a barplot series c_rgb_length must be >= y_length * 3\n");
             }
@@ -6086,7 +6143,7 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
 
       int inner_y_start_index = 0;
       /* Draw inner_series */
-      for (int inner_series_index = 0; inner_series_index < size(indices_vec); inner_series_index++)
+      for (int inner_series_index = 0; inner_series_index < (int)indices_vec.size(); inner_series_index++)
         {
           /* Draw bars from inner_series */
           int inner_y_length = indices_vec[inner_series_index];
@@ -6207,7 +6264,7 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
                 }
               bar_centers.push_back((x1 + x2) / 2.0);
             }
-          extendErrorBars(child, context, bar_centers, y_vec);
+          extendErrorBars(child, context, bar_centers, GRM::get_copy<double>((*context)[y_key]));
         }
     }
 }
@@ -6224,8 +6281,8 @@ static void processContour(const std::shared_ptr<GRM::Element> &element, const s
   int num_levels = PLOT_DEFAULT_CONTOUR_LEVELS;
   int i;
   unsigned int x_length, y_length, z_length;
-  std::vector<double> x_vec, y_vec, z_vec;
-  std::vector<double> px_vec, py_vec, pz_vec;
+  GRM::Span<const double> x_vec, y_vec, z_vec;
+  GRM::Span<const double> px_vec, py_vec, pz_vec;
   int major_h = PLOT_DEFAULT_CONTOUR_MAJOR_H;
   auto plot_parent = element->parentElement();
   getPlotParent(plot_parent);
@@ -6260,9 +6317,9 @@ static void processContour(const std::shared_ptr<GRM::Element> &element, const s
       if (!element->hasAttribute("z")) throw NotFoundError("Contour series is missing required attribute z-data.\n");
       auto z = static_cast<std::string>(element->getAttribute("z"));
 
-      x_vec = GRM::get<std::vector<double>>((*context)[x]);
-      y_vec = GRM::get<std::vector<double>>((*context)[y]);
-      z_vec = GRM::get<std::vector<double>>((*context)[z]);
+      x_vec = GRM::get_span<double>((*context)[x]);
+      y_vec = GRM::get_span<double>((*context)[y]);
+      z_vec = GRM::get_span<double>((*context)[z]);
       x_length = x_vec.size();
       y_length = y_vec.size();
       z_length = z_vec.size();
@@ -6280,9 +6337,9 @@ static void processContour(const std::shared_ptr<GRM::Element> &element, const s
           double *gridit_x = &(gridit_x_vec[0]);
           double *gridit_y = &(gridit_y_vec[0]);
           double *gridit_z = &(gridit_z_vec[0]);
-          double *x_p = &(x_vec[0]);
-          double *y_p = &(y_vec[0]);
-          double *z_p = &(z_vec[0]);
+          double *x_p = const_cast<double *>(x_vec.data());
+          double *y_p = const_cast<double *>(y_vec.data());
+          double *z_p = const_cast<double *>(z_vec.data());
 
           gr_gridit((int)x_length, x_p, y_p, z_p, PLOT_CONTOUR_GRIDIT_N, PLOT_CONTOUR_GRIDIT_N, gridit_x, gridit_y,
                     gridit_z);
@@ -6298,37 +6355,32 @@ static void processContour(const std::shared_ptr<GRM::Element> &element, const s
                                   90); // not plot_parent because it should be now on central_region
           processSpace(element->parentElement());
 
-          px_vec = std::vector<double>(gridit_x, gridit_x + PLOT_CONTOUR_GRIDIT_N);
-          py_vec = std::vector<double>(gridit_y, gridit_y + PLOT_CONTOUR_GRIDIT_N);
-          pz_vec = std::vector<double>(gridit_z, gridit_z + PLOT_CONTOUR_GRIDIT_N * PLOT_CONTOUR_GRIDIT_N);
+          (*context)["px" + str] = std::vector<double>(gridit_x, gridit_x + PLOT_CONTOUR_GRIDIT_N);
+          (*context)["py" + str] = std::vector<double>(gridit_y, gridit_y + PLOT_CONTOUR_GRIDIT_N);
+          (*context)["pz" + str] =
+              std::vector<double>(gridit_z, gridit_z + PLOT_CONTOUR_GRIDIT_N * PLOT_CONTOUR_GRIDIT_N);
         }
       else
         {
           if (x_length * y_length != z_length)
             throw std::length_error("For contour series x_length * y_length must be z_length.\n");
 
-          px_vec = x_vec;
-          py_vec = y_vec;
-          pz_vec = z_vec;
+          (*context)["px" + str] = GRM::get_copy<double>((*context)[x]);
+          (*context)["py" + str] = GRM::get_copy<double>((*context)[y]);
+          (*context)["pz" + str] = GRM::get_copy<double>((*context)[z]);
         }
 
-      (*context)["px" + str] = px_vec;
       element->setAttribute("px", "px" + str);
-      (*context)["py" + str] = py_vec;
       element->setAttribute("py", "py" + str);
-      (*context)["pz" + str] = pz_vec;
       element->setAttribute("pz", "pz" + str);
     }
-  else
-    {
-      auto px = static_cast<std::string>(element->getAttribute("px"));
-      auto py = static_cast<std::string>(element->getAttribute("py"));
-      auto pz = static_cast<std::string>(element->getAttribute("pz"));
+  auto px = static_cast<std::string>(element->getAttribute("px"));
+  auto py = static_cast<std::string>(element->getAttribute("py"));
+  auto pz = static_cast<std::string>(element->getAttribute("pz"));
 
-      px_vec = GRM::get<std::vector<double>>((*context)[px]);
-      py_vec = GRM::get<std::vector<double>>((*context)[py]);
-      pz_vec = GRM::get<std::vector<double>>((*context)[pz]);
-    }
+  px_vec = GRM::get_span<double>((*context)[px]);
+  py_vec = GRM::get_span<double>((*context)[py]);
+  pz_vec = GRM::get_span<double>((*context)[pz]);
 
   for (i = 0; i < num_levels; ++i)
     {
@@ -6338,10 +6390,10 @@ static void processContour(const std::shared_ptr<GRM::Element> &element, const s
   auto nx = (int)px_vec.size();
   auto ny = (int)py_vec.size();
 
-  double *px_p = &(px_vec[0]);
-  double *py_p = &(py_vec[0]);
+  double *px_p = const_cast<double *>(px_vec.data());
+  double *py_p = const_cast<double *>(py_vec.data());
   double *h_p = &(h[0]);
-  double *pz_p = &(pz_vec[0]);
+  double *pz_p = const_cast<double *>(pz_vec.data());
   applyMoveTransformation(element);
 
   if (redraw_ws) gr_contour(nx, ny, num_levels, px_p, py_p, h_p, pz_p, major_h);
@@ -6359,8 +6411,8 @@ static void processContourf(const std::shared_ptr<GRM::Element> &element, const
   int num_levels = PLOT_DEFAULT_CONTOUR_LEVELS;
   int i;
   unsigned int x_length, y_length, z_length;
-  std::vector<double> x_vec, y_vec, z_vec;
-  std::vector<double> px_vec, py_vec, pz_vec;
+  GRM::Span<const double> x_vec, y_vec, z_vec;
+  GRM::Span<const double> px_vec, py_vec, pz_vec;
   int major_h = PLOT_DEFAULT_CONTOURF_MAJOR_H;
   auto plot_parent = element->parentElement();
   getPlotParent(plot_parent);
@@ -6395,9 +6447,9 @@ static void processContourf(const std::shared_ptr<GRM::Element> &element, const
       if (!element->hasAttribute("z")) throw NotFoundError("Contourf series is missing required attribute z-data.\n");
       auto z = static_cast<std::string>(element->getAttribute("z"));
 
-      x_vec = GRM::get<std::vector<double>>((*context)[x]);
-      y_vec = GRM::get<std::vector<double>>((*context)[y]);
-      z_vec = GRM::get<std::vector<double>>((*context)[z]);
+      x_vec = GRM::get_span<double>((*context)[x]);
+      y_vec = GRM::get_span<double>((*context)[y]);
+      z_vec = GRM::get_span<double>((*context)[z]);
       x_length = x_vec.size();
       y_length = y_vec.size();
       z_length = z_vec.size();
@@ -6418,9 +6470,9 @@ static void processContourf(const std::shared_ptr<GRM::Element> &element, const
           double *gridit_x = &(gridit_x_vec[0]);
           double *gridit_y = &(gridit_y_vec[0]);
           double *gridit_z = &(gridit_z_vec[0]);
-          double *x_p = &(x_vec[0]);
-          double *y_p = &(y_vec[0]);
-          double *z_p = &(z_vec[0]);
+          double *x_p = const_cast<double *>(x_vec.data());
+          double *y_p = const_cast<double *>(y_vec.data());
+          double *z_p = const_cast<double *>(z_vec.data());
 
           gr_gridit((int)x_length, x_p, y_p, z_p, PLOT_CONTOUR_GRIDIT_N, PLOT_CONTOUR_GRIDIT_N, gridit_x, gridit_y,
                     gridit_z);
@@ -6436,9 +6488,10 @@ static void processContourf(const std::shared_ptr<GRM::Element> &element, const
           global_render->setSpace(element->parentElement(), z_min, z_max, 0, 90); // central_region
           processSpace(element->parentElement());
 
-          px_vec = std::vector<double>(gridit_x, gridit_x + PLOT_CONTOUR_GRIDIT_N);
-          py_vec = std::vector<double>(gridit_y, gridit_y + PLOT_CONTOUR_GRIDIT_N);
-          pz_vec = std::vector<double>(gridit_z, gridit_z + PLOT_CONTOUR_GRIDIT_N * PLOT_CONTOUR_GRIDIT_N);
+          (*context)["px" + str] = std::vector<double>(gridit_x, gridit_x + PLOT_CONTOUR_GRIDIT_N);
+          (*context)["py" + str] = std::vector<double>(gridit_y, gridit_y + PLOT_CONTOUR_GRIDIT_N);
+          (*context)["pz" + str] =
+              std::vector<double>(gridit_z, gridit_z + PLOT_CONTOUR_GRIDIT_N * PLOT_CONTOUR_GRIDIT_N);
         }
       else
         {
@@ -6447,29 +6500,23 @@ static void processContourf(const std::shared_ptr<GRM::Element> &element, const
 
           global_render->setLineColorInd(element, 989);
 
-          px_vec = x_vec;
-          py_vec = y_vec;
-          pz_vec = z_vec;
+          (*context)["px" + str] = GRM::get_copy<double>((*context)[x]);
+          (*context)["py" + str] = GRM::get_copy<double>((*context)[y]);
+          (*context)["pz" + str] = GRM::get_copy<double>((*context)[z]);
         }
 
-      (*context)["px" + str] = px_vec;
       element->setAttribute("px", "px" + str);
-      (*context)["py" + str] = py_vec;
       element->setAttribute("py", "py" + str);
-      (*context)["pz" + str] = pz_vec;
       element->setAttribute("pz", "pz" + str);
       processLineColorInd(element);
     }
-  else
-    {
-      auto px = static_cast<std::string>(element->getAttribute("px"));
-      auto py = static_cast<std::string>(element->getAttribute("py"));
-      auto pz = static_cast<std::string>(element->getAttribute("pz"));
+  auto px = static_cast<std::string>(element->getAttribute("px"));
+  auto py = static_cast<std::string>(element->getAttribute("py"));
+  auto pz = static_cast<std::string>(element->getAttribute("pz"));
 
-      px_vec = GRM::get<std::vector<double>>((*context)[px]);
-      py_vec = GRM::get<std::vector<double>>((*context)[py]);
-      pz_vec = GRM::get<std::vector<double>>((*context)[pz]);
-    }
+  px_vec = GRM::get_span<double>((*context)[px]);
+  py_vec = GRM::get_span<double>((*context)[py]);
+  pz_vec = GRM::get_span<double>((*context)[pz]);
 
   for (i = 0; i < num_levels; ++i)
     {
@@ -6479,10 +6526,10 @@ static void processContourf(const std::shared_ptr<GRM::Element> &element, const
   auto nx = (int)px_vec.size();
   auto ny = (int)py_vec.size();
 
-  double *px_p = &(px_vec[0]);
-  double *py_p = &(py_vec[0]);
+  double *px_p = const_cast<double *>(px_vec.data());
+  double *py_p = const_cast<double *>(py_vec.data());
   double *h_p = &(h[0]);
-  double *pz_p = &(pz_vec[0]);
+  double *pz_p = const_cast<double *>(pz_vec.data());
   applyMoveTransformation(element);
 
   if (redraw_ws) gr_contourf(nx, ny, num_levels, px_p, py_p, h_p, pz_p, major_h);
@@ -6514,7 +6561,7 @@ static void processDrawGraphics(const std::shared_ptr<GRM::Element> &element,
 {
   std::vector<char> char_vec;
   auto key = static_cast<std::string>(element->getAttribute("data"));
-  auto data_vec = GRM::get<std::vector<int>>((*context)[key]);
+  auto data_vec = GRM::get_span<int>((*context)[key]);
 
   char_vec.reserve(data_vec.size());
   for (int i : data_vec)
@@ -6553,21 +6600,21 @@ static void processDrawImage(const std::shared_ptr<GRM::Element> &element, const
     }
   applyMoveTransformation(element);
   if (redraw_ws)
-    gr_drawimage(x_min, x_max, y_max, y_min, width, height, (int *)&(GRM::get<std::vector<int>>((*context)[data])[0]),
-                 model);
+    gr_drawimage(x_min, x_max, y_max, y_min, width, height,
+                 const_cast<int *>(GRM::get_span<int>((*context)[data]).data()), model);
 }
 
 static void processErrorBars(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
 {
   std::string orientation = PLOT_DEFAULT_ORIENTATION, kind;
   bool is_horizontal;
-  std::vector<double> absolute_upwards_vec, absolute_downwards_vec, relative_upwards_vec, relative_downwards_vec;
+  GRM::Span<const double> absolute_upwards_vec, absolute_downwards_vec, relative_upwards_vec, relative_downwards_vec;
   std::string absolute_upwards, absolute_downwards, relative_upwards, relative_downwards;
   double absolute_upwards_flt, relative_upwards_flt, absolute_downwards_flt, relative_downwards_flt;
   int scale_options, color_upwards_cap, color_downwards_cap, color_error_bar;
   double marker_size, x_min, x_max, y_min, y_max, tick, a, b, e_upwards, e_downwards, x_value;
   double line_x[2], line_y[2], last_line_y[2];
-  std::vector<double> x_vec, y_vec;
+  GRM::Span<const double> x_vec, y_vec;
   unsigned int x_length;
   std::string x_key, y_key;
   std::shared_ptr<GRM::Element> series;
@@ -6590,8 +6637,8 @@ static void processErrorBars(const std::shared_ptr<GRM::Element> &element, const
   if (!element->hasAttribute("y")) throw NotFoundError("Error-bars are missing required attribute y-data.\n");
   y_key = static_cast<std::string>(element->getAttribute("y"));
 
-  x_vec = GRM::get<std::vector<double>>((*context)[x_key]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
+  x_vec = GRM::get_span<double>((*context)[x_key]);
+  y_vec = GRM::get_span<double>((*context)[y_key]);
   x_length = x_vec.size();
   kind = static_cast<std::string>(series->getAttribute("kind"));
   if (element->parentElement()->hasAttribute("orientation"))
@@ -6610,22 +6657,22 @@ static void processErrorBars(const std::shared_ptr<GRM::Element> &element, const
   if (element->hasAttribute("absolute_downwards"))
     {
       absolute_downwards = static_cast<std::string>(element->getAttribute("absolute_downwards"));
-      absolute_downwards_vec = GRM::get<std::vector<double>>((*context)[absolute_downwards]);
+      absolute_downwards_vec = GRM::get_span<double>((*context)[absolute_downwards]);
     }
   if (element->hasAttribute("relative_downwards"))
     {
       relative_downwards = static_cast<std::string>(element->getAttribute("relative_downwards"));
-      relative_downwards_vec = GRM::get<std::vector<double>>((*context)[relative_downwards]);
+      relative_downwards_vec = GRM::get_span<double>((*context)[relative_downwards]);
     }
   if (element->hasAttribute("absolute_upwards"))
     {
       absolute_upwards = static_cast<std::string>(element->getAttribute("absolute_upwards"));
-      absolute_upwards_vec = GRM::get<std::vector<double>>((*context)[absolute_upwards]);
+      absolute_upwards_vec = GRM::get_span<double>((*context)[absolute_upwards]);
     }
   if (element->hasAttribute("relative_upwards"))
     {
       relative_upwards = static_cast<std::string>(element->getAttribute("relative_upwards"));
-      relative_upwards_vec = GRM::get<std::vector<double>>((*context)[relative_upwards]);
+      relative_upwards_vec = GRM::get_span<double>((*context)[relative_upwards]);
     }
   if (element->hasAttribute("absolute_downwards_flt"))
     absolute_downwards_flt = static_cast<double>(element->getAttribute("absolute_downwards_flt"));
@@ -6890,7 +6937,7 @@ static void processErrorBar(const std::shared_ptr<GRM::Element> &element, const
 static void processIsosurface(const std::shared_ptr<GRM::Element> &element,
                               const std::shared_ptr<GRM::Context> &context)
 {
-  std::vector<double> z_vec, temp_colors;
+  GRM::Span<const double> z_vec, temp_colors;
   unsigned int i, z_length, dims;
   int strides[3];
   double c_min, c_max, isovalue = 0.5;
@@ -6898,13 +6945,13 @@ static void processIsosurface(const std::shared_ptr<GRM::Element> &element,
 
   if (!element->hasAttribute("z")) throw NotFoundError("Isosurface series is missing required attribute z-data.\n");
   auto z_key = static_cast<std::string>(element->getAttribute("z"));
-  z_vec = GRM::get<std::vector<double>>((*context)[z_key]);
+  z_vec = GRM::get_span<double>((*context)[z_key]);
   z_length = z_vec.size();
 
   if (!element->hasAttribute("z_dims"))
     throw NotFoundError("Isosurface series is missing required attribute z_dims.\n");
   auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
-  auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+  auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
   dims = z_dims_vec.size();
 
   if (dims != 3) throw std::length_error("For isosurface series the size of z_dims has to be 3.\n");
@@ -6918,7 +6965,7 @@ static void processIsosurface(const std::shared_ptr<GRM::Element> &element,
   if (element->hasAttribute("color_rgb_values"))
     {
       auto temp_c = static_cast<std::string>(element->getAttribute("color_rgb_values"));
-      temp_colors = GRM::get<std::vector<double>>((*context)[temp_c]);
+      temp_colors = GRM::get_span<double>((*context)[temp_c]);
       i = temp_colors.size();
       if (i != 3) throw std::length_error("For isosurface series the foreground colors must have size 3.\n");
       while (i-- > 0)
@@ -6981,7 +7028,7 @@ static void processLegend(const std::shared_ptr<GRM::Element> &element, const st
   double tbx[4], tby[4];
   std::shared_ptr<GRM::Render> render;
   std::string labels_key = static_cast<std::string>(element->getAttribute("labels"));
-  auto labels = GRM::get<std::vector<std::string>>((*context)[labels_key]);
+  auto labels = GRM::get_span<std::string>((*context)[labels_key]);
   del_values del = del_values::update_without_default;
   int child_id = 0;
   auto plot_parent = element->parentElement();
@@ -7005,7 +7052,7 @@ static void processLegend(const std::shared_ptr<GRM::Element> &element, const st
       gr_savestate();
 
       auto specs_key = static_cast<std::string>(element->getAttribute("specs"));
-      std::vector<std::string> specs = GRM::get<std::vector<std::string>>((*context)[specs_key]);
+      auto specs = GRM::get_span<std::string>((*context)[specs_key]);
       auto scale_factor = static_cast<double>(element->getAttribute("_scale_factor"));
 
       viewport[0] = static_cast<double>(element->getAttribute("viewport_x_min"));
@@ -7111,7 +7158,7 @@ static void processLegend(const std::shared_ptr<GRM::Element> &element, const st
 
               if (i < labels.size())
                 {
-                  gr_inqtext(0, 0, labels[i].data(), tbx, tby);
+                  gr_inqtext(0, 0, const_cast<char *>(labels[i].c_str()), tbx, tby);
                   dy = grm_max((tby[2] - tby[0]) - 0.03 * scale_factor, 0);
                   viewport[3] -= 0.5 * dy;
                 }
@@ -7123,7 +7170,7 @@ static void processLegend(const std::shared_ptr<GRM::Element> &element, const st
                 }
 
               gr_savestate();
-              mask = gr_uselinespec(specs[spec_i].data());
+              mask = gr_uselinespec((char *)specs[spec_i].c_str());
               gr_restorestate();
 
               if (int_equals_any(mask, 5, 0, 1, 3, 4, 5))
@@ -7468,7 +7515,7 @@ static void processLegend(const std::shared_ptr<GRM::Element> &element, const st
                                        current_label, CoordinateSpace::NDC, text);
                 }
 
-              gr_inqtext(0, 0, current_label.data(), tbx, tby);
+              gr_inqtext(0, 0, const_cast<char *>(current_label.c_str()), tbx, tby);
               viewport[0] += tbx[2] - tbx[0] + 0.05 * scale_factor;
             }
         }
@@ -8414,13 +8461,13 @@ static void processFillArea(const std::shared_ptr<GRM::Element> &element, const
   auto x = static_cast<std::string>(element->getAttribute("x"));
   auto y = static_cast<std::string>(element->getAttribute("y"));
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
 
   int n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
   applyMoveTransformation(element);
 
-  if (redraw_ws) gr_fillarea(n, (double *)&(x_vec[0]), (double *)&(y_vec[0]));
+  if (redraw_ws) gr_fillarea(n, const_cast<double *>(x_vec.data()), const_cast<double *>(y_vec.data()));
 }
 
 static void processGrid3d(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
@@ -8497,7 +8544,7 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
   std::shared_ptr<GRM::Element> plot_parent;
   std::shared_ptr<GRM::Element> element_context = element;
   std::vector<int> data, rgba;
-  std::vector<double> x_vec, y_vec, z_vec;
+  GRM::Span<const double> x_vec, y_vec, z_vec;
   del_values del = del_values::update_without_default;
   int child_id = 0;
   int x_offset = 0, y_offset = 0;
@@ -8523,7 +8570,7 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
   if (element_context->hasAttribute("x"))
     {
       auto x = static_cast<std::string>(element_context->getAttribute("x"));
-      x_vec = GRM::get<std::vector<double>>((*context)[x]);
+      x_vec = GRM::get_span<double>((*context)[x]);
       cols = x_vec.size();
 
       if (static_cast<int>(plot_parent->getAttribute("x_log")))
@@ -8531,7 +8578,7 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
           for (i = 0; i < cols; i++)
             {
               if (!grm_isnan(x_vec[i])) break;
-              x_vec.erase(x_vec.begin(), x_vec.begin() + 1);
+              x_vec = x_vec.subspan(1);
               x_offset += 1;
             }
           cols = x_vec.size();
@@ -8540,7 +8587,7 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
   if (element_context->hasAttribute("y"))
     {
       auto y = static_cast<std::string>(element_context->getAttribute("y"));
-      y_vec = GRM::get<std::vector<double>>((*context)[y]);
+      y_vec = GRM::get_span<double>((*context)[y]);
       rows = y_vec.size();
 
       if (static_cast<int>(plot_parent->getAttribute("y_log")))
@@ -8548,7 +8595,7 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
           for (i = 0; i < rows; i++)
             {
               if (!grm_isnan(y_vec[i])) break;
-              y_vec.erase(y_vec.begin(), y_vec.begin() + 1);
+              y_vec = y_vec.subspan(1);
               y_offset += 1;
             }
           rows = y_vec.size();
@@ -8558,7 +8605,7 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
   if (!element_context->hasAttribute("z"))
     throw NotFoundError("Heatmap series is missing required attribute z-data.\n");
   auto z = static_cast<std::string>(element_context->getAttribute("z"));
-  z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  z_vec = GRM::get_span<double>((*context)[z]);
   z_length = z_vec.size();
 
   if (x_offset > 0 || y_offset > 0)
@@ -8582,7 +8629,7 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
       if (!element->hasAttribute("z_dims"))
         throw NotFoundError("Heatmap series is missing required attribute z_dims.\n");
       auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
-      auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+      auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
       cols = z_dims_vec[0];
       rows = z_dims_vec[1];
     }
@@ -8754,9 +8801,9 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
       std::shared_ptr<GRM::Element> cell_array;
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
-          cell_array =
-              global_render->createNonUniformCellArray("x" + str, x_vec, "y" + str, y_vec, (int)cols, (int)rows, 1, 1,
-                                                       (int)cols, (int)rows, "color_ind_values" + str, rgba);
+          cell_array = global_render->createNonUniformCellArray("x" + str, GRM::get_copy(x_vec), "y" + str,
+                                                                GRM::get_copy(y_vec), (int)cols, (int)rows, 1, 1,
+                                                                (int)cols, (int)rows, "color_ind_values" + str, rgba);
           cell_array->setAttribute("_child_id", child_id++);
           element->append(cell_array);
         }
@@ -8764,9 +8811,9 @@ static void processHeatmap(const std::shared_ptr<GRM::Element> &element, const s
         {
           cell_array = element->querySelectors("nonuniform_cell_array[_child_id=" + std::to_string(child_id++) + "]");
           if (cell_array != nullptr)
-            global_render->createNonUniformCellArray("x" + str, x_vec, "y" + str, y_vec, (int)cols, (int)rows, 1, 1,
-                                                     (int)cols, (int)rows, "color_ind_values" + str, rgba, nullptr,
-                                                     cell_array);
+            global_render->createNonUniformCellArray("x" + str, GRM::get_copy(x_vec), "y" + str, GRM::get_copy(y_vec),
+                                                     (int)cols, (int)rows, 1, 1, (int)cols, (int)rows,
+                                                     "color_ind_values" + str, rgba, nullptr, cell_array);
         }
     }
 }
@@ -8783,11 +8830,10 @@ static void hexbin(const std::shared_ptr<GRM::Element> &element, const std::shar
   auto y = static_cast<std::string>(element->getAttribute("y"));
   auto nbins = static_cast<int>(element->getAttribute("num_bins"));
 
-  double *x_p = &(GRM::get<std::vector<double>>((*context)[x])[0]);
-  double *y_p = &(GRM::get<std::vector<double>>((*context)[y])[0]);
-
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
+  double *x_p = const_cast<double *>(x_vec.data());
+  double *y_p = const_cast<double *>(y_vec.data());
   auto x_length = (int)x_vec.size();
 
   if (element->hasAttribute("_hexbin_context_address"))
@@ -8823,11 +8869,10 @@ static void processHexbin(const std::shared_ptr<GRM::Element> &element, const st
       element->setAttribute("num_bins", nbins);
     }
 
-  double *x_p = &(GRM::get<std::vector<double>>((*context)[x])[0]);
-  double *y_p = &(GRM::get<std::vector<double>>((*context)[y])[0]);
-
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
+  double *x_p = const_cast<double *>(x_vec.data());
+  double *y_p = const_cast<double *>(y_vec.data());
   auto x_length = (int)x_vec.size();
   auto y_length = (int)y_vec.size();
   if (x_length != y_length) throw std::length_error("For Hexbin x- and y-data must have the same size\n.");
@@ -8852,19 +8897,19 @@ static void processHexbin(const std::shared_ptr<GRM::Element> &element, const st
 static void histBins(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
 {
   double *tmp_bins;
-  std::vector<double> x, weights;
+  GRM::Span<const double> x, weights;
   unsigned int num_bins = 0, num_weights = 0;
 
   if (!element->hasAttribute("x")) throw NotFoundError("Hist series is missing required attribute x-data.\n");
   auto key = static_cast<std::string>(element->getAttribute("x"));
-  x = GRM::get<std::vector<double>>((*context)[key]);
+  x = GRM::get_span<double>((*context)[key]);
   auto current_point_count = (int)x.size();
 
   if (element->hasAttribute("num_bins")) num_bins = static_cast<int>(element->getAttribute("num_bins"));
   if (element->hasAttribute("weights"))
     {
       auto weights_key = static_cast<std::string>(element->getAttribute("weights"));
-      weights = GRM::get<std::vector<double>>((*context)[weights_key]);
+      weights = GRM::get_span<double>((*context)[weights_key]);
       num_weights = weights.size();
     }
   if (!weights.empty() && current_point_count != num_weights)
@@ -8872,8 +8917,8 @@ static void histBins(const std::shared_ptr<GRM::Element> &element, const std::sh
 
   if (num_bins <= 1) num_bins = (int)(3.3 * log10(current_point_count) + 0.5) + 1;
   auto bins = std::vector<double>(num_bins);
-  double *x_p = &(x[0]);
-  double *weights_p = (weights.empty()) ? nullptr : &(weights[0]);
+  double *x_p = const_cast<double *>(x.data());
+  double *weights_p = (weights.empty()) ? nullptr : const_cast<double *>(weights.data());
   tmp_bins = &(bins[0]);
   bin_data(current_point_count, x_p, num_bins, tmp_bins, weights_p);
   std::vector<double> tmp(tmp_bins, tmp_bins + num_bins);
@@ -8895,14 +8940,15 @@ static void processHist(const std::shared_ptr<GRM::Element> &element, const std:
    */
 
   int bar_color_index = 989, i;
-  std::vector<double> bar_color_rgb_vec = {-1, -1, -1};
+  static const double unset_color_rgb[3] = {-1, -1, -1};
+  GRM::Span<const double> bar_color_rgb_vec(unset_color_rgb, 3);
   std::shared_ptr<GRM::Element> plot_parent;
   del_values del = del_values::update_without_default;
   int child_id = 0;
   int edge_color_index = 1;
-  std::vector<double> edge_color_rgb_vec = {-1, -1, -1};
+  GRM::Span<const double> edge_color_rgb_vec(unset_color_rgb, 3);
   double x_min, x_max, bar_width, y_min, y_max;
-  std::vector<double> bins_vec;
+  GRM::Span<const double> bins_vec;
   unsigned int num_bins;
   std::string orientation = PLOT_DEFAULT_ORIENTATION, line_spec = SERIES_DEFAULT_SPEC;
   bool is_horizontal;
@@ -8910,7 +8956,7 @@ static void processHist(const std::shared_ptr<GRM::Element> &element, const std:
   if (element->hasAttribute("fill_color_rgb"))
     {
       auto bar_color_rgb = static_cast<std::string>(element->getAttribute("fill_color_rgb"));
-      bar_color_rgb_vec = GRM::get<std::vector<double>>((*context)[bar_color_rgb]);
+      bar_color_rgb_vec = GRM::get_span<double>((*context)[bar_color_rgb]);
     }
 
   // Todo: using line_spec here istn't really clean, cause no lines are drawn, but it's the only option atm to get the
@@ -8942,7 +8988,7 @@ static void processHist(const std::shared_ptr<GRM::Element> &element, const std:
   if (element->hasAttribute("line_color_rgb"))
     {
       auto edge_color_rgb = static_cast<std::string>(element->getAttribute("line_color_rgb"));
-      edge_color_rgb_vec = GRM::get<std::vector<double>>((*context)[edge_color_rgb]);
+      edge_color_rgb_vec = GRM::get_span<double>((*context)[edge_color_rgb]);
     }
 
   if (element->hasAttribute("line_color_ind"))
@@ -8962,7 +9008,7 @@ static void processHist(const std::shared_ptr<GRM::Element> &element, const std:
 
   if (!element->hasAttribute("bins")) histBins(element, context);
   auto bins = static_cast<std::string>(element->getAttribute("bins"));
-  bins_vec = GRM::get<std::vector<double>>((*context)[bins]);
+  bins_vec = GRM::get_span<double>((*context)[bins]);
   num_bins = bins_vec.size();
 
   if (element->hasAttribute("orientation"))
@@ -9072,7 +9118,7 @@ static void processHist(const std::shared_ptr<GRM::Element> &element, const std:
         {
           std::vector<double> bar_centers(num_bins);
           linspace(x_min + 0.5 * bar_width, x_max - 0.5 * bar_width, (int)num_bins, bar_centers);
-          extendErrorBars(child, context, bar_centers, bins_vec);
+          extendErrorBars(child, context, bar_centers, GRM::get_copy(bins_vec));
         }
     }
 }
@@ -9085,7 +9131,7 @@ static void processBar(const std::shared_ptr<GRM::Element> &element, const std::
   std::string orientation = PLOT_DEFAULT_ORIENTATION, text;
   del_values del = del_values::update_without_default;
   double line_width = NAN, y_lightness = NAN;
-  std::vector<double> bar_color_rgb, edge_color_rgb;
+  GRM::Span<const double> bar_color_rgb, edge_color_rgb;
   int child_id = 0;
 
   x1 = static_cast<double>(element->getAttribute("x1"));
@@ -9100,12 +9146,12 @@ static void processBar(const std::shared_ptr<GRM::Element> &element, const std::
   if (element->hasAttribute("fill_color_rgb"))
     {
       auto bar_color_rgb_key = static_cast<std::string>(element->getAttribute("fill_color_rgb"));
-      bar_color_rgb = GRM::get<std::vector<double>>((*context)[bar_color_rgb_key]);
+      bar_color_rgb = GRM::get_span<double>((*context)[bar_color_rgb_key]);
     }
   if (element->hasAttribute("line_color_rgb"))
     {
       auto edge_color_rgb_key = static_cast<std::string>(element->getAttribute("line_color_rgb"));
-      edge_color_rgb = GRM::get<std::vector<double>>((*context)[edge_color_rgb_key]);
+      edge_color_rgb = GRM::get_span<double>((*context)[edge_color_rgb_key]);
     }
 
   /* clear old rects */
@@ -9257,13 +9303,13 @@ static void processNonUniformPolarCellArray(const std::shared_ptr<GRM::Element>
   auto n_row = static_cast<int>(element->getAttribute("num_row"));
   auto color_key = static_cast<std::string>(element->getAttribute("color_ind_values"));
 
-  auto r_vec = GRM::get<std::vector<double>>((*context)[r_key]);
-  auto phi_vec = GRM::get<std::vector<double>>((*context)[phi_key]);
-  auto color_vec = GRM::get<std::vector<int>>((*context)[color_key]);
+  auto r_vec = GRM::get_span<double>((*context)[r_key]);
+  auto phi_vec = GRM::get_span<double>((*context)[phi_key]);
+  auto color_vec = GRM::get_span<int>((*context)[color_key]);
 
-  double *phi = &(phi_vec[0]);
-  double *r = &(r_vec[0]);
-  int *color = &(color_vec[0]);
+  double *phi = const_cast<double *>(phi_vec.data());
+  double *r = const_cast<double *>(r_vec.data());
+  int *color = const_cast<int *>(color_vec.data());
   applyMoveTransformation(element);
 
   if (redraw_ws) gr_nonuniformpolarcellarray(x_org, y_org, phi, r, dim_phi, dim_r, s_col, s_row, n_col, n_row, color);
@@ -9289,10 +9335,10 @@ static void processNonuniformCellArray(const std::shared_ptr<GRM::Element> &elem
   auto nrow = static_cast<int>(element->getAttribute("num_row"));
   auto color = static_cast<std::string>(element->getAttribute("color_ind_values"));
 
-  auto x_p = (double *)&(GRM::get<std::vector<double>>((*context)[x])[0]);
-  auto y_p = (double *)&(GRM::get<std::vector<double>>((*context)[y])[0]);
+  auto x_p = const_cast<double *>(GRM::get_span<double>((*context)[x]).data());
+  auto y_p = const_cast<double *>(GRM::get_span<double>((*context)[y]).data());
 
-  auto color_p = (int *)&(GRM::get<std::vector<int>>((*context)[color])[0]);
+  auto color_p = const_cast<int *>(GRM::get_span<int>((*context)[color]).data());
   applyMoveTransformation(element);
   if (redraw_ws) gr_nonuniformcellarray(x_p, y_p, dimx, dimy, scol, srow, ncol, nrow, color_p);
 }
@@ -9319,8 +9365,8 @@ static void processPolarCellArray(const std::shared_ptr<GRM::Element> &element,
   auto n_row = static_cast<int>(element->getAttribute("num_row"));
   auto color_key = static_cast<std::string>(element->getAttribute("color_ind_values"));
 
-  auto color_vec = GRM::get<std::vector<int>>((*context)[color_key]);
-  int *color = &(color_vec[0]);
+  auto color_vec = GRM::get_span<int>((*context)[color_key]);
+  int *color = const_cast<int *>(color_vec.data());
   applyMoveTransformation(element);
 
   if (redraw_ws)
@@ -9345,8 +9391,8 @@ static void processPolyline(const std::shared_ptr<GRM::Element> &element, const
       auto x = static_cast<std::string>(element->getAttribute("x"));
       auto y = static_cast<std::string>(element->getAttribute("y"));
 
-      std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-      std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
+      auto x_vec = GRM::get_span<double>((*context)[x]);
+      auto y_vec = GRM::get_span<double>((*context)[y]);
 
       auto n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
       auto group = element->parentElement();
@@ -9359,7 +9405,7 @@ static void processPolyline(const std::shared_ptr<GRM::Element> &element, const
           lineHelper(element, context, "polyline");
         }
       else if (redraw_ws)
-        gr_polyline(n, (double *)&(x_vec[0]), (double *)&(y_vec[0]));
+        gr_polyline(n, const_cast<double *>(x_vec.data()), const_cast<double *>(y_vec.data()));
     }
   else if (element->getAttribute("x1").isDouble() && element->getAttribute("x2").isDouble() &&
            element->getAttribute("y1").isDouble() && element->getAttribute("y2").isDouble())
@@ -9389,13 +9435,13 @@ static void processPolyline3d(const std::shared_ptr<GRM::Element> &element,
   auto y = static_cast<std::string>(element->getAttribute("y"));
   auto z = static_cast<std::string>(element->getAttribute("z"));
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
-  std::vector<double> z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
+  auto z_vec = GRM::get_span<double>((*context)[z]);
 
-  double *x_p = &(x_vec[0]);
-  double *y_p = &(y_vec[0]);
-  double *z_p = &(z_vec[0]);
+  double *x_p = const_cast<double *>(x_vec.data());
+  double *y_p = const_cast<double *>(y_vec.data());
+  double *z_p = const_cast<double *>(z_vec.data());
   auto group = element->parentElement();
 
   applyMoveTransformation(element);
@@ -9428,8 +9474,8 @@ static void processPolymarker(const std::shared_ptr<GRM::Element> &element,
       auto x = static_cast<std::string>(element->getAttribute("x"));
       auto y = static_cast<std::string>(element->getAttribute("y"));
 
-      std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-      std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
+      auto x_vec = GRM::get_span<double>((*context)[x]);
+      auto y_vec = GRM::get_span<double>((*context)[y]);
 
       auto n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
       auto group = element->parentElement();
@@ -9443,7 +9489,7 @@ static void processPolymarker(const std::shared_ptr<GRM::Element> &element,
         }
       else
         {
-          if (redraw_ws) gr_polymarker(n, (double *)&(x_vec[0]), (double *)&(y_vec[0]));
+          if (redraw_ws) gr_polymarker(n, const_cast<double *>(x_vec.data()), const_cast<double *>(y_vec.data()));
         }
     }
   else if (element->getAttribute("x").isDouble() && element->getAttribute("y").isDouble())
@@ -9467,13 +9513,13 @@ static void processPolymarker3d(const std::shared_ptr<GRM::Element> &element,
   auto y = static_cast<std::string>(element->getAttribute("y"));
   auto z = static_cast<std::string>(element->getAttribute("z"));
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
-  std::vector<double> z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
+  auto z_vec = GRM::get_span<double>((*context)[z]);
 
-  double *x_p = &(x_vec[0]);
-  double *y_p = &(y_vec[0]);
-  double *z_p = &(z_vec[0]);
+  double *x_p = const_cast<double *>(x_vec.data());
+  double *y_p = const_cast<double *>(y_vec.data());
+  double *z_p = const_cast<double *>(z_vec.data());
 
   auto group = element->parentElement();
   applyMoveTransformation(element);
@@ -9509,10 +9555,10 @@ static void processQuiver(const std::shared_ptr<GRM::Element> &element, const st
   auto v = static_cast<std::string>(element->getAttribute("v"));
   auto color = static_cast<int>(element->getAttribute("color_ind"));
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
-  std::vector<double> u_vec = GRM::get<std::vector<double>>((*context)[u]);
-  std::vector<double> v_vec = GRM::get<std::vector<double>>((*context)[v]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
+  auto u_vec = GRM::get_span<double>((*context)[u]);
+  auto v_vec = GRM::get_span<double>((*context)[v]);
   auto x_length = (int)x_vec.size();
   auto y_length = (int)y_vec.size();
   auto u_length = (int)u_vec.size();
@@ -9523,10 +9569,10 @@ static void processQuiver(const std::shared_ptr<GRM::Element> &element, const st
   if (x_length * y_length != v_length)
     throw std::length_error("For quiver series x_length * y_length must be v_length.\n");
 
-  double *x_p = &(x_vec[0]);
-  double *y_p = &(y_vec[0]);
-  double *u_p = &(GRM::get<std::vector<double>>((*context)[u])[0]);
-  double *v_p = &(GRM::get<std::vector<double>>((*context)[v])[0]);
+  double *x_p = const_cast<double *>(x_vec.data());
+  double *y_p = const_cast<double *>(y_vec.data());
+  double *u_p = const_cast<double *>(GRM::get_span<double>((*context)[u]).data());
+  double *v_p = const_cast<double *>(GRM::get_span<double>((*context)[v]).data());
   applyMoveTransformation(element);
 
   if (redraw_ws) gr_quiver(x_length, y_length, x_p, y_p, u_p, v_p, color);
@@ -9554,8 +9600,8 @@ void calculatePolarXAndY(std::vector<double> &x, std::vector<double> &y, const s
   auto x_key = static_cast<std::string>(element->getAttribute("x"));
   if (!element->hasAttribute("y")) throw NotFoundError(kind + " series is missing required attribute y-data (rho).\n");
   auto y_key = static_cast<std::string>(element->getAttribute("y"));
-  theta_vec = GRM::get<std::vector<double>>((*context)[x_key]);
-  rho_vec = GRM::get<std::vector<double>>((*context)[y_key]);
+  theta_vec = GRM::get_copy<double>((*context)[x_key]);
+  rho_vec = GRM::get_copy<double>((*context)[y_key]);
   theta_length = theta_vec.size();
   rho_length = rho_vec.size();
 
@@ -9891,18 +9937,18 @@ static void processPolarHeatmap(const std::shared_ptr<GRM::Element> &element,
   if (element->hasAttribute("x"))
     {
       auto x = static_cast<std::string>(element->getAttribute("x"));
-      x_vec = GRM::get<std::vector<double>>((*context)[x]);
+      x_vec = GRM::get_copy<double>((*context)[x]);
       cols = x_vec.size();
     }
   if (element->hasAttribute("y"))
     {
       auto y = static_cast<std::string>(element->getAttribute("y"));
-      y_vec = GRM::get<std::vector<double>>((*context)[y]);
+      y_vec = GRM::get_copy<double>((*context)[y]);
       rows = y_vec.size();
     }
   if (!element->hasAttribute("z")) throw NotFoundError("Polar-heatmap series is missing required attribute z-data.\n");
   auto z = static_cast<std::string>(element->getAttribute("z"));
-  z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  z_vec = GRM::get_copy<double>((*context)[z]);
   z_length = z_vec.size();
 
   if (element->hasAttribute("x_range_min") && element->hasAttribute("x_range_max"))
@@ -9931,7 +9977,7 @@ static void processPolarHeatmap(const std::shared_ptr<GRM::Element> &element,
       if (!element->hasAttribute("z_dims"))
         throw NotFoundError("Polar-heatmap series is missing required attribute z_dims.\n");
       auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
-      auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+      auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
       cols = z_dims_vec[0];
       rows = z_dims_vec[1];
     }
@@ -10149,7 +10195,7 @@ static void processPolarHeatmap(const std::shared_ptr<GRM::Element> &element,
 
 static void preBarplot(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
 {
-  std::vector<int> indices_vec;
+  GRM::Span<const int> indices_vec;
   int max_y_length = 0;
   for (const auto &series : element->querySelectorsAll("series_barplot"))
     {
@@ -10157,19 +10203,19 @@ static void preBarplot(const std::shared_ptr<GRM::Element> &element, const std::
         {
           if (!series->hasAttribute("y")) throw NotFoundError("Barplot series is missing indices\n");
           auto y_key = static_cast<std::string>(series->getAttribute("y"));
-          auto y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
-          indices_vec = std::vector<int>(y_vec.size(), 1);
+          auto y_vec = GRM::get_span<double>((*context)[y_key]);
           auto id = static_cast<int>(global_root->getAttribute("_id"));
           auto id_str = std::to_string(id);
 
-          (*context)["indices" + id_str] = indices_vec;
+          (*context)["indices" + id_str] = std::vector<int>(y_vec.size(), 1);
+          indices_vec = GRM::get_span<int>((*context)["indices" + id_str]);
           series->setAttribute("indices", "indices" + id_str);
           global_root->setAttribute("_id", ++id);
         }
       else
         {
           auto indices_key = static_cast<std::string>(series->getAttribute("indices"));
-          indices_vec = GRM::get<std::vector<int>>((*context)[indices_key]);
+          indices_vec = GRM::get_span<int>((*context)[indices_key]);
         }
       auto cur_y_length = (int)indices_vec.size();
       max_y_length = grm_max(cur_y_length, max_y_length);
@@ -10183,7 +10229,8 @@ static void prePolarHistogram(const std::shared_ptr<GRM::Element> &plot_elem,
   unsigned int num_bins, length, num_bin_edges = 0, i;
   std::vector<double> theta;
   std::string norm = "count";
-  std::vector<int> classes, bin_counts;
+  std::vector<int> classes;
+  GRM::Span<const int> bin_counts;
   double r_max, temp_max, bin_width, x_range_min, x_range_max;
   double *phi_lim = nullptr;
   int max_observations = 0, total_observations = 0;
@@ -10201,7 +10248,7 @@ static void prePolarHistogram(const std::shared_ptr<GRM::Element> &plot_elem,
     {
       is_bin_counts = true;
       auto bin_counts_key = static_cast<std::string>(series->getAttribute("bin_counts"));
-      bin_counts = GRM::get<std::vector<int>>((*context)[bin_counts_key]);
+      bin_counts = GRM::get_span<int>((*context)[bin_counts_key]);
 
       length = bin_counts.size();
       num_bins = length;
@@ -10210,7 +10257,7 @@ static void prePolarHistogram(const std::shared_ptr<GRM::Element> &plot_elem,
   else if (series->hasAttribute("theta"))
     {
       auto theta_key = static_cast<std::string>(series->getAttribute("theta"));
-      theta = GRM::get<std::vector<double>>((*context)[theta_key]);
+      theta = GRM::get_copy<double>((*context)[theta_key]);
       length = theta.size();
 
       if (series->hasAttribute("x_range_min") && series->hasAttribute("x_range_max"))
@@ -10277,7 +10324,7 @@ static void prePolarHistogram(const std::shared_ptr<GRM::Element> &plot_elem,
       int cnt = 0;
 
       bin_edges_key = static_cast<std::string>(series->getAttribute("bin_edges"));
-      bin_edges = GRM::get<std::vector<double>>((*context)[bin_edges_key]);
+      bin_edges = GRM::get_copy<double>((*context)[bin_edges_key]);
       num_bin_edges = bin_edges.size();
 
       /* filter bin_edges */
@@ -10467,7 +10514,7 @@ static void prePolarHistogram(const std::shared_ptr<GRM::Element> &plot_elem,
         }
       else
         {
-          classes = bin_counts;
+          classes = GRM::get_copy(bin_counts);
         }
 
       series->setAttribute("classes", classes_key);
@@ -10577,14 +10624,15 @@ static void processPolarHistogram(const std::shared_ptr<GRM::Element> &element,
   double y_lim_min, y_lim_max;
   bool draw_edges = false, stairs = false, phi_flip = false, keep_radii_axes = false, ylims = false, y_log = false;
   std::string norm = "count";
-  std::vector<double> r_lim_vec, bin_edges, bin_widths, rect_list;
+  std::vector<double> r_lim_vec, bin_edges, rect_list;
+  GRM::Span<const double> bin_widths;
   std::vector<int> classes;
   del_values del = del_values::update_without_default;
   std::shared_ptr<GRM::Element> plot_group = element->parentElement();
   getPlotParent(plot_group);
 
   auto classes_key = static_cast<std::string>(element->getAttribute("classes"));
-  classes = GRM::get<std::vector<int>>((*context)[classes_key]);
+  classes = GRM::get_copy<int>((*context)[classes_key]);
 
   /* clear old polar-histogram children */
   del = del_values(static_cast<int>(element->getAttribute("_delete_children")));
@@ -10635,11 +10683,11 @@ static void processPolarHistogram(const std::shared_ptr<GRM::Element> &element,
   else
     {
       auto bin_edges_key = static_cast<std::string>(element->getAttribute("bin_edges"));
-      bin_edges = GRM::get<std::vector<double>>((*context)[bin_edges_key]);
+      bin_edges = GRM::get_copy<double>((*context)[bin_edges_key]);
       num_bin_edges = bin_edges.size();
 
       auto bin_widths_key = static_cast<std::string>(element->getAttribute("bin_widths"));
-      bin_widths = GRM::get<std::vector<double>>((*context)[bin_widths_key]);
+      bin_widths = GRM::get_span<double>((*context)[bin_widths_key]);
       num_bins = bin_widths.size();
     }
 
@@ -10982,7 +11030,8 @@ static void processPolarBar(const std::shared_ptr<GRM::Element> &element, const
   double y_lim_min, y_lim_max;
   std::complex<double> complex1;
   const double convert = 180.0 / M_PI;
-  std::vector<double> f1, f2, arc_2_x, arc_2_y, phi_vec, bin_edges;
+  std::vector<double> f1, f2, arc_2_x, arc_2_y, phi_vec;
+  GRM::Span<const double> bin_edges;
   int child_id = 0;
   int x_colormap = -2, y_colormap = -2, edge_color = 1, face_color = 989;
   double count, bin_width = -1.0, r_max;
@@ -11025,7 +11074,7 @@ static void processPolarBar(const std::shared_ptr<GRM::Element> &element, const
   if (element->hasAttribute("bin_edges"))
     {
       auto bin_edges_key = static_cast<std::string>(element->getAttribute("bin_edges"));
-      bin_edges = GRM::get<std::vector<double>>((*context)[bin_edges_key]);
+      bin_edges = GRM::get_span<double>((*context)[bin_edges_key]);
       num_bin_edges = (int)bin_edges.size();
     }
 
@@ -11033,7 +11082,7 @@ static void processPolarBar(const std::shared_ptr<GRM::Element> &element, const
   if (element->parentElement()->hasAttribute("bin_widths"))
     {
       auto bin_widths_key = static_cast<std::string>(element->parentElement()->getAttribute("bin_widths"));
-      auto bin_widths_vec = GRM::get<std::vector<double>>((*context)[bin_widths_key]);
+      auto bin_widths_vec = GRM::get_span<double>((*context)[bin_widths_key]);
       num_bins = (int)bin_widths_vec.size();
       bin_width = bin_widths_vec[class_nr];
     }
@@ -11380,7 +11429,8 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   int i, c_index = -1;
   std::vector<int> marker_color_inds_vec;
   std::vector<double> marker_sizes_vec;
-  std::vector<double> x_vec, y_vec, z_vec, c_vec;
+  std::vector<double> x_vec, y_vec;
+  GRM::Span<const double> z_vec, c_vec;
   del_values del = del_values::update_without_default;
   int child_id = 0;
   std::shared_ptr<GRM::Element> marker;
@@ -11389,8 +11439,8 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   auto x = static_cast<std::string>(element->getAttribute("x"));
   if (!element->hasAttribute("y")) throw NotFoundError("Scatter series is missing required attribute y-data.\n");
   auto y = static_cast<std::string>(element->getAttribute("y"));
-  x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  x_vec = GRM::get_copy<double>((*context)[x]);
+  y_vec = GRM::get_copy<double>((*context)[y]);
   x_length = x_vec.size();
   y_length = y_vec.size();
   if (x_length != y_length) throw std::length_error("For scatter series x- and y-data must have the same size.\n");
@@ -11398,14 +11448,14 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   if (element->hasAttribute("z"))
     {
       auto z = static_cast<std::string>(element->getAttribute("z"));
-      z_vec = GRM::get<std::vector<double>>((*context)[z]);
+      z_vec = GRM::get_span<double>((*context)[z]);
       z_length = z_vec.size();
       if (x_length != z_length) throw std::length_error("For scatter series x- and z-data must have the same size.\n");
     }
   if (element->hasAttribute("c"))
     {
       auto c = static_cast<std::string>(element->getAttribute("c"));
-      c_vec = GRM::get<std::vector<double>>((*context)[c]);
+      c_vec = GRM::get_span<double>((*context)[c]);
       c_length = c_vec.size();
     }
   if (element->hasAttribute("orientation"))
@@ -11586,7 +11636,8 @@ static void processScatter3(const std::shared_ptr<GRM::Element> &element, const
    */
   double c_min, c_max;
   unsigned int x_length, y_length, z_length, c_length, i, c_index;
-  std::vector<double> x_vec, y_vec, z_vec, c_vec;
+  std::vector<double> x_vec, y_vec, z_vec;
+  GRM::Span<const double> c_vec;
   del_values del = del_values::update_without_default;
   int child_id = 0;
   std::shared_ptr<GRM::Element> marker;
@@ -11597,9 +11648,9 @@ static void processScatter3(const std::shared_ptr<GRM::Element> &element, const
   auto y = static_cast<std::string>(element->getAttribute("y"));
   if (!element->hasAttribute("z")) throw NotFoundError("Scatter3 series is missing required attribute z-data.\n");
   auto z = static_cast<std::string>(element->getAttribute("z"));
-  x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
-  z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  x_vec = GRM::get_copy<double>((*context)[x]);
+  y_vec = GRM::get_copy<double>((*context)[y]);
+  z_vec = GRM::get_copy<double>((*context)[z]);
   x_length = x_vec.size();
   y_length = y_vec.size();
   z_length = z_vec.size();
@@ -11613,7 +11664,7 @@ static void processScatter3(const std::shared_ptr<GRM::Element> &element, const
   if (element->hasAttribute("c"))
     {
       auto c = static_cast<std::string>(element->getAttribute("c"));
-      c_vec = GRM::get<std::vector<double>>((*context)[c]);
+      c_vec = GRM::get_span<double>((*context)[c]);
       c_length = c_vec.size();
       auto plot_parent = element->parentElement();
       getPlotParent(plot_parent);
@@ -11672,7 +11723,7 @@ static void processStairs(const std::shared_ptr<GRM::Element> &element, const st
   std::string orientation = PLOT_DEFAULT_ORIENTATION, line_spec = SERIES_DEFAULT_SPEC;
   bool is_vertical;
   unsigned int x_length, y_length, mask, i;
-  std::vector<double> x_vec, y_vec;
+  GRM::Span<const double> x_vec, y_vec;
   std::shared_ptr<GRM::Element> element_context = element, line, marker;
   del_values del = del_values::update_without_default;
   int child_id = 0;
@@ -11685,8 +11736,8 @@ static void processStairs(const std::shared_ptr<GRM::Element> &element, const st
   if (!element_context->hasAttribute("y")) throw NotFoundError("Stairs series is missing required attribute y-data.\n");
   auto y = static_cast<std::string>(element_context->getAttribute("y"));
 
-  x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  x_vec = GRM::get_span<double>((*context)[x]);
+  y_vec = GRM::get_span<double>((*context)[y]);
   x_length = x_vec.size();
   y_length = y_vec.size();
 
@@ -11861,13 +11912,10 @@ static void processStairs(const std::shared_ptr<GRM::Element> &element, const st
         }
       if (mask & 2)
         {
-          std::vector<double> marker_x = x_vec, marker_y = y_vec;
+          auto marker_x = GRM::get_copy(is_vertical ? y_vec : x_vec);
+          auto marker_y = GRM::get_copy(is_vertical ? x_vec : y_vec);
           int current_marker_color_ind;
           gr_inqmarkercolorind(&current_marker_color_ind);
-          if (is_vertical)
-            {
-              marker_x = y_vec, marker_y = x_vec;
-            }
           if (del != del_values::update_without_default && del != del_values::update_with_default)
             {
               marker = global_render->createPolymarker("x" + str, marker_x, "y" + str, marker_y);
@@ -11912,7 +11960,7 @@ static void processStem(const std::shared_ptr<GRM::Element> &element, const std:
   bool is_vertical;
   unsigned int x_length, y_length;
   unsigned int i;
-  std::vector<double> x_vec, y_vec;
+  GRM::Span<const double> x_vec, y_vec;
   del_values del = del_values::update_without_default;
   int child_id = 0;
   std::shared_ptr<GRM::Element> line, marker, coordinate_system;
@@ -11943,8 +11991,8 @@ static void processStem(const std::shared_ptr<GRM::Element> &element, const std:
   mask = gr_uselinespec((char *)spec_char);
 
   is_vertical = orientation == "vertical";
-  x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  x_vec = GRM::get_span<double>((*context)[x]);
+  y_vec = GRM::get_span<double>((*context)[y]);
   x_length = x_vec.size();
   y_length = y_vec.size();
   if (x_length != y_length) throw std::length_error("For stem series x- and y-data must have the same size.\n");
@@ -12000,8 +12048,8 @@ static void processStem(const std::shared_ptr<GRM::Element> &element, const std:
   global_root->setAttribute("_id", id + 1);
   auto str = std::to_string(id);
 
-  std::vector<double> marker_x = x_vec, marker_y = y_vec;
-  if (is_vertical) marker_x = y_vec, marker_y = x_vec;
+  auto marker_x = GRM::get_copy(is_vertical ? y_vec : x_vec);
+  auto marker_y = GRM::get_copy(is_vertical ? x_vec : y_vec);
   if (del != del_values::update_without_default && del != del_values::update_with_default)
     {
       marker = global_render->createPolymarker("x" + str, marker_x, "y" + str, marker_y, nullptr,
@@ -12026,21 +12074,21 @@ static void processStem(const std::shared_ptr<GRM::Element> &element, const std:
 static void processShade(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
 {
   int xform = 5, x_bins = 1200, y_bins = 1200, n;
-  std::vector<double> x_vec, y_vec;
+  GRM::Span<const double> x_vec, y_vec;
   double *x_p, *y_p;
 
   auto x_key = static_cast<std::string>(element->getAttribute("x"));
   auto y_key = static_cast<std::string>(element->getAttribute("y"));
 
-  x_vec = GRM::get<std::vector<double>>((*context)[x_key]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
+  x_vec = GRM::get_span<double>((*context)[x_key]);
+  y_vec = GRM::get_span<double>((*context)[y_key]);
 
   if (element->hasAttribute("transformation")) xform = static_cast<int>(element->getAttribute("transformation"));
   if (element->hasAttribute("x_bins")) x_bins = static_cast<int>(element->getAttribute("x_bins"));
   if (element->hasAttribute("y_bins")) y_bins = static_cast<int>(element->getAttribute("y_bins"));
 
-  x_p = &(x_vec[0]);
-  y_p = &(y_vec[0]);
+  x_p = const_cast<double *>(x_vec.data());
+  y_p = const_cast<double *>(y_vec.data());
   n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
   applyMoveTransformation(element);
 
@@ -12056,7 +12104,8 @@ static void processSurface(const std::shared_ptr<GRM::Element> &element, const s
    * \param[in] context The GRM::Context that contains the actual data
    */
   int accelerate = PLOT_DEFAULT_ACCELERATE; /* this argument decides if GR3 or GR is used to plot the surface */
-  std::vector<double> x_vec, y_vec, z_vec;
+  GRM::Span<const double> x_vec, y_vec, z_vec;
+  std::vector<double> x_tmp, y_tmp, gridit_x_vec, gridit_y_vec, gridit_z_vec;
   unsigned int x_length, y_length, z_length;
   double x_min, x_max, y_min, y_max;
 
@@ -12072,20 +12121,20 @@ static void processSurface(const std::shared_ptr<GRM::Element> &element, const s
   if (element->hasAttribute("x"))
     {
       auto x = static_cast<std::string>(element->getAttribute("x"));
-      x_vec = GRM::get<std::vector<double>>((*context)[x]);
+      x_vec = GRM::get_span<double>((*context)[x]);
       x_length = x_vec.size();
     }
   if (element->hasAttribute("y"))
     {
       auto y = static_cast<std::string>(element->getAttribute("y"));
-      y_vec = GRM::get<std::vector<double>>((*context)[y]);
+      y_vec = GRM::get_span<double>((*context)[y]);
       y_length = y_vec.size();
     }
 
   if (!element->hasAttribute("z")) throw NotFoundError("Surface series is missing required attribute z-data.\n");
 
   auto z = static_cast<std::string>(element->getAttribute("z"));
-  z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  z_vec = GRM::get_span<double>((*context)[z]);
   z_length = z_vec.size();
 
   if (x_vec.empty() && y_vec.empty())
@@ -12094,7 +12143,7 @@ static void processSurface(const std::shared_ptr<GRM::Element> &element, const s
       if (!element->hasAttribute("z_dims"))
         throw NotFoundError("Surface series is missing required attribute zdims.\n");
       auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
-      auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+      auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
       x_length = z_dims_vec[0];
       y_length = z_dims_vec[1];
     }
@@ -12144,21 +12193,21 @@ static void processSurface(const std::shared_ptr<GRM::Element> &element, const s
 
   if (x_vec.empty())
     {
-      std::vector<double> tmp(x_length);
+      x_tmp.resize(x_length);
       for (int j = 0; j < x_length; ++j)
         {
-          tmp[j] = (int)(x_min + (x_max - x_min) / x_length * j + 0.5);
+          x_tmp[j] = (int)(x_min + (x_max - x_min) / x_length * j + 0.5);
         }
-      x_vec = tmp;
+      x_vec = x_tmp;
     }
   if (y_vec.empty())
     {
-      std::vector<double> tmp(y_length);
+      y_tmp.resize(y_length);
       for (int j = 0; j < y_length; ++j)
         {
-          tmp[j] = (int)(y_min + (y_max - y_min) / y_length * j + 0.5);
+          y_tmp[j] = (int)(y_min + (y_max - y_min) / y_length * j + 0.5);
         }
-      y_vec = tmp;
+      y_vec = y_tmp;
     }
 
   if (x_length == y_length && x_length == z_length)
@@ -12166,22 +12215,22 @@ static void processSurface(const std::shared_ptr<GRM::Element> &element, const s
       logger((stderr, "Create a %d x %d grid for \"surface\" with \"gridit\"\n", PLOT_SURFACE_GRIDIT_N,
               PLOT_SURFACE_GRIDIT_N));
 
-      std::vector<double> gridit_x_vec(PLOT_SURFACE_GRIDIT_N);
-      std::vector<double> gridit_y_vec(PLOT_SURFACE_GRIDIT_N);
-      std::vector<double> gridit_z_vec(PLOT_SURFACE_GRIDIT_N * PLOT_SURFACE_GRIDIT_N);
+      gridit_x_vec.resize(PLOT_SURFACE_GRIDIT_N);
+      gridit_y_vec.resize(PLOT_SURFACE_GRIDIT_N);
+      gridit_z_vec.resize(PLOT_SURFACE_GRIDIT_N * PLOT_SURFACE_GRIDIT_N);
 
       double *gridit_x = &(gridit_x_vec[0]);
       double *gridit_y = &(gridit_y_vec[0]);
       double *gridit_z = &(gridit_z_vec[0]);
-      double *x_p = &(x_vec[0]);
-      double *y_p = &(y_vec[0]);
-      double *z_p = &(z_vec[0]);
+      double *x_p = const_cast<double *>(x_vec.data());
+      double *y_p = const_cast<double *>(y_vec.data());
+      double *z_p = const_cast<double *>(z_vec.data());
       gr_gridit((int)x_length, x_p, y_p, z_p, PLOT_SURFACE_GRIDIT_N, PLOT_SURFACE_GRIDIT_N, gridit_x, gridit_y,
                 gridit_z);
 
-      x_vec = std::vector<double>(gridit_x, gridit_x + PLOT_SURFACE_GRIDIT_N);
-      y_vec = std::vector<double>(gridit_y, gridit_y + PLOT_SURFACE_GRIDIT_N);
-      z_vec = std::vector<double>(gridit_z, gridit_z + PLOT_SURFACE_GRIDIT_N * PLOT_SURFACE_GRIDIT_N);
+      x_vec = gridit_x_vec;
+      y_vec = gridit_y_vec;
+      z_vec = gridit_z_vec;
 
       x_length = y_length = PLOT_SURFACE_GRIDIT_N;
     }
@@ -12195,9 +12244,9 @@ static void processSurface(const std::shared_ptr<GRM::Element> &element, const s
   applyMoveTransformation(element);
   if (!accelerate)
     {
-      double *px_p = &(x_vec[0]);
-      double *py_p = &(y_vec[0]);
-      double *pz_p = &(z_vec[0]);
+      double *px_p = const_cast<double *>(x_vec.data());
+      double *py_p = const_cast<double *>(y_vec.data());
+      double *pz_p = const_cast<double *>(z_vec.data());
 
       if (redraw_ws) gr_surface((int)x_length, (int)y_length, px_p, py_p, pz_p, GR_OPTION_COLORED_MESH);
     }
@@ -12224,7 +12273,8 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
    * \param[in] context The GRM::Context that contains the actual data
    */
   std::string orientation = PLOT_DEFAULT_ORIENTATION, line_spec = SERIES_DEFAULT_SPEC;
-  std::vector<double> x_vec, y_vec;
+  GRM::Span<const double> x_vec, y_vec;
+  std::vector<double> x_tmp;
   unsigned int x_length = 0, y_length = 0;
   del_values del = del_values::update_without_default;
   int child_id = 0;
@@ -12242,7 +12292,7 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
 
   if (!element->hasAttribute("y")) throw NotFoundError("Line series is missing required attribute y-data.\n");
   auto y = static_cast<std::string>(element->getAttribute("y"));
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  y_vec = GRM::get_span<double>((*context)[y]);
   y_length = y_vec.size();
 
   if (!element->hasAttribute("x"))
@@ -12250,13 +12300,14 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
       x_length = y_length;
       for (int i = 0; i < y_length; ++i) /* julia starts with 1, so GRM starts with 1 to be consistent */
         {
-          x_vec.push_back(i + 1);
+          x_tmp.push_back(i + 1);
         }
+      x_vec = x_tmp;
     }
   else
     {
       auto x = static_cast<std::string>(element->getAttribute("x"));
-      x_vec = GRM::get<std::vector<double>>((*context)[x]);
+      x_vec = GRM::get_span<double>((*context)[x]);
       x_length = x_vec.size();
     }
   if (x_length != y_length) throw std::length_error("For line series x- and y-data must have the same size.\n");
@@ -12283,8 +12334,8 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
       auto id = static_cast<int>(global_root->getAttribute("_id"));
       auto str = std::to_string(id);
 
-      std::vector<double> line_x = x_vec, line_y = y_vec;
-      if (orientation == "vertical") line_x = y_vec, line_y = x_vec;
+      auto line_x = GRM::get_copy(orientation == "vertical" ? y_vec : x_vec);
+      auto line_y = GRM::get_copy(orientation == "vertical" ? x_vec : y_vec);
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
           line = global_render->createPolyline("x" + str, line_x, "y" + str, line_y);
@@ -12308,8 +12359,8 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
       auto id = static_cast<int>(global_root->getAttribute("_id"));
       auto str = std::to_string(id);
 
-      std::vector<double> marker_x = x_vec, marker_y = y_vec;
-      if (orientation == "vertical") marker_x = y_vec, marker_y = x_vec;
+      auto marker_x = GRM::get_copy(orientation == "vertical" ? y_vec : x_vec);
+      auto marker_y = GRM::get_copy(orientation == "vertical" ? x_vec : y_vec);
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
           marker = global_render->createPolymarker("x" + str, marker_x, "y" + str, marker_y);
@@ -12344,7 +12395,8 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
   // error_bar handling
   for (const auto &child : element->children())
     {
-      if (child->localName() == "error_bars") extendErrorBars(child, context, x_vec, y_vec);
+      if (child->localName() == "error_bars")
+        extendErrorBars(child, context, GRM::get_copy(x_vec), GRM::get_copy(y_vec));
     }
 }
 
@@ -12417,7 +12469,7 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
     }
 
   auto x = static_cast<std::string>(element->getAttribute("x"));
-  auto x_vec = GRM::get<std::vector<double>>((*context)[x]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
   num_bins_x = x_vec.size();
   if (plot_parent->hasAttribute("x_log") && static_cast<int>(plot_parent->getAttribute("x_log")))
     {
@@ -12429,7 +12481,7 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
   num_bins_x -= x_offset;
 
   auto y = static_cast<std::string>(element->getAttribute("y"));
-  auto y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
   num_bins_y = y_vec.size();
   if (plot_parent->hasAttribute("y_log") && static_cast<int>(plot_parent->getAttribute("y_log")))
     {
@@ -12441,7 +12493,7 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
   num_bins_y -= y_offset;
 
   auto plot = static_cast<std::string>(element->getAttribute("z"));
-  auto plot_vec = GRM::get<std::vector<double>>((*context)[plot]);
+  auto plot_vec = GRM::get_span<double>((*context)[plot]);
 
   /* clear old child nodes */
   del = del_values(static_cast<int>(element->getAttribute("_delete_children")));
@@ -12465,11 +12517,11 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
   // for validation
   if (heatmap != nullptr)
     {
-      (*context)["x" + str] = x_vec;
+      (*context)["x" + str] = GRM::get_copy(x_vec);
       heatmap->setAttribute("x", "x" + str);
-      (*context)["y" + str] = y_vec;
+      (*context)["y" + str] = GRM::get_copy(y_vec);
       heatmap->setAttribute("y", "y" + str);
-      (*context)["z" + str] = plot_vec;
+      (*context)["z" + str] = GRM::get_copy(plot_vec);
       heatmap->setAttribute("z", "z" + str);
     }
 
@@ -12579,7 +12631,7 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
               (*context)["bins" + str] = bins;
               sub_group->setAttribute("bins", "bins" + str);
 
-              (*context)["x" + str] = x_vec;
+              (*context)["x" + str] = GRM::get_copy(x_vec);
               sub_group->setAttribute("x", "x" + str);
             }
         }
@@ -12614,10 +12666,10 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
               sub_group->setAttribute("line_spec", SERIES_DEFAULT_SPEC);
 
               // for validation
-              (*context)["y" + str] = y_vec;
+              (*context)["y" + str] = GRM::get_copy(y_vec);
               sub_group->setAttribute("y", "y" + str);
 
-              (*context)["x" + str] = x_vec;
+              (*context)["x" + str] = GRM::get_copy(x_vec);
               sub_group->setAttribute("x", "x" + str);
             }
         }
@@ -12717,13 +12769,13 @@ static int set_next_color(const std::string &key, gr_color_type_t color_type,
               if (element->hasAttribute("color_ind_values"))
                 {
                   auto c = static_cast<std::string>(element->getAttribute("color_ind_values"));
-                  color_indices = GRM::get<std::vector<int>>((*context)[c]);
+                  color_indices = GRM::get_copy<int>((*context)[c]);
                   color_array_length = color_indices.size();
                 }
               else if (element->hasAttribute("color_rgb_values"))
                 {
                   auto c = static_cast<std::string>(element->getAttribute("color_rgb_values"));
-                  color_rgb_values = GRM::get<std::vector<double>>((*context)[c]);
+                  color_rgb_values = GRM::get_copy<double>((*context)[c]);
                   color_array_length = color_rgb_values.size();
                 }
             }
@@ -12850,7 +12902,7 @@ static void processPie(const std::shared_ptr<GRM::Element> &element, const std::
 
   if (!element->hasAttribute("x")) throw NotFoundError("Pie series is missing required attribute x-data.\n");
   auto x = static_cast<std::string>(element->getAttribute("x"));
-  auto x_vec = GRM::get<std::vector<double>>((*context)[x]);
+  auto x_vec = GRM::get_copy<double>((*context)[x]);
   x_length = x_vec.size();
 
   std::vector<double> normalized_x(x_length);
@@ -12911,17 +12963,17 @@ static void processPlot3(const std::shared_ptr<GRM::Element> &element, const std
 
   if (!element->hasAttribute("x")) throw NotFoundError("Plot3 series is missing required attribute x-data.\n");
   auto x = static_cast<std::string>(element->getAttribute("x"));
-  auto x_vec = GRM::get<std::vector<double>>((*context)[x]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
   x_length = x_vec.size();
 
   if (!element->hasAttribute("y")) throw NotFoundError("Plot3 series is missing required attribute y-data.\n");
   auto y = static_cast<std::string>(element->getAttribute("y"));
-  auto y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
   y_length = y_vec.size();
 
   if (!element->hasAttribute("z")) throw NotFoundError("Plot3 series is missing required attribute z-data.\n");
   auto z = static_cast<std::string>(element->getAttribute("z"));
-  auto z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  auto z_vec = GRM::get_span<double>((*context)[z]);
   z_length = z_vec.size();
 
   if (x_length != y_length || x_length != z_length)
@@ -12938,7 +12990,8 @@ static void processPlot3(const std::shared_ptr<GRM::Element> &element, const std
   std::shared_ptr<GRM::Element> line;
   if (del != del_values::update_without_default && del != del_values::update_with_default)
     {
-      line = global_render->createPolyline3d("x" + id, x_vec, "y" + id, y_vec, "z" + id, z_vec);
+      line = global_render->createPolyline3d("x" + id, GRM::get_copy(x_vec), "y" + id, GRM::get_copy(y_vec), "z" + id,
+                                             GRM::get_copy(z_vec));
       line->setAttribute("_child_id", child_id++);
       element->append(line);
     }
@@ -12946,7 +12999,8 @@ static void processPlot3(const std::shared_ptr<GRM::Element> &element, const std
     {
       line = element->querySelectors("polyline_3d[_child_id=" + std::to_string(child_id++) + "]");
       if (line != nullptr)
-        global_render->createPolyline3d("x" + id, x_vec, "y" + id, y_vec, "z" + id, z_vec, nullptr, line);
+        global_render->createPolyline3d("x" + id, GRM::get_copy(x_vec), "y" + id, GRM::get_copy(y_vec), "z" + id,
+                                        GRM::get_copy(z_vec), nullptr, line);
     }
 }
 
@@ -12965,8 +13019,8 @@ static void processImshow(const std::shared_ptr<GRM::Element> &element, const st
   auto plot_parent = element->parentElement();
   del_values del = del_values::update_without_default;
   int child_id = 0;
-  std::vector<double> z_data_vec;
-  std::vector<int> z_dims_vec;
+  GRM::Span<const double> z_data_vec;
+  GRM::Span<const int> z_dims_vec;
 
   getPlotParent(plot_parent);
   if (plot_parent->hasAttribute("grplot"))
@@ -12987,8 +13041,8 @@ static void processImshow(const std::shared_ptr<GRM::Element> &element, const st
     throw NotFoundError("Imshow series is missing required attribute z_dims-data.\n");
   auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
 
-  z_data_vec = GRM::get<std::vector<double>>((*context)[z_key]);
-  z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+  z_data_vec = GRM::get_span<double>((*context)[z_key]);
+  z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
   z_data_length = z_data_vec.size();
   dims = z_dims_vec.size();
   if (dims != 2) throw std::length_error("The size of dims data from imshow has to be 2.\n");
@@ -13773,7 +13827,7 @@ static void processTriContour(const std::shared_ptr<GRM::Element> &element,
   int num_levels = PLOT_DEFAULT_TRICONT_LEVELS;
   int i;
   unsigned int x_length, y_length, z_length;
-  std::vector<double> x_vec, y_vec, z_vec;
+  GRM::Span<const double> x_vec, y_vec, z_vec;
   auto plot_parent = element->parentElement();
   getPlotParent(plot_parent);
 
@@ -13802,9 +13856,9 @@ static void processTriContour(const std::shared_ptr<GRM::Element> &element,
   if (!element->hasAttribute("z")) throw NotFoundError("Tricontour series is missing required attribute pz-data.\n");
   auto z = static_cast<std::string>(element->getAttribute("z"));
 
-  x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
-  z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  x_vec = GRM::get_span<double>((*context)[x]);
+  y_vec = GRM::get_span<double>((*context)[y]);
+  z_vec = GRM::get_span<double>((*context)[z]);
   x_length = x_vec.size();
   y_length = y_vec.size();
   z_length = z_vec.size();
@@ -13812,9 +13866,9 @@ static void processTriContour(const std::shared_ptr<GRM::Element> &element,
   if (x_length != y_length || x_length != z_length)
     throw std::length_error("For tricontour series x-, y- and z-data must have the same size.\n");
 
-  double *px_p = &(x_vec[0]);
-  double *py_p = &(y_vec[0]);
-  double *pz_p = &(z_vec[0]);
+  double *px_p = const_cast<double *>(x_vec.data());
+  double *py_p = const_cast<double *>(y_vec.data());
+  double *pz_p = const_cast<double *>(z_vec.data());
   double *l_p = &(levels[0]);
   applyMoveTransformation(element);
 
@@ -13837,9 +13891,9 @@ static void processTriSurface(const std::shared_ptr<GRM::Element> &element,
   if (!element->hasAttribute("z")) throw NotFoundError("Trisurface series is missing required attribute pz-data.\n");
   auto pz = static_cast<std::string>(element->getAttribute("z"));
 
-  std::vector<double> px_vec = GRM::get<std::vector<double>>((*context)[px]);
-  std::vector<double> py_vec = GRM::get<std::vector<double>>((*context)[py]);
-  std::vector<double> pz_vec = GRM::get<std::vector<double>>((*context)[pz]);
+  auto px_vec = GRM::get_span<double>((*context)[px]);
+  auto py_vec = GRM::get_span<double>((*context)[py]);
+  auto pz_vec = GRM::get_span<double>((*context)[pz]);
 
   auto nx = (int)px_vec.size();
   auto ny = (int)py_vec.size();
@@ -13847,9 +13901,9 @@ static void processTriSurface(const std::shared_ptr<GRM::Element> &element,
   if (nx != ny || nx != nz)
     throw std::length_error("For trisurface series px-, py- and pz-data must have the same size.\n");
 
-  double *px_p = &(px_vec[0]);
-  double *py_p = &(py_vec[0]);
-  double *pz_p = &(pz_vec[0]);
+  double *px_p = const_cast<double *>(px_vec.data());
+  double *py_p = const_cast<double *>(py_vec.data());
+  double *pz_p = const_cast<double *>(pz_vec.data());
   applyMoveTransformation(element);
 
   if (redraw_ws) gr_trisurface(nx, px_p, py_p, pz_p);
@@ -13862,9 +13916,9 @@ static void volume(const std::shared_ptr<GRM::Element> &element, const std::shar
   double d_min = -1, d_max = -1;
 
   auto z_key = static_cast<std::string>(element->getAttribute("z"));
-  auto z_vec = GRM::get<std::vector<double>>((*context)[z_key]);
+  auto z_vec = GRM::get_span<double>((*context)[z_key]);
   auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
-  auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+  auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
   int algorithm = getVolumeAlgorithm(element);
   if (element->hasAttribute("d_min")) d_min = static_cast<double>(element->getAttribute("d_min"));
   if (element->hasAttribute("d_max")) d_max = static_cast<double>(element->getAttribute("d_max"));
@@ -13881,13 +13935,15 @@ static void volume(const std::shared_ptr<GRM::Element> &element, const std::shar
       long volume_address = stol(address, nullptr, 16);
       const gr3_volume_2pass_t *volume_context = (gr3_volume_2pass_t *)volume_address;
       if (redraw_ws)
-        gr_volume_2pass(z_dims_vec[0], z_dims_vec[1], z_dims_vec[2], &(z_vec[0]), algorithm, &d_min, &d_max,
-                        volume_context);
+        gr_volume_2pass(z_dims_vec[0], z_dims_vec[1], z_dims_vec[2], const_cast<double *>(z_vec.data()), algorithm,
+                        &d_min, &d_max, volume_context);
       element->removeAttribute("_volume_context_address");
     }
   else
     {
-      if (redraw_ws) gr_volume(z_dims_vec[0], z_dims_vec[1], z_dims_vec[2], &(z_vec[0]), algorithm, &d_min, &d_max);
+      if (redraw_ws)
+        gr_volume(z_dims_vec[0], z_dims_vec[1], z_dims_vec[2], const_cast<double *>(z_vec.data()), algorithm, &d_min,
+                  &d_max);
     }
 }
 
@@ -13903,12 +13959,12 @@ static void processVolume(const std::shared_ptr<GRM::Element> &element, const st
 
   if (!element->hasAttribute("z")) throw NotFoundError("Volume series is missing required attribute z-data.\n");
   auto z_key = static_cast<std::string>(element->getAttribute("z"));
-  auto z_vec = GRM::get<std::vector<double>>((*context)[z_key]);
+  auto z_vec = GRM::get_span<double>((*context)[z_key]);
   z_length = z_vec.size();
 
   if (!element->hasAttribute("z_dims")) throw NotFoundError("Volume series is missing required attribute z_dims.\n");
   auto z_dims_key = static_cast<std::string>(element->getAttribute("z_dims"));
-  auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+  auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
   dims = z_dims_vec.size();
 
   if (dims != 3) throw std::length_error("For volume series the size of z_dims has to be 3.\n");
@@ -13940,7 +13996,8 @@ static void processVolume(const std::shared_ptr<GRM::Element> &element, const st
       gr_setpicturesizeforvolume((int)(width * device_pixel_ratio), (int)(height * device_pixel_ratio));
     }
   const gr3_volume_2pass_t *volume_context =
-      gr_volume_2pass(z_dims_vec[0], z_dims_vec[1], z_dims_vec[2], &(z_vec[0]), algorithm, &d_min, &d_max, nullptr);
+      gr_volume_2pass(z_dims_vec[0], z_dims_vec[1], z_dims_vec[2], const_cast<double *>(z_vec.data()), algorithm,
+                      &d_min, &d_max, nullptr);
 
   std::ostringstream get_address;
   get_address << volume_context;
@@ -13985,9 +14042,9 @@ static void processWireframe(const std::shared_ptr<GRM::Element> &element, const
   auto y = static_cast<std::string>(element->getAttribute("y"));
   auto z = static_cast<std::string>(element->getAttribute("z"));
 
-  std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
-  std::vector<double> z_vec = GRM::get<std::vector<double>>((*context)[z]);
+  auto x_vec = GRM::get_span<double>((*context)[x]);
+  auto y_vec = GRM::get_span<double>((*context)[y]);
+  auto z_vec = GRM::get_span<double>((*context)[z]);
   x_length = x_vec.size();
   y_length = y_vec.size();
   z_length = z_vec.size();
@@ -14008,9 +14065,9 @@ static void processWireframe(const std::shared_ptr<GRM::Element> &element, const
       double *gridit_x = &(gridit_x_vec[0]);
       double *gridit_y = &(gridit_y_vec[0]);
       double *gridit_z = &(gridit_z_vec[0]);
-      double *x_p = &(x_vec[0]);
-      double *y_p = &(y_vec[0]);
-      double *z_p = &(z_vec[0]);
+      double *x_p = const_cast<double *>(x_vec.data());
+      double *y_p = const_cast<double *>(y_vec.data());
+      double *z_p = const_cast<double *>(z_vec.data());
 
       gr_gridit((int)x_length, x_p, y_p, z_p, PLOT_WIREFRAME_GRIDIT_N, PLOT_WIREFRAME_GRIDIT_N, gridit_x, gridit_y,
                 gridit_z);
@@ -14025,9 +14082,9 @@ static void processWireframe(const std::shared_ptr<GRM::Element> &element, const
         throw std::length_error("For wireframe series x_length * y_length must be z_length.\n");
     }
 
-  double *px_p = &(x_vec[0]);
-  double *py_p = &(y_vec[0]);
-  double *pz_p = &(z_vec[0]);
+  double *px_p = const_cast<double *>(x_vec.data());
+  double *py_p = const_cast<double *>(y_vec.data());
+  double *pz_p = const_cast<double *>(z_vec.data());
   applyMoveTransformation(element);
   if (redraw_ws) gr_surface((int)x_length, (int)y_length, px_p, py_p, pz_p, GR_OPTION_FILLED_MESH);
 }
@@ -14087,7 +14144,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
   unsigned int series_count = 0;
   std::vector<std::string> data_component_names = {"x", "y", "z", "c", ""};
   std::vector<std::string>::iterator current_component_name;
-  std::vector<double> current_component;
+  GRM::Span<const double> current_component;
   std::shared_ptr<GRM::Element> central_region;
   unsigned int current_point_count = 0;
   struct
@@ -14096,7 +14153,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
     const char *series;
   } * current_range_keys,
       range_keys[] = {{"x_lim", "x_range"}, {"y_lim", "y_range"}, {"z_lim", "z_range"}, {"c_lim", "c_range"}};
-  std::vector<double> bins;
+  GRM::Span<const double> bins;
   unsigned int i;
 
   logger((stderr, "Storing coordinate ranges\n"));
@@ -14168,7 +14225,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                           if (series->hasAttribute(*current_component_name))
                             {
                               auto key = static_cast<std::string>(series->getAttribute(*current_component_name));
-                              current_component = GRM::get<std::vector<double>>((*context)[key]);
+                              current_component = GRM::get_span<double>((*context)[key]);
                               current_point_count = current_component.size();
                               if (style == "stacked")
                                 {
@@ -14210,7 +14267,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                               if (!series->hasAttribute("y"))
                                 throw NotFoundError("Series is missing required attribute y.\n");
                               auto key = static_cast<std::string>(series->getAttribute("y"));
-                              auto y_vec = GRM::get<std::vector<double>>((*context)[key]);
+                              auto y_vec = GRM::get_span<double>((*context)[key]);
                               y_length = y_vec.size();
                               current_min_component = 0.0;
                               current_max_component = y_length - 1;
@@ -14224,7 +14281,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                                * -> set the current grm_min/max_component to the dimensions of `z`
                                *    (shifted by half a unit to center color blocks) */
                               const char *other_component_name = (*current_component_name == "x") ? "y" : "x";
-                              std::vector<double> other_component;
+                              GRM::Span<const double> other_component;
                               unsigned int other_point_count;
                               if (series->hasAttribute(other_component_name))
                                 {
@@ -14232,13 +14289,13 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                                   unsigned int z_length;
 
                                   auto key = static_cast<std::string>(series->getAttribute(other_component_name));
-                                  other_component = GRM::get<std::vector<double>>((*context)[key]);
+                                  other_component = GRM::get_span<double>((*context)[key]);
                                   other_point_count = other_component.size();
 
                                   if (!series->hasAttribute("z"))
                                     throw NotFoundError("Series is missing required attribute z.\n");
                                   auto z_key = static_cast<std::string>(series->getAttribute("z"));
-                                  auto z_vec = GRM::get<std::vector<double>>((*context)[z_key]);
+                                  auto z_vec = GRM::get_span<double>((*context)[z_key]);
                                   z_length = z_vec.size();
                                   current_point_count = z_length / other_point_count;
                                 }
@@ -14250,7 +14307,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                                   if (!series->hasAttribute("z_dims"))
                                     throw NotFoundError("Series is missing attribute z_dims.\n");
                                   auto z_dims_key = static_cast<std::string>(series->getAttribute("z_dims"));
-                                  auto z_dims_vec = GRM::get<std::vector<int>>((*context)[z_dims_key]);
+                                  auto z_dims_vec = GRM::get_span<int>((*context)[z_dims_key]);
                                   cols = z_dims_vec[0];
                                   rows = z_dims_vec[1];
                                   current_point_count = (*current_component_name == "x") ? cols : rows;
@@ -14261,13 +14318,13 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                           else if (series->hasAttribute("indices"))
                             {
                               auto indices_key = static_cast<std::string>(series->getAttribute("indices"));
-                              auto indices = GRM::get<std::vector<int>>((*context)[indices_key]);
+                              auto indices = GRM::get_span<int>((*context)[indices_key]);
 
                               if (series->hasAttribute(*current_component_name))
                                 {
                                   int index_sum = 0;
                                   auto key = static_cast<std::string>(series->getAttribute(*current_component_name));
-                                  current_component = GRM::get<std::vector<double>>((*context)[key]);
+                                  current_component = GRM::get_span<double>((*context)[key]);
                                   current_point_count = current_component.size();
 
                                   current_max_component = 0;
@@ -14492,8 +14549,8 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                         throw NotFoundError("Quiver series is missing required attribute v-data.\n");
                       auto v_key = static_cast<std::string>(series->getAttribute("v"));
 
-                      std::vector<double> u = GRM::get<std::vector<double>>((*context)[u_key]);
-                      std::vector<double> v = GRM::get<std::vector<double>>((*context)[v_key]);
+                      auto u = GRM::get_span<double>((*context)[u_key]);
+                      auto v = GRM::get_span<double>((*context)[v_key]);
                       u_length = u.size();
                       v_length = v.size();
                       if (u_length != v_length)
@@ -14581,7 +14638,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                       if (series->hasAttribute("orientation"))
                         orientation = static_cast<std::string>(series->getAttribute("orientation"));
                       auto key = static_cast<std::string>(series->getAttribute("y"));
-                      auto y = GRM::get<std::vector<double>>((*context)[key]);
+                      auto y = GRM::get_span<double>((*context)[key]);
                       current_point_count = y.size();
 
                       xmin = static_cast<double>(series->getAttribute("x_range_min"));
@@ -14617,7 +14674,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                       else
                         {
                           auto key = static_cast<std::string>(series->getAttribute("y"));
-                          auto y = GRM::get<std::vector<double>>((*context)[key]);
+                          auto y = GRM::get_span<double>((*context)[key]);
                           current_point_count = y.size();
                           x_max = grm_max(current_point_count + 1, x_max);
                         }
@@ -14641,7 +14698,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                   if (series->hasAttribute("orientation"))
                     orientation = static_cast<std::string>(series->getAttribute("orientation"));
                   auto key = static_cast<std::string>(series->getAttribute("y"));
-                  auto y = GRM::get<std::vector<double>>((*context)[key]);
+                  auto y = GRM::get_span<double>((*context)[key]);
                   current_point_count = y.size();
 
                   if (series->hasAttribute("y_range_min") && series->hasAttribute("y_range_max"))
@@ -14712,7 +14769,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
 
                   if (!series->hasAttribute("bins")) histBins(series, context);
                   auto bins_key = static_cast<std::string>(series->getAttribute("bins"));
-                  bins = GRM::get<std::vector<double>>((*context)[bins_key]);
+                  bins = GRM::get_span<double>((*context)[bins_key]);
                   auto num_bins = (int)bins.size();
 
                   for (i = 0; i < num_bins; i++)
@@ -15213,7 +15270,7 @@ static void processPlot(const std::shared_ptr<GRM::Element> &element, const std:
         {
           double x_min = INFINITY, x_max = (double)-INFINITY;
           auto x = static_cast<std::string>(child->getAttribute("_x_org"));
-          auto x_vec = GRM::get<std::vector<double>>((*context)[x]);
+          auto x_vec = GRM::get_copy<double>((*context)[x]);
           auto x_len = x_vec.size();
 
           if (kind == "volume")
@@ -15253,7 +15310,7 @@ static void processPlot(const std::shared_ptr<GRM::Element> &element, const std:
         {
           double y_min = INFINITY, y_max = (double)-INFINITY;
           auto y = static_cast<std::string>(child->getAttribute("_y_org"));
-          auto y_vec = GRM::get<std::vector<double>>((*context)[y]);
+          auto y_vec = GRM::get_copy<double>((*context)[y]);
           auto y_len = y_vec.size();
 
           if (kind == "volume")
@@ -15294,7 +15351,7 @@ static void processPlot(const std::shared_ptr<GRM::Element> &element, const std:
         {
           double z_min = INFINITY, z_max = (double)-INFINITY;
           auto z = static_cast<std::string>(child->getAttribute("_z_org"));
-          auto z_vec = GRM::get<std::vector<double>>((*context)[z]);
+          auto z_vec = GRM::get_copy<double>((*context)[z]);
           auto z_len = z_vec.size();
 
           if (kind == "volume")
@@ -15439,7 +15496,7 @@ static void processSeries(const std::shared_ptr<GRM::Element> &element, const st
   std::shared_ptr<GRM::Element> central_region, central_region_parent;
 
   central_region_parent = plot_elem;
-  if (kind == "marginal_heatmap") central_region_parent = plot_elem->children()[0];
+  if (kind == "marginal_heatmap") central_region_parent = plot_elem->firstChildElement();
   for (const auto &child : central_region_parent->children())
     {
       if (child->localName() == "central_region")
@@ -15457,6 +15514,184 @@ static void processSeries(const std::shared_ptr<GRM::Element> &element, const st
     }
 }
 
+/* ========================= element types ========================================================================== */
+
+/*!
+ * All element types the renderer can process. Elements are mapped to their type once per local name, so processing an
+ * element needs neither string comparisons nor a lookup in a string keyed map.
+ */
+enum class ElementType
+{
+  angle_line,
+  arc_grid_line,
+  axes_3d,
+  axis,
+  bar,
+  cell_array,
+  central_region,
+  colorbar,
+  coordinate_system,
+  draw_arc,
+  draw_graphics,
+  draw_image,
+  draw_rect,
+  error_bar,
+  error_bars,
+  figure,
+  fill_arc,
+  fill_area,
+  fill_rect,
+  grid_3d,
+  grid_line,
+  integral,
+  integral_group,
+  isosurface_render,
+  label,
+  labels_group,
+  layout_grid,
+  layout_grid_element,
+  legend,
+  marginal_heatmap_plot,
+  nonuniform_cell_array,
+  nonuniform_polar_cell_array,
+  panzoom,
+  pie_segment,
+  plot,
+  polar_bar,
+  polar_cell_array,
+  polyline,
+  polyline_3d,
+  polymarker,
+  polymarker_3d,
+  rho_axes,
+  root,
+  series,
+  side_plot_region,
+  side_region,
+  text,
+  text_region,
+  theta_axes,
+  tick,
+  tick_group,
+  titles_3d,
+  unknown,
+  unresolved
+};
+
+struct ElementTypeInfo
+{
+  ElementType type;
+  const char *local_name;
+  void (*process)(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context);
+  /* drawables are processed when the z-queue is being processed */
+  bool push_to_z_queue;
+  /* modifiers only set up the state (viewport, window, ...) for their children */
+  bool is_modifier;
+};
+
+static const ElementTypeInfo element_type_infos[] = {
+    {ElementType::angle_line, "angle_line", processAngleLine, false, true},
+    {ElementType::arc_grid_line, "arc_grid_line", processArcGridLine, false, true},
+    {ElementType::axes_3d, "axes_3d", processAxes3d, true, false},
+    {ElementType::axis, "axis", processAxis, false, true},
+    {ElementType::bar, "bar", processBar, false, false},
+    {ElementType::cell_array, "cell_array", processCellArray, true, false},
+    {ElementType::central_region, "central_region", nullptr, false, true},
+    {ElementType::colorbar, "colorbar", processColorbar, false, false},
+    {ElementType::coordinate_system, "coordinate_system", processCoordinateSystem, false, false},
+    {ElementType::draw_arc, "draw_arc", processDrawArc, true, false},
+    {ElementType::draw_graphics, "draw_graphics", processDrawGraphics, true, false},
+    {ElementType::draw_image, "draw_image", processDrawImage, true, false},
+    {ElementType::draw_rect, "draw_rect", processDrawRect, true, false},
+    {ElementType::error_bar, "error_bar", processErrorBar, false, false},
+    {ElementType::error_bars, "error_bars", processErrorBars, false, false},
+    {ElementType::figure, "figure", nullptr, false, true},
+    {ElementType::fill_arc, "fill_arc", processFillArc, true, false},
+    {ElementType::fill_area, "fill_area", processFillArea, true, false},
+    {ElementType::fill_rect, "fill_rect", processFillRect, true, false},
+    {ElementType::grid_3d, "grid_3d", processGrid3d, true, false},
+    {ElementType::grid_line, "grid_line", processGridLine, true, false},
+    {ElementType::integral, "integral", processIntegral, false, false},
+    {ElementType::integral_group, "integral_group", processIntegralGroup, false, false},
+    {ElementType::isosurface_render, "isosurface_render", processIsosurfaceRender, true, false},
+    {ElementType::label, "label", nullptr, false, true},
+    {ElementType::labels_group, "labels_group", nullptr, false, true},
+    {ElementType::layout_grid, "layout_grid", processLayoutGrid, true, false},
+    {ElementType::layout_grid_element, "layout_grid_element", nullptr, false, true},
+    {ElementType::legend, "legend", processLegend, false, false},
+    {ElementType::marginal_heatmap_plot, "marginal_heatmap_plot", processMarginalHeatmapPlot, false, false},
+    {ElementType::nonuniform_cell_array, "nonuniform_cell_array", processNonuniformCellArray, true, false},
+    {ElementType::nonuniform_polar_cell_array, "nonuniform_polar_cell_array", processNonUniformPolarCellArray, true,
+     false},
+    {ElementType::panzoom, "panzoom", processPanzoom, true, false},
+    {ElementType::pie_segment, "pie_segment", processPieSegment, false, false},
+    {ElementType::plot, "plot", nullptr, false, true},
+    {ElementType::polar_bar, "polar_bar", processPolarBar, false, false},
+    {ElementType::polar_cell_array, "polar_cell_array", processPolarCellArray, true, false},
+    {ElementType::polyline, "polyline", processPolyline, true, false},
+    {ElementType::polyline_3d, "polyline_3d", processPolyline3d, true, false},
+    {ElementType::polymarker, "polymarker", processPolymarker, true, false},
+    {ElementType::polymarker_3d, "polymarker_3d", processPolymarker3d, true, false},
+    {ElementType::rho_axes, "rho_axes", processRhoAxes, false, true},
+    {ElementType::root, "root", nullptr, false, true},
+    {ElementType::series, "series", processSeries, false, false},
+    {ElementType::side_plot_region, "side_plot_region", processSidePlotRegion, false, true},
+    {ElementType::side_region, "side_region", processSideRegion, false, true},
+    {ElementType::text, "text", processText, true, false},
+    {ElementType::text_region, "text_region", processTextRegion, false, true},
+    {ElementType::theta_axes, "theta_axes", processThetaAxes, false, true},
+    {ElementType::tick, "tick", processTick, true, false},
+    {ElementType::tick_group, "tick_group", processTickGroup, false, true},
+    {ElementType::titles_3d, "titles_3d", processTitles3d, true, false},
+    {ElementType::unknown, "", nullptr, false, false},
+};
+
+static const ElementTypeInfo &elementTypeInfo(ElementType type)
+{
+  static const auto infos_by_type = [] {
+    std::array<const ElementTypeInfo *, static_cast<std::size_t>(ElementType::unknown) + 1> infos{};
+    for (const auto &info : element_type_infos) infos[static_cast<std::size_t>(info.type)] = &info;
+    return infos;
+  }();
+  return *infos_by_type[static_cast<std::size_t>(type)];
+}
+
+static ElementType elementType(const GRM::Element &element)
+{
+  /*!
+   * \returns the type of `element`; the local name is only looked up when an element with this local name is
+   *          processed for the first time
+   */
+  static std::vector<ElementType> types_by_local_name;
+  auto local_name_id = element.localNameId();
+  if (local_name_id >= types_by_local_name.size())
+    {
+      types_by_local_name.resize(local_name_id + 1, ElementType::unresolved);
+    }
+  auto &type = types_by_local_name[local_name_id];
+  if (type == ElementType::unresolved)
+    {
+      const auto &local_name = element.localName();
+      type = ElementType::unknown;
+      if (starts_with(local_name, "series"))
+        {
+          type = ElementType::series;
+        }
+      else
+        {
+          for (const auto &info : element_type_infos)
+            {
+              if (local_name == info.local_name)
+                {
+                  type = info.type;
+                  break;
+                }
+            }
+        }
+    }
+  return type;
+}
+
 static void processElement(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
 {
   /*!
@@ -15466,78 +15701,29 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
    * \param[in] context The GRM::Context containing the actual data
    */
 
-  // Map used for processing all kinds of elements
-  bool update_required = static_cast<int>(element->getAttribute("_update_required"));
-  static std::map<std::string,
-                  std::function<void(const std::shared_ptr<GRM::Element>, const std::shared_ptr<GRM::Context>)>>
-      elemStringToFunc{
-          {std::string("angle_line"), processAngleLine},
-          {std::string("arc_grid_line"), processArcGridLine},
-          {std::string("axes_3d"), PushDrawableToZQueue(processAxes3d)},
-          {std::string("axis"), processAxis},
-          {std::string("bar"), processBar},
-          {std::string("cell_array"), PushDrawableToZQueue(processCellArray)},
-          {std::string("colorbar"), processColorbar},
-          {std::string("coordinate_system"), processCoordinateSystem},
-          {std::string("error_bar"), processErrorBar},
-          {std::string("error_bars"), processErrorBars},
-          {std::string("legend"), processLegend},
-          {std::string("draw_arc"), PushDrawableToZQueue(processDrawArc)},
-          {std::string("draw_graphics"), PushDrawableToZQueue(processDrawGraphics)},
-          {std::string("draw_image"), PushDrawableToZQueue(processDrawImage)},
-          {std::string("draw_rect"), PushDrawableToZQueue(processDrawRect)},
-          {std::string("fill_arc"), PushDrawableToZQueue(processFillArc)},
-          {std::string("fill_area"), PushDrawableToZQueue(processFillArea)},
-          {std::string("fill_rect"), PushDrawableToZQueue(processFillRect)},
-          {std::string("grid_3d"), PushDrawableToZQueue(processGrid3d)},
-          {std::string("grid_line"), PushDrawableToZQueue(processGridLine)},
-          {std::string("integral"), processIntegral},
-          {std::string("integral_group"), processIntegralGroup},
-          {std::string("isosurface_render"), PushDrawableToZQueue(processIsosurfaceRender)},
-          {std::string("layout_grid"), PushDrawableToZQueue(processLayoutGrid)},
-          {std::string("marginal_heatmap_plot"), processMarginalHeatmapPlot},
-          {std::string("nonuniform_polar_cell_array"), PushDrawableToZQueue(processNonUniformPolarCellArray)},
-          {std::string("nonuniform_cell_array"), PushDrawableToZQueue(processNonuniformCellArray)},
-          {std::string("panzoom"), PushDrawableToZQueue(processPanzoom)},
-          {std::string("pie_segment"), processPieSegment},
-          {std::string("polar_bar"), processPolarBar},
-          {std::string("polar_cell_array"), PushDrawableToZQueue(processPolarCellArray)},
-          {std::string("polyline"), PushDrawableToZQueue(processPolyline)},
-          {std::string("polyline_3d"), PushDrawableToZQueue(processPolyline3d)},
-          {std::string("polymarker"), PushDrawableToZQueue(processPolymarker)},
-          {std::string("polymarker_3d"), PushDrawableToZQueue(processPolymarker3d)},
-          {std::string("rho_axes"), processRhoAxes},
-          {std::string("series"), processSeries},
-          {std::string("side_region"), processSideRegion},
-          {std::string("side_plot_region"), processSidePlotRegion},
-          {std::string("text"), PushDrawableToZQueue(processText)},
-          {std::string("text_region"), processTextRegion},
-          {std::string("theta_axes"), processThetaAxes},
-          {std::string("tick"), PushDrawableToZQueue(processTick)},
-          {std::string("tick_group"), processTickGroup},
-          {std::string("titles_3d"), PushDrawableToZQueue(processTitles3d)},
-      };
+  static const GRM::AttributeKey update_required_key("_update_required");
+  bool update_required = static_cast<int>(element->getAttribute(update_required_key));
+  auto type = elementType(*element);
+  const auto &type_info = elementTypeInfo(type);
 
   /* Modifier */
-  if (str_equals_any(element->localName(), "axis", "central_region", "figure", "plot", "label", "labels_group", "root",
-                     "layout_grid_element", "rho_axes", "side_region", "text_region", "side_plot_region", "tick_group",
-                     "theta_axes", "arc_grid_line", "angle_line"))
+  if (type_info.is_modifier)
     {
       bool old_state = automatic_update;
       automatic_update = false;
       /* check if figure is active; skip inactive elements */
-      if (element->localName() == "figure")
+      if (type == ElementType::figure)
         {
           if (!static_cast<int>(element->getAttribute("active"))) return;
           if (global_root->querySelectorsAll("draw_graphics").empty()) plotProcessWsWindowWsViewport(element, context);
         }
-      if (element->localName() == "plot")
+      if (type == ElementType::plot)
         {
           std::shared_ptr<GRM::Element> central_region_parent = element;
           processPlot(element, context);
+          // if the kind is marginal_heatmap plot can only has 1 child and this child is the marginal_heatmap_plot
           if (static_cast<std::string>(element->getAttribute("_kind")) == "marginal_heatmap")
-            central_region_parent = element->children()[0]; // if the kind is marginal_heatmap plot can only has 1 child
-                                                            // and this child is the marginal_heatmap_plot
+            central_region_parent = element->firstChildElement();
 
           if (central_region_parent != element) calculateViewport(central_region_parent);
 
@@ -15557,22 +15743,14 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
         {
           calculateViewport(element);
         }
-      if (element->localName() == "angle_line") processAngleLine(element, context);
-      if (element->localName() == "arc_grid_line") processArcGridLine(element, context);
-      if (element->localName() == "axis") processAxis(element, context);
-      if (element->localName() == "rho_axes") processRhoAxes(element, context);
-      if (element->localName() == "side_plot_region") processSidePlotRegion(element, context);
-      if (element->localName() == "side_region") processSideRegion(element, context);
-      if (element->localName() == "text_region") processTextRegion(element, context);
-      if (element->localName() == "theta_axes") processThetaAxes(element, context);
-      if (element->localName() == "tick_group") processTickGroup(element, context);
+      if (type_info.process) type_info.process(element, context);
       GRM::Render::processAttributes(element);
       automatic_update = old_state;
-      if (element->localName() != "root") applyMoveTransformation(element);
+      if (type != ElementType::root) applyMoveTransformation(element);
     }
   else
     {
-      if (element->localName() == "marginal_heatmap_plot")
+      if (type == ElementType::marginal_heatmap_plot)
         {
           bool old_state = automatic_update;
           automatic_update = false;
@@ -15595,8 +15773,6 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
         {
           // elements without children are the draw-functions which need to be processed everytime, else there could
           // be problems with overlapping elements
-          std::string local_name = getLocalName(element);
-
           bool old_state = automatic_update;
           automatic_update = false;
           /* The attributes of drawables (except for the z_index itself) are being processed when the z_queue is being
@@ -15611,20 +15787,24 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
               GRM::Render::processAttributes(element);
             }
 
-          if (auto search = elemStringToFunc.find(local_name); search != elemStringToFunc.end())
+          if (!type_info.process)
             {
-              auto f = search->second;
-              f(element, context);
+              throw NotFoundError("No dom render function found for element with local name: " + element->localName() +
+                                  "\n");
+            }
+          if (type_info.push_to_z_queue)
+            {
+              pushDrawableToZQueue(element, context, type_info.process);
             }
           else
             {
-              throw NotFoundError("No dom render function found for element with local name: " + element->localName() +
-                                  "\n");
+              type_info.process(element, context);
             }
 
           // reset _update_required
-          element->setAttribute("_update_required", false);
-          element->setAttribute("_delete_children", 0);
+          static const GRM::AttributeKey delete_children_key("_delete_children");
+          element->setAttribute(update_required_key, GRM::Value(0));
+          element->setAttribute(delete_children_key, GRM::Value(0));
           if (update_required)
             {
               for (const auto &child : element->children())
@@ -15653,7 +15833,73 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~ render functions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  */
 
-static void renderHelper(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
+static int findSegmentStoreWkid()
+{
+  /*!
+   * Find a workstation id for the segment store.
+   *
+   * \returns the lowest unused workstation id or 0 if another WISS workstation is already open
+   */
+  int errind, num_open, wkid, conid, wtype, i;
+  std::set<int> open_wkids;
+
+  gks_inq_open_ws(1, &errind, &num_open, &wkid);
+  for (i = 1; i <= num_open; i++)
+    {
+      gks_inq_open_ws(i, &errind, &num_open, &wkid);
+      gks_inq_ws_conntype(wkid, &errind, &conid, &wtype);
+      // GKS supports only one WISS workstation, and segments of other users must not be touched
+      if (wtype == 5) return 0;
+      open_wkids.insert(wkid);
+    }
+  for (wkid = DEFAULT_WKID + 1; open_wkids.count(wkid) != 0 || wkid == PRINT_WKID; wkid++)
+    ;
+  return wkid;
+}
+
+static bool openSegmentStore()
+{
+  /*!
+   * Open the WISS workstation holding the recorded segments if it is not open yet. The workstation is only activated
+   * while a segment is recorded, so it is not affected by clearing the active workstations.
+   *
+   * \returns true if segments can be recorded and replayed
+   */
+  int errind, conid, wtype;
+
+  if (segment_store_unavailable) return false;
+  if (segment_store_wkid != 0)
+    {
+      gks_inq_ws_conntype(segment_store_wkid, &errind, &conid, &wtype);
+      if (errind == GKS_K_NO_ERROR && wtype == 5) return true;
+    }
+
+  // GKS has been (re)initialized, so all segments recorded so far are gone
+  for (auto &entry : plot_drawable_cache)
+    {
+      entry.second.segment = 0;
+      for (const auto &drawable : entry.second.drawables) drawable->segment = 0;
+    }
+  recorded_segments.clear();
+  segment_store_wkid = findSegmentStoreWkid();
+  if (segment_store_wkid != 0)
+    {
+      gr_openws(segment_store_wkid, nullptr, 5);
+      gks_inq_ws_conntype(segment_store_wkid, &errind, &conid, &wtype);
+    }
+  if (segment_store_wkid == 0 || errind != GKS_K_NO_ERROR || wtype != 5)
+    {
+      logger((stderr, "Could not open a WISS workstation, plots are not recorded into segments\n"));
+      segment_store_unavailable = true;
+      return false;
+    }
+  return true;
+}
+
+typedef std::deque<std::vector<std::shared_ptr<GRM::Element>>> ChildBuffers;
+
+static void renderHelper(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context,
+                         ChildBuffers &child_buffers, std::size_t depth)
 {
   /*!
    * Recursive helper function for render; Not part of render class
@@ -15662,7 +15908,47 @@ static void renderHelper(const std::shared_ptr<GRM::Element> &element, const std
    *
    * \param[in] element A GRM::Element
    * \param[in] context A GRM::Context
+   * \param[in] child_buffers One buffer per tree depth which is reused for collecting the children of all elements on
+   *                          that depth
+   * \param[in] depth The depth of `element` in the traversed tree
    */
+  std::vector<std::shared_ptr<Drawable>> plot_drawables, *parent_recorded_drawables = recorded_drawables;
+  bool is_plot = element->localName() == "plot", parent_modified = ancestor_modified;
+  int plot_segment = 0;
+
+  /* a plot can only be reused if neither the plot subtree nor one of the elements above it has been modified */
+  if (is_plot && reuse_plot_drawables && !ancestor_modified && !element->isDirty())
+    {
+      auto search = plot_drawable_cache.find(element);
+      // when drawing, the graphics which are not part of the drawables must be available as a segment
+      if (search != plot_drawable_cache.end() &&
+          (!redraw_ws || (openSegmentStore() && search->second.segment != 0)))
+        {
+          if (redraw_ws) gr_copysegws(search->second.segment);
+          for (const auto &drawable : search->second.drawables)
+            {
+              drawable->insertionIndex = (int)z_queue.size();
+              z_queue.push(drawable);
+              if (recorded_drawables) recorded_drawables->push_back(drawable);
+              drawable_to_plot.emplace(drawable.get(), element.get());
+            }
+          return;
+        }
+    }
+  if (is_plot && record_plot_drawables)
+    {
+      recorded_drawables = &plot_drawables;
+      if (redraw_ws && openSegmentStore())
+        {
+          plot_segment = next_segment++;
+          gr_activatews(segment_store_wkid);
+          gr_createseg(plot_segment);
+          recorded_segments.insert(plot_segment);
+        }
+    }
+  // the attributes of root only hold global render flags like `_modified` which are changed in every pass
+  if (element->isModified() && element->localName() != "root") ancestor_modified = true;
+
   gr_savestate();
   z_index_manager.savestate();
   custom_color_index_manager.savestate();
@@ -15679,17 +15965,130 @@ static void renderHelper(const std::shared_ptr<GRM::Element> &element, const std
   processElement(element, context);
   if (element->hasChildNodes() && parent_types.count(element->localName()))
     {
-      for (const auto &child : element->children())
+      // processing a child can add or remove its siblings, so the children are collected before they are rendered
+      if (child_buffers.size() <= depth) child_buffers.emplace_back();
+      auto &buffer = child_buffers[depth];
+      element->children(buffer);
+      for (const auto &child : buffer)
         {
           if (child->localName() == "figure" && !static_cast<int>(child->getAttribute("active"))) continue;
-          renderHelper(child, context);
+          renderHelper(child, context, child_buffers, depth + 1);
         }
+      buffer.clear();
     }
   if (bounding_boxes && !isDrawable(element)) gr_cancelbboxcallback();
+  if (plot_segment != 0)
+    {
+      gr_closeseg();
+      gr_deactivatews(segment_store_wkid);
+    }
 
   custom_color_index_manager.restorestate();
   z_index_manager.restorestate();
   gr_restorestate();
+
+  ancestor_modified = parent_modified;
+  if (is_plot && record_plot_drawables)
+    {
+      recorded_drawables = parent_recorded_drawables;
+      if (recorded_drawables)
+        recorded_drawables->insert(recorded_drawables->end(), plot_drawables.begin(), plot_drawables.end());
+      for (const auto &drawable : plot_drawables) drawable_to_plot.emplace(drawable.get(), element.get());
+      plot_drawable_cache[element] = CachedPlot{std::move(plot_drawables), plot_segment};
+    }
+}
+
+static void renderHelper(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
+{
+  /*!
+   * Render or process `element` and its subtree
+   *
+   * \param[in] element A GRM::Element
+   * \param[in] context A GRM::Context
+   */
+  ChildBuffers child_buffers;
+  renderHelper(element, context, child_buffers, 0);
+}
+
+static void beginRenderPass(bool reuse_unmodified_plots)
+{
+  /*!
+   * Prepare a render pass of the whole tree which records the drawables of all plots
+   *
+   * \param[in] reuse_unmodified_plots Push the cached drawables of plots whose subtree has not been modified since the
+   *                                   last pass to the z-queue instead of processing these plots again
+   */
+  bool bounding_boxes = (getenv("GRDISPLAY") && strcmp(getenv("GRDISPLAY"), "edit") == 0);
+
+  // bounding boxes are calculated while processing the elements, so plots cannot be skipped in edit mode
+  record_plot_drawables = !bounding_boxes;
+  reuse_plot_drawables = reuse_unmodified_plots && !bounding_boxes;
+  recorded_drawables = nullptr;
+  ancestor_modified = false;
+  drawable_to_plot.clear();
+  if (!reuse_plot_drawables) plot_drawable_cache.clear();
+}
+
+static void finishRenderPass(const std::shared_ptr<GRM::Context> &context)
+{
+  /*!
+   * Mark the whole tree as unmodified after a render pass and drop cached drawables of removed plots
+   *
+   * \param[in] context The GRM::Context used for rendering
+   */
+  record_plot_drawables = false;
+  reuse_plot_drawables = false;
+  for (auto it = plot_drawable_cache.begin(); it != plot_drawable_cache.end();)
+    {
+      if (it->first->isConnected())
+        ++it;
+      else
+        it = plot_drawable_cache.erase(it);
+    }
+  global_root->clearDirty();
+  rendered_context_modification_count = context->getModificationCount();
+
+  // delete the segments of drawables which are not cached anymore
+  std::set<int> used_segments;
+  for (const auto &entry : plot_drawable_cache)
+    {
+      if (entry.second.segment != 0) used_segments.insert(entry.second.segment);
+      for (const auto &drawable : entry.second.drawables)
+        {
+          if (drawable->segment != 0) used_segments.insert(drawable->segment);
+        }
+    }
+  if (!recorded_segments.empty())
+    {
+      int errind, conid, wtype;
+
+      gks_inq_ws_conntype(segment_store_wkid, &errind, &conid, &wtype);
+      if (errind != GKS_K_NO_ERROR)
+        {
+          recorded_segments.clear();
+        }
+      else if (used_segments.empty())
+        {
+          // clearing the whole segment store is much cheaper than deleting each segment on its own
+          gks_clear_ws(segment_store_wkid, GKS_K_CLEAR_ALWAYS);
+          recorded_segments.clear();
+        }
+      else
+        {
+          for (auto it = recorded_segments.begin(); it != recorded_segments.end();)
+            {
+              if (used_segments.count(*it) == 0)
+                {
+                  gks_delete_seg(*it);
+                  it = recorded_segments.erase(it);
+                }
+              else
+                {
+                  ++it;
+                }
+            }
+        }
+    }
 }
 
 static void missingBboxCalculator(const std::shared_ptr<GRM::Element> &element,
@@ -15743,31 +16142,128 @@ static void missingBboxCalculator(const std::shared_ptr<GRM::Element> &element,
     }
 }
 
+static bool isRecordedRun(const std::vector<std::shared_ptr<Drawable>> &drawables, std::size_t start)
+{
+  /*!
+   * Check if the drawables beginning at `start` are exactly the drawables which have been recorded into the segment of
+   * the first one, so the segment can be replayed instead of drawing them
+   */
+  const auto &first = drawables[start];
+
+  if (first->segmentPosition != 0 || start + first->segmentLength > drawables.size()) return false;
+  for (int j = 0; j < first->segmentLength; ++j)
+    {
+      const auto &drawable = drawables[start + j];
+      if (drawable->segment != first->segment || drawable->segmentPosition != j ||
+          !drawable->getElement()->parentElement())
+        return false;
+    }
+  return true;
+}
+
+static void endSegment(std::vector<Drawable *> &recorded, const GRM::Element **recording_plot)
+{
+  /*!
+   * Close the segment which is currently recorded and remember its length in all drawables which were drawn into it.
+   */
+  gr_closeseg();
+  gr_deactivatews(segment_store_wkid);
+  for (auto drawable : recorded) drawable->segmentLength = (int)recorded.size();
+  recorded.clear();
+  next_segment++;
+  *recording_plot = nullptr;
+}
+
 static void renderZQueue(const std::shared_ptr<GRM::Context> &context)
 {
   z_queue_is_being_rendered = true;
   bool bounding_boxes = (getenv("GRDISPLAY") && strcmp(getenv("GRDISPLAY"), "edit") == 0);
 
   gr_savestate();
-  for (; !z_queue.empty(); z_queue.pop())
+  if (record_plot_drawables && redraw_ws && openSegmentStore())
     {
-      const auto &drawable = z_queue.top();
-      auto element = drawable->getElement();
-      if (!element->parentElement()) continue;
+      std::vector<std::shared_ptr<Drawable>> drawables;
+      std::vector<Drawable *> recorded;
+      const GRM::Element *recording_plot = nullptr;
+
+      drawables.reserve(z_queue.size());
+      for (; !z_queue.empty(); z_queue.pop()) drawables.push_back(z_queue.top());
 
-      if (bounding_boxes)
+      for (std::size_t i = 0; i < drawables.size(); ++i)
         {
-          gr_setbboxcallback(bounding_id, &receiverFunction);
-          bounding_map[bounding_id] = element;
-          bounding_id++;
+          const auto &drawable = drawables[i];
+          if (!drawable->getElement()->parentElement()) continue;
+
+          if (drawable->segment != 0)
+            {
+              if (isRecordedRun(drawables, i))
+                {
+                  if (recording_plot) endSegment(recorded, &recording_plot);
+                  gr_copysegws(drawable->segment);
+                  i += drawable->segmentLength - 1;
+                  continue;
+                }
+              // the z-order has changed since the segment was recorded, so record this drawable again
+              drawable->segment = 0;
+            }
+
+          auto search = drawable_to_plot.find(drawable.get());
+          auto plot = search != drawable_to_plot.end() ? search->second : nullptr;
+          if (recording_plot && recording_plot != plot) endSegment(recorded, &recording_plot);
+          if (!recording_plot && plot)
+            {
+              gr_activatews(segment_store_wkid);
+              gr_createseg(next_segment);
+              recorded_segments.insert(next_segment);
+              recording_plot = plot;
+            }
+          if (recording_plot)
+            {
+              drawable->segment = next_segment;
+              drawable->segmentPosition = (int)recorded.size();
+              recorded.push_back(drawable.get());
+            }
+
+          custom_color_index_manager.selectcontext(drawable->getGrContextId());
+          drawable->draw();
         }
+      if (recording_plot) endSegment(recorded, &recording_plot);
+    }
+  else
+    {
+      for (; !z_queue.empty(); z_queue.pop())
+        {
+          const auto &drawable = z_queue.top();
+          auto element = drawable->getElement();
+          if (!element->parentElement()) continue;
+
+          if (bounding_boxes)
+            {
+              gr_setbboxcallback(bounding_id, &receiverFunction);
+              bounding_map[bounding_id] = element;
+              bounding_id++;
+            }
 
-      custom_color_index_manager.selectcontext(drawable->getGrContextId());
-      drawable->draw();
+          custom_color_index_manager.selectcontext(drawable->getGrContextId());
+          drawable->draw();
 
-      if (bounding_boxes) gr_cancelbboxcallback();
+          if (bounding_boxes) gr_cancelbboxcallback();
+        }
+    }
+  if (plot_drawable_cache.empty())
+    {
+      gr_context_id_manager.markAllIdsAsUnused();
+    }
+  else
+    {
+      /* the gr contexts of cached drawables are needed again in the next render pass */
+      std::set<int> retained_ids;
+      for (const auto &entry : plot_drawable_cache)
+        {
+          for (const auto &drawable : entry.second.drawables) retained_ids.insert(drawable->getGrContextId());
+        }
+      gr_context_id_manager.markAllIdsAsUnused(retained_ids);
     }
-  gr_context_id_manager.markAllIdsAsUnused();
   parent_to_context = {};
   gr_unselectcontext();
   gr_restorestate();
@@ -15958,7 +16454,7 @@ static void applyPlotDefaults(const std::shared_ptr<GRM::Element> &plot)
   if (!plot->hasAttribute("colormap")) plot->setAttribute("colormap", PLOT_DEFAULT_COLORMAP);
 
   auto central_region_parent = plot;
-  if (kind == "marginal_heatmap") central_region_parent = plot->children()[0];
+  if (kind == "marginal_heatmap") central_region_parent = plot->firstChildElement();
   for (const auto &child : central_region_parent->children())
     {
       if (child->localName() == "central_region")
@@ -16112,11 +16608,18 @@ void GRM::Render::render()
                     << "\n";
         }
       if (static_cast<int>(root->getAttribute("_clear_ws"))) gr_clearws();
+      // the tree is rendered right below, an automatic update would draw all plots a second time
+      bool old_state = automatic_update;
+      automatic_update = false;
       root->setAttribute("_modified", true);
+      automatic_update = old_state;
       finalizeGrid(active_figure);
+      GRM::Context::resetBytesCopied();
+      beginRenderPass(this->context->getModificationCount() == rendered_context_modification_count);
       renderHelper(root, this->context);
       renderZQueue(this->context);
       root->setAttribute("_modified", false); // reset the modified flag, cause all updates are made
+      logger((stderr, "%zu bytes of context data were copied during rendering\n", GRM::Context::bytesCopied()));
       if (getenv("GRDISPLAY") && strcmp(getenv("GRDISPLAY"), "edit") == 0) missingBboxCalculator(root, this->context);
       if (root->hasAttribute("_update_ws") && static_cast<int>(root->getAttribute("_update_ws"))) gr_updatews();
       // needed when series_line is changed to series_scatter for example
@@ -16138,15 +16641,19 @@ void GRM::Render::render()
       // reset marker types
       previous_scatter_marker_type = plot_scatter_markertypes;
       previous_line_marker_type = plot_scatter_markertypes;
+      finishRenderPass(this->context);
     }
 }
 
 void GRM::Render::process_tree()
 {
+  /* unmodified plots are reused from the last pass unless context data could have been changed in the meantime */
+  beginRenderPass(this->context->getModificationCount() == rendered_context_modification_count);
   global_root->setAttribute("_modified", true);
   renderHelper(global_root, this->context);
   renderZQueue(this->context);
   global_root->setAttribute("_modified", false); // reset the modified flag, cause all updates are made
+  finishRenderPass(this->context);
 }
 
 void GRM::Render::finalize()
@@ -18530,8 +19037,8 @@ void updateFilter(const std::shared_ptr<GRM::Element> &element, const std::strin
           auto plot_parent = element->parentElement();
           getPlotParent(plot_parent);
           central_region_parent = plot_parent;
-          if (plot_parent->children()[0]->localName() == "marginal_heatmap_plot")
-            central_region_parent = plot_parent->children()[0];
+          if (plot_parent->firstChildElement()->localName() == "marginal_heatmap_plot")
+            central_region_parent = plot_parent->firstChildElement();
           for (const auto &child : central_region_parent->children())
             {
               if (child->localName() == "central_region")
@@ -18664,10 +19171,10 @@ void updateFilter(const std::shared_ptr<GRM::Element> &element, const std::strin
                   auto id = static_cast<int>(global_root->getAttribute("_id"));
                   auto str = std::to_string(id);
                   auto x = static_cast<std::string>(element->getAttribute("x"));
-                  auto x_vec = GRM::get<std::vector<double>>((*context)[x]);
+                  auto x_vec = GRM::get_span<double>((*context)[x]);
                   int x_length = (int)x_vec.size();
                   auto y = static_cast<std::string>(element->getAttribute("y"));
-                  auto y_vec = GRM::get<std::vector<double>>((*context)[y]);
+                  auto y_vec = GRM::get_span<double>((*context)[y]);
                   int y_length = (int)y_vec.size();
                   std::vector<int> z_dims_vec = {(int)x_length, (int)y_length};
                   (*context)["z_dims" + str] = z_dims_vec;
@@ -18994,8 +19501,8 @@ void updateFilter(const std::shared_ptr<GRM::Element> &element, const std::strin
                                           static_cast<std::string>(barplot->getAttribute("style")) == "default")
                                         {
                                           auto y_key = static_cast<std::string>(barplot->getAttribute("y"));
-                                          std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
-                                          if (size(y_vec) > 20)
+                                          auto y_vec = GRM::get_span<double>((*context)[y_key]);
+                                          if (y_vec.size() > 20)
                                             {
                                               problematic_bar_num = true;
                                               break;
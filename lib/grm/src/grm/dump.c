@@ -288,7 +288,7 @@ void grm_dump_json(const grm_args_t *args, FILE *f)
 
   if (memwriter == NULL)
     {
-      memwriter = memwriter_new();
+      memwriter = memwriter_new_with_capacity(args_estimate_serialized_size(args, 1));
     }
   tojson_write_args(memwriter, args);
   if (tojson_is_complete())
@@ -307,7 +307,7 @@ char *grm_dump_json_str(void)
 
   if (memwriter == NULL)
     {
-      memwriter = memwriter_new();
+      memwriter = memwriter_new_with_capacity(args_estimate_serialized_size(active_plot_args, 1));
     }
   /* tojson_write_args(memwriter, global_root_args); */
   tojson_write_args(memwriter, active_plot_args);
@@ -332,7 +332,7 @@ void grm_dump_bson(const grm_args_t *args, FILE *f)
 
   if (memwriter == NULL)
     {
-      memwriter = memwriter_new();
+      memwriter = memwriter_new_with_capacity(args_estimate_serialized_size(args, 0));
     }
   tobson_write_args(memwriter, args);
   if (tobson_is_complete())
@@ -0,0 +1,24 @@
+#ifndef GRM_FLOAT_PARSE_INT_H_INCLUDED
+#define GRM_FLOAT_PARSE_INT_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ######################### includes ############################################################################### */
+
+#include <stddef.h>
+
+
+/* ######################### internal interface ##################################################################### */
+
+/* ========================= functions ============================================================================== */
+
+/* ------------------------- float parsing -------------------------------------------------------------------------- */
+
+double float_parse_double(const char *begin, const char *end, const char **number_end);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ifndef GRM_FLOAT_PARSE_INT_H_INCLUDED */
@@ -1,17 +1,30 @@
 /* ######################### includes ############################################################################### */
 
+#include "float_parse_int.h"
 #include "import_int.hxx"
 #include "util_int.h"
 #include "utilcpp_int.hxx"
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <fstream>
+#include <limits>
 #include <list>
 #include <sstream>
 #include <algorithm>
 #include <map>
 #include <iostream>
-#include <clocale>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 /* ========================= static variables ======================================================================= */
 
@@ -223,6 +236,957 @@ err_t parse_columns(std::list<int> *columns, const char *colms)
   return ERROR_NONE;
 }
 
+/* data files are split into chunks of at least this size which are parsed in parallel */
+#define DATA_FILE_MIN_CHUNK_SIZE (1 << 20)
+
+/*!
+ * \brief The contents of a data file.
+ *
+ * Regular files are mapped into memory, so they are parsed directly from the page cache. Standard input and files
+ * which cannot be mapped are read into a buffer.
+ */
+class DataFileSource
+{
+public:
+  explicit DataFileSource(const std::string &path)
+  {
+    if (path == "-")
+      {
+        read(stdin);
+        return;
+      }
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd < 0) return;
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0)
+      {
+        void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+          {
+            mapping_ = mapping;
+            data_ = static_cast<const char *>(mapping);
+            size_ = file_stat.st_size;
+            close(fd);
+            return;
+          }
+      }
+    close(fd);
+#endif
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file != nullptr)
+      {
+        read(file);
+        fclose(file);
+      }
+  }
+
+  DataFileSource(const DataFileSource &) = delete;
+  DataFileSource &operator=(const DataFileSource &) = delete;
+
+  ~DataFileSource()
+  {
+#ifndef _WIN32
+    if (mapping_ != nullptr) munmap(mapping_, size_);
+#endif
+  }
+
+  const char *begin() const { return data_; }
+  const char *end() const { return data_ + size_; }
+
+private:
+  void read(FILE *file)
+  {
+    char chunk[64 * 1024];
+    std::size_t bytes_read;
+    while ((bytes_read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+      {
+        buffer_.insert(buffer_.end(), chunk, chunk + bytes_read);
+      }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+
+  void *mapping_ = nullptr;
+  std::vector<char> buffer_;
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+/*!
+ * \brief A part of the numeric section of a data file which is parsed by one thread.
+ *
+ * Empty lines separate the data blocks (depth layers) of a file. The first pass counts the rows of each segment
+ * between empty lines, so all blocks can be allocated with their final size. The second pass writes the values
+ * directly into the column arrays, starting at the `segment_targets` (block index and first row) of each segment.
+ */
+struct DataChunk
+{
+  const char *begin;
+  const char *end;
+  std::size_t line_count = 0;
+  std::vector<std::size_t> segment_rows;
+  std::vector<std::pair<std::size_t, std::size_t>> segment_targets;
+  bool starts_with_break = false;
+  bool ends_with_break = false;
+  const char *last_row = nullptr;
+  err_t error = ERROR_NONE;
+  std::size_t error_line = 0;
+  std::size_t error_column = 0;
+  std::size_t error_column_count = 0;
+  std::string error_token;
+};
+
+static inline bool is_blank_char(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline const char *find_line_end(const char *begin, const char *end)
+{
+  const char *line_end = static_cast<const char *>(memchr(begin, '\n', end - begin));
+  return (line_end != nullptr) ? line_end : end;
+}
+
+static inline bool is_empty_line(const char *begin, const char *end)
+{
+  return begin == end || (end - begin == 1 && *begin == '\r');
+}
+
+/*!
+ * \brief Call `field(column, begin, end)` for each field of a data line and return the number of fields.
+ *
+ * Fields are separated by commas if the line contains one, otherwise by whitespace. Empty fields between commas are
+ * passed as empty ranges (missing values). Everything after a `#` which starts a word is a comment. Parsing stops
+ * early if `field` returns false.
+ */
+template <typename F> static std::size_t for_each_data_field(const char *begin, const char *end, F &&field)
+{
+  const char *p;
+  bool is_comma_separated = false;
+  std::size_t column = 0;
+
+  for (p = begin; p < end; ++p)
+    {
+      if (*p == '#' && (p == begin || is_blank_char(p[-1]))) break;
+      if (*p == ',') is_comma_separated = true;
+    }
+  end = p;
+  p = begin;
+  if (!is_comma_separated)
+    {
+      while (true)
+        {
+          const char *field_begin;
+          while (p < end && is_blank_char(*p)) ++p;
+          if (p == end) break;
+          field_begin = p;
+          while (p < end && !is_blank_char(*p)) ++p;
+          if (!field(column++, field_begin, p)) break;
+        }
+      return column;
+    }
+  while (true)
+    {
+      const char *field_end = static_cast<const char *>(memchr(p, ',', end - p));
+      const char *next = (field_end != nullptr) ? field_end + 1 : nullptr;
+      const char *field_begin = p;
+      if (field_end == nullptr) field_end = end;
+      while (field_begin < field_end && is_blank_char(*field_begin)) ++field_begin;
+      while (field_end > field_begin && is_blank_char(field_end[-1])) --field_end;
+      /* a comma at the end of a line does not start another field */
+      if (next == nullptr && field_begin == field_end && column > 0) break;
+      if (!field(column++, field_begin, field_end) || next == nullptr) break;
+      p = next;
+    }
+  return column;
+}
+
+static void scan_data_chunk(DataChunk &chunk)
+{
+  bool has_rows = false, pending_break = false;
+  const char *p = chunk.begin;
+
+  chunk.segment_rows.push_back(0);
+  while (p < chunk.end)
+    {
+      const char *line_end = find_line_end(p, chunk.end);
+      ++chunk.line_count;
+      if (is_empty_line(p, line_end))
+        {
+          if (has_rows)
+            {
+              pending_break = true;
+            }
+          else
+            {
+              chunk.starts_with_break = true;
+            }
+        }
+      else
+        {
+          if (pending_break)
+            {
+              chunk.segment_rows.push_back(0);
+              pending_break = false;
+            }
+          ++chunk.segment_rows.back();
+          chunk.last_row = p;
+          has_rows = true;
+        }
+      p = (line_end < chunk.end) ? line_end + 1 : chunk.end;
+    }
+  chunk.ends_with_break = pending_break || (!has_rows && chunk.starts_with_break);
+}
+
+static void parse_data_chunk(DataChunk &chunk, std::vector<std::vector<std::vector<double>>> &data,
+                             const std::vector<int> &output_columns)
+{
+  std::size_t column_count = output_columns.size();
+  std::size_t segment = 0, row = chunk.segment_targets[0].second, line = 0;
+  bool has_rows = false, pending_break = false;
+  const char *p = chunk.begin;
+
+  for (; p < chunk.end; ++line)
+    {
+      const char *line_end = find_line_end(p, chunk.end);
+      const char *line_begin = p;
+      p = (line_end < chunk.end) ? line_end + 1 : chunk.end;
+      if (is_empty_line(line_begin, line_end))
+        {
+          pending_break = has_rows;
+          continue;
+        }
+      if (pending_break)
+        {
+          ++segment;
+          row = chunk.segment_targets[segment].second;
+          pending_break = false;
+        }
+      has_rows = true;
+      auto &block = data[chunk.segment_targets[segment].first];
+      std::size_t fields = for_each_data_field(line_begin, line_end, [&](std::size_t column, const char *field_begin,
+                                                                         const char *field_end) {
+        const char *number_end;
+        double value;
+        if (column >= column_count || output_columns[column] < 0) return true;
+        if (field_begin == field_end)
+          {
+            value = NAN;
+          }
+        else
+          {
+            value = float_parse_double(field_begin, field_end, &number_end);
+            if (number_end == field_begin)
+              {
+                chunk.error = ERROR_PARSE_DOUBLE;
+                chunk.error_column = column;
+                chunk.error_token.assign(field_begin, field_end);
+                return false;
+              }
+          }
+        block[output_columns[column]][row] = value;
+        return true;
+      });
+      if (chunk.error == ERROR_NONE && fields != column_count)
+        {
+          chunk.error = ERROR_PLOT_MISSING_DATA;
+          chunk.error_column_count = fields;
+        }
+      if (chunk.error != ERROR_NONE)
+        {
+          chunk.error_line = line;
+          return;
+        }
+      ++row;
+    }
+}
+
+template <typename F> static void process_chunks_in_parallel(std::vector<DataChunk> &chunks, F process)
+{
+  std::vector<std::thread> threads;
+
+  for (std::size_t i = 1; i < chunks.size(); ++i)
+    {
+      threads.emplace_back([&process, &chunks, i]() { process(chunks[i]); });
+    }
+  process(chunks[0]);
+  for (auto &thread : threads)
+    {
+      thread.join();
+    }
+}
+
+/*!
+ * \brief Parse the numeric section of a data file into column arrays.
+ *
+ * The section is split into chunks at line boundaries which are processed in parallel. Only the columns selected by
+ * `output_columns` (the index of each file column in the output or -1) are stored. `first_line_number` is the line
+ * number of `begin` in the file and only used for error messages. `last_row` is set to the last non-empty line.
+ *
+ * Every row must have as many columns as the first data row. Rows with fewer columns are rejected like rows with more
+ * columns, since their missing values cannot be told apart from values of a shifted column. Empty fields of comma
+ * separated rows are read as NaN instead.
+ */
+static err_t read_numeric_data(const char *begin, const char *end, const std::vector<int> &output_columns,
+                               int output_column_count, int first_line_number,
+                               std::vector<std::vector<std::vector<double>>> &data, const char **last_row)
+{
+  std::size_t chunk_count = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                                  std::max<std::size_t>(1, (end - begin) / DATA_FILE_MIN_CHUNK_SIZE));
+  std::vector<DataChunk> chunks(chunk_count);
+  std::vector<std::size_t> block_rows;
+  std::size_t line_number = first_line_number;
+  bool new_block = true;
+  const char *chunk_begin = begin;
+
+  for (std::size_t i = 0; i < chunk_count; ++i)
+    {
+      chunks[i].begin = chunk_begin;
+      if (i + 1 < chunk_count)
+        {
+          const char *split = std::max(chunk_begin, begin + (end - begin) / chunk_count * (i + 1));
+          const char *line_end = find_line_end(split, end);
+          chunks[i].end = (line_end < end) ? line_end + 1 : end;
+        }
+      else
+        {
+          chunks[i].end = end;
+        }
+      chunk_begin = chunks[i].end;
+    }
+
+  process_chunks_in_parallel(chunks, [](DataChunk &chunk) { scan_data_chunk(chunk); });
+
+  /* a segment continues the last block of the previous chunk unless an empty line lies in between */
+  for (auto &chunk : chunks)
+    {
+      chunk.segment_targets.resize(chunk.segment_rows.size());
+      for (std::size_t segment = 0; segment < chunk.segment_rows.size(); ++segment)
+        {
+          if (chunk.segment_rows[segment] == 0) continue;
+          if (new_block || segment > 0 || chunk.starts_with_break) block_rows.push_back(0);
+          chunk.segment_targets[segment] = std::make_pair(block_rows.size() - 1, block_rows.back());
+          block_rows.back() += chunk.segment_rows[segment];
+          new_block = false;
+        }
+      if (chunk.ends_with_break) new_block = true;
+      if (chunk.last_row != nullptr) *last_row = chunk.last_row;
+    }
+  data.resize(block_rows.size());
+  for (std::size_t block = 0; block < block_rows.size(); ++block)
+    {
+      data[block].assign(output_column_count, std::vector<double>(block_rows[block]));
+    }
+
+  process_chunks_in_parallel(chunks, [&](DataChunk &chunk) { parse_data_chunk(chunk, data, output_columns); });
+
+  for (auto &chunk : chunks)
+    {
+      if (chunk.error == ERROR_PARSE_DOUBLE)
+        {
+          fprintf(stderr, "Invalid number in line %zu, column %zu (%s)\n", line_number + chunk.error_line,
+                  chunk.error_column + 1, chunk.error_token.c_str());
+          return chunk.error;
+        }
+      if (chunk.error == ERROR_PLOT_MISSING_DATA)
+        {
+          fprintf(stderr, "Line %zu has a different number of columns (%zu) than previous lines (%zu)\n",
+                  line_number + chunk.error_line, chunk.error_column_count, output_columns.size());
+          return chunk.error;
+        }
+      line_number += chunk.line_count;
+    }
+
+  return ERROR_NONE;
+}
+
+/*!
+ * \brief Map the columns of a data file to the stored columns.
+ *
+ * `output_columns` is set to the index of each file column among the stored columns or -1 if the column is not
+ * selected. The stored indices of the x, y and error columns are appended to `x_data`, `y_data` and `error_data`.
+ * Returns the number of stored columns.
+ */
+static int select_data_columns(std::size_t column_count, const std::list<int> &columns,
+                               const std::list<int> &x_columns, const std::list<int> &y_columns,
+                               const std::list<int> &e_columns, std::vector<int> &output_columns,
+                               std::vector<int> &x_data, std::vector<int> &y_data, std::vector<int> &error_data)
+{
+  int output_column_count = 0;
+
+  output_columns.resize(column_count);
+  for (size_t col = 0; col < column_count; col++)
+    {
+      if (columns.empty() ? (!use_bins || col > 0) : std::find(columns.begin(), columns.end(), col) != columns.end())
+        {
+          if (!x_columns.empty() && std::find(x_columns.begin(), x_columns.end(), col) != x_columns.end())
+            x_data.emplace_back(output_column_count);
+          if (!y_columns.empty() && std::find(y_columns.begin(), y_columns.end(), col) != y_columns.end())
+            y_data.emplace_back(output_column_count);
+          if (!e_columns.empty() && std::find(e_columns.begin(), e_columns.end(), col) != e_columns.end())
+            error_data.emplace_back(output_column_count);
+          output_columns[col] = output_column_count++;
+        }
+      else
+        {
+          output_columns[col] = -1;
+        }
+    }
+
+  return output_column_count;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~ binary data files ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/*
+ * Besides text, data files can be stored in binary formats which are recognized by their first bytes:
+ * - NumPy arrays (`.npy`) with one (a single column), two (rows x columns) or three dimensions (blocks x rows x
+ *   columns) in C or Fortran order
+ * - NumPy archives (`.npz`) of one- or two-dimensional arrays whose columns are used in the order of the archive, the
+ *   array names are used as labels (compressed archives need zlib)
+ * - raw little endian columns with a small header, see below
+ * The values are copied from the mapped file into the column arrays without any parsing and only the selected columns
+ * are read. The column arrays are not mapped directly, since some plot types modify the data in place.
+ *
+ * Raw data files start with a header of `RAW_DATA_HEADER_SIZE` bytes (all numbers in little endian byte order):
+ * - the magic string `GRMRAW`
+ * - the format version (1 byte, currently 1)
+ * - the value type (1 byte): `d` for 64 bit or `f` for 32 bit floating point numbers
+ * - the number of columns (4 bytes)
+ * - the number of blocks (4 bytes)
+ * - the number of rows per block (8 bytes)
+ * - the size of the labels (8 bytes)
+ * The labels (column names separated by tabs) follow, padded with zero bytes to a multiple of 8 bytes. Then, the values
+ * are stored block by block and column by column.
+ */
+
+#define RAW_DATA_MAGIC "GRMRAW"
+#define RAW_DATA_HEADER_SIZE 32
+#define NPY_MAGIC "\x93NUMPY"
+#define ZIP_LOCAL_FILE_SIGNATURE 0x04034b50u
+#define ZIP_CENTRAL_DIRECTORY_SIGNATURE 0x02014b50u
+#define ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE 0x06054b50u
+#define ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE 0x06064b50u
+#define ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE 0x07064b50u
+#define ZIP_END_OF_CENTRAL_DIRECTORY_SIZE 22
+#define ZIP_MAX_COMMENT_SIZE 65535
+/* deflate cannot compress data by more than this factor, larger uncompressed sizes of a member are invalid */
+#define ZIP_MAX_DEFLATE_RATIO 1032
+
+/*! A column of a binary data file which is read with a fixed distance (`stride`) between two values. */
+struct BinaryColumn
+{
+  const char *values;
+  std::size_t stride;
+  char kind; /* `f` (floating point number), `i` (signed integer) or `u` (unsigned integer) */
+  std::size_t item_size;
+  std::string label;
+};
+
+/*! The columns of a binary data file (`blocks[block][column]`), all columns have `row_count` values. */
+struct BinaryDataSet
+{
+  std::vector<std::vector<BinaryColumn>> blocks;
+  std::size_t row_count = 0;
+  bool has_labels = false;
+  /* blocks of a three-dimensional array cannot be combined with other arrays */
+  bool has_3d_array = false;
+  /* decompressed members of an archive */
+  std::list<std::vector<char>> buffers;
+};
+
+struct NpyArray
+{
+  const char *values;
+  char kind;
+  std::size_t item_size;
+  bool fortran_order;
+  std::vector<std::size_t> shape;
+};
+
+template <typename T> static inline T read_little_endian(const char *bytes)
+{
+  T value = 0;
+  for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+      value |= static_cast<T>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+  return value;
+}
+
+static inline bool has_bytes(const char *p, const char *end, std::size_t size)
+{
+  return p <= end && static_cast<std::size_t>(end - p) >= size;
+}
+
+static bool is_binary_data_file(const char *begin, const char *end)
+{
+  return (has_bytes(begin, end, 6) && (memcmp(begin, NPY_MAGIC, 6) == 0 || memcmp(begin, RAW_DATA_MAGIC, 6) == 0)) ||
+         (has_bytes(begin, end, 4) && read_little_endian<uint32_t>(begin) == ZIP_LOCAL_FILE_SIGNATURE);
+}
+
+static double read_binary_value(const char *bytes, char kind, std::size_t item_size)
+{
+  if (kind == 'f')
+    {
+      if (item_size == sizeof(double))
+        {
+          double value;
+          memcpy(&value, bytes, sizeof(value));
+          return value;
+        }
+      float value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+  uint64_t value = 0;
+  memcpy(&value, bytes, item_size);
+  if (kind == 'i' && item_size < sizeof(value) && (value >> (8 * item_size - 1)) != 0)
+    {
+      /* sign extension */
+      value |= ~static_cast<uint64_t>(0) << (8 * item_size);
+    }
+  return (kind == 'i') ? static_cast<double>(static_cast<int64_t>(value)) : static_cast<double>(value);
+}
+
+static void copy_binary_column(const BinaryColumn &column, std::size_t row_count, std::vector<double> &values)
+{
+  values.resize(row_count);
+  if (column.kind == 'f' && column.item_size == sizeof(double) && column.stride == sizeof(double))
+    {
+      memcpy(values.data(), column.values, row_count * sizeof(double));
+      return;
+    }
+  for (std::size_t row = 0; row < row_count; ++row)
+    {
+      values[row] = read_binary_value(column.values + row * column.stride, column.kind, column.item_size);
+    }
+}
+
+static bool find_npy_header_value(const std::string &header, const char *key, std::string &value)
+{
+  std::size_t pos = header.find(std::string("'") + key + "'"), value_end;
+
+  if (pos == std::string::npos || (pos = header.find(':', pos)) == std::string::npos) return false;
+  pos = header.find_first_not_of(" ", pos + 1);
+  if (pos == std::string::npos) return false;
+  if (header[pos] == '\'')
+    {
+      value_end = header.find('\'', ++pos);
+    }
+  else if (header[pos] == '(')
+    {
+      value_end = header.find(')', ++pos);
+    }
+  else
+    {
+      value_end = header.find_first_of(",}", pos);
+    }
+  if (value_end == std::string::npos) return false;
+  value = header.substr(pos, value_end - pos);
+
+  return true;
+}
+
+static err_t read_npy_array(const char *begin, const char *end, NpyArray &array)
+{
+  std::size_t header_size, header_offset, value_count = 1;
+  std::string header, descr, fortran_order, shape;
+  const char *shape_ptr;
+
+  if (!has_bytes(begin, end, 10) || memcmp(begin, NPY_MAGIC, 6) != 0) return ERROR_IMPORT_INVALID_FORMAT;
+  /* format version 1 stores the header size in 2 bytes, later versions in 4 bytes */
+  if (begin[6] == 1)
+    {
+      header_size = read_little_endian<uint16_t>(begin + 8);
+      header_offset = 10;
+    }
+  else
+    {
+      if (!has_bytes(begin, end, 12)) return ERROR_IMPORT_INVALID_FORMAT;
+      header_size = read_little_endian<uint32_t>(begin + 8);
+      header_offset = 12;
+    }
+  if (!has_bytes(begin + header_offset, end, header_size)) return ERROR_IMPORT_INVALID_FORMAT;
+  header.assign(begin + header_offset, header_size);
+  if (!find_npy_header_value(header, "descr", descr) ||
+      !find_npy_header_value(header, "fortran_order", fortran_order) ||
+      !find_npy_header_value(header, "shape", shape) || descr.size() < 3)
+    {
+      return ERROR_IMPORT_INVALID_FORMAT;
+    }
+  array.kind = descr[1];
+  array.item_size = strtoul(descr.c_str() + 2, nullptr, 10);
+  /* only little endian (or single byte) numbers are supported */
+  if (strchr("<|=", descr[0]) == nullptr ||
+      !((array.kind == 'f' && (array.item_size == 4 || array.item_size == 8)) ||
+        ((array.kind == 'i' || array.kind == 'u') &&
+         (array.item_size == 1 || array.item_size == 2 || array.item_size == 4 || array.item_size == 8))))
+    {
+      fprintf(stderr, "Unsupported data type \"%s\" in NumPy array\n", descr.c_str());
+      return ERROR_UNSUPPORTED_DATATYPE;
+    }
+  array.fortran_order = (fortran_order == "True");
+  array.shape.clear();
+  for (shape_ptr = shape.c_str(); *shape_ptr != '\0';)
+    {
+      char *number_end;
+      std::size_t dimension = strtoull(shape_ptr, &number_end, 10);
+      if (number_end == shape_ptr) break;
+      array.shape.push_back(dimension);
+      shape_ptr = number_end + strspn(number_end, ", ");
+    }
+  for (auto dimension : array.shape)
+    {
+      if (dimension != 0 && value_count > SIZE_MAX / array.item_size / dimension) return ERROR_IMPORT_INVALID_FORMAT;
+      value_count *= dimension;
+    }
+  array.values = begin + header_offset + header_size;
+  if (array.shape.empty() || array.shape.size() > 3 || !has_bytes(array.values, end, value_count * array.item_size))
+    {
+      return ERROR_IMPORT_INVALID_FORMAT;
+    }
+
+  return ERROR_NONE;
+}
+
+/*!
+ * \brief Add the columns of a NumPy array to a data set.
+ *
+ * One-dimensional arrays are one column, the columns of two-dimensional arrays are the second dimension and
+ * three-dimensional arrays contain several blocks. Arrays without a name (`.npy` files) have no labels.
+ */
+static err_t add_npy_columns(const NpyArray &array, const std::string &name, BinaryDataSet &data_set)
+{
+  std::size_t ndim = array.shape.size();
+  std::size_t block_count = (ndim == 3) ? array.shape[0] : 1;
+  std::size_t row_count = array.shape[(ndim == 3) ? 1 : 0];
+  std::size_t column_count = (ndim >= 2) ? array.shape[ndim - 1] : 1;
+  std::size_t item_size = array.item_size;
+
+  if (!data_set.blocks.empty() && (ndim == 3 || data_set.has_3d_array))
+    {
+      fprintf(stderr, "Three-dimensional arrays are only supported in single array files\n");
+      return ERROR_UNSUPPORTED_DATATYPE;
+    }
+  if (!data_set.blocks.empty() && row_count != data_set.row_count)
+    {
+      fprintf(stderr, "The array \"%s\" has a different number of rows (%zu) than the previous arrays (%zu)\n",
+              name.c_str(), row_count, data_set.row_count);
+      return ERROR_PLOT_COMPONENT_LENGTH_MISMATCH;
+    }
+  data_set.row_count = row_count;
+  data_set.has_3d_array = (ndim == 3);
+  data_set.blocks.resize(block_count);
+  for (std::size_t block = 0; block < block_count; ++block)
+    {
+      for (std::size_t col = 0; col < column_count; ++col)
+        {
+          BinaryColumn column;
+          /* the offsets of value (block, row, col) are ((block * rows + row) * cols + col) in C order and
+           * (block + blocks * (row + rows * col)) in Fortran order */
+          if (array.fortran_order)
+            {
+              column.values = array.values + (block + block_count * row_count * col) * item_size;
+              column.stride = block_count * item_size;
+            }
+          else
+            {
+              column.values = array.values + (block * row_count * column_count + col) * item_size;
+              column.stride = column_count * item_size;
+            }
+          column.kind = array.kind;
+          column.item_size = item_size;
+          if (!name.empty()) column.label = (column_count > 1) ? name + "[" + std::to_string(col) + "]" : name;
+          data_set.blocks[block].push_back(column);
+        }
+    }
+  data_set.has_labels = !name.empty();
+
+  return ERROR_NONE;
+}
+
+#ifdef HAVE_ZLIB
+static err_t inflate_zip_member(const char *data, std::size_t size, std::vector<char> &member)
+{
+  /* zlib uses 32 bit sizes, so large members are processed in several steps */
+  const std::size_t max_block_size = 1u << 30;
+  z_stream stream;
+  std::size_t used = 0;
+  int result = Z_OK;
+
+  std::memset(&stream, 0, sizeof(stream));
+  /* zip archives contain raw deflate streams without a zlib header */
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return ERROR_IMPORT_INVALID_FORMAT;
+  while (result == Z_OK)
+    {
+      if (stream.avail_in == 0 && size > 0)
+        {
+          std::size_t block_size = std::min(size, max_block_size);
+          stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+          stream.avail_in = static_cast<uInt>(block_size);
+          data += block_size;
+          size -= block_size;
+        }
+      std::size_t available = std::min(member.size() - used, max_block_size);
+      stream.next_out = reinterpret_cast<Bytef *>(member.data() + used);
+      stream.avail_out = static_cast<uInt>(available);
+      result = inflate(&stream, Z_NO_FLUSH);
+      used += available - stream.avail_out;
+    }
+  inflateEnd(&stream);
+
+  return (result == Z_STREAM_END && used == member.size()) ? ERROR_NONE : ERROR_IMPORT_INVALID_FORMAT;
+}
+#endif
+
+static err_t read_npz_archive(const char *begin, const char *end, BinaryDataSet &data_set)
+{
+  const char *eocd = nullptr, *entry;
+  uint64_t entry_count, central_directory_offset;
+  err_t error;
+
+  /* the end of central directory record is followed by a comment of variable size */
+  for (const char *p = end - std::min<std::size_t>(end - begin, ZIP_END_OF_CENTRAL_DIRECTORY_SIZE);
+       p >= begin && end - p <= ZIP_END_OF_CENTRAL_DIRECTORY_SIZE + ZIP_MAX_COMMENT_SIZE; --p)
+    {
+      if (read_little_endian<uint32_t>(p) == ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+        {
+          eocd = p;
+          break;
+        }
+      if (p == begin) break;
+    }
+  if (eocd == nullptr || !has_bytes(eocd, end, ZIP_END_OF_CENTRAL_DIRECTORY_SIZE)) return ERROR_IMPORT_INVALID_FORMAT;
+  entry_count = read_little_endian<uint16_t>(eocd + 10);
+  central_directory_offset = read_little_endian<uint32_t>(eocd + 16);
+  if (entry_count == 0xffff || central_directory_offset == 0xffffffff)
+    {
+      /* archives larger than 4 GiB use a zip64 record which is found with a locator in front of the record */
+      const char *locator = eocd - 20, *record;
+      if (locator < begin || read_little_endian<uint32_t>(locator) != ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE)
+        {
+          return ERROR_IMPORT_INVALID_FORMAT;
+        }
+      record = begin + std::min<uint64_t>(read_little_endian<uint64_t>(locator + 8), end - begin);
+      if (!has_bytes(record, end, 56) ||
+          read_little_endian<uint32_t>(record) != ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+        {
+          return ERROR_IMPORT_INVALID_FORMAT;
+        }
+      entry_count = read_little_endian<uint64_t>(record + 32);
+      central_directory_offset = read_little_endian<uint64_t>(record + 48);
+    }
+  if (central_directory_offset > static_cast<uint64_t>(end - begin)) return ERROR_IMPORT_INVALID_FORMAT;
+
+  entry = begin + central_directory_offset;
+  for (uint64_t i = 0; i < entry_count; ++i)
+    {
+      uint64_t compressed_size, uncompressed_size, local_header_offset;
+      std::size_t name_size, extra_size, comment_size;
+      const char *extra, *local_header, *member;
+      unsigned int method;
+      std::string name;
+      NpyArray array;
+
+      if (!has_bytes(entry, end, 46) || read_little_endian<uint32_t>(entry) != ZIP_CENTRAL_DIRECTORY_SIGNATURE)
+        {
+          return ERROR_IMPORT_INVALID_FORMAT;
+        }
+      method = read_little_endian<uint16_t>(entry + 10);
+      compressed_size = read_little_endian<uint32_t>(entry + 20);
+      uncompressed_size = read_little_endian<uint32_t>(entry + 24);
+      name_size = read_little_endian<uint16_t>(entry + 28);
+      extra_size = read_little_endian<uint16_t>(entry + 30);
+      comment_size = read_little_endian<uint16_t>(entry + 32);
+      local_header_offset = read_little_endian<uint32_t>(entry + 42);
+      if (!has_bytes(entry + 46, end, name_size + extra_size + comment_size)) return ERROR_IMPORT_INVALID_FORMAT;
+      name.assign(entry + 46, name_size);
+      /* sizes and offsets which do not fit into 32 bits are stored in the zip64 extra field */
+      for (extra = entry + 46 + name_size; extra + 4 <= entry + 46 + name_size + extra_size;)
+        {
+          unsigned int field_id = read_little_endian<uint16_t>(extra);
+          std::size_t field_size = read_little_endian<uint16_t>(extra + 2);
+          const char *field = extra + 4, *field_end = field + field_size;
+          if (field_id == 1)
+            {
+              for (uint64_t *value : {&uncompressed_size, &compressed_size, &local_header_offset})
+                {
+                  if (*value == 0xffffffff && field + 8 <= field_end)
+                    {
+                      *value = read_little_endian<uint64_t>(field);
+                      field += 8;
+                    }
+                }
+            }
+          extra = field_end;
+        }
+      entry += 46 + name_size + extra_size + comment_size;
+
+      if (local_header_offset > static_cast<uint64_t>(end - begin)) return ERROR_IMPORT_INVALID_FORMAT;
+      local_header = begin + local_header_offset;
+      if (!has_bytes(local_header, end, 30) || read_little_endian<uint32_t>(local_header) != ZIP_LOCAL_FILE_SIGNATURE)
+        {
+          return ERROR_IMPORT_INVALID_FORMAT;
+        }
+      member = local_header + 30 + read_little_endian<uint16_t>(local_header + 26) +
+               read_little_endian<uint16_t>(local_header + 28);
+      if (!has_bytes(member, end, compressed_size)) return ERROR_IMPORT_INVALID_FORMAT;
+      if (method == 8)
+        {
+#ifdef HAVE_ZLIB
+          /* the sizes are read from the file, so they are checked before the member is allocated */
+          if (uncompressed_size > compressed_size * ZIP_MAX_DEFLATE_RATIO ||
+              uncompressed_size > std::numeric_limits<std::size_t>::max() / 2)
+            {
+              return ERROR_IMPORT_INVALID_FORMAT;
+            }
+          data_set.buffers.emplace_back(uncompressed_size);
+          if ((error = inflate_zip_member(member, compressed_size, data_set.buffers.back())) != ERROR_NONE)
+            {
+              return error;
+            }
+          member = data_set.buffers.back().data();
+#else
+          fprintf(stderr, "Compressed NumPy archives are not supported without zlib\n");
+          return ERROR_UNSUPPORTED_OPERATION;
+#endif
+        }
+      else if (method != 0 || compressed_size != uncompressed_size)
+        {
+          fprintf(stderr, "Unsupported compression method (%u) in NumPy archive\n", method);
+          return ERROR_UNSUPPORTED_OPERATION;
+        }
+
+      if (name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0) name.resize(name.size() - 4);
+      if ((error = read_npy_array(member, member + uncompressed_size, array)) != ERROR_NONE ||
+          (error = add_npy_columns(array, name, data_set)) != ERROR_NONE)
+        {
+          return error;
+        }
+    }
+
+  return ERROR_NONE;
+}
+
+static err_t read_raw_data(const char *begin, const char *end, BinaryDataSet &data_set)
+{
+  std::size_t column_count, block_count, row_count, labels_size, item_size;
+  const char *labels, *values;
+  char kind;
+
+  if (!has_bytes(begin, end, RAW_DATA_HEADER_SIZE) || begin[6] != 1 || (begin[7] != 'd' && begin[7] != 'f'))
+    {
+      return ERROR_IMPORT_INVALID_FORMAT;
+    }
+  kind = 'f';
+  item_size = (begin[7] == 'd') ? sizeof(double) : sizeof(float);
+  column_count = read_little_endian<uint32_t>(begin + 8);
+  block_count = read_little_endian<uint32_t>(begin + 12);
+  row_count = read_little_endian<uint64_t>(begin + 16);
+  labels_size = read_little_endian<uint64_t>(begin + 24);
+  labels = begin + RAW_DATA_HEADER_SIZE;
+  if (!has_bytes(labels, end, labels_size)) return ERROR_IMPORT_INVALID_FORMAT;
+  values = labels + (labels_size + 7) / 8 * 8;
+  if (row_count > 0 && column_count > 0 &&
+      (block_count > SIZE_MAX / column_count / row_count / item_size ||
+       !has_bytes(values, end, block_count * column_count * row_count * item_size)))
+    {
+      return ERROR_IMPORT_INVALID_FORMAT;
+    }
+
+  data_set.row_count = row_count;
+  data_set.blocks.resize(block_count);
+  for (std::size_t block = 0; block < block_count; ++block)
+    {
+      const char *label = labels, *labels_end = labels + labels_size;
+      for (std::size_t col = 0; col < column_count; ++col)
+        {
+          BinaryColumn column;
+          const char *label_end = static_cast<const char *>(memchr(label, '\t', labels_end - label));
+          if (label_end == nullptr) label_end = labels_end;
+          column.values = values + (block * column_count + col) * row_count * item_size;
+          column.stride = item_size;
+          column.kind = kind;
+          column.item_size = item_size;
+          column.label.assign(label, label_end);
+          label = (label_end < labels_end) ? label_end + 1 : labels_end;
+          data_set.blocks[block].push_back(column);
+        }
+    }
+  data_set.has_labels = labels_size > 0;
+
+  return ERROR_NONE;
+}
+
+static err_t read_binary_data_file(const char *begin, const char *end,
+                                   std::vector<std::vector<std::vector<double>>> &data, std::vector<int> &x_data,
+                                   std::vector<int> &y_data, std::vector<int> &error_data,
+                                   std::vector<std::string> &labels, const std::list<int> &columns,
+                                   const std::list<int> &x_columns, const std::list<int> &y_columns,
+                                   const std::list<int> &e_columns, PlotRange *ranges)
+{
+  BinaryDataSet data_set;
+  std::vector<int> output_columns;
+  int output_column_count;
+  err_t error;
+
+  if (memcmp(begin, RAW_DATA_MAGIC, 6) == 0)
+    {
+      error = read_raw_data(begin, end, data_set);
+    }
+  else if (memcmp(begin, NPY_MAGIC, 6) == 0)
+    {
+      NpyArray array;
+      if ((error = read_npy_array(begin, end, array)) == ERROR_NONE) error = add_npy_columns(array, "", data_set);
+    }
+  else
+    {
+      error = read_npz_archive(begin, end, data_set);
+    }
+  if (error != ERROR_NONE)
+    {
+      if (error == ERROR_IMPORT_INVALID_FORMAT) fprintf(stderr, "Invalid or truncated binary data file\n");
+      return error;
+    }
+  if (data_set.blocks.empty() || data_set.blocks[0].empty() || data_set.row_count == 0) return ERROR_NONE;
+
+  output_column_count = select_data_columns(data_set.blocks[0].size(), columns, x_columns, y_columns, e_columns,
+                                            output_columns, x_data, y_data, error_data);
+  if (data_set.has_labels)
+    {
+      for (std::size_t col = 0; col < output_columns.size(); ++col)
+        {
+          if (columns.empty() || std::find(columns.begin(), columns.end(), col) != columns.end())
+            labels.push_back(data_set.blocks[0][col].label);
+        }
+    }
+  data.resize(data_set.blocks.size());
+  for (std::size_t block = 0; block < data_set.blocks.size(); ++block)
+    {
+      data[block].resize(output_column_count);
+      for (std::size_t col = 0; col < output_columns.size(); ++col)
+        {
+          if (output_columns[col] >= 0)
+            copy_binary_column(data_set.blocks[block][col], data_set.row_count, data[block][output_columns[col]]);
+        }
+    }
+  /* with `use_bins` the first column contains the y values of the first and the last row */
+  if (use_bins && output_columns[0] < 0)
+    {
+      const BinaryColumn &first_bins = data_set.blocks.front()[0], &last_bins = data_set.blocks.back()[0];
+      ranges->ymin = read_binary_value(first_bins.values, first_bins.kind, first_bins.item_size);
+      if (data_set.row_count > 1)
+        {
+          ranges->ymax = read_binary_value(last_bins.values + (data_set.row_count - 1) * last_bins.stride,
+                                           last_bins.kind, last_bins.item_size);
+        }
+    }
+
+  return ERROR_NONE;
+}
+
 err_t read_data_file(const std::string &path, std::vector<std::vector<std::vector<double>>> &data,
                      std::vector<int> &x_data, std::vector<int> &y_data, std::vector<int> &error_data,
                      std::vector<std::string> &labels, grm_args_t *args, const char *colms, const char *x_colms,
@@ -230,11 +1194,11 @@ err_t read_data_file(const std::string &path, std::vector<std::vector<std::vecto
 {
   std::string line;
   std::string token;
-  std::ifstream file_path(path);
-  std::istream &cin_path = std::cin;
+  DataFileSource source(path);
+  const char *pos = source.begin(), *first_row, *last_row = nullptr;
   std::list<int> columns, x_columns, y_columns, e_columns;
-  bool depth_change = true;
-  int depth = 0, max_col = -1;
+  std::vector<int> output_columns;
+  int output_column_count;
   int linecount = 0;
   err_t error = ERROR_NONE;
 
@@ -246,11 +1210,18 @@ err_t read_data_file(const std::string &path, std::vector<std::vector<std::vecto
   if ((error = parse_columns(&y_columns, y_colms)) != ERROR_NONE) return error;
   if ((error = parse_columns(&e_columns, e_colms)) != ERROR_NONE) return error;
 
-  std::istream &file = (path == "-") ? cin_path : file_path;
+  if (is_binary_data_file(source.begin(), source.end()))
+    {
+      return read_binary_data_file(source.begin(), source.end(), data, x_data, y_data, error_data, labels, columns,
+                                   x_columns, y_columns, e_columns, ranges);
+    }
+
   /* read the lines from the file */
-  while (getline(file, line))
+  while (pos < source.end())
     {
-      std::istringstream iss(line, std::istringstream::in);
+      const char *line_end = find_line_end(pos, source.end());
+      line.assign(pos, (line_end > pos && line_end[-1] == '\r') ? line_end - 1 : line_end);
+      pos = (line_end < source.end()) ? line_end + 1 : source.end();
       linecount += 1;
       /* the line defines a grm container parameter */
       if (line[0] == '#')
@@ -377,117 +1348,53 @@ err_t read_data_file(const std::string &path, std::vector<std::vector<std::vecto
         }
     }
 
-  // Save locale setting
-  const std::string oldLocale = std::setlocale(LC_NUMERIC, nullptr);
-  std::setlocale(LC_NUMERIC, "C");
+  /* the first data line defines the number of columns and which of them are stored */
+  for (first_row = pos; first_row < source.end() && is_empty_line(first_row, find_line_end(first_row, source.end()));)
+    {
+      first_row = find_line_end(first_row, source.end()) + 1;
+    }
+  if (first_row >= source.end()) return ERROR_NONE;
+  output_column_count = select_data_columns(
+      for_each_data_field(first_row, find_line_end(first_row, source.end()),
+                          [](std::size_t, const char *, const char *) { return true; }),
+      columns, x_columns, y_columns, e_columns, output_columns, x_data, y_data, error_data);
+
+  /* read the numeric data for the plot, unselected columns are skipped without being converted */
+  if ((error = read_numeric_data(pos, source.end(), output_columns, output_column_count, linecount + 1, data,
+                                 &last_row)) != ERROR_NONE)
+    {
+      return error;
+    }
 
-  /* read the numeric data for the plot */
-  for (size_t row = 0; std::getline(file, line); row++)
+  /* with `use_bins` the first column contains the y values of the first and the last row */
+  if (use_bins && !output_columns.empty() && output_columns[0] < 0)
     {
-      std::istringstream line_ss(normalize_line(line));
-      int cnt = 0;
-      char det = '\t';
-      int start_with_nan = 0;
-      size_t col;
-      if (line.empty())
-        {
-          depth += 1;
-          depth_change = true;
-          continue;
-        }
-      if (std::find(line.begin(), line.end(), ',') != line.end())
-        {
-          det = ',';
-          std::string tmp = ",";
-          if (starts_with(trim(line), tmp)) start_with_nan = 1;
-        }
-      for (col = 0; std::getline(line_ss, token, det) && (token.length() || start_with_nan); col++)
-        {
-          if (std::find(columns.begin(), columns.end(), col) != columns.end() ||
-              (columns.empty() && labels.empty() && (!use_bins || col > 0)) ||
-              (columns.empty() && (!use_bins || col > 0)))
-            {
-              if ((row == 0 && (col == use_bins || col == columns.front())) ||
-                  (depth_change && (col == use_bins || col == columns.front())) ||
-                  (start_with_nan && (col == use_bins || col == columns.front())))
-                {
-                  data.emplace_back(std::vector<std::vector<double>>());
-                }
-              if (depth_change)
-                {
-                  data[depth].emplace_back(std::vector<double>());
-                }
-              if (max_col != -1 && max_col < (int)cnt + 1)
-                {
-                  fprintf(stderr, "Line %i has a different number of columns (%i) than previous lines (%i)\n",
-                          (int)row + linecount + 1, cnt + 1, max_col);
-                  return ERROR_PLOT_MISSING_DATA;
-                }
-              try
-                {
-                  trim(token);
-                  token.erase(std::remove(token.begin(), token.end(), '\t'), token.end());
-                  if (token.empty() && det == ',')
-                    {
-                      data[depth][cnt].push_back(NAN);
-                    }
-                  else
-                    {
-                      data[depth][cnt].push_back(std::stod(token));
-                    }
-                }
-              catch (std::invalid_argument &e)
-                {
-                  fprintf(stderr, "Invalid number in line %zu, column %zu (%s)\n", row + linecount + 1, col + 1,
-                          token.c_str());
-                  return ERROR_PARSE_DOUBLE;
-                }
-              if (row == 0 && !x_columns.empty() &&
-                  std::find(x_columns.begin(), x_columns.end(), col) != x_columns.end())
-                x_data.emplace_back(cnt);
-              if (row == 0 && !y_columns.empty() &&
-                  std::find(y_columns.begin(), y_columns.end(), col) != y_columns.end())
-                y_data.emplace_back(cnt);
-              if (row == 0 && !e_columns.empty() &&
-                  std::find(e_columns.begin(), e_columns.end(), col) != e_columns.end())
-                error_data.emplace_back(cnt);
-              cnt += 1;
-            }
-          else if (use_bins && col == 0)
-            {
-              try
-                {
-                  if (row == 0)
-                    {
-                      ranges->ymin = std::stod(token);
-                    }
-                  else
-                    {
-                      ranges->ymax = std::stod(token); // not the best way to get ymax but the number of rows is unknown
-                    }
-                }
-              catch (std::invalid_argument &e)
-                {
-                  fprintf(stderr,
-                          "Invalid argument for y_range parameter (%s) while using option use_bins in line %i\n",
-                          labels[0].c_str(), (int)row + linecount + 1);
-                }
-            }
-        }
-      depth_change = false;
-      if (max_col == -1)
-        {
-          max_col = (int)col;
-        }
-      else if (max_col != (int)col)
-        {
-          fprintf(stderr, "Line %i has a different number of columns (%i) than previous lines (%i)\n",
-                  (int)row + linecount + 1, (int)col, max_col);
-          return ERROR_PLOT_MISSING_DATA;
+      for (const char *row : {first_row, last_row})
+        {
+          for_each_data_field(row, find_line_end(row, source.end()),
+                              [&](std::size_t, const char *field_begin, const char *field_end) {
+                                const char *number_end;
+                                double value = float_parse_double(field_begin, field_end, &number_end);
+                                if (number_end == field_begin)
+                                  {
+                                    fprintf(stderr,
+                                            "Invalid argument for y_range parameter (%s) while using option use_bins\n",
+                                            std::string(field_begin, field_end).c_str());
+                                  }
+                                else if (row == first_row)
+                                  {
+                                    ranges->ymin = value;
+                                  }
+                                else
+                                  {
+                                    ranges->ymax = value;
+                                  }
+                                return false;
+                              });
+          if (last_row == first_row) break;
         }
     }
-  // Restore locale setting
-  std::setlocale(LC_NUMERIC, oldLocale.c_str());
+
   return ERROR_NONE;
 }
 
@@ -570,8 +570,8 @@ int grm_input(const grm_args_t *input_args)
 
               std::shared_ptr<GRM::Context> context = grm_get_render()->getContext();
 
-              auto x_series_vec = GRM::get<std::vector<double>>((*context)[x_series_key]);
-              auto y_series_vec = GRM::get<std::vector<double>>((*context)[y_series_key]);
+              auto x_series_vec = GRM::get_span<double>((*context)[x_series_key]);
+              auto y_series_vec = GRM::get_span<double>((*context)[y_series_key]);
 
               x_length = x_series_vec.size();
               y_length = y_series_vec.size();
@@ -1622,10 +1622,10 @@ err_t get_tooltips(int mouse_x, int mouse_y, err_t (*tooltip_callback)(int, int,
                   auto u_key = static_cast<std::string>(current_series->getAttribute("u"));
                   auto v_key = static_cast<std::string>(current_series->getAttribute("v"));
 
-                  auto u_series_vec = GRM::get<std::vector<double>>((*context)[u_key]);
-                  auto v_series_vec = GRM::get<std::vector<double>>((*context)[v_key]);
-                  u_series = &u_series_vec[0];
-                  v_series = &v_series_vec[0];
+                  auto u_series_vec = GRM::get_span<double>((*context)[u_key]);
+                  auto v_series_vec = GRM::get_span<double>((*context)[v_key]);
+                  u_series = (double *)u_series_vec.data();
+                  v_series = (double *)v_series_vec.data();
                 }
 
               mindiff = 0;
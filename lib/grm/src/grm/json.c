@@ -5,45 +5,26 @@
 /* ######################### includes ############################################################################### */
 
 #include <ctype.h>
-#include <locale.h>
 #include <errno.h>
 #include <limits.h>
 #include <math.h>
 #include <stdio.h>
 
+#include "gkscore.h"
 #include "grm/error.h"
+#include "args_int.h"
+#include "float_parse_int.h"
 #include "json_int.h"
 #include "plot_int.h"
 
 
 /* ######################### internal implementation ################################################################ */
 
-/* ========================= macros ================================================================================= */
-
-/* ------------------------- general -------------------------------------------------------------------------------- */
-
-#ifndef DBL_DECIMAL_DIG
-#define DBL_DECIMAL_DIG 17
-#endif
-
 /* ========================= static variables ======================================================================= */
 
 /* ------------------------- json deserializer ---------------------------------------------------------------------- */
 
 const char *FROMJSON_VALID_DELIMITERS = ",]}";
-const char FROMJSON_STRING_DELIMITER = '"';
-const char FROMJSON_ESCAPE_CHARACTER = '\\';
-
-static err_t (*fromjson_datatype_to_func[])(fromjson_state_t *) = {NULL,
-                                                                   fromjson_parse_null,
-                                                                   fromjson_parse_bool,
-                                                                   fromjson_parse_number,
-                                                                   fromjson_parse_string,
-                                                                   fromjson_parse_array,
-                                                                   fromjson_parse_object};
-
-static const char *const fromjson_datatype_to_string[] = {"unknown", "null",  "bool",  "number",
-                                                          "string",  "array", "object"};
 
 
 /* ------------------------- json serializer ------------------------------------------------------------------------ */
@@ -64,7 +45,21 @@ int grm_read(grm_args_t *args, const char *json_string)
 
 err_t fromjson_read(grm_args_t *args, const char *json_string)
 {
-  return fromjson_parse(args, json_string, NULL);
+  fromjson_stream_t *stream;
+  err_t error;
+
+  stream = fromjson_stream_new(args);
+  if (stream == NULL)
+    {
+      return ERROR_MALLOC;
+    }
+  if ((error = fromjson_stream_feed(stream, json_string, strlen(json_string))) == ERROR_NONE)
+    {
+      error = fromjson_stream_finish(stream);
+    }
+  fromjson_stream_delete(stream);
+
+  return error;
 }
 
 int grm_load_from_str(const char *json_string)
@@ -72,717 +67,1088 @@ int grm_load_from_str(const char *json_string)
   return (fromjson_read(active_plot_args, json_string) == ERROR_NONE);
 }
 
-err_t fromjson_parse(grm_args_t *args, const char *json_string, fromjson_shared_state_t *shared_state)
+fromjson_stream_t *fromjson_stream_new(grm_args_t *args)
 {
-  char *filtered_json_string = NULL;
-  fromjson_state_t state;
-  int allocated_shared_state_mem = 0;
-  err_t error = ERROR_NONE;
-  char *saved_locale;
+  fromjson_stream_t *stream;
 
-  state.datatype = JSON_DATATYPE_UNKNOWN;
-  state.value_buffer = NULL;
-  state.value_buffer_pointer_level = 0;
-  state.next_value_memory = NULL;
-  state.next_value_type = malloc(NEXT_VALUE_TYPE_SIZE);
-  if (state.next_value_type == NULL)
+  stream = malloc(sizeof(fromjson_stream_t));
+  if (stream == NULL)
     {
       debug_print_malloc_error();
-      return ERROR_MALLOC;
+      return NULL;
+    }
+  stream->args = args;
+  stream->frames = NULL;
+  stream->frame_count = 0;
+  stream->frame_capacity = 0;
+  stream->expectation = FROMJSON_EXPECT_ROOT;
+  stream->token = FROMJSON_TOKEN_NONE;
+  stream->token_buffer = NULL;
+  stream->token_length = 0;
+  stream->token_capacity = 0;
+  stream->escape_state = 0;
+  stream->escape_code_point = 0;
+  stream->high_surrogate = 0;
+  stream->error = ERROR_NONE;
+
+  return stream;
+}
+
+void fromjson_stream_delete(fromjson_stream_t *stream)
+{
+  size_t i;
+
+  if (stream == NULL)
+    {
+      return;
     }
-  state.args = args;
-  if (shared_state == NULL)
+  while (stream->frame_count > 0)
     {
-      shared_state = malloc(sizeof(fromjson_shared_state_t));
-      if (shared_state == NULL)
+      fromjson_frame_t *frame = &stream->frames[--stream->frame_count];
+      free(frame->key);
+      fromjson_array_free(&frame->array);
+      for (i = 0; i < frame->inner_array_count; ++i)
         {
-          free(state.next_value_type);
-          debug_print_malloc_error();
-          return ERROR_MALLOC;
+          fromjson_array_free(&frame->inner_arrays[i]);
         }
-      if ((error = fromjson_copy_and_filter_json_string(&filtered_json_string, json_string)) != ERROR_NONE)
+      free(frame->inner_arrays);
+      /* the root object is owned by the caller */
+      if (frame->is_object && stream->frame_count > 0)
         {
-          free(state.next_value_type);
-          free(shared_state);
-          return error;
+          grm_args_delete(frame->args);
         }
-      shared_state->json_ptr = filtered_json_string;
-      shared_state->parsed_any_value_before = 0;
-      allocated_shared_state_mem = 1;
     }
-  state.shared_state = shared_state;
-  state.parsing_object = (*state.shared_state->json_ptr == '{');
-  if (state.parsing_object)
+  free(stream->frames);
+  free(stream->token_buffer);
+  free(stream);
+}
+
+err_t fromjson_stream_feed(fromjson_stream_t *stream, const char *data, size_t length)
+{
+  const char *current = data;
+  const char *end = data + length;
+  err_t error = ERROR_NONE;
+
+  if (stream->error != ERROR_NONE)
+    {
+      return stream->error;
+    }
+  while (current < end)
     {
-      ++state.shared_state->json_ptr;
+      if (stream->token != FROMJSON_TOKEN_NONE)
+        {
+          if (stream->token == FROMJSON_TOKEN_KEY || stream->token == FROMJSON_TOKEN_STRING)
+            {
+              error = fromjson_stream_continue_string(stream, &current, end);
+            }
+          else
+            {
+              error = fromjson_stream_continue_scalar(stream, &current, end);
+            }
+          if (error != ERROR_NONE)
+            {
+              break;
+            }
+          continue;
+        }
+      if (isspace((unsigned char)*current))
+        {
+          ++current;
+          continue;
+        }
+      if ((error = fromjson_stream_process_char(stream, *current)) != ERROR_NONE)
+        {
+          break;
+        }
+      /* scalar tokens are read by `fromjson_stream_continue_scalar`, starting with their first character */
+      if (stream->token != FROMJSON_TOKEN_NUMBER && stream->token != FROMJSON_TOKEN_LITERAL)
+        {
+          ++current;
+        }
     }
+  stream->error = error;
 
-  saved_locale = setlocale(LC_NUMERIC, NULL);
-  setlocale(LC_NUMERIC, "C");
+  return error;
+}
 
-  while (strchr("}", *state.shared_state->json_ptr) == NULL)
+err_t fromjson_stream_finish(fromjson_stream_t *stream)
+{
+  if (stream->error == ERROR_NONE && stream->expectation != FROMJSON_EXPECT_ROOT &&
+      stream->expectation != FROMJSON_EXPECT_NOTHING)
     {
-      const char *current_key = NULL;
+      stream->error = ERROR_PARSE_INCOMPLETE_STRING;
+    }
+  return stream->error;
+}
+
+int fromjson_stream_is_complete(const fromjson_stream_t *stream)
+{
+  return stream->expectation == FROMJSON_EXPECT_NOTHING;
+}
+
+err_t fromjson_stream_process_char(fromjson_stream_t *stream, char c)
+{
+  fromjson_frame_t *frame = (stream->frame_count > 0) ? &stream->frames[stream->frame_count - 1] : NULL;
 
-      if (state.parsing_object)
+  switch (stream->expectation)
+    {
+    case FROMJSON_EXPECT_ROOT:
+      if (c != '{')
         {
-          fromjson_parse_string(&state);
-          current_key = *(const char **)state.value_buffer;
-          free(state.value_buffer);
-          state.value_buffer = NULL;
-          ++(state.shared_state->json_ptr);
+          /* parsing values without an outer object (-> missing key) is not supported by the argument container */
+          return ERROR_PARSE_MISSING_OBJECT_CONTAINER;
         }
-      state.datatype = fromjson_check_type(&state);
-      if (state.datatype)
+      return fromjson_stream_push_frame(stream, 1);
+    case FROMJSON_EXPECT_KEY_OR_END:
+      if (c == '}')
         {
-          if ((error = fromjson_datatype_to_func[state.datatype](&state)) != ERROR_NONE)
-            {
-              break;
-            }
-          if (state.parsing_object)
+          return fromjson_stream_close_object(stream);
+        }
+      /* fall through */
+    case FROMJSON_EXPECT_KEY:
+      if (c != '"')
+        {
+          return ERROR_PARSE_STRING;
+        }
+      stream->token = FROMJSON_TOKEN_KEY;
+      stream->token_length = 0;
+      return ERROR_NONE;
+    case FROMJSON_EXPECT_COLON:
+      if (c != ':')
+        {
+          return ERROR_PARSE_INVALID_DELIMITER;
+        }
+      stream->expectation = FROMJSON_EXPECT_VALUE;
+      return ERROR_NONE;
+    case FROMJSON_EXPECT_VALUE_OR_END:
+      if (c == ']')
+        {
+          return fromjson_stream_close_array(stream);
+        }
+      /* fall through */
+    case FROMJSON_EXPECT_VALUE:
+      if (c == '"')
+        {
+          stream->token = FROMJSON_TOKEN_STRING;
+          stream->token_length = 0;
+        }
+      else if (c == '{')
+        {
+          return fromjson_stream_push_frame(stream, 1);
+        }
+      else if (c == '[')
+        {
+          if (!frame->is_object)
             {
-              grm_args_push_buf(args, current_key, state.next_value_type, state.value_buffer, 0);
+              if (frame->is_inner_array)
+                {
+                  debug_print_error(("Arrays only support one level of nesting!\n"));
+                  return ERROR_PARSE_ARRAY;
+                }
+              if (frame->array.format != '\0' && frame->array.format != '[')
+                {
+                  debug_print_error(("Arrays cannot mix values and nested arrays!\n"));
+                  return ERROR_PARSE_ARRAY;
+                }
+              frame->array.format = '[';
             }
-          else
+          return fromjson_stream_push_frame(stream, 0);
+        }
+      else if (fromjson_is_number_char(c))
+        {
+          stream->token = FROMJSON_TOKEN_NUMBER;
+          stream->token_length = 0;
+        }
+      else if (fromjson_is_literal_char(c))
+        {
+          stream->token = FROMJSON_TOKEN_LITERAL;
+          stream->token_length = 0;
+        }
+      else
+        {
+          return ERROR_PARSE_UNKNOWN_DATATYPE;
+        }
+      return ERROR_NONE;
+    case FROMJSON_EXPECT_DELIMITER:
+      if (c == ',')
+        {
+          stream->expectation = frame->is_object ? FROMJSON_EXPECT_KEY : FROMJSON_EXPECT_VALUE;
+          return ERROR_NONE;
+        }
+      else if (c == '}' && frame->is_object)
+        {
+          return fromjson_stream_close_object(stream);
+        }
+      else if (c == ']' && !frame->is_object)
+        {
+          return fromjson_stream_close_array(stream);
+        }
+      return ERROR_PARSE_INVALID_DELIMITER;
+    case FROMJSON_EXPECT_NOTHING:
+      /* only whitespace may follow the root object */
+      return ERROR_PARSE_INVALID_DELIMITER;
+    default:
+      return ERROR_NONE;
+    }
+}
+
+err_t fromjson_stream_continue_string(fromjson_stream_t *stream, const char **current, const char *end)
+{
+  const char *json_ptr = *current;
+  err_t error = ERROR_NONE;
+
+  while (json_ptr < end)
+    {
+      if (stream->escape_state == 0)
+        {
+          /* copy everything up to the next special character at once */
+          const char *segment_end = json_ptr;
+          while (segment_end < end && *segment_end != '"' && *segment_end != '\\')
             {
-              /* parsing values without an outer object (-> missing key) is not supported by the argument container */
-              error = ERROR_PARSE_MISSING_OBJECT_CONTAINER;
-              break;
+              ++segment_end;
             }
-          if (strchr(FROMJSON_VALID_DELIMITERS, *state.shared_state->json_ptr) != NULL)
+          if (segment_end > json_ptr)
             {
-              if (*state.shared_state->json_ptr == ',')
+              if ((error = fromjson_stream_flush_high_surrogate(stream)) != ERROR_NONE ||
+                  (error = fromjson_stream_append_to_token(stream, json_ptr, segment_end - json_ptr)) != ERROR_NONE)
                 {
-                  ++state.shared_state->json_ptr;
+                  return error;
                 }
+              json_ptr = segment_end;
             }
-          else
+          if (json_ptr == end)
             {
-              error = ERROR_PARSE_INVALID_DELIMITER;
               break;
             }
+          if (*json_ptr++ == '"')
+            {
+              *current = json_ptr;
+              return fromjson_stream_finish_string(stream);
+            }
+          stream->escape_state = 1;
         }
-      else
+      else if (stream->escape_state == 1)
         {
-          error = ERROR_PARSE_UNKNOWN_DATATYPE;
-          break;
+          char unescaped_char = *json_ptr++;
+          if (unescaped_char == 'u')
+            {
+              stream->escape_state = 2;
+              stream->escape_code_point = 0;
+              continue;
+            }
+          switch (unescaped_char)
+            {
+            case 'b':
+              unescaped_char = '\b';
+              break;
+            case 'f':
+              unescaped_char = '\f';
+              break;
+            case 'n':
+              unescaped_char = '\n';
+              break;
+            case 'r':
+              unescaped_char = '\r';
+              break;
+            case 't':
+              unescaped_char = '\t';
+              break;
+            default:
+              /* `"`, `\`, `/` and all unknown escape sequences are replaced by the escaped character itself */
+              break;
+            }
+          if ((error = fromjson_stream_flush_high_surrogate(stream)) != ERROR_NONE ||
+              (error = fromjson_stream_append_to_token(stream, &unescaped_char, 1)) != ERROR_NONE)
+            {
+              return error;
+            }
+          stream->escape_state = 0;
         }
-      if (state.value_buffer_pointer_level > 1)
+      else
         {
-          int i, outer_array_length = uppercase_count(state.next_value_type);
-          for (i = 0; i < outer_array_length; ++i)
+          /* `\uXXXX`: `escape_state` counts the read hex digits (offset by 2) */
+          char hex_digit = *json_ptr++;
+          unsigned int digit_value;
+          if (hex_digit >= '0' && hex_digit <= '9')
+            {
+              digit_value = hex_digit - '0';
+            }
+          else if (hex_digit >= 'a' && hex_digit <= 'f')
+            {
+              digit_value = hex_digit - 'a' + 10;
+            }
+          else if (hex_digit >= 'A' && hex_digit <= 'F')
+            {
+              digit_value = hex_digit - 'A' + 10;
+            }
+          else
             {
-              free(((char **)state.value_buffer)[i]);
+              debug_print_error(("Invalid unicode escape sequence in json string!\n"));
+              return ERROR_PARSE_STRING;
+            }
+          stream->escape_code_point = 16 * stream->escape_code_point + digit_value;
+          if (++stream->escape_state == 6)
+            {
+              stream->escape_state = 0;
+              if ((error = fromjson_stream_append_code_point(stream, stream->escape_code_point)) != ERROR_NONE)
+                {
+                  return error;
+                }
             }
         }
-      free(state.value_buffer);
-      state.value_buffer = NULL;
-      state.value_buffer_pointer_level = 0;
     }
-  if (state.parsing_object && *state.shared_state->json_ptr == '\0')
+  *current = json_ptr;
+
+  return error;
+}
+
+err_t fromjson_stream_finish_string(fromjson_stream_t *stream)
+{
+  fromjson_frame_t *frame = &stream->frames[stream->frame_count - 1];
+  fromjson_token_t token = stream->token;
+  err_t error;
+
+  if ((error = fromjson_stream_flush_high_surrogate(stream)) != ERROR_NONE ||
+      (error = fromjson_stream_terminate_token(stream)) != ERROR_NONE)
     {
-      error = ERROR_PARSE_INCOMPLETE_STRING;
+      return error;
     }
-  if (*state.shared_state->json_ptr)
+  stream->token = FROMJSON_TOKEN_NONE;
+  if (token == FROMJSON_TOKEN_KEY)
     {
-      ++state.shared_state->json_ptr;
+      free(frame->key);
+      frame->key = gks_strdup(stream->token_buffer);
+      if (frame->key == NULL)
+        {
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
+        }
+      stream->expectation = FROMJSON_EXPECT_COLON;
+      return ERROR_NONE;
     }
 
-  free(state.value_buffer);
-  free(filtered_json_string);
-  free(state.next_value_type);
+  return fromjson_stream_add_value(stream, 's', stream->token_buffer);
+}
 
-  if (allocated_shared_state_mem)
+err_t fromjson_stream_continue_scalar(fromjson_stream_t *stream, const char **current, const char *end)
+{
+  const char *token_start = *current;
+  const char *token_end = token_start;
+  fromjson_token_t token = stream->token;
+  err_t error;
+
+  if (token == FROMJSON_TOKEN_NUMBER)
     {
-      free(shared_state);
+      while (token_end < end && fromjson_is_number_char(*token_end))
+        {
+          ++token_end;
+        }
     }
-
-  if (saved_locale)
+  else
     {
-      setlocale(LC_NUMERIC, saved_locale);
+      while (token_end < end && fromjson_is_literal_char(*token_end))
+        {
+          ++token_end;
+        }
+    }
+  *current = token_end;
+  if (token_end == end || stream->token_length > 0)
+    {
+      /* the token is split across chunks -> collect it in the token buffer */
+      if ((error = fromjson_stream_append_to_token(stream, token_start, token_end - token_start)) != ERROR_NONE)
+        {
+          return error;
+        }
+      if (token_end == end)
+        {
+          return ERROR_NONE;
+        }
+      token_start = stream->token_buffer;
+      token_end = stream->token_buffer + stream->token_length;
     }
+  stream->token = FROMJSON_TOKEN_NONE;
+  stream->token_length = 0;
 
-  return error;
+  if (token == FROMJSON_TOKEN_NUMBER)
+    {
+      return fromjson_stream_parse_number(stream, token_start, token_end);
+    }
+  return fromjson_stream_parse_literal(stream, token_start, token_end);
 }
 
-#define CHECK_AND_ALLOCATE_MEMORY(type, length)                \
-  do                                                           \
-    {                                                          \
-      if (state->value_buffer == NULL)                         \
-        {                                                      \
-          state->value_buffer = malloc(length * sizeof(type)); \
-          if (state->value_buffer == NULL)                     \
-            {                                                  \
-              debug_print_malloc_error();                      \
-              return 0;                                        \
-            }                                                  \
-          state->value_buffer_pointer_level = 1;               \
-          state->next_value_memory = state->value_buffer;      \
-        }                                                      \
-    }                                                          \
-  while (0)
-
-err_t fromjson_parse_null(fromjson_state_t *state)
+err_t fromjson_stream_parse_number(fromjson_stream_t *stream, const char *begin, const char *end)
 {
-  if (strncmp(state->shared_state->json_ptr, "null", 4) != 0)
+  const char *number_ptr = begin;
+
+  if (!fromjson_is_valid_number(begin, end))
     {
-      return ERROR_PARSE_NULL;
+      debug_print_error(("The parameter \"%.*s\" is not a valid number!\n", (int)(end - begin), begin));
+      return ERROR_PARSE_DOUBLE;
+    }
+  while (number_ptr < end && (isdigit((unsigned char)*number_ptr) || *number_ptr == '-' || *number_ptr == '+'))
+    {
+      ++number_ptr;
+    }
+  if (number_ptr == end)
+    {
+      int int_value;
+      if (!fromjson_str_to_int(begin, end, &int_value))
+        {
+          debug_print_error(("The parameter \"%.*s\" is not a valid integer!\n", (int)(end - begin), begin));
+          return ERROR_PARSE_INT;
+        }
+      return fromjson_stream_add_value(stream, 'i', &int_value);
+    }
+  else
+    {
+      double double_value;
+      const char *number_end;
+      errno = 0;
+      double_value = float_parse_double(begin, end, &number_end);
+      if (number_end != end || errno == ERANGE)
+        {
+          debug_print_error(("The parameter \"%.*s\" is not a valid number!\n", (int)(end - begin), begin));
+          return ERROR_PARSE_DOUBLE;
+        }
+      return fromjson_stream_add_value(stream, 'd', &double_value);
     }
-  strcpy(state->next_value_type, "");
-  state->shared_state->json_ptr += 4;
-  return ERROR_NONE;
 }
 
-err_t fromjson_parse_bool(fromjson_state_t *state)
+err_t fromjson_stream_parse_literal(fromjson_stream_t *stream, const char *begin, const char *end)
 {
+  size_t length = end - begin;
   int bool_value;
 
-  if (strncmp(state->shared_state->json_ptr, "true", 4) == 0)
+  if (length == 4 && strncmp(begin, "null", 4) == 0)
+    {
+      return fromjson_stream_add_value(stream, 'n', NULL);
+    }
+  if (length == 4 && strncmp(begin, "true", 4) == 0)
     {
       bool_value = 1;
     }
-  else if (strncmp(state->shared_state->json_ptr, "false", 5) == 0)
+  else if (length == 5 && strncmp(begin, "false", 5) == 0)
     {
       bool_value = 0;
     }
   else
     {
-      return ERROR_PARSE_BOOL;
+      return (*begin == 'n') ? ERROR_PARSE_NULL : ERROR_PARSE_BOOL;
     }
-  CHECK_AND_ALLOCATE_MEMORY(int, 1);
-  *((int *)state->next_value_memory) = bool_value;
-  strcpy(state->next_value_type, "i");
-  state->shared_state->json_ptr += bool_value ? 4 : 5;
-  return ERROR_NONE;
+
+  return fromjson_stream_add_value(stream, 'b', &bool_value);
 }
 
-err_t fromjson_parse_number(fromjson_state_t *state)
+err_t fromjson_stream_add_value(fromjson_stream_t *stream, char type, const void *value)
 {
+  /* `value` points to an `int` ('i' and 'b'), to a `double` ('d'), to the string itself ('s') or is the argument
+   * container ('a'); it is `NULL` for `null` values ('n') */
+  fromjson_frame_t *frame = &stream->frames[stream->frame_count - 1];
+  int was_successful;
   err_t error;
 
-  if (is_int_number(state->shared_state->json_ptr))
+  if (frame->is_object)
     {
-      error = fromjson_parse_int(state);
+      switch (type)
+        {
+        case 'i':
+        case 'b':
+          was_successful = grm_args_push(frame->args, frame->key, "i", *(const int *)value);
+          break;
+        case 'd':
+          was_successful = grm_args_push(frame->args, frame->key, "d", *(const double *)value);
+          break;
+        case 's':
+          was_successful = grm_args_push(frame->args, frame->key, "s", (const char *)value);
+          break;
+        case 'a':
+          was_successful = grm_args_push(frame->args, frame->key, "a", (grm_args_t *)value);
+          break;
+        default:
+          was_successful = grm_args_push_buf(frame->args, frame->key, "", NULL, 0);
+          break;
+        }
+      free(frame->key);
+      frame->key = NULL;
+      if (!was_successful)
+        {
+          return ERROR_MALLOC;
+        }
     }
   else
     {
-      error = fromjson_parse_double(state);
+      if (frame->array.format == '[')
+        {
+          debug_print_error(("Arrays cannot mix values and nested arrays!\n"));
+          return ERROR_PARSE_ARRAY;
+        }
+      if (type == 'b' || type == 'n')
+        {
+          debug_print_error(("The datatype \"%s\" is currently not supported in arrays!\n",
+                             (type == 'b') ? "bool" : "null"));
+          return ERROR_PARSE_ARRAY;
+        }
+      if ((error = fromjson_array_append(&frame->array, type, value)) != ERROR_NONE)
+        {
+          return error;
+        }
     }
-  return error;
-}
+  stream->expectation = FROMJSON_EXPECT_DELIMITER;
 
-err_t fromjson_parse_int(fromjson_state_t *state)
-{
-  int was_successful;
-  int int_value;
-
-  int_value = fromjson_str_to_int((const char **)&state->shared_state->json_ptr, &was_successful);
-  if (!was_successful)
-    {
-      return ERROR_PARSE_INT;
-    }
-  CHECK_AND_ALLOCATE_MEMORY(int, 1);
-  *((int *)state->next_value_memory) = int_value;
-  strcpy(state->next_value_type, "i");
   return ERROR_NONE;
 }
 
-err_t fromjson_parse_double(fromjson_state_t *state)
+err_t fromjson_stream_push_frame(fromjson_stream_t *stream, int is_object)
 {
-  int was_successful;
-  double double_value;
+  fromjson_frame_t *frame;
 
-  double_value = fromjson_str_to_double((const char **)&state->shared_state->json_ptr, &was_successful);
-  if (!was_successful)
+  if (stream->frame_count == stream->frame_capacity)
     {
-      return ERROR_PARSE_DOUBLE;
+      size_t new_capacity = (stream->frame_capacity > 0) ? 2 * stream->frame_capacity : 8;
+      fromjson_frame_t *new_frames = realloc(stream->frames, new_capacity * sizeof(fromjson_frame_t));
+      if (new_frames == NULL)
+        {
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
+        }
+      stream->frames = new_frames;
+      stream->frame_capacity = new_capacity;
+    }
+  frame = &stream->frames[stream->frame_count];
+  frame->is_object = is_object;
+  frame->is_inner_array = !is_object && stream->frame_count > 0 && !stream->frames[stream->frame_count - 1].is_object;
+  frame->key = NULL;
+  frame->array.format = '\0';
+  frame->array.length = 0;
+  frame->array.capacity = 0;
+  frame->array.values = NULL;
+  frame->inner_arrays = NULL;
+  frame->inner_array_count = 0;
+  frame->inner_array_capacity = 0;
+  if (is_object)
+    {
+      frame->args = (stream->frame_count > 0) ? grm_args_new() : stream->args;
+      if (frame->args == NULL)
+        {
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
+        }
+      stream->expectation = FROMJSON_EXPECT_KEY_OR_END;
+    }
+  else
+    {
+      frame->args = NULL;
+      stream->expectation = FROMJSON_EXPECT_VALUE_OR_END;
     }
-  CHECK_AND_ALLOCATE_MEMORY(double, 1);
-  *((double *)state->next_value_memory) = double_value;
-  strcpy(state->next_value_type, "d");
+  ++stream->frame_count;
+
   return ERROR_NONE;
 }
 
-err_t fromjson_parse_string(fromjson_state_t *state)
+err_t fromjson_stream_close_object(fromjson_stream_t *stream)
 {
-  char *string_value;
-  char *json_ptr;
-  const char *src_ptr;
-  char *dest_ptr;
-  int string_is_complete;
-  int skipped_char;
+  fromjson_frame_t *frame = &stream->frames[--stream->frame_count];
+  grm_args_t *args = frame->args;
+  err_t error;
 
-  CHECK_AND_ALLOCATE_MEMORY(char *, 1);
-  json_ptr = state->shared_state->json_ptr;
-  string_value = ++json_ptr;
-  while (*json_ptr && !is_string_delimiter(json_ptr, string_value))
+  free(frame->key);
+  if (stream->frame_count == 0)
     {
-      ++json_ptr;
+      /* the root object is complete, all following data is ignored */
+      stream->expectation = FROMJSON_EXPECT_NOTHING;
+      return ERROR_NONE;
     }
-  string_is_complete = (*json_ptr != '\0');
-  *json_ptr = '\0';
-  /* Unescape '"' and '\' (since '\' is the escape character) */
-  src_ptr = dest_ptr = string_value;
-  skipped_char = 0;
-  while (*src_ptr)
+  if ((error = fromjson_stream_add_value(stream, 'a', args)) != ERROR_NONE)
     {
-      if (*src_ptr == '\\' && !skipped_char)
-        {
-          ++src_ptr;
-          skipped_char = 1;
-        }
-      else
-        {
-          *dest_ptr = *src_ptr;
-          ++src_ptr;
-          ++dest_ptr;
-          skipped_char = 0;
-        }
+      grm_args_delete(args);
     }
-  *dest_ptr = '\0';
-
-  *((const char **)state->next_value_memory) = string_value;
-  strcpy(state->next_value_type, "s");
-  ++json_ptr;
-  state->shared_state->json_ptr = json_ptr;
 
-  return string_is_complete ? ERROR_NONE : ERROR_PARSE_STRING;
+  return error;
 }
 
-err_t fromjson_parse_array(fromjson_state_t *state)
+err_t fromjson_stream_close_array(fromjson_stream_t *stream)
 {
-  fromjson_datatype_t json_datatype;
-  const char *next_delim_ptr;
-
-#define PARSE_VALUES(parse_suffix, c_type)                                                                         \
-  do                                                                                                               \
-    {                                                                                                              \
-      c_type *values;                                                                                              \
-      c_type *current_value_ptr;                                                                                   \
-      CHECK_AND_ALLOCATE_MEMORY(c_type *, 1);                                                                      \
-      values = malloc(array_length * sizeof(c_type));                                                              \
-      if (values == NULL)                                                                                          \
-        {                                                                                                          \
-          debug_print_malloc_error();                                                                              \
-          return ERROR_MALLOC;                                                                                     \
-        }                                                                                                          \
-      current_value_ptr = values;                                                                                  \
-      *(c_type **)state->next_value_memory = values;                                                               \
-      state->value_buffer_pointer_level = 2;                                                                       \
-      state->next_value_memory = values;                                                                           \
-      --state->shared_state->json_ptr;                                                                             \
-      while (!error && strchr("]", *state->shared_state->json_ptr) == NULL)                                        \
-        {                                                                                                          \
-          ++state->shared_state->json_ptr;                                                                         \
-          error = fromjson_parse_##parse_suffix(state);                                                            \
-          ++current_value_ptr;                                                                                     \
-          state->next_value_memory = current_value_ptr;                                                            \
-        }                                                                                                          \
-      snprintf(array_type + strlen(array_type), NEXT_VALUE_TYPE_SIZE, "%c(%zu)", toupper(*state->next_value_type), \
-               array_length);                                                                                      \
-    }                                                                                                              \
-  while (0)
+  fromjson_frame_t *frame = &stream->frames[--stream->frame_count];
+  fromjson_frame_t *parent_frame = &stream->frames[stream->frame_count - 1];
+  fromjson_array_t array = frame->array;
+  err_t error = ERROR_NONE;
 
-  if (strchr("]", *(state->shared_state->json_ptr + 1)) == NULL)
+  if (frame->is_inner_array)
     {
-      char array_type[NEXT_VALUE_TYPE_SIZE];
-      size_t outer_array_length = 0;
-      int is_nested_array = (*(state->shared_state->json_ptr + 1) == '[');
-      unsigned int current_outer_array_index = 0;
-      if (is_nested_array)
+      if ((error = fromjson_array_finalize(&array)) != ERROR_NONE)
         {
-          outer_array_length = fromjson_get_outer_array_length(state->shared_state->json_ptr);
-          /* `char *` is only used as a generic type since all pointers to values have the same storage size */
-          CHECK_AND_ALLOCATE_MEMORY(char *, outer_array_length);
+          fromjson_array_free(&array);
+          return error;
         }
-      array_type[0] = '\0';
-      do
+      if (parent_frame->inner_array_count == parent_frame->inner_array_capacity)
         {
-          err_t error = ERROR_NONE;
-          size_t array_length = 0;
-          state->shared_state->json_ptr += is_nested_array ? 2 : 1;
-          next_delim_ptr = state->shared_state->json_ptr;
-          while (*next_delim_ptr != ']' &&
-                 fromjson_find_next_delimiter(&next_delim_ptr, next_delim_ptr, array_length == 0, 1))
-            {
-              ++array_length;
-            }
-          if (*next_delim_ptr != ']')
+          size_t new_capacity = (parent_frame->inner_array_capacity > 0) ? 2 * parent_frame->inner_array_capacity : 8;
+          fromjson_array_t *new_inner_arrays =
+              realloc(parent_frame->inner_arrays, new_capacity * sizeof(fromjson_array_t));
+          if (new_inner_arrays == NULL)
             {
-              state->shared_state->json_ptr -= is_nested_array ? 2 : 1;
-              return ERROR_PARSE_INCOMPLETE_STRING;
-            }
-          assert(array_length > 0);
-          json_datatype = fromjson_check_type(state);
-          switch (json_datatype)
-            {
-            case JSON_DATATYPE_NUMBER:
-              if (is_int_number(state->shared_state->json_ptr))
-                {
-                  PARSE_VALUES(int, int);
-                }
-              else
-                {
-                  PARSE_VALUES(double, double);
-                }
-              break;
-            case JSON_DATATYPE_STRING:
-              PARSE_VALUES(string, char *);
-              break;
-            case JSON_DATATYPE_OBJECT:
-              PARSE_VALUES(object, grm_args_t *);
-              break;
-            case JSON_DATATYPE_ARRAY:
-              debug_print_error(("Arrays only support one level of nesting!\n"));
-              state->shared_state->json_ptr -= is_nested_array ? 2 : 1;
-              return ERROR_PARSE_ARRAY;
-              break;
-            default:
-              debug_print_error(("The datatype \"%s\" is currently not supported in arrays!\n",
-                                 fromjson_datatype_to_string[json_datatype]));
-              state->shared_state->json_ptr -= is_nested_array ? 2 : 1;
-              return ERROR_PARSE_ARRAY;
-              break;
+              debug_print_malloc_error();
+              fromjson_array_free(&array);
+              return ERROR_MALLOC;
             }
-          ++(state->shared_state->json_ptr);
-          if (is_nested_array)
+          parent_frame->inner_arrays = new_inner_arrays;
+          parent_frame->inner_array_capacity = new_capacity;
+        }
+      parent_frame->inner_arrays[parent_frame->inner_array_count++] = array;
+    }
+  else if (array.format == '[')
+    {
+      error = fromjson_stream_push_arrays(parent_frame, frame->inner_array_count, frame->inner_arrays);
+      if (error != ERROR_NONE)
+        {
+          size_t i;
+          for (i = 0; i < frame->inner_array_count; ++i)
             {
-              ++current_outer_array_index;
-              /* `char **` is only used as a generic type since all pointers to values have the same storage size */
-              state->next_value_memory = ((char **)state->value_buffer) + current_outer_array_index;
+              fromjson_array_free(&frame->inner_arrays[i]);
             }
         }
-      while (is_nested_array && current_outer_array_index < outer_array_length &&
-             strchr("]", *state->shared_state->json_ptr) == NULL);
-      if (is_nested_array && *state->shared_state->json_ptr == ']')
+      free(frame->inner_arrays);
+    }
+  else
+    {
+      if ((error = fromjson_array_finalize(&array)) == ERROR_NONE)
         {
-          ++state->shared_state->json_ptr;
+          error = fromjson_stream_push_arrays(parent_frame, 1, &array);
+        }
+      if (error != ERROR_NONE)
+        {
+          fromjson_array_free(&array);
         }
-      strcpy(state->next_value_type, array_type);
     }
-  else
+  if (error == ERROR_NONE)
     {
-      strcpy(state->next_value_type, "I(0)");
+      stream->expectation = FROMJSON_EXPECT_DELIMITER;
     }
 
-  return ERROR_NONE;
-
-#undef PARSE_VALUES
-}
-
-err_t fromjson_parse_object(fromjson_state_t *state)
-{
-  grm_args_t *args;
-  err_t error;
-
-  CHECK_AND_ALLOCATE_MEMORY(grm_args_t *, 1);
-  args = grm_args_new();
-  error = fromjson_parse(args, state->shared_state->json_ptr, state->shared_state);
-  *((grm_args_t **)state->next_value_memory) = args;
-  strcpy(state->next_value_type, "a");
   return error;
 }
 
-#undef CHECK_AND_ALLOCATE_MEMORY
-
-fromjson_datatype_t fromjson_check_type(const fromjson_state_t *state)
+err_t fromjson_stream_push_arrays(fromjson_frame_t *frame, size_t array_count, const fromjson_array_t *arrays)
 {
-  fromjson_datatype_t datatype;
+  /* `arrays` are handed over to the argument container of `frame` without copying them */
+  char *formats;
+  size_t *lengths;
+  void **values;
+  size_t i;
+  err_t error;
 
-  datatype = JSON_DATATYPE_UNKNOWN;
-  switch (*state->shared_state->json_ptr)
+  formats = malloc(array_count);
+  lengths = malloc(array_count * sizeof(size_t));
+  values = malloc(array_count * sizeof(void *));
+  if (formats == NULL || lengths == NULL || values == NULL)
     {
-    case '"':
-      datatype = JSON_DATATYPE_STRING;
-      break;
-    case '[':
-      datatype = JSON_DATATYPE_ARRAY;
-      break;
-    case '{':
-      datatype = JSON_DATATYPE_OBJECT;
-      break;
-    default:
-      break;
+      debug_print_malloc_error();
+      error = ERROR_MALLOC;
     }
-  if (datatype == JSON_DATATYPE_UNKNOWN)
+  else
     {
-      if (*state->shared_state->json_ptr == 'n')
+      for (i = 0; i < array_count; ++i)
         {
-          datatype = JSON_DATATYPE_NULL;
+          formats[i] = arrays[i].format;
+          lengths[i] = arrays[i].length;
+          values[i] = arrays[i].values;
         }
-      else if (strchr("ft", *state->shared_state->json_ptr) != NULL)
+      error = args_push_arrays_nocopy(frame->args, frame->key, array_count, formats, lengths, values, 1);
+    }
+  free(formats);
+  free(lengths);
+  free(values);
+  free(frame->key);
+  frame->key = NULL;
+
+  return error;
+}
+
+err_t fromjson_stream_append_to_token(fromjson_stream_t *stream, const char *data, size_t length)
+{
+  if (stream->token_length + length + 1 > stream->token_capacity)
+    {
+      size_t new_capacity = (stream->token_capacity > 0) ? stream->token_capacity : 64;
+      char *new_buffer;
+      while (stream->token_length + length + 1 > new_capacity)
         {
-          datatype = JSON_DATATYPE_BOOL;
+          new_capacity *= 2;
         }
-      else
+      new_buffer = realloc(stream->token_buffer, new_capacity);
+      if (new_buffer == NULL)
         {
-          datatype = JSON_DATATYPE_NUMBER;
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
         }
+      stream->token_buffer = new_buffer;
+      stream->token_capacity = new_capacity;
     }
-  return datatype;
+  memcpy(stream->token_buffer + stream->token_length, data, length);
+  stream->token_length += length;
+
+  return ERROR_NONE;
 }
 
-err_t fromjson_copy_and_filter_json_string(char **dest, const char *src)
+err_t fromjson_stream_terminate_token(fromjson_stream_t *stream)
 {
-  const char *src_ptr;
-  char *dest_buffer, *dest_ptr;
-  int in_string;
+  err_t error;
 
-  src_ptr = src;
-  dest_buffer = malloc(strlen(src) + 1);
-  if (dest_buffer == NULL)
+  /* appending an empty string ensures that there is room for the terminator */
+  if ((error = fromjson_stream_append_to_token(stream, "", 0)) != ERROR_NONE)
     {
-      debug_print_malloc_error();
-      return ERROR_MALLOC;
+      return error;
     }
-  dest_ptr = dest_buffer;
+  stream->token_buffer[stream->token_length] = '\0';
+
+  return ERROR_NONE;
+}
+
+err_t fromjson_stream_append_code_point(fromjson_stream_t *stream, unsigned long code_point)
+{
+  err_t error;
 
-  in_string = 0;
-  while (*src_ptr)
+  if (code_point >= 0xDC00 && code_point <= 0xDFFF && stream->high_surrogate != 0)
     {
-      if (is_string_delimiter(src_ptr, src))
+      code_point = 0x10000 + ((stream->high_surrogate - 0xD800) << 10) + (code_point - 0xDC00);
+      stream->high_surrogate = 0;
+    }
+  else
+    {
+      if ((error = fromjson_stream_flush_high_surrogate(stream)) != ERROR_NONE)
         {
-          in_string = !in_string;
+          return error;
         }
-      if (in_string || !isspace(*src_ptr))
+      if (code_point >= 0xD800 && code_point <= 0xDBFF)
         {
-          *dest_ptr = *src_ptr;
-          ++dest_ptr;
+          /* wait for the low surrogate */
+          stream->high_surrogate = code_point;
+          return ERROR_NONE;
         }
-      ++src_ptr;
     }
-  *dest_ptr = '\0';
 
-  *dest = dest_buffer;
-
-  return ERROR_NONE;
+  return fromjson_stream_append_utf8(stream, code_point);
 }
 
-int fromjson_is_escaped_delimiter(const char *delim_ptr, const char *str)
+err_t fromjson_stream_append_utf8(fromjson_stream_t *stream, unsigned long code_point)
 {
-  const char *first_non_escape_char_ptr;
+  char utf8_buffer[4];
+  size_t utf8_length;
 
-  first_non_escape_char_ptr = delim_ptr - 1;
-  while (first_non_escape_char_ptr != str - 1 && *first_non_escape_char_ptr == FROMJSON_ESCAPE_CHARACTER)
+  if (code_point < 0x80)
+    {
+      utf8_buffer[0] = (char)code_point;
+      utf8_length = 1;
+    }
+  else if (code_point < 0x800)
+    {
+      utf8_buffer[0] = (char)(0xC0 | (code_point >> 6));
+      utf8_buffer[1] = (char)(0x80 | (code_point & 0x3F));
+      utf8_length = 2;
+    }
+  else if (code_point < 0x10000)
     {
-      --first_non_escape_char_ptr;
+      utf8_buffer[0] = (char)(0xE0 | (code_point >> 12));
+      utf8_buffer[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+      utf8_buffer[2] = (char)(0x80 | (code_point & 0x3F));
+      utf8_length = 3;
     }
-  return (delim_ptr - first_non_escape_char_ptr) % 2 == 0;
+  else
+    {
+      utf8_buffer[0] = (char)(0xF0 | (code_point >> 18));
+      utf8_buffer[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+      utf8_buffer[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+      utf8_buffer[3] = (char)(0x80 | (code_point & 0x3F));
+      utf8_length = 4;
+    }
+
+  return fromjson_stream_append_to_token(stream, utf8_buffer, utf8_length);
 }
 
-int fromjson_find_next_delimiter(const char **delim_ptr, const char *src, int include_start,
-                                 int exclude_nested_structures)
+err_t fromjson_stream_flush_high_surrogate(fromjson_stream_t *stream)
 {
-  int is_in_string = 0;
+  unsigned long high_surrogate = stream->high_surrogate;
 
-  if (*src == '\0')
+  if (high_surrogate == 0)
     {
-      return 0;
+      return ERROR_NONE;
     }
-  if (!include_start)
+  /* a high surrogate without a following low surrogate is stored as is */
+  stream->high_surrogate = 0;
+  return fromjson_stream_append_utf8(stream, high_surrogate);
+}
+
+err_t fromjson_array_append(fromjson_array_t *array, char type, const void *value)
+{
+  size_t value_size;
+
+  if (array->format == '\0')
     {
-      ++src;
+      array->format = type;
     }
-  if (exclude_nested_structures)
+  else if (array->format != type)
     {
-      const char *src_ptr = src;
-      int nested_level = 0;
-
-      while (*src_ptr != '\0')
+      if (array->format == 'd' && type == 'i')
         {
-          if (*src_ptr == FROMJSON_STRING_DELIMITER && !fromjson_is_escaped_delimiter(src_ptr, src))
-            {
-              is_in_string = !is_in_string;
-            }
-          if (!is_in_string)
+          double double_value = *(const int *)value;
+          return fromjson_array_append(array, 'd', &double_value);
+        }
+      else if (array->format == 'i' && type == 'd')
+        {
+          /* a double value in an integer array promotes all previous values to double */
+          double *double_values = NULL;
+          size_t i;
+          if (array->length > 0)
             {
-              if (strchr("[{", *src_ptr))
-                {
-                  ++nested_level;
-                }
-              else if (strchr("]}", *src_ptr))
+              double_values = malloc(array->capacity * sizeof(double));
+              if (double_values == NULL)
                 {
-                  if (nested_level > 0)
-                    {
-                      --nested_level;
-                    }
-                  else
-                    {
-                      break;
-                    }
+                  debug_print_malloc_error();
+                  return ERROR_MALLOC;
                 }
-              else if (*src_ptr == ',' && nested_level == 0)
+              for (i = 0; i < array->length; ++i)
                 {
-                  break;
+                  double_values[i] = ((int *)array->values)[i];
                 }
             }
-          ++src_ptr;
+          free(array->values);
+          array->values = double_values;
+          array->format = 'd';
         }
-      if (*src_ptr != '\0')
+      else
         {
-          *delim_ptr = src_ptr;
-          return 1;
+          debug_print_error(("Arrays must only contain values of one datatype!\n"));
+          return ERROR_PARSE_ARRAY;
         }
     }
-  else
+  value_size = fromjson_array_value_size(array->format);
+  if (array->length == array->capacity)
     {
-      const char *src_ptr = src;
-      while (*src_ptr != '\0' && (is_in_string || strchr(FROMJSON_VALID_DELIMITERS, *src_ptr) == NULL))
+      size_t new_capacity = (array->capacity > 0) ? 2 * array->capacity : 16;
+      void *new_values = realloc(array->values, new_capacity * value_size);
+      if (new_values == NULL)
         {
-          if (*src_ptr == FROMJSON_STRING_DELIMITER && !fromjson_is_escaped_delimiter(src_ptr, src))
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
+        }
+      array->values = new_values;
+      array->capacity = new_capacity;
+    }
+  switch (array->format)
+    {
+    case 'i':
+      ((int *)array->values)[array->length] = *(const int *)value;
+      break;
+    case 'd':
+      ((double *)array->values)[array->length] = *(const double *)value;
+      break;
+    case 's':
+      ((char **)array->values)[array->length] = gks_strdup((const char *)value);
+      if (((char **)array->values)[array->length] == NULL)
+        {
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
+        }
+      break;
+    case 'a':
+      ((grm_args_t **)array->values)[array->length] = (grm_args_t *)value;
+      break;
+    default:
+      return ERROR_PARSE_ARRAY;
+    }
+  ++array->length;
+
+  return ERROR_NONE;
+}
+
+err_t fromjson_array_finalize(fromjson_array_t *array)
+{
+  /* Bring the array into the form the argument container expects: string and argument container arrays are `NULL`
+   * terminated and empty arrays are integer arrays */
+  if (array->format == '\0')
+    {
+      array->format = 'i';
+    }
+  if (array->format == 's' || array->format == 'a')
+    {
+      if (array->length == array->capacity)
+        {
+          void *new_values = realloc(array->values, (array->length + 1) * sizeof(void *));
+          if (new_values == NULL)
             {
-              is_in_string = !is_in_string;
+              debug_print_malloc_error();
+              return ERROR_MALLOC;
             }
-          ++src_ptr;
+          array->values = new_values;
+          array->capacity = array->length + 1;
         }
-      if (*src_ptr != '\0')
+      ((void **)array->values)[array->length] = NULL;
+    }
+  else if (array->length < array->capacity && array->length > 0)
+    {
+      /* shrinking cannot fail in practice, keep the larger buffer otherwise */
+      void *new_values = realloc(array->values, array->length * fromjson_array_value_size(array->format));
+      if (new_values != NULL)
         {
-          *delim_ptr = src_ptr;
-          return 1;
+          array->values = new_values;
+          array->capacity = array->length;
         }
     }
-  return 0;
+
+  return ERROR_NONE;
 }
 
-size_t fromjson_get_outer_array_length(const char *str)
+void fromjson_array_free(fromjson_array_t *array)
 {
-  size_t outer_array_length = 0;
-  int current_array_level = 1;
+  size_t i;
 
-  if (*str != '[')
+  if (array->format == 's')
     {
-      return outer_array_length;
+      for (i = 0; i < array->length; ++i)
+        {
+          free(((char **)array->values)[i]);
+        }
     }
-  ++str;
-  while (current_array_level > 0 && *str)
+  else if (array->format == 'a')
     {
-      switch (*str)
+      for (i = 0; i < array->length; ++i)
         {
-        case '[':
-          ++current_array_level;
-          break;
-        case ']':
-          --current_array_level;
-          break;
-        case ',':
-          if (current_array_level == 1)
-            {
-              ++outer_array_length;
-            }
-          break;
-        default:
-          break;
+          grm_args_delete(((grm_args_t **)array->values)[i]);
         }
-      ++str;
     }
-  ++outer_array_length;
-  return outer_array_length;
+  free(array->values);
+  array->values = NULL;
+  array->length = 0;
+  array->capacity = 0;
+}
+
+size_t fromjson_array_value_size(char format)
+{
+  switch (format)
+    {
+    case 'i':
+      return sizeof(int);
+    case 'd':
+      return sizeof(double);
+    default:
+      return sizeof(void *);
+    }
+}
+
+int fromjson_is_number_char(char c)
+{
+  /* uppercase letters are part of numbers for `E`, `NAN` and `INF` which are written by the serializer */
+  return isdigit((unsigned char)c) || c == '-' || c == '+' || c == '.' || c == 'e' || (c >= 'A' && c <= 'Z');
 }
 
-double fromjson_str_to_double(const char **str, int *was_successful)
+int fromjson_is_valid_number(const char *begin, const char *end)
 {
-  char *conversion_end = NULL;
-  double conversion_result;
-  int success = 0;
-  const char *next_delim_ptr = NULL;
+  /*
+   * Check the json number grammar: an optional minus, an integer part without leading zeros, an optional fraction and
+   * an optional exponent. The serializer also writes `NAN` and `INF` and marks integral doubles with a trailing `.`
+   * (without fraction digits), so these are accepted as well.
+   */
+  const char *p = begin;
 
-  errno = 0;
-  if (*str != NULL)
+  if (p < end && *p == '-')
     {
-      conversion_result = strtod(*str, &conversion_end);
+      ++p;
     }
-  else
+  if (end - p == 3 && (strncmp(p, "NAN", 3) == 0 || strncmp(p, "INF", 3) == 0))
     {
-      conversion_result = 0.0;
+      return 1;
     }
-  if (conversion_end == NULL)
+  if (p == end || !isdigit((unsigned char)*p))
     {
-      debug_print_error(("No number conversion was executed (the string is NULL)!\n"));
+      return 0;
     }
-  else if (*str == conversion_end || strchr(FROMJSON_VALID_DELIMITERS, *conversion_end) == NULL)
+  if (*p == '0')
     {
-      fromjson_find_next_delimiter(&next_delim_ptr, *str, 1, 0);
-      debug_print_error(("The parameter \"%.*s\" is not a valid number!\n", next_delim_ptr - *str, *str));
+      ++p;
     }
-  else if (errno == ERANGE)
+  else
     {
-      fromjson_find_next_delimiter(&next_delim_ptr, *str, 1, 0);
-      if (conversion_result == HUGE_VAL || conversion_result == -HUGE_VAL)
-        {
-          debug_print_error(("The parameter \"%.*s\" caused an overflow, the number has been clamped to \"%lf\"\n",
-                             next_delim_ptr - *str, *str, conversion_result));
-        }
-      else
+      while (p < end && isdigit((unsigned char)*p))
         {
-          debug_print_error(("The parameter \"%.*s\" caused an underflow, the number has been clamped to \"%lf\"\n",
-                             next_delim_ptr - *str, *str, conversion_result));
+          ++p;
         }
     }
-  else
+  if (p < end && *p == '.')
     {
-      success = 1;
-      *str = conversion_end;
+      ++p;
+      while (p < end && isdigit((unsigned char)*p))
+        {
+          ++p;
+        }
     }
-  if (was_successful != NULL)
+  if (p < end && (*p == 'e' || *p == 'E'))
     {
-      *was_successful = success;
+      ++p;
+      if (p < end && (*p == '-' || *p == '+'))
+        {
+          ++p;
+        }
+      if (p == end || !isdigit((unsigned char)*p))
+        {
+          return 0;
+        }
+      while (p < end && isdigit((unsigned char)*p))
+        {
+          ++p;
+        }
     }
 
-  return conversion_result;
+  return p == end;
 }
 
-int fromjson_str_to_int(const char **str, int *was_successful)
+int fromjson_is_literal_char(char c)
 {
-  char *conversion_end = NULL;
-  long conversion_result;
-  int success = 0;
-  const char *next_delim_ptr = NULL;
+  return c >= 'a' && c <= 'z';
+}
 
-  errno = 0;
-  if (*str != NULL)
-    {
-      conversion_result = strtol(*str, &conversion_end, 10);
-    }
-  else
+int fromjson_str_to_int(const char *begin, const char *end, int *value)
+{
+  /* `begin` to `end` only consists of digits and signs, so only the structure and the range need to be checked */
+  const char *str_ptr = begin;
+  unsigned long limit = INT_MAX, result = 0;
+  int is_negative = 0;
+
+  if (str_ptr < end && (*str_ptr == '-' || *str_ptr == '+'))
     {
-      conversion_result = 0;
+      is_negative = (*str_ptr == '-');
+      ++str_ptr;
     }
-  if (conversion_end == NULL)
+  if (str_ptr == end)
     {
-      debug_print_error(("No number conversion was executed (the string is NULL)!\n"));
+      return 0;
     }
-  else if (*str == conversion_end || strchr(FROMJSON_VALID_DELIMITERS, *conversion_end) == NULL)
+  if (is_negative)
     {
-      fromjson_find_next_delimiter(&next_delim_ptr, *str, 1, 0);
-      debug_print_error(("The parameter \"%.*s\" is not a valid number!\n", next_delim_ptr - *str, *str));
+      limit = (unsigned long)INT_MAX + 1;
     }
-  else if (errno == ERANGE || conversion_result > INT_MAX || conversion_result < INT_MIN)
+  for (; str_ptr < end; ++str_ptr)
     {
-      fromjson_find_next_delimiter(&next_delim_ptr, *str, 1, 0);
-      if (conversion_result > INT_MAX)
+      unsigned long digit;
+      if (!isdigit((unsigned char)*str_ptr))
         {
-          debug_print_error(("The parameter \"%.*s\" is too big, the number has been clamped to \"%d\"\n",
-                             next_delim_ptr - *str, *str, INT_MAX));
-          conversion_result = INT_MAX;
+          return 0;
         }
-      else
+      digit = *str_ptr - '0';
+      if (result > (limit - digit) / 10)
         {
-          debug_print_error(("The parameter \"%.*s\" is too small, the number has been clamped to \"%d\"\n",
-                             next_delim_ptr - *str, *str, INT_MIN));
-          conversion_result = INT_MIN;
+          return 0;
         }
+      result = 10 * result + digit;
     }
-  else
+  if (is_negative)
     {
-      success = 1;
-      *str = conversion_end;
+      *value = (result == (unsigned long)INT_MAX + 1) ? INT_MIN : -(int)result;
     }
-  if (was_successful != NULL)
+  else
     {
-      *was_successful = success;
+      *value = (int)result;
     }
 
-  return (int)conversion_result;
+  return 1;
 }
 
 
@@ -937,38 +1303,15 @@ DEFINE_STRINGIFY_MULTI(args, grm_args_t *)
 #undef DEFINE_STRINGIFY_MULTI
 #undef DEFINE_STRINGIFY_VALUE
 
-#define STR(x) #x
-#define XSTR(x) STR(x)
-
 err_t tojson_stringify_double_value(memwriter_t *memwriter, double value)
 {
-  err_t error;
-  size_t string_start_index;
-  const char *unprocessed_string;
-
-  string_start_index = memwriter_size(memwriter);
   /*
-     The %G format specifier is important here, as it returns "NAN" for missing values -
-     %g would return "nan" and be handled as JSON_DATATYPE_NULL in fromjson_check_type()
+     Uppercase output is important here, as it writes "NAN" for missing values - "nan" would be handled as the start of
+     a `null` literal by the deserializer. Integral values get a trailing "." to be read back as doubles.
    */
-  if ((error = memwriter_printf(memwriter, "%." XSTR(DBL_DECIMAL_DIG) "G", value)) != ERROR_NONE)
-    {
-      return error;
-    }
-  unprocessed_string = memwriter_buf(memwriter) + string_start_index;
-  if (strspn(unprocessed_string, "0123456789-") == memwriter_size(memwriter) - string_start_index)
-    {
-      if ((error = memwriter_putc(memwriter, '.')) != ERROR_NONE)
-        {
-          return error;
-        }
-    }
-  return ERROR_NONE;
+  return memwriter_put_double(memwriter, value, GKS_DTOA_UPPERCASE | GKS_DTOA_MARK_FLOAT);
 }
 
-#undef XSTR
-#undef STR
-
 err_t tojson_stringify_char_array(tojson_state_t *state)
 {
   char *chars;
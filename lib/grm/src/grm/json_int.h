@@ -23,45 +23,73 @@ extern "C" {
 extern const char *FROMJSON_VALID_DELIMITERS;
 
 
-/* ========================= macros ================================================================================= */
-
-/* ------------------------- json deserializer ---------------------------------------------------------------------- */
-
-#define NEXT_VALUE_TYPE_SIZE 80
-
-
 /* ========================= datatypes ============================================================================== */
 
 /* ------------------------- json deserializer ---------------------------------------------------------------------- */
 
 typedef enum
 {
-  JSON_DATATYPE_UNKNOWN,
-  JSON_DATATYPE_NULL,
-  JSON_DATATYPE_BOOL,
-  JSON_DATATYPE_NUMBER,
-  JSON_DATATYPE_STRING,
-  JSON_DATATYPE_ARRAY,
-  JSON_DATATYPE_OBJECT
-} fromjson_datatype_t;
+  FROMJSON_EXPECT_ROOT,
+  FROMJSON_EXPECT_VALUE,
+  FROMJSON_EXPECT_VALUE_OR_END,
+  FROMJSON_EXPECT_KEY,
+  FROMJSON_EXPECT_KEY_OR_END,
+  FROMJSON_EXPECT_COLON,
+  FROMJSON_EXPECT_DELIMITER,
+  FROMJSON_EXPECT_NOTHING
+} fromjson_expectation_t;
+
+typedef enum
+{
+  FROMJSON_TOKEN_NONE,
+  FROMJSON_TOKEN_KEY,
+  FROMJSON_TOKEN_STRING,
+  FROMJSON_TOKEN_NUMBER,
+  FROMJSON_TOKEN_LITERAL
+} fromjson_token_t;
 
 typedef struct
 {
-  char *json_ptr;
-  int parsed_any_value_before;
-} fromjson_shared_state_t;
+  /* 'i', 'd', 's', 'a', '[' for an array of arrays or '\0' as long as the array is empty */
+  char format;
+  size_t length;
+  size_t capacity;
+  void *values;
+} fromjson_array_t;
 
 typedef struct
 {
-  fromjson_datatype_t datatype;
-  int parsing_object;
-  void *value_buffer;
-  int value_buffer_pointer_level;
-  void *next_value_memory;
-  char *next_value_type;
+  int is_object;
+  int is_inner_array;
+  grm_args_t *args;
+  char *key;
+  fromjson_array_t array;
+  fromjson_array_t *inner_arrays;
+  size_t inner_array_count;
+  size_t inner_array_capacity;
+} fromjson_frame_t;
+
+/*!
+ * A `fromjson_stream_t` parses a json document incrementally: it can be fed with arbitrary chunks of the document and
+ * writes all object members to the argument container as soon as they are complete. Arrays are collected in growing
+ * buffers which are handed over to the argument container without copying them.
+ */
+typedef struct
+{
   grm_args_t *args;
-  fromjson_shared_state_t *shared_state;
-} fromjson_state_t;
+  fromjson_frame_t *frames;
+  size_t frame_count;
+  size_t frame_capacity;
+  fromjson_expectation_t expectation;
+  fromjson_token_t token;
+  char *token_buffer;
+  size_t token_length;
+  size_t token_capacity;
+  int escape_state;
+  unsigned long escape_code_point;
+  unsigned long high_surrogate;
+  err_t error;
+} fromjson_stream_t;
 
 
 /* ------------------------- json serializer ------------------------------------------------------------------------ */
@@ -120,25 +148,37 @@ typedef struct
 int grm_read(grm_args_t *args, const char *json_string);
 err_t fromjson_read(grm_args_t *args, const char *json_string);
 
-err_t fromjson_parse(grm_args_t *args, const char *json_string, fromjson_shared_state_t *shared_state);
-err_t fromjson_parse_null(fromjson_state_t *state);
-err_t fromjson_parse_bool(fromjson_state_t *state);
-err_t fromjson_parse_number(fromjson_state_t *state);
-err_t fromjson_parse_int(fromjson_state_t *state);
-err_t fromjson_parse_double(fromjson_state_t *state);
-err_t fromjson_parse_string(fromjson_state_t *state);
-err_t fromjson_parse_array(fromjson_state_t *state);
-err_t fromjson_parse_object(fromjson_state_t *state);
-
-fromjson_datatype_t fromjson_check_type(const fromjson_state_t *state);
-err_t fromjson_copy_and_filter_json_string(char **dest, const char *src);
-int fromjson_is_escaped_delimiter(const char *delim_ptr, const char *str);
-int fromjson_find_next_delimiter(const char **delim_ptr, const char *src, int include_start,
-                                 int exclude_nested_structures);
-size_t fromjson_get_outer_array_length(const char *str);
-double fromjson_str_to_double(const char **str, int *was_successful);
-int fromjson_str_to_int(const char **str, int *was_successful);
-
+fromjson_stream_t *fromjson_stream_new(grm_args_t *args);
+void fromjson_stream_delete(fromjson_stream_t *stream);
+err_t fromjson_stream_feed(fromjson_stream_t *stream, const char *data, size_t length);
+err_t fromjson_stream_finish(fromjson_stream_t *stream);
+int fromjson_stream_is_complete(const fromjson_stream_t *stream);
+
+err_t fromjson_stream_process_char(fromjson_stream_t *stream, char c);
+err_t fromjson_stream_continue_string(fromjson_stream_t *stream, const char **current, const char *end);
+err_t fromjson_stream_finish_string(fromjson_stream_t *stream);
+err_t fromjson_stream_continue_scalar(fromjson_stream_t *stream, const char **current, const char *end);
+err_t fromjson_stream_parse_number(fromjson_stream_t *stream, const char *begin, const char *end);
+err_t fromjson_stream_parse_literal(fromjson_stream_t *stream, const char *begin, const char *end);
+err_t fromjson_stream_add_value(fromjson_stream_t *stream, char type, const void *value);
+err_t fromjson_stream_push_frame(fromjson_stream_t *stream, int is_object);
+err_t fromjson_stream_close_object(fromjson_stream_t *stream);
+err_t fromjson_stream_close_array(fromjson_stream_t *stream);
+err_t fromjson_stream_push_arrays(fromjson_frame_t *frame, size_t array_count, const fromjson_array_t *arrays);
+err_t fromjson_stream_append_to_token(fromjson_stream_t *stream, const char *data, size_t length);
+err_t fromjson_stream_terminate_token(fromjson_stream_t *stream);
+err_t fromjson_stream_append_code_point(fromjson_stream_t *stream, unsigned long code_point);
+err_t fromjson_stream_append_utf8(fromjson_stream_t *stream, unsigned long code_point);
+err_t fromjson_stream_flush_high_surrogate(fromjson_stream_t *stream);
+
+err_t fromjson_array_append(fromjson_array_t *array, char type, const void *value);
+err_t fromjson_array_finalize(fromjson_array_t *array);
+void fromjson_array_free(fromjson_array_t *array);
+size_t fromjson_array_value_size(char format);
+int fromjson_is_number_char(char c);
+int fromjson_is_valid_number(const char *begin, const char *end);
+int fromjson_is_literal_char(char c);
+int fromjson_str_to_int(const char *begin, const char *end, int *value);
 
 /* ------------------------- json serializer ------------------------------------------------------------------------ */
 
@@ -6,28 +6,186 @@
 
 #include <stdarg.h>
 #include <string.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#include <pthread.h>
+#endif
 
+#include "gkscore.h"
 #include "grm/error.h"
 #include "memwriter_int.h"
 
 
 /* ######################### internal implementation ################################################################ */
 
+/* ========================= macros ================================================================================= */
+
+/* ------------------------- memwriter ------------------------------------------------------------------------------ */
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define MEMWRITER_USE_POOL
+#endif
+
+
+/* ========================= datatypes ============================================================================== */
+
+/* ------------------------- memwriter ------------------------------------------------------------------------------ */
+
+#ifdef MEMWRITER_USE_POOL
+typedef struct
+{
+  memwriter_t *memwriters[MEMWRITER_POOL_SIZE];
+  int count;
+} memwriter_pool_t;
+#endif
+
+
+/* ========================= static variables ======================================================================= */
+
+/* ------------------------- memwriter ------------------------------------------------------------------------------ */
+
+/*
+ * Deleted memwriters are kept (with their buffers) in a per-thread pool and handed out again by `memwriter_new`, so
+ * repeated serializations of messages of similar size do not allocate any memory. The pool of a thread is registered
+ * with a pthread key whose destructor frees it when the thread exits. Without pthreads every memwriter is freed
+ * immediately.
+ */
+#ifdef MEMWRITER_USE_POOL
+static __thread memwriter_pool_t *memwriter_pool = NULL;
+static pthread_key_t memwriter_pool_key;
+static pthread_once_t memwriter_pool_key_once = PTHREAD_ONCE_INIT;
+static int memwriter_pool_key_created = 0;
+#endif
+
+
 /* ========================= methods ================================================================================ */
 
 /* ------------------------- memwriter ------------------------------------------------------------------------------ */
 
-memwriter_t *memwriter_new()
+#ifdef MEMWRITER_USE_POOL
+static void memwriter_pool_delete(void *pool_ptr)
+{
+  memwriter_pool_t *pool = pool_ptr;
+
+  while (pool->count > 0)
+    {
+      memwriter_t *memwriter = pool->memwriters[--pool->count];
+      free(memwriter->buf);
+      free(memwriter);
+    }
+  free(pool);
+}
+
+static void memwriter_pool_create_key(void)
+{
+  memwriter_pool_key_created = (pthread_key_create(&memwriter_pool_key, memwriter_pool_delete) == 0);
+}
+
+static memwriter_pool_t *memwriter_pool_get(void)
 {
+  /* creates the pool of the calling thread on first use, returns `NULL` if it cannot be created */
+  if (memwriter_pool == NULL)
+    {
+      pthread_once(&memwriter_pool_key_once, memwriter_pool_create_key);
+      if (!memwriter_pool_key_created)
+        {
+          return NULL;
+        }
+      memwriter_pool = calloc(1, sizeof(memwriter_pool_t));
+      if (memwriter_pool == NULL)
+        {
+          return NULL;
+        }
+      if (pthread_setspecific(memwriter_pool_key, memwriter_pool) != 0)
+        {
+          free(memwriter_pool);
+          memwriter_pool = NULL;
+        }
+    }
+
+  return memwriter_pool;
+}
+#endif
+
+static memwriter_t *memwriter_pool_take(size_t capacity)
+{
+#ifdef MEMWRITER_USE_POOL
+  int best_index = -1;
+  int i;
   memwriter_t *memwriter;
 
+  if (memwriter_pool == NULL)
+    {
+      return NULL;
+    }
+  /* prefer the smallest buffer which is large enough, otherwise the largest one since it needs the fewest steps */
+  for (i = 0; i < memwriter_pool->count; ++i)
+    {
+      size_t candidate_capacity = memwriter_pool->memwriters[i]->capacity;
+      size_t best_capacity;
+
+      if (best_index < 0)
+        {
+          best_index = i;
+          continue;
+        }
+      best_capacity = memwriter_pool->memwriters[best_index]->capacity;
+      if ((best_capacity < capacity) ? candidate_capacity > best_capacity
+                                     : (candidate_capacity >= capacity && candidate_capacity < best_capacity))
+        {
+          best_index = i;
+        }
+    }
+  if (best_index < 0)
+    {
+      return NULL;
+    }
+  memwriter = memwriter_pool->memwriters[best_index];
+  memwriter_pool->memwriters[best_index] = memwriter_pool->memwriters[--memwriter_pool->count];
+  memwriter_clear(memwriter);
+
+  return memwriter;
+#else
+  (void)capacity;
+  return NULL;
+#endif
+}
+
+memwriter_t *memwriter_new(void)
+{
+  return memwriter_new_with_capacity(MEMWRITER_INITIAL_SIZE);
+}
+
+memwriter_t *memwriter_new_with_capacity(size_t capacity)
+{
+  /* `capacity` is an estimate of the final size, e.g. computed by `args_estimate_serialized_size` */
+  memwriter_t *memwriter;
+
+  memwriter = memwriter_pool_take(capacity);
+  if (memwriter != NULL)
+    {
+      if (memwriter_ensure_buf(memwriter, capacity) != ERROR_NONE)
+        {
+          memwriter_delete(memwriter);
+          return NULL;
+        }
+      return memwriter;
+    }
   memwriter = malloc(sizeof(memwriter_t));
   if (memwriter == NULL)
     {
       debug_print_malloc_error();
       return NULL;
     }
-  memwriter->buf = malloc(MEMWRITER_INITIAL_SIZE);
+  memwriter->capacity = MEMWRITER_INITIAL_SIZE;
+  while (memwriter->capacity < capacity && memwriter->capacity < MEMWRITER_EXPONENTIAL_INCREASE_UNTIL)
+    {
+      memwriter->capacity *= 2;
+    }
+  if (memwriter->capacity < capacity)
+    {
+      memwriter->capacity = capacity;
+    }
+  memwriter->buf = malloc(memwriter->capacity);
   if (memwriter->buf == NULL)
     {
       free(memwriter);
@@ -35,18 +193,40 @@ memwriter_t *memwriter_new()
       return NULL;
     }
   memwriter->size = 0;
-  memwriter->capacity = MEMWRITER_INITIAL_SIZE;
+  *memwriter->buf = '\0';
 
   return memwriter;
 }
 
 void memwriter_delete(memwriter_t *memwriter)
 {
-  if (memwriter != NULL)
+  if (memwriter == NULL)
     {
-      free(memwriter->buf);
-      free(memwriter);
+      return;
+    }
+#ifdef MEMWRITER_USE_POOL
+  if (memwriter->capacity <= MEMWRITER_POOL_MAX_CAPACITY && memwriter_pool_get() != NULL &&
+      memwriter_pool->count < MEMWRITER_POOL_SIZE)
+    {
+      memwriter_pool->memwriters[memwriter_pool->count++] = memwriter;
+      return;
+    }
+#endif
+  free(memwriter->buf);
+  free(memwriter);
+}
+
+void memwriter_pool_clear(void)
+{
+  /* frees the memwriters kept for reuse by the calling thread */
+#ifdef MEMWRITER_USE_POOL
+  if (memwriter_pool != NULL)
+    {
+      pthread_setspecific(memwriter_pool_key, NULL);
+      memwriter_pool_delete(memwriter_pool);
+      memwriter_pool = NULL;
     }
+#endif
 }
 
 void memwriter_clear(memwriter_t *memwriter)
@@ -91,40 +271,34 @@ err_t memwriter_insert(memwriter_t *memwriter, int index, const char *str)
 
 err_t memwriter_enlarge_buf(memwriter_t *memwriter, size_t size_increment)
 {
+  /* An increment of zero enlarges the buffer by one growth step. The capacity grows geometrically, so the number of
+   * reallocations stays logarithmic in the message size, even for very large messages. */
+  size_t needed_capacity = memwriter->capacity + ((size_increment > 0) ? size_increment : 1);
+  size_t new_capacity = memwriter->capacity;
   void *new_buf;
 
-  if (size_increment == 0)
+  if (needed_capacity < memwriter->capacity)
     {
-      if (memwriter->capacity >= MEMWRITER_EXPONENTIAL_INCREASE_UNTIL)
-        {
-          size_increment = MEMWRITER_LINEAR_INCREMENT_SIZE;
-        }
-      else
-        {
-          size_increment = memwriter->capacity;
-        }
+      debug_print_malloc_error();
+      return ERROR_MALLOC;
     }
-  else
+  while (new_capacity < needed_capacity)
     {
-      /* round up to the next `MEMWRITER_LINEAR_INCREMENT_SIZE` step */
-      if (memwriter->capacity >= MEMWRITER_EXPONENTIAL_INCREASE_UNTIL)
-        {
-          size_increment =
-              ((size_increment - 1) / MEMWRITER_LINEAR_INCREMENT_SIZE + 1) * MEMWRITER_LINEAR_INCREMENT_SIZE;
-        }
-      else
+      size_t previous_capacity = new_capacity;
+      new_capacity += (new_capacity < MEMWRITER_EXPONENTIAL_INCREASE_UNTIL) ? new_capacity : new_capacity / 2;
+      if (new_capacity <= previous_capacity)
         {
-          size_increment = next_or_equal_power2(memwriter->capacity + size_increment) - memwriter->capacity;
+          new_capacity = needed_capacity;
         }
     }
-  new_buf = realloc(memwriter->buf, memwriter->capacity + size_increment);
+  new_buf = realloc(memwriter->buf, new_capacity);
   if (new_buf == NULL)
     {
       debug_print_malloc_error();
       return ERROR_MALLOC;
     }
   memwriter->buf = new_buf;
-  memwriter->capacity += size_increment;
+  memwriter->capacity = new_capacity;
 
   return ERROR_NONE;
 }
@@ -194,11 +368,28 @@ err_t memwriter_putc(memwriter_t *memwriter, char c)
   return memwriter_printf(memwriter, "%c", c);
 }
 
+err_t memwriter_put_double(memwriter_t *memwriter, double value, int flags)
+{
+  /* `flags` are passed to `gks_dtoa` which writes the shortest representation that is read back as `value` */
+  err_t error;
+
+  if ((error = memwriter_ensure_buf(memwriter, GKS_DTOA_BUFFER_SIZE)) != ERROR_NONE)
+    {
+      return error;
+    }
+  memwriter->size += gks_dtoa(&memwriter->buf[memwriter->size], value, flags);
+
+  return ERROR_NONE;
+}
+
 err_t memwriter_memcpy(memwriter_t *memwriter, const void *source, size_t num)
 {
   err_t error = ERROR_NONE;
 
-  memwriter_ensure_buf(memwriter, num);
+  if ((error = memwriter_ensure_buf(memwriter, num)) != ERROR_NONE)
+    {
+      return error;
+    }
 
   memcpy(&memwriter->buf[memwriter->size], source, num);
 
@@ -210,14 +401,18 @@ err_t memwriter_memcpy(memwriter_t *memwriter, const void *source, size_t num)
 err_t memwriter_memcpy_rev_chunks(memwriter_t *memwriter, const void *source, size_t num, int chunk_size)
 {
   err_t error = ERROR_NONE;
-
-  memwriter_ensure_buf(memwriter, num);
-
-  char *d = &memwriter->buf[memwriter->size];
+  char *d;
   const char *s = source;
   int i;
   int j;
 
+  if ((error = memwriter_ensure_buf(memwriter, num)) != ERROR_NONE)
+    {
+      return error;
+    }
+
+  d = &memwriter->buf[memwriter->size];
+
   for (i = 0; i < num; i += chunk_size)
     {
       for (j = 0; j < chunk_size; j++)
@@ -19,8 +19,12 @@ extern "C" {
 /* ------------------------- memwriter ------------------------------------------------------------------------------ */
 
 #define MEMWRITER_INITIAL_SIZE 32768
+/* the capacity doubles until it reaches this size and grows by half of its size afterwards */
 #define MEMWRITER_EXPONENTIAL_INCREASE_UNTIL 268435456
-#define MEMWRITER_LINEAR_INCREMENT_SIZE 67108864
+/* number of deleted memwriters which are kept per thread for reuse */
+#define MEMWRITER_POOL_SIZE 4
+/* larger buffers are freed, so threads do not keep the memory of a single huge message */
+#define MEMWRITER_POOL_MAX_CAPACITY 4194304
 
 #define ETB '\027'
 
@@ -42,7 +46,9 @@ typedef struct _memwriter_t memwriter_t;
 /* ------------------------- memwriter ------------------------------------------------------------------------------ */
 
 memwriter_t *memwriter_new(void);
+memwriter_t *memwriter_new_with_capacity(size_t capacity);
 void memwriter_delete(memwriter_t *memwriter);
+void memwriter_pool_clear(void);
 void memwriter_clear(memwriter_t *memwriter);
 err_t memwriter_replace(memwriter_t *memwriter, int index, int count, const char *replacement_str);
 err_t memwriter_erase(memwriter_t *memwriter, int index, int count);
@@ -55,6 +61,7 @@ err_t memwriter_puts_with_len(memwriter_t *memwriter, char *s, size_t length);
 err_t memwriter_memcpy(memwriter_t *memwriter, const void *source, size_t num);
 err_t memwriter_memcpy_rev_chunks(memwriter_t *memwriter, const void *source, size_t num, int chunk_size);
 err_t memwriter_putc(memwriter_t *memwriter, char c);
+err_t memwriter_put_double(memwriter_t *memwriter, double value, int flags);
 char *memwriter_buf(const memwriter_t *memwriter);
 size_t memwriter_size(const memwriter_t *memwriter);
 
@@ -5,6 +5,7 @@
 #endif
 
 #include <ctype.h>
+#include <errno.h>
 #include <limits.h>
 #include <string.h>
 #ifdef _WIN32
@@ -16,15 +17,19 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <time.h>
+#include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #endif
 
 #include "args_int.h"
+#include "bson_int.h"
 #include "dynamic_args_array_int.h"
 #include "json_int.h"
 #include "net_int.h"
+#include "util_int.h"
 #include "datatype/string_list_int.h"
 #include "datatype/template/list_int.h"
 
@@ -113,6 +118,123 @@ err_t dynamic_args_array_list_entry_delete(dynamic_args_array_list_entry_t entry
 
 /* ========================= methods ================================================================================ */
 
+/* ------------------------- ring buffer ---------------------------------------------------------------------------- */
+
+void ring_buffer_init(ring_buffer_t *ring_buffer)
+{
+  /* the buffer memory is allocated on first use */
+  ring_buffer->buf = NULL;
+  ring_buffer->capacity = 0;
+  ring_buffer->start = 0;
+  ring_buffer->size = 0;
+}
+
+void ring_buffer_finalize(ring_buffer_t *ring_buffer)
+{
+  free(ring_buffer->buf);
+  ring_buffer_init(ring_buffer);
+}
+
+const char *ring_buffer_data(const ring_buffer_t *ring_buffer, size_t *size)
+{
+  /* returns the first contiguous part of the buffered data */
+  if (size != NULL)
+    {
+      *size = (ring_buffer->size < ring_buffer->capacity - ring_buffer->start)
+                  ? ring_buffer->size
+                  : ring_buffer->capacity - ring_buffer->start;
+    }
+  return ring_buffer->buf + ring_buffer->start;
+}
+
+char *ring_buffer_space(ring_buffer_t *ring_buffer, size_t *size)
+{
+  /* returns the first contiguous part of the free space */
+  size_t end = ring_buffer->start + ring_buffer->size;
+
+  if (end < ring_buffer->capacity)
+    {
+      *size = ring_buffer->capacity - end;
+      return ring_buffer->buf + end;
+    }
+  end -= ring_buffer->capacity;
+  *size = ring_buffer->start - end;
+  return ring_buffer->buf + end;
+}
+
+void ring_buffer_consume(ring_buffer_t *ring_buffer, size_t size)
+{
+  ring_buffer->size -= size;
+  /* start at the beginning again if the buffer is empty, so the free space is contiguous */
+  ring_buffer->start = (ring_buffer->size > 0) ? (ring_buffer->start + size) % ring_buffer->capacity : 0;
+}
+
+void ring_buffer_commit(ring_buffer_t *ring_buffer, size_t size)
+{
+  ring_buffer->size += size;
+}
+
+
+/* ------------------------- receiver / sender ---------------------------------------------------------------------- */
+
+void message_length_to_bytes(size_t length, char *bytes)
+{
+  /* the length is split into two 32 bit halves since `size_t` can be smaller than the length field */
+  unsigned long low = (unsigned long)(length & 0xffffffffUL), high = (unsigned long)((length >> 16) >> 16);
+  int i;
+
+  for (i = 0; i < 4; ++i)
+    {
+      bytes[i] = (char)((low >> (8 * i)) & 0xff);
+      bytes[i + 4] = (char)((high >> (8 * i)) & 0xff);
+    }
+}
+
+err_t bytes_to_message_length(const char *bytes, size_t *length)
+{
+  unsigned long low = 0, high = 0;
+  int i;
+
+  for (i = 3; i >= 0; --i)
+    {
+      low = (low << 8) | (unsigned char)bytes[i];
+      high = (high << 8) | (unsigned char)bytes[i + 4];
+    }
+  if (high > 0 && sizeof(size_t) < MESSAGE_LENGTH_SIZE)
+    {
+      debug_print_error(("The received message is too large for this platform.\n"));
+      return ERROR_NETWORK_RECV;
+    }
+  *length = (((size_t)high << 16) << 16) | low;
+
+  return ERROR_NONE;
+}
+
+int socket_wait_for_data(net_handle_t *handle, int timeout_ms)
+{
+  /* returns 1 if received data is buffered or arrives on the socket within `timeout_ms` milliseconds */
+  fd_set read_fds;
+  struct timeval timeout;
+#ifdef _WIN32
+  SOCKET s = (SOCKET)handle->sender_receiver.receiver.comm.socket.client_socket;
+#else
+  int s = handle->sender_receiver.receiver.comm.socket.client_socket;
+#endif
+
+  if (handle->recv_buffer.size > 0)
+    {
+      return 1;
+    }
+  FD_ZERO(&read_fds);
+  FD_SET(s, &read_fds);
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_usec = (timeout_ms % 1000) * 1000;
+
+  /* the first argument is ignored on Windows */
+  return select((int)s + 1, &read_fds, NULL, NULL, &timeout) > 0;
+}
+
+
 /* ------------------------- receiver ------------------------------------------------------------------------------- */
 
 err_t receiver_init_for_custom(net_handle_t *handle, const char *name, unsigned int id,
@@ -122,6 +244,7 @@ err_t receiver_init_for_custom(net_handle_t *handle, const char *name, unsigned
   handle->sender_receiver.receiver.comm.custom.name = name;
   handle->sender_receiver.receiver.comm.custom.id = id;
   handle->sender_receiver.receiver.message_size = 0;
+  handle->sender_receiver.receiver.args = NULL;
   handle->sender_receiver.receiver.recv = receiver_recv_for_custom;
   handle->sender_receiver.receiver.send = NULL;
   handle->finalize = receiver_finalize_for_custom;
@@ -140,6 +263,8 @@ err_t receiver_init_for_socket(net_handle_t *handle, const char *hostname, unsig
   struct addrinfo *addr_info = NULL, addr_hints;
   struct sockaddr_in client_addr;
   socklen_t client_addrlen = sizeof(client_addr);
+  char capabilities[2];
+  net_iovec_t capabilities_buffer;
   int error;
 #ifdef SO_REUSEADDR
   int socket_opt;
@@ -155,6 +280,7 @@ err_t receiver_init_for_socket(net_handle_t *handle, const char *hostname, unsig
   handle->sender_receiver.receiver.comm.socket.server_socket = -1;
   handle->sender_receiver.receiver.comm.socket.client_socket = -1;
   handle->sender_receiver.receiver.message_size = 0;
+  handle->sender_receiver.receiver.args = NULL;
   handle->sender_receiver.receiver.recv = receiver_recv_for_socket;
   handle->sender_receiver.receiver.send = sender_send_for_socket;
   handle->finalize = receiver_finalize_for_socket;
@@ -244,6 +370,7 @@ err_t receiver_init_for_socket(net_handle_t *handle, const char *hostname, unsig
       psocketerror("accept failed");
       return ERROR_NETWORK_CONNECTION_ACCEPT;
     }
+  handle->use_shm = gks_shm_is_available(handle->sender_receiver.receiver.comm.socket.client_socket);
 
   handle->sender_receiver.receiver.memwriter = memwriter_new();
   if (handle->sender_receiver.receiver.memwriter == NULL)
@@ -251,7 +378,13 @@ err_t receiver_init_for_socket(net_handle_t *handle, const char *hostname, unsig
       return ERROR_MALLOC;
     }
 
-  return ERROR_NONE;
+  /* announce the supported message formats, the sender only uses them afterwards */
+  capabilities[0] = CAPABILITIES_MESSAGE_START;
+  capabilities[1] = (char)(CAPABILITY_FRAMING | CAPABILITY_BSON | (handle->use_shm ? CAPABILITY_SHM : 0));
+  capabilities_buffer.iov_base = capabilities;
+  capabilities_buffer.iov_len = sizeof(capabilities);
+
+  return sender_send_buffers_for_socket(handle, &capabilities_buffer, 1);
 }
 
 err_t receiver_finalize_for_custom(net_handle_t *handle)
@@ -265,6 +398,9 @@ err_t receiver_finalize_for_socket(net_handle_t *handle)
 {
   err_t error = ERROR_NONE;
 
+  ring_buffer_finalize(&handle->recv_buffer);
+  gks_shm_close(handle->send_shm);
+  gks_shm_close(handle->recv_shm);
   memwriter_delete(handle->sender_receiver.receiver.memwriter);
 #ifdef _WIN32
   if (handle->sender_receiver.receiver.comm.socket.client_socket >= 0)
@@ -312,44 +448,369 @@ err_t receiver_finalize_for_socket(net_handle_t *handle)
 
 err_t receiver_recv_for_socket(net_handle_t *handle)
 {
-  int search_start_index = 0;
-  char *end_ptr;
-  static char recv_buf[SOCKET_RECV_BUF_SIZE];
+  ring_buffer_t *recv_buffer = &handle->recv_buffer;
+  char message_start;
+  err_t error;
+
+  /* The first byte of a message selects its encoding. Replies use the same encoding as the last received message, so a
+   * sender which requests the binary protocol gets binary answers, too. */
+  if (recv_buffer->size == 0)
+    {
+      if ((error = receiver_recv_into_buffer_for_socket(handle, SOCKET_RECV_BUF_SIZE)) != ERROR_NONE)
+        {
+          return error;
+        }
+    }
+  message_start = *ring_buffer_data(recv_buffer, NULL);
+  if (message_start == CAPABILITIES_MESSAGE_START)
+    {
+      if ((error = receiver_recv_capabilities_for_socket(handle)) != ERROR_NONE)
+        {
+          return error;
+        }
+      return receiver_recv_for_socket(handle);
+    }
+  if (handle->is_receiver)
+    {
+      /* a peer which sends messages with a start byte understands framed messages, too */
+      handle->use_framing = (message_start == JSON_MESSAGE_START || message_start == BSON_MESSAGE_START ||
+                             message_start == SHM_MESSAGE_START);
+      if (message_start != SHM_MESSAGE_START)
+        {
+          handle->use_bson = (message_start == BSON_MESSAGE_START);
+        }
+    }
+  else if (handle->peer_capabilities < 0)
+    {
+      /* older receivers reply without announcing their capabilities first */
+      sender_set_peer_capabilities(handle, 0);
+    }
+  if (message_start == SHM_MESSAGE_START)
+    {
+      return receiver_recv_shm_for_socket(handle);
+    }
+  if (message_start == BSON_MESSAGE_START)
+    {
+      return receiver_recv_bson_for_socket(handle);
+    }
+
+  return receiver_recv_json_for_socket(handle);
+}
+
+err_t receiver_recv_json_for_socket(net_handle_t *handle)
+{
+  ring_buffer_t *recv_buffer = &handle->recv_buffer;
+  fromjson_stream_t *json_stream;
+  const char *data, *end_ptr = NULL;
+  size_t data_size, remaining_size = 0;
+  int has_length = 0;
   err_t error = ERROR_NONE;
 
-  while ((end_ptr = memchr(memwriter_buf(handle->sender_receiver.receiver.memwriter) + search_start_index, ETB,
-                           memwriter_size(handle->sender_receiver.receiver.memwriter) - search_start_index)) == NULL)
+  json_stream = fromjson_stream_new(handle->sender_receiver.receiver.args);
+  if (json_stream == NULL)
     {
-      int bytes_received;
-      search_start_index = memwriter_size(handle->sender_receiver.receiver.memwriter);
-      bytes_received =
-          recv(handle->sender_receiver.receiver.comm.socket.client_socket, recv_buf, SOCKET_RECV_BUF_SIZE, 0);
-      if (bytes_received < 0)
+      return ERROR_MALLOC;
+    }
+  if (*ring_buffer_data(recv_buffer, NULL) == JSON_MESSAGE_START)
+    {
+      char header[1 + MESSAGE_LENGTH_SIZE];
+      if ((error = receiver_read_for_socket(handle, header, sizeof(header))) == ERROR_NONE)
         {
-          psocketerror("error while receiving data");
-          return ERROR_NETWORK_RECV;
+          error = bytes_to_message_length(header + 1, &remaining_size);
         }
-      else if (bytes_received == 0)
+      has_length = 1;
+    }
+  /*
+   * Received data is passed to the json parser chunk by chunk, so a message is parsed while the rest of it is still in
+   * transit. If the message length is known, no data beyond the message is requested from the socket. Otherwise, the
+   * message ends at `ETB` and data following it stays in the receive buffer for the next call. Parse errors are stored
+   * in the json stream; the message is read up to its end anyway to keep the connection in a valid state.
+   */
+  while (error == ERROR_NONE && (has_length ? remaining_size > 0 : end_ptr == NULL))
+    {
+      if (recv_buffer->size == 0)
         {
-          return ERROR_NETWORK_RECV_CONNECTION_SHUTDOWN;
+          error = receiver_recv_into_buffer_for_socket(handle, has_length ? remaining_size : SOCKET_RECV_BUF_SIZE);
+          if (error != ERROR_NONE)
+            {
+              break;
+            }
         }
-      if ((error = memwriter_printf(handle->sender_receiver.receiver.memwriter, "%.*s", bytes_received, recv_buf)) !=
-          ERROR_NONE)
+      data = ring_buffer_data(recv_buffer, &data_size);
+      if (has_length)
         {
-          return error;
+          if (data_size > remaining_size)
+            {
+              data_size = remaining_size;
+            }
+          fromjson_stream_feed(json_stream, data, data_size);
+          ring_buffer_consume(recv_buffer, data_size);
+          remaining_size -= data_size;
+        }
+      else
+        {
+          end_ptr = memchr(data, ETB, data_size);
+          fromjson_stream_feed(json_stream, data, (end_ptr != NULL) ? (size_t)(end_ptr - data) : data_size);
+          ring_buffer_consume(recv_buffer, (end_ptr != NULL) ? (size_t)(end_ptr - data) + 1 : data_size);
+        }
+    }
+  if (error == ERROR_NONE && has_length)
+    {
+      char etb;
+      if ((error = receiver_read_for_socket(handle, &etb, 1)) == ERROR_NONE && etb != ETB)
+        {
+          error = ERROR_PARSE_INVALID_DELIMITER;
+        }
+    }
+  if (error == ERROR_NONE)
+    {
+      error = fromjson_stream_finish(json_stream);
+    }
+  fromjson_stream_delete(json_stream);
+
+  return error;
+}
+
+err_t receiver_recv_bson_for_socket(net_handle_t *handle)
+{
+  char header[1 + sizeof(int)];
+  char *document, *grown_document;
+  int document_size;
+  size_t capacity, received_size, chunk_size;
+  err_t error;
+
+  /* a binary message consists of the start byte and a BSON document which begins with its total size */
+  if ((error = receiver_read_for_socket(handle, header, sizeof(header))) != ERROR_NONE)
+    {
+      return error;
+    }
+  bytes_to_int(&document_size, header + 1);
+  if (document_size < 5)
+    {
+      return ERROR_PARSE_OBJECT;
+    }
+  /*
+   * The size is read from the wire, so the buffer is not allocated for the full size at once. It grows with the data
+   * which is actually received, so a corrupted size cannot cause a huge allocation by itself.
+   */
+  capacity = ((size_t)document_size < SOCKET_RECV_BUF_SIZE) ? (size_t)document_size : SOCKET_RECV_BUF_SIZE;
+  document = malloc(capacity);
+  if (document == NULL)
+    {
+      debug_print_malloc_error();
+      return ERROR_MALLOC;
+    }
+  memcpy(document, header + 1, sizeof(int));
+  received_size = sizeof(int);
+  while (error == ERROR_NONE && received_size < (size_t)document_size)
+    {
+      if (received_size == capacity)
+        {
+          capacity = (2 * capacity < (size_t)document_size) ? 2 * capacity : (size_t)document_size;
+          grown_document = realloc(document, capacity);
+          if (grown_document == NULL)
+            {
+              debug_print_malloc_error();
+              error = ERROR_MALLOC;
+              break;
+            }
+          document = grown_document;
+        }
+      chunk_size = capacity - received_size;
+      error = receiver_read_for_socket(handle, document + received_size, chunk_size);
+      received_size += chunk_size;
+    }
+  if (error == ERROR_NONE)
+    {
+      error = (document[document_size - 1] == '\0') ? frombson_read(handle->sender_receiver.receiver.args, document)
+                                                    : ERROR_PARSE_OBJECT;
+    }
+  free(document);
+
+  return error;
+}
+
+err_t receiver_recv_shm_for_socket(net_handle_t *handle)
+{
+  char header[2 + GKS_SHM_NAME_SIZE + 2 * MESSAGE_LENGTH_SIZE];
+  const char *name = header + 2;
+  size_t segment_size, message_size;
+  fromjson_stream_t *json_stream;
+  err_t error;
+
+  if ((error = receiver_read_for_socket(handle, header, sizeof(header))) != ERROR_NONE ||
+      (error = bytes_to_message_length(name + GKS_SHM_NAME_SIZE, &segment_size)) != ERROR_NONE ||
+      (error = bytes_to_message_length(name + GKS_SHM_NAME_SIZE + MESSAGE_LENGTH_SIZE, &message_size)) != ERROR_NONE)
+    {
+      return error;
+    }
+  if (header[1] == SHM_MESSAGE_START)
+    {
+      /*
+       * A new segment is announced. It is acknowledged by clearing its busy flag, so the sender only uses it after it
+       * was mapped here. If it cannot be mapped (e.g. the sender runs on another host), messages keep coming through
+       * the socket. The actual message follows the announcement.
+       */
+      gks_shm_close(handle->recv_shm);
+      handle->recv_shm = handle->use_shm ? gks_shm_open(name, segment_size) : NULL;
+      if (handle->recv_shm != NULL)
+        {
+          gks_shm_set_busy(handle->recv_shm, 0);
         }
+      return receiver_recv_for_socket(handle);
+    }
+  /* the sender reuses its segment as long as messages fit into it */
+  if (handle->recv_shm == NULL || strncmp(handle->recv_shm->name, name, GKS_SHM_NAME_SIZE) != 0 ||
+      message_size > handle->recv_shm->size)
+    {
+      debug_print_error(("A received message refers to an unknown shared memory segment.\n"));
+      return ERROR_NETWORK_RECV;
     }
-  *end_ptr = '\0';
-  handle->sender_receiver.receiver.message_size = end_ptr - memwriter_buf(handle->sender_receiver.receiver.memwriter);
+
+  /* the message is parsed in place and the segment is released for the next message afterwards */
+  if (handle->is_receiver)
+    {
+      handle->use_bson = (header[1] == BSON_MESSAGE_START);
+    }
+  if (header[1] == BSON_MESSAGE_START)
+    {
+      int document_size = 0;
+      if (message_size >= 5)
+        {
+          bytes_to_int(&document_size, handle->recv_shm->data);
+        }
+      error = (document_size >= 5 && (size_t)document_size == message_size &&
+               handle->recv_shm->data[message_size - 1] == '\0')
+                  ? frombson_read(handle->sender_receiver.receiver.args, handle->recv_shm->data)
+                  : ERROR_PARSE_OBJECT;
+    }
+  else
+    {
+      json_stream = fromjson_stream_new(handle->sender_receiver.receiver.args);
+      if (json_stream == NULL)
+        {
+          error = ERROR_MALLOC;
+        }
+      else
+        {
+          fromjson_stream_feed(json_stream, handle->recv_shm->data, message_size);
+          error = fromjson_stream_finish(json_stream);
+          fromjson_stream_delete(json_stream);
+        }
+    }
+  gks_shm_set_busy(handle->recv_shm, 0);
 
   return error;
 }
 
+err_t receiver_recv_capabilities_for_socket(net_handle_t *handle)
+{
+  char capabilities[2];
+  err_t error;
+
+  if ((error = receiver_read_for_socket(handle, capabilities, sizeof(capabilities))) != ERROR_NONE)
+    {
+      return error;
+    }
+  if (!handle->is_receiver)
+    {
+      sender_set_peer_capabilities(handle, (unsigned char)capabilities[1]);
+    }
+
+  return ERROR_NONE;
+}
+
+err_t receiver_recv_into_buffer_for_socket(net_handle_t *handle, size_t max_size)
+{
+  ring_buffer_t *recv_buffer = &handle->recv_buffer;
+  char *space;
+  size_t space_size;
+  int bytes_received;
+
+  if (recv_buffer->buf == NULL)
+    {
+      recv_buffer->buf = malloc(SOCKET_RECV_BUF_SIZE);
+      if (recv_buffer->buf == NULL)
+        {
+          debug_print_malloc_error();
+          return ERROR_MALLOC;
+        }
+      recv_buffer->capacity = SOCKET_RECV_BUF_SIZE;
+    }
+  space = ring_buffer_space(recv_buffer, &space_size);
+  if (space_size > max_size)
+    {
+      space_size = max_size;
+    }
+  bytes_received = recv(handle->sender_receiver.receiver.comm.socket.client_socket, space, (int)space_size, 0);
+  if (bytes_received < 0)
+    {
+      psocketerror("error while receiving data");
+      return ERROR_NETWORK_RECV;
+    }
+  else if (bytes_received == 0)
+    {
+      return ERROR_NETWORK_RECV_CONNECTION_SHUTDOWN;
+    }
+  ring_buffer_commit(recv_buffer, bytes_received);
+
+  return ERROR_NONE;
+}
+
+err_t receiver_read_for_socket(net_handle_t *handle, char *dest, size_t size)
+{
+  /* Copies the next `size` bytes of the connection to `dest`. Buffered data is used first, large remainders are
+   * received into `dest` directly. */
+  ring_buffer_t *recv_buffer = &handle->recv_buffer;
+  err_t error;
+
+  while (size > 0)
+    {
+      const char *data;
+      size_t data_size;
+      if (recv_buffer->size == 0)
+        {
+          if (size >= SOCKET_RECV_BUF_SIZE)
+            {
+              int bytes_received = recv(handle->sender_receiver.receiver.comm.socket.client_socket, dest,
+                                        (size < INT_MAX) ? (int)size : INT_MAX, 0);
+              if (bytes_received < 0)
+                {
+                  psocketerror("error while receiving data");
+                  return ERROR_NETWORK_RECV;
+                }
+              else if (bytes_received == 0)
+                {
+                  return ERROR_NETWORK_RECV_CONNECTION_SHUTDOWN;
+                }
+              dest += bytes_received;
+              size -= bytes_received;
+              continue;
+            }
+          if ((error = receiver_recv_into_buffer_for_socket(handle, SOCKET_RECV_BUF_SIZE)) != ERROR_NONE)
+            {
+              return error;
+            }
+        }
+      data = ring_buffer_data(recv_buffer, &data_size);
+      if (data_size > size)
+        {
+          data_size = size;
+        }
+      memcpy(dest, data, data_size);
+      ring_buffer_consume(recv_buffer, data_size);
+      dest += data_size;
+      size -= data_size;
+    }
+
+  return ERROR_NONE;
+}
+
 err_t receiver_recv_for_custom(net_handle_t *handle)
 {
-  /* TODO: is it really necessary to copy the memory? */
   const char *recv_buf;
-  err_t error = ERROR_NONE;
+  fromjson_stream_t *json_stream;
+  err_t error;
 
   recv_buf = handle->sender_receiver.receiver.comm.custom.recv(handle->sender_receiver.receiver.comm.custom.name,
                                                                handle->sender_receiver.receiver.comm.custom.id);
@@ -357,12 +818,15 @@ err_t receiver_recv_for_custom(net_handle_t *handle)
     {
       return ERROR_CUSTOM_RECV;
     }
-  memwriter_clear(handle->sender_receiver.receiver.memwriter);
-  if ((error = memwriter_puts(handle->sender_receiver.receiver.memwriter, recv_buf)) != ERROR_NONE)
+  /* the received string is parsed in place, no copy is needed */
+  json_stream = fromjson_stream_new(handle->sender_receiver.receiver.args);
+  if (json_stream == NULL)
     {
-      return error;
+      return ERROR_MALLOC;
     }
-  handle->sender_receiver.receiver.message_size = memwriter_size(handle->sender_receiver.receiver.memwriter);
+  fromjson_stream_feed(json_stream, recv_buf, strlen(recv_buf));
+  error = fromjson_stream_finish(json_stream);
+  fromjson_stream_delete(json_stream);
 
   return error;
 }
@@ -535,6 +999,7 @@ err_t sender_init_for_socket(net_handle_t *handle, const char *hostname, unsigne
       psocketerror("");
       return ERROR_NETWORK_CONNECT;
     }
+  handle->use_shm = gks_shm_is_available(handle->sender_receiver.sender.comm.socket.client_socket);
 
   handle->sender_receiver.sender.memwriter = memwriter_new();
   if (handle->sender_receiver.sender.memwriter == NULL)
@@ -556,6 +1021,9 @@ err_t sender_finalize_for_socket(net_handle_t *handle)
 {
   err_t error = ERROR_NONE;
 
+  ring_buffer_finalize(&handle->recv_buffer);
+  gks_shm_close(handle->send_shm);
+  gks_shm_close(handle->recv_shm);
   memwriter_delete(handle->sender_receiver.sender.memwriter);
 #ifdef _WIN32
   if (handle->sender_receiver.sender.comm.socket.client_socket >= 0)
@@ -587,34 +1055,195 @@ err_t sender_finalize_for_socket(net_handle_t *handle)
 
 err_t sender_send_for_socket(net_handle_t *handle)
 {
-  const char *buf;
-  size_t buf_size;
-  int bytes_left;
+  char header[1 + MESSAGE_LENGTH_SIZE];
+  net_iovec_t buffers[2];
+  int was_sent;
   err_t error = ERROR_NONE;
 
+  if (handle->use_bson)
+    {
+      return sender_send_bson_for_socket(handle);
+    }
+  buffers[0].iov_base = memwriter_buf(handle->sender_receiver.sender.memwriter);
+  buffers[0].iov_len = memwriter_size(handle->sender_receiver.sender.memwriter);
+  error = sender_send_shm_for_socket(handle, buffers, 1, JSON_MESSAGE_START, &was_sent);
+  if (error != ERROR_NONE || was_sent)
+    {
+      memwriter_clear(handle->sender_receiver.sender.memwriter);
+      return error;
+    }
   if ((error = memwriter_putc(handle->sender_receiver.sender.memwriter, ETB)) != ERROR_NONE)
     {
       return error;
     }
 
-  buf = memwriter_buf(handle->sender_receiver.sender.memwriter);
-  buf_size = memwriter_size(handle->sender_receiver.sender.memwriter);
+  if (handle->use_framing)
+    {
+      header[0] = JSON_MESSAGE_START;
+      message_length_to_bytes(memwriter_size(handle->sender_receiver.sender.memwriter) - 1, header + 1);
+      buffers[0].iov_base = header;
+      buffers[0].iov_len = sizeof(header);
+      buffers[1].iov_base = memwriter_buf(handle->sender_receiver.sender.memwriter);
+      buffers[1].iov_len = memwriter_size(handle->sender_receiver.sender.memwriter);
+      error = sender_send_buffers_for_socket(handle, buffers, 2);
+    }
+  else
+    {
+      buffers[0].iov_base = memwriter_buf(handle->sender_receiver.sender.memwriter);
+      buffers[0].iov_len = memwriter_size(handle->sender_receiver.sender.memwriter);
+      error = sender_send_buffers_for_socket(handle, buffers, 1);
+    }
+
+  memwriter_clear(handle->sender_receiver.sender.memwriter);
 
-  bytes_left = buf_size;
-  while (bytes_left)
+  return error;
+}
+
+err_t sender_send_bson_for_socket(net_handle_t *handle)
+{
+  static char message_start = BSON_MESSAGE_START;
+  memwriter_t *memwriter = handle->sender_receiver.sender.memwriter;
+  const tobson_array_ref_t *array_refs;
+  size_t array_ref_count, buffer_count = 0, offset = 0, i;
+  net_iovec_t *buffers;
+  int was_sent;
+  err_t error;
+
+  /* the memwriter contents are sent interleaved with the referenced arrays, which are never copied */
+  array_refs = tobson_array_refs(&array_ref_count);
+  buffers = malloc((2 * array_ref_count + 2) * sizeof(net_iovec_t));
+  if (buffers == NULL)
+    {
+      debug_print_malloc_error();
+      tobson_clear_array_refs();
+      memwriter_clear(memwriter);
+      return ERROR_MALLOC;
+    }
+  buffers[buffer_count].iov_base = &message_start;
+  buffers[buffer_count++].iov_len = 1;
+  for (i = 0; i < array_ref_count; ++i)
+    {
+      buffers[buffer_count].iov_base = memwriter_buf(memwriter) + offset;
+      buffers[buffer_count++].iov_len = array_refs[i].offset - offset;
+      buffers[buffer_count].iov_base = (void *)array_refs[i].data;
+      buffers[buffer_count++].iov_len = array_refs[i].size;
+      offset = array_refs[i].offset;
+    }
+  buffers[buffer_count].iov_base = memwriter_buf(memwriter) + offset;
+  buffers[buffer_count++].iov_len = memwriter_size(memwriter) - offset;
+  error = sender_send_shm_for_socket(handle, buffers + 1, buffer_count - 1, BSON_MESSAGE_START, &was_sent);
+  if (error == ERROR_NONE && !was_sent)
+    {
+      error = sender_send_buffers_for_socket(handle, buffers, buffer_count);
+    }
+
+  free(buffers);
+  tobson_clear_array_refs();
+  memwriter_clear(memwriter);
+
+  return error;
+}
+
+err_t sender_send_buffers_for_socket(net_handle_t *handle, net_iovec_t *buffers, size_t buffer_count)
+{
+  /* sends all buffers completely, `buffers` is modified */
+  while (buffer_count > 0)
     {
-      int bytes_sent = send(handle->sender_receiver.sender.comm.socket.client_socket, buf, bytes_left, 0);
+#ifdef _WIN32
+      int bytes_sent = send(handle->sender_receiver.sender.comm.socket.client_socket, buffers->iov_base,
+                            (buffers->iov_len < INT_MAX) ? (int)buffers->iov_len : INT_MAX, 0);
+#else
+      ssize_t bytes_sent = writev(handle->sender_receiver.sender.comm.socket.client_socket, buffers,
+                                  (buffer_count < IOV_MAX) ? (int)buffer_count : IOV_MAX);
+      if (bytes_sent < 0 && errno == EINTR)
+        {
+          continue;
+        }
+#endif
       if (bytes_sent < 0)
         {
           psocketerror("could not send any data");
           return ERROR_NETWORK_SEND;
         }
-      bytes_left -= bytes_sent;
+      while (buffer_count > 0 && (size_t)bytes_sent >= buffers->iov_len)
+        {
+          bytes_sent -= buffers->iov_len;
+          ++buffers;
+          --buffer_count;
+        }
+      if (bytes_sent > 0)
+        {
+          buffers->iov_base = (char *)buffers->iov_base + bytes_sent;
+          buffers->iov_len -= bytes_sent;
+        }
     }
 
-  memwriter_clear(handle->sender_receiver.sender.memwriter);
+  return ERROR_NONE;
+}
 
-  return error;
+err_t sender_send_shm_for_socket(net_handle_t *handle, const net_iovec_t *buffers, size_t buffer_count,
+                                 char message_start, int *was_sent)
+{
+  /* The buffers are copied into the shared memory segment and only a description of it is sent through the socket.
+   * If the receiver has not acknowledged the segment or not parsed the previous message from it yet, `was_sent` is set
+   * to zero and the message must be sent through the socket instead. */
+  char header[2 + GKS_SHM_NAME_SIZE + 2 * MESSAGE_LENGTH_SIZE];
+  net_iovec_t header_buffer;
+  size_t message_size = 0, segment_size = GKS_SHM_MIN_SIZE, offset = 0, i;
+
+  *was_sent = 0;
+  for (i = 0; i < buffer_count; ++i)
+    {
+      message_size += buffers[i].iov_len;
+    }
+  /* older peers do not understand segment announcements */
+  if (!handle->use_shm || !handle->use_framing || message_size < GKS_SHM_MIN_SIZE)
+    {
+      return ERROR_NONE;
+    }
+  if (handle->send_shm == NULL || handle->send_shm->size < message_size)
+    {
+      gks_shm_close(handle->send_shm);
+      while (segment_size < message_size)
+        {
+          segment_size *= 2;
+        }
+      if ((handle->send_shm = gks_shm_create(segment_size)) == NULL)
+        {
+          return ERROR_NONE;
+        }
+      /* the segment is busy until the receiver has mapped it, this message still goes through the socket */
+      gks_shm_set_busy(handle->send_shm, 1);
+      header[0] = SHM_MESSAGE_START;
+      header[1] = SHM_MESSAGE_START;
+      memcpy(header + 2, handle->send_shm->name, GKS_SHM_NAME_SIZE);
+      message_length_to_bytes(handle->send_shm->size, header + 2 + GKS_SHM_NAME_SIZE);
+      message_length_to_bytes(0, header + 2 + GKS_SHM_NAME_SIZE + MESSAGE_LENGTH_SIZE);
+      header_buffer.iov_base = header;
+      header_buffer.iov_len = sizeof(header);
+      return sender_send_buffers_for_socket(handle, &header_buffer, 1);
+    }
+  if (gks_shm_is_busy(handle->send_shm))
+    {
+      return ERROR_NONE;
+    }
+  for (i = 0; i < buffer_count; ++i)
+    {
+      memcpy(handle->send_shm->data + offset, buffers[i].iov_base, buffers[i].iov_len);
+      offset += buffers[i].iov_len;
+    }
+  gks_shm_set_busy(handle->send_shm, 1);
+
+  header[0] = SHM_MESSAGE_START;
+  header[1] = message_start;
+  memcpy(header + 2, handle->send_shm->name, GKS_SHM_NAME_SIZE);
+  message_length_to_bytes(handle->send_shm->size, header + 2 + GKS_SHM_NAME_SIZE);
+  message_length_to_bytes(message_size, header + 2 + GKS_SHM_NAME_SIZE + MESSAGE_LENGTH_SIZE);
+  header_buffer.iov_base = header;
+  header_buffer.iov_len = sizeof(header);
+  *was_sent = 1;
+
+  return sender_send_buffers_for_socket(handle, &header_buffer, 1);
 }
 
 err_t sender_send_for_custom(net_handle_t *handle)
@@ -634,6 +1263,78 @@ err_t sender_send_for_custom(net_handle_t *handle)
   return error;
 }
 
+void sender_set_peer_capabilities(net_handle_t *handle, int capabilities)
+{
+  handle->peer_capabilities = capabilities;
+  handle->use_framing = (capabilities & CAPABILITY_FRAMING) != 0;
+  handle->use_bson = handle->request_bson && (capabilities & CAPABILITY_BSON) != 0;
+  handle->use_shm = handle->use_shm && (capabilities & CAPABILITY_SHM) != 0;
+}
+
+void sender_check_capabilities_for_socket(net_handle_t *handle)
+{
+  /* Receivers announce their capabilities right after accepting the connection. The sender waits for them before its
+   * first message, but not forever since older receivers never send them. Until they arrive, messages are sent in the
+   * format which all receivers understand. */
+  int timeout_ms = handle->waited_for_capabilities ? 0 : CAPABILITIES_TIMEOUT_MS;
+
+  handle->waited_for_capabilities = 1;
+  if (!socket_wait_for_data(handle, timeout_ms))
+    {
+      return;
+    }
+  if (handle->recv_buffer.size == 0 &&
+      receiver_recv_into_buffer_for_socket(handle, SOCKET_RECV_BUF_SIZE) != ERROR_NONE)
+    {
+      sender_set_peer_capabilities(handle, 0);
+      return;
+    }
+  if (*ring_buffer_data(&handle->recv_buffer, NULL) != CAPABILITIES_MESSAGE_START ||
+      receiver_recv_capabilities_for_socket(handle) != ERROR_NONE)
+    {
+      sender_set_peer_capabilities(handle, 0);
+    }
+}
+
+void sender_begin_write(net_handle_t *handle)
+{
+  /* the message format may only change between messages */
+  if (!handle->is_receiver && handle->peer_capabilities < 0 &&
+      handle->sender_receiver.sender.send == sender_send_for_socket &&
+      memwriter_size(handle->sender_receiver.sender.memwriter) == 0)
+    {
+      sender_check_capabilities_for_socket(handle);
+    }
+  if (handle->use_bson)
+    {
+      tobson_set_array_ref_min_size(BSON_ARRAY_REF_MIN_SIZE);
+    }
+}
+
+err_t sender_end_write(net_handle_t *handle, err_t error)
+{
+  /* Sends the message if it is complete. Otherwise, the rest of the message follows in later calls, so referenced
+   * arrays must be copied now since they are only guaranteed to be valid during the current call. */
+  err_t resolve_error;
+
+  if (!handle->use_bson)
+    {
+      if (error == ERROR_NONE && tojson_is_complete() && handle->sender_receiver.sender.send != NULL)
+        {
+          error = handle->sender_receiver.sender.send(handle);
+        }
+      return error;
+    }
+  tobson_set_array_ref_min_size(0);
+  if (error == ERROR_NONE && tobson_is_complete() && handle->sender_receiver.sender.send != NULL)
+    {
+      return handle->sender_receiver.sender.send(handle);
+    }
+  resolve_error = tobson_resolve_array_refs(handle->sender_receiver.sender.memwriter);
+
+  return (error != ERROR_NONE) ? error : resolve_error;
+}
+
 
 /* ######################### public implementation ################################################################## */
 
@@ -654,6 +1355,15 @@ void *grm_open(int is_receiver, const char *name, unsigned int id,
       return NULL;
     }
   handle->is_receiver = is_receiver;
+  handle->use_bson = 0;
+  handle->use_framing = 0;
+  handle->peer_capabilities = -1;
+  handle->waited_for_capabilities = 0;
+  handle->request_bson = 0;
+  ring_buffer_init(&handle->recv_buffer);
+  handle->use_shm = 0;
+  handle->send_shm = NULL;
+  handle->recv_shm = NULL;
   handle->sender_receiver.receiver.comm.custom.recv = custom_recv;
   if (is_receiver)
     {
@@ -675,6 +1385,8 @@ void *grm_open(int is_receiver, const char *name, unsigned int id,
       else
         {
           error = sender_init_for_socket(handle, name, id);
+          /* BSON is only sent if the receiver announces that it supports it, otherwise JSON is used */
+          handle->request_bson = is_env_variable_enabled(BINARY_PROTOCOL_ENV_KEY);
         }
     }
 
@@ -706,6 +1418,7 @@ grm_args_t *grm_recv(const void *p, grm_args_t *args)
 {
   net_handle_t *handle = (net_handle_t *)p;
   int created_args = 0;
+  err_t error;
 
   if (handle->sender_receiver.receiver.recv == NULL)
     {
@@ -723,17 +1436,10 @@ grm_args_t *grm_recv(const void *p, grm_args_t *args)
       created_args = 1;
     }
 
-  if (handle->sender_receiver.receiver.recv(handle) != ERROR_NONE)
-    {
-      goto error_cleanup;
-    }
-  if (fromjson_read(args, memwriter_buf(handle->sender_receiver.receiver.memwriter)) != ERROR_NONE)
-    {
-      goto error_cleanup;
-    }
-
-  if (memwriter_erase(handle->sender_receiver.receiver.memwriter, 0,
-                      handle->sender_receiver.receiver.message_size + 1) != ERROR_NONE)
+  handle->sender_receiver.receiver.args = args;
+  error = handle->sender_receiver.receiver.recv(handle);
+  handle->sender_receiver.receiver.args = NULL;
+  if (error != ERROR_NONE)
     {
       goto error_cleanup;
     }
@@ -750,6 +1456,20 @@ error_cleanup:
 }
 
 
+/* Returns 1 if data of another message has already arrived, so `grm_recv` would not need to wait for the sender. */
+int grm_recv_pending(const void *p)
+{
+  net_handle_t *handle = (net_handle_t *)p;
+
+  if (handle->sender_receiver.receiver.recv != receiver_recv_for_socket)
+    {
+      return 0;
+    }
+
+  return socket_wait_for_data(handle, 0);
+}
+
+
 /* ------------------------- sender --------------------------------------------------------------------------------- */
 
 int grm_send(const void *p, const char *data_desc, ...)
@@ -761,11 +1481,10 @@ int grm_send(const void *p, const char *data_desc, ...)
   va_start(vl, data_desc);
   if (handle->sender_receiver.sender.send != NULL)
     {
-      error = tojson_write_vl(handle->sender_receiver.sender.memwriter, data_desc, &vl);
-      if (error == ERROR_NONE && tojson_is_complete() && handle->sender_receiver.sender.send != NULL)
-        {
-          error = handle->sender_receiver.sender.send(handle);
-        }
+      sender_begin_write(handle);
+      error = handle->use_bson ? tobson_write_vl(handle->sender_receiver.sender.memwriter, data_desc, &vl)
+                               : tojson_write_vl(handle->sender_receiver.sender.memwriter, data_desc, &vl);
+      error = sender_end_write(handle, error);
     }
   else
     {
@@ -782,11 +1501,11 @@ int grm_send_buf(const void *p, const char *data_desc, const void *buffer, int a
   net_handle_t *handle = (net_handle_t *)p;
   err_t error;
 
-  error = tojson_write_buf(handle->sender_receiver.sender.memwriter, data_desc, buffer, apply_padding);
-  if (error == ERROR_NONE && tojson_is_complete() && handle->sender_receiver.sender.send != NULL)
-    {
-      error = handle->sender_receiver.sender.send(handle);
-    }
+  sender_begin_write(handle);
+  error = handle->use_bson
+              ? tobson_write_buf(handle->sender_receiver.sender.memwriter, data_desc, buffer, apply_padding)
+              : tojson_write_buf(handle->sender_receiver.sender.memwriter, data_desc, buffer, apply_padding);
+  error = sender_end_write(handle, error);
 
   return error == ERROR_NONE;
 }
@@ -803,7 +1522,7 @@ int grm_send_ref(const void *p, const char *key, char format, const void *ref, i
   char format_string[SEND_REF_FORMAT_MAX_LENGTH];
   err_t error = ERROR_NONE;
 
-  if (tojson_struct_nested_level() == 0)
+  if ((handle->use_bson ? tobson_struct_nested_level() : tojson_struct_nested_level()) == 0)
     {
       grm_send(handle, "o(");
     }
@@ -1054,11 +1773,19 @@ int grm_send_args(const void *p, const grm_args_t *args)
   net_handle_t *handle = (net_handle_t *)p;
   err_t error;
 
-  error = tojson_write_args(handle->sender_receiver.sender.memwriter, args);
-  if (error == ERROR_NONE && tojson_is_complete() && handle->sender_receiver.sender.send != NULL)
+  sender_begin_write(handle);
+  if (!handle->use_bson)
     {
-      error = handle->sender_receiver.sender.send(handle);
+      /* large BSON arrays are sent by reference and are not copied into the buffer, so reserve only for JSON */
+      error = memwriter_ensure_buf(handle->sender_receiver.sender.memwriter, args_estimate_serialized_size(args, 1));
+      if (error != ERROR_NONE)
+        {
+          return 0;
+        }
     }
+  error = handle->use_bson ? tobson_write_args(handle->sender_receiver.sender.memwriter, args)
+                           : tojson_write_args(handle->sender_receiver.sender.memwriter, args);
+  error = sender_end_write(handle, error);
 
   return error == ERROR_NONE;
 }
@@ -7,7 +7,9 @@ extern "C" {
 
 /* ######################### includes ############################################################################### */
 
+#include "gkscore.h"
 #include "grm/error.h"
+#include "json_int.h"
 #include "memwriter_int.h"
 #include <grm/net.h>
 
@@ -18,7 +20,39 @@ extern "C" {
 
 /* ------------------------- receiver / sender----------------------------------------------------------------------- */
 
-#define SOCKET_RECV_BUF_SIZE (MEMWRITER_INITIAL_SIZE - 1)
+#define SOCKET_RECV_BUF_SIZE 65536
+
+/*
+ * Socket messages start with one of these bytes:
+ * - `JSON_MESSAGE_START`: the length of the JSON text (`MESSAGE_LENGTH_SIZE` bytes, little endian), the JSON text and
+ *   `ETB`. The length allows to receive exactly one message; `ETB` is kept for peers which only scan for it.
+ * - `BSON_MESSAGE_START`: a BSON document (which starts with its total size).
+ * - `SHM_MESSAGE_START`: the start byte of the actual encoding (`JSON_MESSAGE_START` or `BSON_MESSAGE_START`), the
+ *   name of a shared memory segment (`GKS_SHM_NAME_SIZE` bytes), the segment size and the message size (both
+ *   `MESSAGE_LENGTH_SIZE` bytes). The segment contains the JSON text (without `ETB`) or the BSON document. Large
+ *   messages are sent this way if both sides run on the same host.
+ *   A new segment is announced first by the same header with `SHM_MESSAGE_START` as encoding (and a message size of
+ *   zero). The receiver acknowledges it by clearing the busy flag of the segment, which the sender sets on creation.
+ *   Until then, and forever if the receiver cannot map the segment, messages are sent through the socket.
+ * - `CAPABILITIES_MESSAGE_START`: one byte of `CAPABILITY_*` flags. A receiver sends it once after accepting a
+ *   connection, it is never passed to the application.
+ * Messages starting with any other byte are JSON text terminated by `ETB` (sent by older versions). Older peers only
+ * understand this format, so a sender uses the other formats only after the receiver has announced its capabilities.
+ * Framing and shared memory are used whenever the receiver supports them, BSON additionally needs to be requested with
+ * `BINARY_PROTOCOL_ENV_KEY`. A receiver answers with the format of the last message it received.
+ */
+#define JSON_MESSAGE_START '\001'
+#define BSON_MESSAGE_START '\002'
+#define SHM_MESSAGE_START '\003'
+#define CAPABILITIES_MESSAGE_START '\004'
+#define MESSAGE_LENGTH_SIZE 8
+#define BINARY_PROTOCOL_ENV_KEY "GRM_BINARY_PROTOCOL"
+
+#define CAPABILITY_FRAMING 1
+#define CAPABILITY_BSON 2
+#define CAPABILITY_SHM 4
+/* a sender waits this long for the capabilities of the receiver before its first message is sent without them */
+#define CAPABILITIES_TIMEOUT_MS 100
 
 
 /* ------------------------- sender --------------------------------------------------------------------------------- */
@@ -26,6 +60,12 @@ extern "C" {
 #define SEND_REF_FORMAT_MAX_LENGTH 100
 #define PORT_MAX_STRING_LENGTH 80
 
+/* BSON arrays of at least this size are sent directly from the caller's buffer */
+#define BSON_ARRAY_REF_MIN_SIZE 16384
+#ifndef IOV_MAX
+#define IOV_MAX 16
+#endif
+
 
 /* ========================= datatypes ============================================================================== */
 
@@ -40,9 +80,44 @@ typedef const char *(*custom_recv_callback_t)(const char *, unsigned int);
 typedef int (*custom_send_callback_t)(const char *, unsigned int, const char *);
 typedef err_t (*finalize_callback_t)(net_handle_t *);
 
+/*!
+ * Received data which is not consumed yet. Data is never moved inside the buffer, so messages which arrive together
+ * are parsed from the buffer one after another without copying the remaining data.
+ */
+typedef struct
+{
+  char *buf;
+  size_t capacity;
+  size_t start;
+  size_t size;
+} ring_buffer_t;
+
+#ifdef _WIN32
+typedef struct
+{
+  void *iov_base;
+  size_t iov_len;
+} net_iovec_t;
+#else
+typedef struct iovec net_iovec_t;
+#endif
+
 struct _net_handle_t
 {
   int is_receiver;
+  /* messages are sent as BSON (requested by the sender, receivers answer in the encoding of the last message) */
+  int use_bson;
+  /* JSON messages are framed with their length (only after the peer has shown that it supports framing) */
+  int use_framing;
+  /* senders only: the capabilities announced by the receiver (`-1` until they are known) */
+  int peer_capabilities;
+  int waited_for_capabilities;
+  int request_bson;
+  ring_buffer_t recv_buffer;
+  /* large messages are passed in shared memory segments (only for socket connections to the same host) */
+  int use_shm;
+  gks_shm_t *send_shm;
+  gks_shm_t *recv_shm;
   union
   {
     struct
@@ -74,6 +149,8 @@ struct _net_handle_t
           int server_socket;
         } socket;
       } comm;
+      /* target of the received message, only valid during `grm_recv` */
+      grm_args_t *args;
     } receiver;
     struct
     {
@@ -102,6 +179,23 @@ struct _net_handle_t
 
 /* ========================= methods ================================================================================ */
 
+/* ------------------------- ring buffer ---------------------------------------------------------------------------- */
+
+static void ring_buffer_init(ring_buffer_t *ring_buffer);
+static void ring_buffer_finalize(ring_buffer_t *ring_buffer);
+static const char *ring_buffer_data(const ring_buffer_t *ring_buffer, size_t *size);
+static char *ring_buffer_space(ring_buffer_t *ring_buffer, size_t *size);
+static void ring_buffer_consume(ring_buffer_t *ring_buffer, size_t size);
+static void ring_buffer_commit(ring_buffer_t *ring_buffer, size_t size);
+
+
+/* ------------------------- receiver / sender ---------------------------------------------------------------------- */
+
+static void message_length_to_bytes(size_t length, char *bytes);
+static err_t bytes_to_message_length(const char *bytes, size_t *length);
+static int socket_wait_for_data(net_handle_t *handle, int timeout_ms);
+
+
 /* ------------------------- receiver ------------------------------------------------------------------------------- */
 
 static err_t receiver_init_for_socket(net_handle_t *handle, const char *hostname, unsigned int port);
@@ -110,6 +204,12 @@ static err_t receiver_init_for_custom(net_handle_t *handle, const char *name, un
 static err_t receiver_finalize_for_socket(net_handle_t *handle);
 static err_t receiver_finalize_for_custom(net_handle_t *handle);
 static err_t receiver_recv_for_socket(net_handle_t *handle);
+static err_t receiver_recv_json_for_socket(net_handle_t *handle);
+static err_t receiver_recv_bson_for_socket(net_handle_t *handle);
+static err_t receiver_recv_shm_for_socket(net_handle_t *handle);
+static err_t receiver_recv_capabilities_for_socket(net_handle_t *handle);
+static err_t receiver_recv_into_buffer_for_socket(net_handle_t *handle, size_t max_size);
+static err_t receiver_read_for_socket(net_handle_t *handle, char *dest, size_t size);
 static err_t receiver_recv_for_custom(net_handle_t *handle);
 
 
@@ -121,7 +221,15 @@ static err_t sender_init_for_custom(net_handle_t *handle, const char *name, unsi
 static err_t sender_finalize_for_socket(net_handle_t *handle);
 static err_t sender_finalize_for_custom(net_handle_t *handle);
 static err_t sender_send_for_socket(net_handle_t *handle);
+static err_t sender_send_bson_for_socket(net_handle_t *handle);
+static err_t sender_send_buffers_for_socket(net_handle_t *handle, net_iovec_t *buffers, size_t buffer_count);
+static err_t sender_send_shm_for_socket(net_handle_t *handle, const net_iovec_t *buffers, size_t buffer_count,
+                                        char message_start, int *was_sent);
 static err_t sender_send_for_custom(net_handle_t *handle);
+static void sender_set_peer_capabilities(net_handle_t *handle, int capabilities);
+static void sender_check_capabilities_for_socket(net_handle_t *handle);
+static void sender_begin_write(net_handle_t *handle);
+static err_t sender_end_write(net_handle_t *handle, err_t error);
 
 
 #ifdef __cplusplus
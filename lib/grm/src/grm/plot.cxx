@@ -9,12 +9,15 @@
 #include <array>
 #include <fstream>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 #ifdef __unix__
@@ -24,6 +27,7 @@
 extern "C" {
 #include <grm/layout.h>
 #include <ctype.h>
+#include <errno.h>
 #include <float.h>
 #include <limits.h>
 #include <math.h>
@@ -60,6 +64,7 @@ extern "C" {
 #endif
 
 #include "plot_int.h"
+#include "snapshot_int.hxx"
 #include "grm/layout.hxx"
 #include "utilcpp_int.hxx"
 
@@ -190,6 +195,8 @@ static std::shared_ptr<GRM::Element> global_root;
 static std::shared_ptr<GRM::Element> edit_figure;
 static std::shared_ptr<GRM::Element> current_dom_element;
 static std::shared_ptr<GRM::Element> current_central_region_element;
+/* series elements of line and scatter plots by their argument container, so `grm_append` can update them in place */
+static std::map<const grm_args_t *, std::weak_ptr<GRM::Element>> series_args_to_element;
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~ event handling ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
@@ -1030,6 +1037,13 @@ error_cleanup:
   return error;
 }
 
+int plot_check_for_append(const grm_args_t *args)
+{
+  int append;
+
+  return grm_args_values(args, "append", "i", &append) && append;
+}
+
 int plot_check_for_request(const grm_args_t *args, err_t *error)
 {
   const char *request;
@@ -1548,6 +1562,7 @@ err_t plot_line(grm_args_t *subplot_args)
       double x_min, x_max, y_min, y_max;
       auto subGroup = global_render->createSeries("line");
       group->append(subGroup);
+      series_args_to_element[*current_series] = subGroup;
 
       int id = static_cast<int>(global_root->getAttribute("_id"));
       std::string str = std::to_string(id);
@@ -1720,6 +1735,7 @@ err_t plot_scatter(grm_args_t *subplot_args)
     {
       auto subGroup = global_render->createSeries("scatter");
       group->append(subGroup);
+      series_args_to_element[*current_series] = subGroup;
       if (grm_args_values(subplot_args, "orientation", "s", &orientation))
         subGroup->setAttribute("orientation", orientation);
 
@@ -4403,7 +4419,8 @@ err_t plot_draw_error_bars(grm_args_t *series_args, unsigned int x_length)
 
   double *absolute_upwards = nullptr, *absolute_downwards = nullptr, *relative_upwards = nullptr,
          *relative_downwards = nullptr;
-  double absolute_upwards_flt, relative_upwards_flt, absolute_downwards_flt, relative_downwards_flt;
+  double absolute_upwards_flt = FLT_MAX, relative_upwards_flt = FLT_MAX, absolute_downwards_flt = FLT_MAX,
+         relative_downwards_flt = FLT_MAX;
   unsigned int upwards_length, downwards_length, i;
   int color_upwards_cap, color_downwards_cap, color_error_bar;
 
@@ -5049,9 +5066,208 @@ void load_context_str(GRM::Context &context, const std::string &context_str, dum
 }
 
 
+namespace internal
+{
+/*!
+ * \brief Context entries which are decoded from a BSON document when they are accessed for the first time.
+ *
+ * The BSON document is only scanned for its top-level keys. When an entry is requested, its element is copied into a
+ * new BSON document and decoded with `frombson_read`, so entries which are never rendered are never decoded.
+ */
+class DeferredBsonContextEntries : public GRM::Context::DeferredEntries
+{
+public:
+  /*!
+   * \param[in] bson_data A BSON document, allocated with `malloc`. The object takes ownership of the data.
+   * \param[in] bson_size The size of the allocated BSON data.
+   * \throw std::runtime_error if the top-level structure of the document is invalid.
+   */
+  DeferredBsonContextEntries(char *bson_data, size_t bson_size) : bson_data_(bson_data, std::free)
+  {
+    int document_size;
+    if (bson_size < 5 || (bytes_to_int(&document_size, bson_data), document_size < 5) ||
+        static_cast<size_t>(document_size) > bson_size)
+      {
+        throw std::runtime_error("Invalid BSON context document");
+      }
+    size_t position = sizeof(int);
+    while (position < static_cast<size_t>(document_size) - 1)
+      {
+        size_t element_start = position;
+        char type = bson_data[position++];
+        const char *key = bson_data + position;
+        size_t key_length = strnlen(key, document_size - position);
+        if (position + key_length >= static_cast<size_t>(document_size))
+          {
+            throw std::runtime_error("Invalid BSON context document");
+          }
+        position += key_length + 1;
+        size_t value_size;
+        switch (type)
+          {
+          case 0x01:
+            value_size = sizeof(double);
+            break;
+          case 0x08:
+            value_size = 1;
+            break;
+          case 0x10:
+            value_size = sizeof(int);
+            break;
+          case 0x02:
+          case 0x03:
+          case 0x04:
+          case 0x05:
+            {
+              int length;
+              if (position + sizeof(int) > static_cast<size_t>(document_size))
+                {
+                  throw std::runtime_error("Invalid BSON context document");
+                }
+              bytes_to_int(&length, bson_data + position);
+              /* strings store the size of their data, all other types store the size including the length field */
+              if (length < ((type == 0x02) ? 1 : static_cast<int>(sizeof(int))))
+                {
+                  throw std::runtime_error("Invalid BSON context document");
+                }
+              value_size = (type == 0x02) ? sizeof(int) + length : length;
+              break;
+            }
+          default:
+            throw std::runtime_error("Unsupported datatype in BSON context document");
+          }
+        if (value_size >= static_cast<size_t>(document_size) - position)
+          {
+            throw std::runtime_error("Invalid BSON context document");
+          }
+        position += value_size;
+        elements_.emplace(std::string(key, key_length), std::make_pair(element_start, position - element_start));
+      }
+  }
+
+  /*!
+   * \brief The keys of all context entries in the document.
+   */
+  std::vector<std::string> keys() const
+  {
+    std::vector<std::string> keys;
+    keys.reserve(elements_.size());
+    for (const auto &element : elements_)
+      {
+        keys.push_back(element.first);
+      }
+    return keys;
+  }
+
+  void load(GRM::Context &context, const std::string &key) noexcept override
+  {
+    auto element_it = elements_.find(key);
+    if (element_it == elements_.end()) return;
+    try
+      {
+        loadElement(context, key, element_it->second.first, element_it->second.second);
+      }
+    catch (const std::exception &e)
+      {
+        logger((stderr, "Failed to load the context entry \"%s\": %s\n", key.c_str(), e.what()));
+      }
+  }
+
+private:
+  void loadElement(GRM::Context &context, const std::string &key, size_t element_start, size_t element_size)
+  {
+    int document_size = static_cast<int>(sizeof(int) + element_size + 1);
+    std::vector<char> document(document_size);
+    char *document_size_bytes;
+    int_to_bytes(document_size, &document_size_bytes);
+    memcpy(document.data(), document_size_bytes, sizeof(int));
+    free(document_size_bytes);
+    memcpy(document.data() + sizeof(int), bson_data_.get() + element_start, element_size);
+    document.back() = '\0';
+
+    auto context_args = std::unique_ptr<grm_args_t, void (*)(grm_args_t *)>(grm_args_new(), grm_args_delete);
+    if (context_args == nullptr || frombson_read(context_args.get(), document.data()) != ERROR_NONE)
+      {
+        throw std::runtime_error("Failed to decode the context entry \"" + key + "\"");
+      }
+    arg_t *context_arg;
+    if ((context_arg = args_at(context_args.get(), key.c_str())) != nullptr)
+      {
+        auto context_arg_value_it = grm_arg_value_iter(context_arg);
+        if (context_arg_value_it->next(context_arg_value_it) != nullptr)
+          {
+            switch (context_arg_value_it->format)
+              {
+              case 'i':
+                put_value_into_context<int, int>(context_arg, context_arg_value_it, context);
+                break;
+              case 'd':
+                put_value_into_context<double, double>(context_arg, context_arg_value_it, context);
+                break;
+              case 's':
+                put_value_into_context<char *, std::string>(context_arg, context_arg_value_it, context);
+                break;
+              }
+          }
+        args_value_iterator_delete(context_arg_value_it);
+      }
+  }
+
+  std::unique_ptr<char, void (*)(void *)> bson_data_;
+  std::unordered_map<std::string, std::pair<size_t, size_t>> elements_;
+};
+} // namespace internal
+
+/*!
+ * \brief Load a GRM context object from a serialized context string, but decode the entries on first access.
+ *
+ * Only Base64 encoded BSON documents (the format of `dump_context_as_xml_comment`) can be decoded lazily, other
+ * encodings are loaded immediately with `load_context_str`.
+ *
+ * \param[in] context The context object to load into
+ * \param[in] context_str The serialized context string to deserialize
+ * \throw std::runtime_error
+ */
+void load_context_str_deferred(GRM::Context &context, const std::string &context_str)
+{
+  if (context_str.empty() || context_str[0] == '{' || (context_str[0] == 'e' && context_str[1] == 'y'))
+    {
+      load_context_str(context, context_str, DUMP_AUTO_DETECT);
+      return;
+    }
+  err_t error = ERROR_NONE;
+  size_t bson_size;
+  char *bson_data = base64_decode(nullptr, context_str.c_str(), &bson_size, &error);
+  if (error != ERROR_NONE)
+    {
+      free(bson_data);
+      std::stringstream error_description;
+      error_description << "error \"" << error << "\" (\"" << error_names[error] << "\")";
+      logger((stderr, "Got %s!\n", error_description.str().c_str()));
+      throw std::runtime_error("Failed to decode base64 context string (" + error_description.str() + ")");
+    }
+  auto entries = std::make_shared<internal::DeferredBsonContextEntries>(bson_data, bson_size);
+  context.deferEntries(entries->keys(), entries);
+}
+
 /* ------------------------- xml ------------------------------------------------------------------------------------ */
 
 #ifndef NO_XERCES_C
+/*!
+ * \brief The attribute types of the graphics tree schema, as needed to load trusted graphics trees without validation.
+ */
+enum class TrustedAttributeType
+{
+  integer,
+  floating_point,
+  integer_or_string,
+  string
+};
+
+typedef std::unordered_map<std::string, std::pair<GRM::AttributeKey, TrustedAttributeType>>
+    trusted_element_attribute_types_t;
+typedef std::unordered_map<std::string, trusted_element_attribute_types_t> trusted_attribute_types_t;
+
 namespace XERCES_CPP_NAMESPACE
 {
 
@@ -5092,7 +5308,14 @@ public:
 
   void writeChars(const XMLByte *const toWrite, const XMLSize_t count, XMLFormatter *const formatter) override
   {
-    out_buffer_.write((char *)toWrite, (int)count);
+    if (out_string_ != nullptr)
+      {
+        out_string_->append((const char *)toWrite, count);
+      }
+    else
+      {
+        out_buffer_.write((char *)toWrite, (int)count);
+      }
   }
 
   /*!
@@ -5112,8 +5335,23 @@ public:
     return out;
   }
 
+  /*!
+   * \brief Encode a given Xerces string into an existing string, so its memory can be reused for the next string.
+   *
+   * \param[in] chars Xerces string to encode.
+   * \param[out] out The string which is replaced by the encoded string.
+   */
+  void encodeInto(const XMLCh *chars, std::string &out)
+  {
+    out.clear();
+    out_string_ = &out;
+    *this << chars;
+    out_string_ = nullptr;
+  }
+
 private:
   std::stringstream out_buffer_;
+  std::string *out_string_ = nullptr;
 };
 
 
@@ -5663,6 +5901,139 @@ private:
   std::vector<std::pair<std::string, std::string>> current_attributes_;
 };
 
+/*!
+ * \brief A SAX handler which builds the graphics tree from trusted XML input without schema validation.
+ *
+ * Attribute types are looked up in a table derived from the graphics tree schema once, instead of validating every
+ * document against the schema. Like in a validated load, attributes which are not declared in the schema are dropped.
+ * Names and values are transcoded into two reused strings, and the serialized context is only decoded when an entry
+ * is accessed.
+ */
+class TrustedGraphicsTreeParseHandler : public DefaultHandler, public SaxErrorHandler
+{
+public:
+  TrustedGraphicsTreeParseHandler(GRM::Context &context, const trusted_attribute_types_t &attribute_types)
+      : context_(context), attribute_types_(attribute_types)
+  {
+  }
+
+  void startElement(const XMLCh *const uri, const XMLCh *const localname, const XMLCh *const qname,
+                    const Attributes &attributes) override
+  {
+    xml_buffer_.encodeInto(qname, name_buffer_);
+
+    std::shared_ptr<GRM::Element> element;
+    if (name_buffer_ == "root")
+      {
+        global_root = global_render->createElement("root");
+        global_render->replaceChildren(global_root);
+        element = global_root;
+        insertion_parent_ = nullptr;
+      }
+    else
+      {
+        element = global_render->createElement(name_buffer_);
+      }
+
+    auto element_attribute_types_it = attribute_types_.find(name_buffer_);
+    if (element_attribute_types_it != attribute_types_.end())
+      {
+        const auto &element_attribute_types = element_attribute_types_it->second;
+        XMLSize_t attribute_count = attributes.getLength();
+        for (XMLSize_t i = 0; i < attribute_count; i++)
+          {
+            xml_buffer_.encodeInto(attributes.getQName(i), name_buffer_);
+            auto attribute_type_it = element_attribute_types.find(name_buffer_);
+            if (attribute_type_it == element_attribute_types.end())
+              {
+                continue;
+              }
+            const auto &[attribute_key, attribute_type] = attribute_type_it->second;
+            xml_buffer_.encodeInto(attributes.getValue(i), value_buffer_);
+            set_attribute(*element, attribute_key, attribute_type, value_buffer_);
+            if (name_buffer_ == "active" && value_buffer_ == "1")
+              {
+                global_render->setActiveFigure(element);
+              }
+          }
+      }
+
+    if (insertion_parent_ != nullptr)
+      {
+        insertion_parent_->appendChild(element);
+      }
+    insertion_parent_ = std::move(element);
+  }
+
+  void endElement(const XMLCh *const uri, const XMLCh *const localname, const XMLCh *const qname) override
+  {
+    insertion_parent_ = insertion_parent_->parentElement();
+  }
+
+  void comment(const XMLCh *const chars, const XMLSize_t length) override
+  {
+    xml_buffer_.encodeInto(chars, value_buffer_);
+    std::string_view comment_view{value_buffer_};
+    comment_view = trim(comment_view);
+    if (starts_with(comment_view, "__grm_context__:"))
+      {
+        comment_view.remove_prefix(16);
+        comment_view = ltrim(comment_view);
+        load_context_str_deferred(context_, std::string(comment_view));
+      }
+  }
+
+  void warning(const SAXParseException &e) override { SaxErrorHandler::warning(e); }
+
+  void error(const SAXParseException &e) override { SaxErrorHandler::error(e); }
+
+  void fatalError(const SAXParseException &e) override { SaxErrorHandler::fatalError(e); }
+
+  void resetErrors() override { SaxErrorHandler::resetErrors(); }
+
+private:
+  /*!
+   * \brief Set an attribute with the same conversion rules as the validating loader (`std::stoi` and `std::stod`
+   *        accept any value which starts with a number).
+   */
+  static void set_attribute(GRM::Element &element, const GRM::AttributeKey &key, TrustedAttributeType type,
+                            const std::string &value)
+  {
+    const char *begin = value.c_str();
+    char *end;
+    if (type == TrustedAttributeType::integer || type == TrustedAttributeType::integer_or_string)
+      {
+        errno = 0;
+        long int_value = strtol(begin, &end, 10);
+        if (end != begin && errno == 0 && int_value >= INT_MIN && int_value <= INT_MAX)
+          {
+            element.setAttribute(key, GRM::Value(static_cast<int>(int_value)));
+            return;
+          }
+        if (type == TrustedAttributeType::integer)
+          {
+            return;
+          }
+      }
+    else if (type == TrustedAttributeType::floating_point)
+      {
+        double double_value = strtod(begin, &end);
+        if (end != begin)
+          {
+            element.setAttribute(key, GRM::Value(double_value));
+          }
+        return;
+      }
+    element.setAttribute(key, GRM::Value(value));
+  }
+
+  XMLStringBuffer xml_buffer_{"UTF-8"};
+  GRM::Context &context_;
+  const trusted_attribute_types_t &attribute_types_;
+  std::shared_ptr<GRM::Element> insertion_parent_;
+  std::string name_buffer_, value_buffer_;
+};
+
 /*!
  * \brief The core class to handle SAX parsing of XML schemas.
  *
@@ -5815,15 +6186,13 @@ private:
 };
 } // namespace XERCES_CPP_NAMESPACE
 
-extern "C" {
-
 /*!
  * \brief Load a graphics tree from an XML file.
  *
  * \param[in] file The file object to parse from.
  * \return 1 on success, 0 on failure.
  */
-int grm_load_graphics_tree(FILE *file)
+static int load_graphics_tree_xml(FILE *file)
 {
   using namespace XERCES_CPP_NAMESPACE;
 
@@ -5893,6 +6262,189 @@ int grm_load_graphics_tree(FILE *file)
 
   return errorCount == 0;
 }
+
+/*!
+ * \brief Collect the attribute types of all elements declared in the (merged) graphics tree schema.
+ *
+ * Only the types which the validating loader distinguishes (`xs:integer`, `xs:double` and `strint`) are recorded,
+ * all other attributes are stored as strings.
+ */
+static void collect_trusted_attribute_types(
+    const GRM::Element &schema_element,
+    const std::unordered_map<std::string, const GRM::Element *> &attribute_groups,
+    trusted_element_attribute_types_t &attribute_types, std::unordered_set<std::string> &visited_attribute_groups)
+{
+  for (const auto &child : schema_element.childElements())
+    {
+      const std::string &child_name = child.localName();
+      if (child_name == "xs:element" && child.hasAttribute("name"))
+        {
+          continue;
+        }
+      if (child_name == "xs:attribute" && child.getAttribute("name").isString())
+        {
+          auto attribute_name = static_cast<std::string>(child.getAttribute("name"));
+          auto type_value = child.getAttribute("type");
+          std::string type = type_value.isString() ? static_cast<std::string>(type_value) : "";
+          TrustedAttributeType attribute_type = TrustedAttributeType::string;
+          if (type == "xs:integer")
+            {
+              attribute_type = TrustedAttributeType::integer;
+            }
+          else if (type == "xs:double")
+            {
+              attribute_type = TrustedAttributeType::floating_point;
+            }
+          else if (type == "strint")
+            {
+              attribute_type = TrustedAttributeType::integer_or_string;
+            }
+          attribute_types.emplace(attribute_name, std::make_pair(GRM::AttributeKey(attribute_name), attribute_type));
+        }
+      else if (child_name == "xs:attributeGroup" && child.getAttribute("ref").isString())
+        {
+          auto group_name = static_cast<std::string>(child.getAttribute("ref"));
+          auto group_it = attribute_groups.find(group_name);
+          if (group_it != attribute_groups.end() && visited_attribute_groups.insert(group_name).second)
+            {
+              collect_trusted_attribute_types(*group_it->second, attribute_groups, attribute_types,
+                                              visited_attribute_groups);
+              visited_attribute_groups.erase(group_name);
+            }
+        }
+      else
+        {
+          collect_trusted_attribute_types(child, attribute_groups, attribute_types, visited_attribute_groups);
+        }
+    }
+}
+
+/*!
+ * \brief Get the attribute types of all graphics tree elements. The schema is only parsed on the first call.
+ *
+ * \return A pointer to the attribute type table or `nullptr` if the schema could not be loaded.
+ */
+static const trusted_attribute_types_t *get_trusted_attribute_types()
+{
+  static std::unique_ptr<trusted_attribute_types_t> attribute_types;
+
+  if (attribute_types == nullptr)
+    {
+      auto schema = grm_load_graphics_tree_schema(true);
+      if (schema == nullptr || schema->documentElement() == nullptr)
+        {
+          return nullptr;
+        }
+      std::unordered_map<std::string, const GRM::Element *> attribute_groups;
+      std::vector<const GRM::Element *> element_declarations;
+      for (const auto &declaration : schema->documentElement()->childElements())
+        {
+          if (!declaration.getAttribute("name").isString())
+            {
+              continue;
+            }
+          if (declaration.localName() == "xs:attributeGroup")
+            {
+              attribute_groups.emplace(static_cast<std::string>(declaration.getAttribute("name")), &declaration);
+            }
+          else if (declaration.localName() == "xs:element")
+            {
+              element_declarations.push_back(&declaration);
+            }
+        }
+      auto new_attribute_types = std::make_unique<trusted_attribute_types_t>();
+      for (const auto *declaration : element_declarations)
+        {
+          auto element_name = static_cast<std::string>(declaration->getAttribute("name"));
+          std::unordered_set<std::string> visited_attribute_groups;
+          collect_trusted_attribute_types(*declaration, attribute_groups, (*new_attribute_types)[element_name],
+                                          visited_attribute_groups);
+        }
+      attribute_types = std::move(new_attribute_types);
+    }
+
+  return attribute_types.get();
+}
+
+/*!
+ * \brief Load a graphics tree from a trusted XML file without validating it against the schema.
+ *
+ * \param[in] file The file object to parse from.
+ * \return 1 on success, 0 on failure.
+ */
+static int load_graphics_tree_xml_trusted(FILE *file)
+{
+  using namespace XERCES_CPP_NAMESPACE;
+
+  if (plot_init_static_variables() != ERROR_NONE)
+    {
+      return 0;
+    }
+
+  gr_setscale(0); // TODO: Check why scale is not restored after a render call in `render.cxx` automatically
+
+  const trusted_attribute_types_t *attribute_types = get_trusted_attribute_types();
+  if (attribute_types == nullptr)
+    {
+      std::cerr << "The graphics tree schema could not be loaded." << std::endl;
+      return 0;
+    }
+
+  try
+    {
+      XMLPlatformUtils::Initialize();
+    }
+  catch (const XMLException &e)
+    {
+      std::cerr << "Error during initialization! :\n" << TranscodeToUtf8Str(e.getMessage()) << std::endl;
+      return 0;
+    }
+
+  bool auto_update;
+  global_render->getAutoUpdate(&auto_update);
+  global_render->setAutoUpdate(false);
+
+  XMLSize_t errorCount = 1;
+  {
+    auto parser =
+        std::unique_ptr<SAX2XMLReaderImpl>(static_cast<SAX2XMLReaderImpl *>(XMLReaderFactory::createXMLReader()));
+
+    // The input is trusted, so skip validation
+    parser->setFeature(XMLUni::fgSAX2CoreValidation, false);
+    parser->setFeature(XMLUni::fgXercesDynamic, false);
+    parser->setFeature(XMLUni::fgXercesSchema, false);
+    parser->setFeature(XMLUni::fgXercesSchemaFullChecking, false);
+
+    try
+      {
+        TrustedGraphicsTreeParseHandler handler(*global_render->getContext(), *attribute_types);
+        parser->setContentHandler(&handler);
+        parser->setLexicalHandler(&handler);
+        parser->setErrorHandler(static_cast<SaxErrorHandler *>(&handler));
+        parser->parse(FileInputSource(file));
+        errorCount = parser->getErrorCount();
+      }
+    catch (const OutOfMemoryException &)
+      {
+        std::cerr << "OutOfMemoryException" << std::endl;
+      }
+    catch (const XMLException &e)
+      {
+        std::cerr << "\nAn error occurred\n  Error: " << TranscodeToUtf8Str(e.getMessage()) << "\n" << std::endl;
+      }
+    catch (const std::exception &e)
+      {
+        std::cerr << "\nAn error occurred\n  Error: " << e.what() << "\n" << std::endl;
+      }
+
+  } // `parser` must be freed before `XMLPlatformUtils::Terminate()` is called
+
+  XMLPlatformUtils::Terminate();
+
+  edit_figure = global_render->getActiveFigure();
+  global_render->setAutoUpdate(auto_update);
+
+  return errorCount == 0;
 }
 
 /*!
@@ -6115,6 +6667,8 @@ void grm_finalize(void)
       type_map = nullptr;
       grid_delete(global_grid);
       global_grid = nullptr;
+      series_args_to_element.clear();
+      memwriter_pool_clear();
       delete_tmp_dir();
       uninstall_backtrace_handler_if_enabled();
       plot_static_variables_initialized = 0;
@@ -6219,6 +6773,105 @@ void grm_dump_graphics_tree(FILE *f)
   dump_context_as_xml_comment(f, &restore_backup_attribute_filter.context_keys_to_discard());
 }
 
+int grm_dump_graphics_tree_snapshot(FILE *f, int compress)
+{
+  internal::RestoreBackupAttributeFilter restore_backup_attribute_filter;
+  /* Unlike the XML export, internal attributes are stored with their types and are restored when loading. */
+  err_t error = snapshot_write(
+      f, *global_root, *global_render->getContext(), compress,
+      [&restore_backup_attribute_filter](const std::string &attribute_name, const GRM::Element &element,
+                                         std::optional<std::string> &new_attribute_name) -> bool {
+        return restore_backup_attribute_filter(attribute_name, element, new_attribute_name);
+      },
+      &restore_backup_attribute_filter.context_keys_to_discard());
+  if (error != ERROR_NONE)
+    {
+      logger((stderr, "Got error \"%d\" (\"%s\")!\n", error, error_names[error]));
+      return 0;
+    }
+  return 1;
+}
+
+/*!
+ * \brief Load a graphics tree from a binary snapshot created by `grm_dump_graphics_tree_snapshot`.
+ *
+ * \param[in] file The file object to read from.
+ * \return 1 on success, 0 on failure.
+ */
+static int load_graphics_tree_snapshot(FILE *file)
+{
+  if (plot_init_static_variables() != ERROR_NONE)
+    {
+      return 0;
+    }
+
+  gr_setscale(0); // TODO: Check why scale is not restored after a render call in `render.cxx` automatically
+
+  bool auto_update;
+  global_render->getAutoUpdate(&auto_update);
+  global_render->setAutoUpdate(false);
+
+  std::shared_ptr<GRM::Element> root;
+  err_t error = snapshot_read(file, *global_render, *global_render->getContext(), root);
+  if (error == ERROR_NONE)
+    {
+      try
+        {
+          global_root = root;
+          global_render->replaceChildren(global_root);
+          for (const auto &figure : global_root->querySelectorsAll("figure"))
+            {
+              auto active = figure->getAttribute("active");
+              if (active.isInt() && static_cast<int>(active) == 1)
+                {
+                  global_render->setActiveFigure(figure);
+                }
+            }
+          edit_figure = global_render->getActiveFigure();
+        }
+      catch (const std::exception &e)
+        {
+          logger((stderr, "%s\n", e.what()));
+          error = ERROR_SNAPSHOT_INVALID_FORMAT;
+        }
+    }
+  if (error != ERROR_NONE)
+    {
+      logger((stderr, "Got error \"%d\" (\"%s\")!\n", error, error_names[error]));
+    }
+  global_render->setAutoUpdate(auto_update);
+
+  return error == ERROR_NONE;
+}
+
+int grm_load_graphics_tree(FILE *file)
+{
+  if (is_snapshot_file(file))
+    {
+      return load_graphics_tree_snapshot(file);
+    }
+#ifndef NO_XERCES_C
+  return load_graphics_tree_xml(file);
+#else
+  fprintf(stderr, "No Xerces-C++ support compiled in, only graphics tree snapshots can be loaded.\n");
+  return 0;
+#endif
+}
+
+int grm_load_graphics_tree_trusted(FILE *file)
+{
+  if (is_snapshot_file(file))
+    {
+      return load_graphics_tree_snapshot(file);
+    }
+#ifndef NO_XERCES_C
+  return load_graphics_tree_xml_trusted(file);
+#else
+  fprintf(stderr, "No Xerces-C++ support compiled in, only graphics tree snapshots can be loaded.\n");
+  return 0;
+#endif
+}
+
 unsigned int grm_max_plotid(void)
 {
   unsigned int args_array_length = 0;
@@ -6271,10 +6924,17 @@ int grm_merge_extended(const grm_args_t *args, int hold, const char *identificat
           process_events();
           return error == ERROR_NONE;
         }
+      if (plot_check_for_append(args))
+        {
+          // Appended data is added to an existing series instead of being merged
+          return grm_append(args);
+        }
       if (plot_merge_args(global_root_args, args, nullptr, nullptr, hold) != ERROR_NONE)
         {
           return 0;
         }
+      /* merging can delete series containers and reuse their addresses, the map is filled again by the next plot */
+      series_args_to_element.clear();
       if (!get_id_from_args(args, &last_merge_plot_id, &last_merge_subplot_id, &last_merge_series_id))
         {
           last_merge_plot_id = 0;
@@ -6301,6 +6961,147 @@ int grm_merge_named(const grm_args_t *args, const char *identificator)
   return grm_merge_extended(args, 0, identificator);
 }
 
+int grm_append(const grm_args_t *args)
+{
+  /*
+   * Append data points to the `x` and `y` arrays of an existing series. The series is selected by `id` or `plot_id`,
+   * `subplot_id` and `series_id` like in `grm_merge` (default: the first series of the first subplot of the active
+   * plot). If `window` is given and greater than 0, only the last `window` points of the series are kept.
+   * Line and scatter series which are already part of the graphics tree are updated in place and only the plot which
+   * contains the series is processed again by the next `grm_render` call. Otherwise, the plot is recreated by the next
+   * `grm_plot` call.
+   */
+  grm_args_t **plots, **subplots, **series, *series_args;
+  unsigned int plot_count, subplot_count, series_count, x_length, y_length, c_length;
+  int plot_id, subplot_id, series_id, window = 0;
+  double *x, *y, *c;
+  arg_t *x_arg, *y_arg;
+  err_t error = ERROR_NONE;
+
+  if (plot_init_static_variables() != ERROR_NONE)
+    {
+      return 0;
+    }
+  if (!grm_args_first_value(args, "x", "D", &x, &x_length) || !grm_args_first_value(args, "y", "D", &y, &y_length) ||
+      x_length != y_length)
+    {
+      logger((stderr, "Appending needs \"x\" and \"y\" arrays of the same length\n"));
+      return 0;
+    }
+  grm_args_values(args, "window", "i", &window);
+  get_id_from_args(args, &plot_id, &subplot_id, &series_id);
+  if (plot_id <= 0) plot_id = static_cast<int>(active_plot_index);
+  if (subplot_id <= 0) subplot_id = 1;
+  if (series_id <= 0) series_id = 1;
+
+  if (!grm_args_first_value(global_root_args, "plots", "A", &plots, &plot_count) ||
+      plot_id > static_cast<int>(plot_count) ||
+      !grm_args_first_value(plots[plot_id - 1], "subplots", "A", &subplots, &subplot_count) ||
+      subplot_id > static_cast<int>(subplot_count) ||
+      !grm_args_first_value(subplots[subplot_id - 1], "series", "A", &series, &series_count) ||
+      series_id > static_cast<int>(series_count))
+    {
+      logger((stderr, "Cannot append to the non-existing series %d.%d.%d\n", plot_id - 1, subplot_id, series_id));
+      return 0;
+    }
+  series_args = series[series_id - 1];
+  /* other per-point data would not match the appended points anymore */
+  if (grm_args_contains(series_args, "z") || grm_args_first_value(series_args, "c", "D", &c, &c_length) ||
+      grm_args_contains(series_args, "error"))
+    {
+      logger((stderr, "Appending is only supported for series with \"x\" and \"y\" data only\n"));
+      return 0;
+    }
+
+  /* the arrays may be shared with other containers or borrowed from the caller, so they are copied before appending */
+  x_arg = args_at_writable(series_args, "x");
+  y_arg = args_at_writable(series_args, "y");
+  if (x_arg == nullptr || y_arg == nullptr)
+    {
+      logger((stderr, "Appending needs a series with \"x\" and \"y\" data\n"));
+      return 0;
+    }
+  if (strcmp(x_arg->value_format, "nD") != 0 || strcmp(y_arg->value_format, "nD") != 0)
+    {
+      logger((stderr, "Appending needs a series with \"x\" and \"y\" data stored as double arrays\n"));
+      return 0;
+    }
+  if (*(size_t *)x_arg->value_ptr != *(size_t *)y_arg->value_ptr)
+    {
+      logger((stderr, "The \"x\" and \"y\" data of the series differ in length\n"));
+      return 0;
+    }
+  /* both arrays are allocated first, so the series is left unchanged if one of the allocations fails */
+  error = arg_reserve_array(x_arg, x_length, window > 0 ? window : 0);
+  if (error == ERROR_NONE) error = arg_reserve_array(y_arg, y_length, window > 0 ? window : 0);
+  if (error != ERROR_NONE)
+    {
+      logger((stderr, "Got error \"%d\" (\"%s\")!\n", error, error_names[error]));
+      return 0;
+    }
+  arg_append_array(x_arg, x, x_length, window > 0 ? window : 0);
+  arg_append_array(y_arg, y, y_length, window > 0 ? window : 0);
+
+  auto search = series_args_to_element.find(series_args);
+  auto element = (search != series_args_to_element.end()) ? search->second.lock() : nullptr;
+  if (element != nullptr && !element->isConnected()) element = nullptr;
+  std::shared_ptr<GRM::Element> plot_element;
+  for (auto ancestor = element; ancestor != nullptr; ancestor = ancestor->parentElement())
+    {
+      if (ancestor->localName() == "plot")
+        {
+          plot_element = ancestor;
+          break;
+        }
+    }
+  if (plot_element != nullptr && plot_element->parentElement() != nullptr && element->hasAttribute("x") &&
+      element->hasAttribute("y") && !element->hasAttribute("z") && !element->hasAttribute("c"))
+    {
+      auto context = global_render->getContext();
+      context->appendDoubles(static_cast<std::string>(element->getAttribute("x")), x, x_length,
+                             window > 0 ? window : 0);
+      context->appendDoubles(static_cast<std::string>(element->getAttribute("y")), y, y_length,
+                             window > 0 ? window : 0);
+      /* the renderer caches the data ranges of a series, they are extended by the appended points unless a rolling
+       * window could have dropped the extreme values */
+      const char *range_keys[] = {"x_range", "y_range"};
+      const double *appended_values[] = {x, y};
+      for (int i = 0; i < 2; ++i)
+        {
+          std::string min_key = std::string(range_keys[i]) + "_min", max_key = std::string(range_keys[i]) + "_max";
+          if (grm_args_contains(series_args, range_keys[i]) || !element->hasAttribute(min_key) ||
+              !element->hasAttribute(max_key))
+            {
+              continue;
+            }
+          if (window > 0)
+            {
+              element->removeAttribute(min_key);
+              element->removeAttribute(max_key);
+              continue;
+            }
+          auto range_min = static_cast<double>(element->getAttribute(min_key));
+          auto range_max = static_cast<double>(element->getAttribute(max_key));
+          for (unsigned int j = 0; j < x_length; ++j)
+            {
+              if (std::isnan(appended_values[i][j])) continue;
+              range_min = grm_min(range_min, appended_values[i][j]);
+              range_max = grm_max(range_max, appended_values[i][j]);
+            }
+          element->setAttribute(min_key, range_min);
+          element->setAttribute(max_key, range_max);
+        }
+      element->setAttribute("_update_required", true);
+      plot_element->setAttribute("_update_limits", 1);
+    }
+  else
+    {
+      args_changed_since_last_plot = true;
+    }
+
+  return 1;
+}
+
 int plot_process_subplot_args(grm_args_t *subplot_args)
 {
   plot_func_t plot_func;
@@ -6551,6 +7352,15 @@ int grm_plot(const grm_args_t *args) // TODO: rename this method so the name dis
       if (!edit_figure->hasChildNodes() || (append_figures && !figure_id_given))
         {
           int plot_id = 0;
+          /* forget the series of replaced figures before the new series elements are registered */
+          for (auto it = series_args_to_element.begin(); it != series_args_to_element.end();)
+            {
+              auto element = it->second.lock();
+              if (element == nullptr || !element->isConnected())
+                it = series_args_to_element.erase(it);
+              else
+                ++it;
+            }
           if (!(nrows == 1 && ncols == 1 &&
                 currentGrid->getElement(0, 0) == nullptr)) // Check if Grid arguments in container
             {
@@ -6658,8 +7468,45 @@ int grm_process_tree(void)
   return 1;
 }
 
+/*!
+ * \brief Export the current plot to a file.
+ *
+ * The file type is chosen by the extension of `file_path`:
+ * - `.xml` writes the graphics tree as XML document (like `grm_dump_graphics_tree`),
+ * - `.grm` writes the graphics tree and its context as binary snapshot (see `grm_dump_graphics_tree_snapshot`),
+ * - `.grmz` writes a zlib compressed binary snapshot (stored uncompressed if GRM was built without zlib).
+ * Graphics tree files are not rendered and can be loaded again with `grm_load_graphics_tree`. All other extensions
+ * render the plot to a print file with `gr_beginprint`.
+ *
+ * \param[in] file_path The path of the exported file.
+ * \return 1 on success, 0 on failure.
+ */
 int grm_export(const char *file_path)
 {
+  std::string_view file_path_view{file_path};
+  bool is_snapshot = ends_with(file_path_view, ".grm"), is_compressed_snapshot = ends_with(file_path_view, ".grmz");
+  if (ends_with(file_path_view, ".xml") || is_snapshot || is_compressed_snapshot)
+    {
+      /* Graphics tree exports are not rendered, the current tree is written as XML document or binary snapshot */
+      FILE *file = fopen(file_path, (is_snapshot || is_compressed_snapshot) ? "wb" : "w");
+      if (file == nullptr)
+        {
+          logger((stderr, "Could not open \"%s\" for writing\n", file_path));
+          return 0;
+        }
+      int return_value = 1;
+      if (is_snapshot || is_compressed_snapshot)
+        {
+          return_value = grm_dump_graphics_tree_snapshot(file, is_compressed_snapshot);
+        }
+      else
+        {
+          grm_dump_graphics_tree(file);
+        }
+      if (fclose(file) != 0) return_value = 0;
+      return return_value;
+    }
+
   gr_beginprint(const_cast<char *>(file_path));
   int return_value = grm_plot(nullptr);
   gr_endprint();
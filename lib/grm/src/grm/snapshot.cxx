@@ -0,0 +1,811 @@
+/* ######################### includes ############################################################################### */
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <grm/dom_render/graphics_tree/util.hxx>
+#include "logging_int.h"
+#include "snapshot_int.hxx"
+#include "util_int.h"
+
+
+/* ######################### internal implementation ################################################################ */
+
+/* ========================= static variables ======================================================================= */
+
+/* ------------------------- snapshot ------------------------------------------------------------------------------- */
+
+/* the first byte is not valid at the start of an UTF-8 document, so snapshots cannot be confused with XML files */
+static const char snapshot_magic[8] = {'\x89', 'G', 'R', 'M', '\r', '\n', '\x1a', '\n'};
+static const std::uint32_t snapshot_version = 1;
+static const std::uint32_t snapshot_flag_zlib = 1;
+static const std::size_t snapshot_header_size = 32;
+static const std::size_t snapshot_alignment = 8;
+/* zlib counts bytes in `uInt`, so larger blocks are passed in several steps */
+static const std::size_t snapshot_zlib_max_block_size = 1u << 30;
+/* the best compression ratio which deflate can achieve */
+static const std::size_t snapshot_zlib_max_ratio = 1032;
+
+enum snapshot_value_type_t : std::uint8_t
+{
+  SNAPSHOT_VALUE_INT = 1,
+  SNAPSHOT_VALUE_DOUBLE = 2,
+  SNAPSHOT_VALUE_STRING = 3
+};
+
+static_assert(sizeof(int) == 4 && sizeof(double) == 8, "snapshots store int and double values as i32 and f64");
+
+
+/* ========================= datatypes ============================================================================== */
+
+/* ------------------------- snapshot ------------------------------------------------------------------------------- */
+
+class SnapshotFormatError : public std::runtime_error
+{
+public:
+  explicit SnapshotFormatError(const std::string &what) : std::runtime_error(what) {}
+};
+
+
+/* ========================= functions ============================================================================== */
+
+/* ------------------------- byte order ----------------------------------------------------------------------------- */
+
+static bool host_is_little_endian()
+{
+  const std::uint16_t probe = 1;
+  unsigned char first_byte;
+  std::memcpy(&first_byte, &probe, 1);
+  return first_byte == 1;
+}
+
+template <typename T> static void append_le(std::vector<char> &buffer, T value)
+{
+  static_assert(std::is_arithmetic_v<T>, "only arithmetic values can be stored in a snapshot");
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  if (!host_is_little_endian()) std::reverse(bytes, bytes + sizeof(T));
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T> static T load_le(const char *data)
+{
+  char bytes[sizeof(T)];
+  T value;
+  std::memcpy(bytes, data, sizeof(T));
+  if (!host_is_little_endian()) std::reverse(bytes, bytes + sizeof(T));
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+static void append_string(std::vector<char> &buffer, std::string_view str)
+{
+  if (str.size() > UINT32_MAX) throw std::length_error("String is too long to be stored in a snapshot");
+  append_le<std::uint32_t>(buffer, static_cast<std::uint32_t>(str.size()));
+  buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+static std::size_t aligned_size(std::size_t size)
+{
+  return (size + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+}
+
+
+/* ------------------------- snapshot writer ------------------------------------------------------------------------ */
+
+/*!
+ * \brief Collect the payload of a snapshot as a sequence of memory blocks.
+ *
+ * Small sections are serialized into owned buffers, but on little endian hosts numeric context arrays are referenced
+ * in place, so even large arrays are written to the file (or passed to zlib) without an intermediate copy.
+ */
+class SnapshotPayload
+{
+public:
+  std::vector<char> &buffer() { return current_; }
+
+  void align()
+  {
+    current_.resize(current_.size() + aligned_size(size_ + current_.size()) - (size_ + current_.size()), '\0');
+  }
+
+  template <typename T> void appendArray(const T *data, std::size_t length)
+  {
+    if (length == 0) return;
+    if (!host_is_little_endian())
+      {
+        for (std::size_t i = 0; i < length; ++i)
+          {
+            append_le<T>(current_, data[i]);
+          }
+        return;
+      }
+    flush();
+    blocks_.push_back({reinterpret_cast<const char *>(data), length * sizeof(T)});
+    size_ += length * sizeof(T);
+  }
+
+  const std::vector<std::pair<const char *, std::size_t>> &blocks()
+  {
+    flush();
+    return blocks_;
+  }
+
+  std::size_t size() const { return size_ + current_.size(); }
+
+private:
+  void flush()
+  {
+    if (current_.empty()) return;
+    owned_.push_back(std::move(current_));
+    current_ = std::vector<char>();
+    blocks_.push_back({owned_.back().data(), owned_.back().size()});
+    size_ += owned_.back().size();
+  }
+
+  std::vector<char> current_;
+  std::list<std::vector<char>> owned_;
+  std::vector<std::pair<const char *, std::size_t>> blocks_;
+  std::size_t size_ = 0;
+};
+
+class SnapshotTreeWriter
+{
+public:
+  explicit SnapshotTreeWriter(const snapshot_attribute_filter_t &attribute_filter) : attribute_filter_(attribute_filter)
+  {
+  }
+
+  void writeElement(const GRM::Element &element)
+  {
+    std::vector<std::pair<std::uint32_t, GRM::Value>> attributes;
+    for (const auto &key : element.getAttributeKeys())
+      {
+        std::optional<std::string> new_attribute_name;
+        if (attribute_filter_ && !attribute_filter_(key.name(), element, new_attribute_name)) continue;
+        auto value = element.getAttribute(key);
+        if (value.isUndefined()) continue;
+        attributes.emplace_back(nameIndex(new_attribute_name ? *new_attribute_name : key.name()), std::move(value));
+      }
+    std::uint32_t child_count = 0;
+    for (const auto &child : element.childElements())
+      {
+        static_cast<void>(child);
+        ++child_count;
+      }
+
+    append_le<std::uint32_t>(elements_, nameIndex(element.localName()));
+    append_le<std::uint32_t>(elements_, static_cast<std::uint32_t>(attributes.size()));
+    append_le<std::uint32_t>(elements_, child_count);
+    for (const auto &[name_index, value] : attributes)
+      {
+        append_le<std::uint32_t>(elements_, name_index);
+        switch (value.type())
+          {
+          case GRM::Value::Type::INT:
+            append_le<std::uint8_t>(elements_, SNAPSHOT_VALUE_INT);
+            append_le<std::int32_t>(elements_, static_cast<int>(value));
+            break;
+          case GRM::Value::Type::DOUBLE:
+            append_le<std::uint8_t>(elements_, SNAPSHOT_VALUE_DOUBLE);
+            append_le<double>(elements_, static_cast<double>(value));
+            break;
+          default:
+            append_le<std::uint8_t>(elements_, SNAPSHOT_VALUE_STRING);
+            append_string(elements_, static_cast<std::string>(value));
+            break;
+          }
+      }
+    ++element_count_;
+
+    for (const auto &child : element.childElements())
+      {
+        writeElement(child);
+      }
+  }
+
+  void writeTo(SnapshotPayload &payload) const
+  {
+    auto &buffer = payload.buffer();
+    append_le<std::uint32_t>(buffer, static_cast<std::uint32_t>(names_.size()));
+    for (const auto &name : names_)
+      {
+        append_string(buffer, name);
+      }
+    payload.align();
+    append_le<std::uint32_t>(payload.buffer(), element_count_);
+    payload.buffer().insert(payload.buffer().end(), elements_.begin(), elements_.end());
+    payload.align();
+  }
+
+private:
+  std::uint32_t nameIndex(const std::string &name)
+  {
+    auto it = name_indices_.find(name);
+    if (it != name_indices_.end()) return it->second;
+    auto index = static_cast<std::uint32_t>(names_.size());
+    names_.push_back(name);
+    name_indices_.emplace(name, index);
+    return index;
+  }
+
+  const snapshot_attribute_filter_t &attribute_filter_;
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, std::uint32_t> name_indices_;
+  std::vector<char> elements_;
+  std::uint32_t element_count_ = 0;
+};
+
+template <typename T> static void write_context_entry(SnapshotPayload &payload, const std::string &key,
+                                                     const std::vector<T> &values)
+{
+  append_string(payload.buffer(), key);
+  if constexpr (std::is_same_v<T, std::string>)
+    {
+      append_le<std::uint8_t>(payload.buffer(), SNAPSHOT_VALUE_STRING);
+      payload.align();
+      append_le<std::uint64_t>(payload.buffer(), values.size());
+      for (const auto &value : values)
+        {
+          append_string(payload.buffer(), value);
+        }
+    }
+  else
+    {
+      append_le<std::uint8_t>(payload.buffer(), std::is_same_v<T, int> ? SNAPSHOT_VALUE_INT : SNAPSHOT_VALUE_DOUBLE);
+      payload.align();
+      append_le<std::uint64_t>(payload.buffer(), values.size());
+      payload.appendArray(values.data(), values.size());
+    }
+  payload.align();
+}
+
+static void write_context(SnapshotPayload &payload, GRM::Context &context,
+                          const std::unordered_set<std::string> *context_keys_to_discard)
+{
+  std::vector<GRM::Context::Iterator::value_type> entries;
+  for (auto item : context)
+    {
+      const std::string &key =
+          std::visit([](auto pair_ref) -> const std::string & { return pair_ref.get().first; }, item);
+      if (context_keys_to_discard == nullptr || context_keys_to_discard->find(key) == context_keys_to_discard->end())
+        {
+          entries.push_back(item);
+        }
+    }
+
+  append_le<std::uint32_t>(payload.buffer(), static_cast<std::uint32_t>(entries.size()));
+  for (const auto &entry : entries)
+    {
+      std::visit(
+          [&payload](auto pair_ref) { write_context_entry(payload, pair_ref.get().first, pair_ref.get().second); },
+          entry);
+    }
+}
+
+#ifdef HAVE_ZLIB
+static err_t compress_payload(const std::vector<std::pair<const char *, std::size_t>> &blocks,
+                              std::vector<char> &compressed)
+{
+  z_stream stream;
+  std::size_t used = 0;
+  int result = Z_OK;
+
+  std::memset(&stream, 0, sizeof(stream));
+  /* the context arrays are mostly binary doubles which do not compress well, so favor speed */
+  if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK) return ERROR_SNAPSHOT_COMPRESSION;
+  auto deflate_block = [&stream, &used, &result, &compressed](const char *data, std::size_t size, int flush) {
+    do
+      {
+        std::size_t block_size = std::min(size, snapshot_zlib_max_block_size);
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        stream.avail_in = static_cast<uInt>(block_size);
+        data += block_size;
+        size -= block_size;
+        do
+          {
+            if (compressed.size() - used < 64 * 1024)
+              {
+                compressed.resize(std::max<std::size_t>(2 * compressed.size(), used + 1024 * 1024));
+              }
+            std::size_t available = std::min(compressed.size() - used, snapshot_zlib_max_block_size);
+            stream.next_out = reinterpret_cast<Bytef *>(compressed.data() + used);
+            stream.avail_out = static_cast<uInt>(available);
+            result = deflate(&stream, (size == 0) ? flush : Z_NO_FLUSH);
+            if (result == Z_STREAM_ERROR) return;
+            used += available - stream.avail_out;
+          }
+        while (stream.avail_out == 0);
+      }
+    while (size > 0);
+  };
+  for (const auto &block : blocks)
+    {
+      deflate_block(block.first, block.second, Z_NO_FLUSH);
+      if (result == Z_STREAM_ERROR) break;
+    }
+  if (result != Z_STREAM_ERROR) deflate_block(nullptr, 0, Z_FINISH);
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END) return ERROR_SNAPSHOT_COMPRESSION;
+  compressed.resize(used);
+
+  return ERROR_NONE;
+}
+
+static err_t decompress_payload(const char *data, std::size_t size, std::vector<char> &payload)
+{
+  z_stream stream;
+  std::size_t used = 0;
+  int result = Z_OK;
+
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK) return ERROR_SNAPSHOT_COMPRESSION;
+  while (result == Z_OK)
+    {
+      if (stream.avail_in == 0 && size > 0)
+        {
+          std::size_t block_size = std::min(size, snapshot_zlib_max_block_size);
+          stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+          stream.avail_in = static_cast<uInt>(block_size);
+          data += block_size;
+          size -= block_size;
+        }
+      std::size_t available = std::min(payload.size() - used, snapshot_zlib_max_block_size);
+      stream.next_out = reinterpret_cast<Bytef *>(payload.data() + used);
+      stream.avail_out = static_cast<uInt>(available);
+      /* a truncated stream or a too small payload size stops with `Z_BUF_ERROR` */
+      result = inflate(&stream, Z_NO_FLUSH);
+      used += available - stream.avail_out;
+    }
+  inflateEnd(&stream);
+
+  return (result == Z_STREAM_END && used == payload.size()) ? ERROR_NONE : ERROR_SNAPSHOT_COMPRESSION;
+}
+#endif
+
+
+/* ------------------------- snapshot reader ------------------------------------------------------------------------ */
+
+/*!
+ * \brief The raw bytes of a snapshot file.
+ *
+ * Regular files are mapped into memory, so the numeric arrays can be copied directly from the page cache into the
+ * context. Other streams (pipes, Windows) are read into a buffer.
+ */
+class SnapshotSource
+{
+public:
+  explicit SnapshotSource(FILE *file)
+  {
+#ifndef _WIN32
+    struct stat file_stat;
+    long offset = ftell(file);
+    if (offset >= 0 && fstat(fileno(file), &file_stat) == 0 && S_ISREG(file_stat.st_mode) &&
+        file_stat.st_size > offset)
+      {
+        void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (mapping != MAP_FAILED)
+          {
+            mapping_ = mapping;
+            mapping_size_ = file_stat.st_size;
+            data_ = static_cast<const char *>(mapping) + offset;
+            size_ = mapping_size_ - offset;
+            fseek(file, 0, SEEK_END);
+            return;
+          }
+      }
+#endif
+    char chunk[64 * 1024];
+    std::size_t bytes_read;
+    while ((bytes_read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+      {
+        buffer_.insert(buffer_.end(), chunk, chunk + bytes_read);
+      }
+    if (ferror(file)) throw std::runtime_error("Failed to read the snapshot file");
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+
+  SnapshotSource(const SnapshotSource &) = delete;
+  SnapshotSource &operator=(const SnapshotSource &) = delete;
+
+  ~SnapshotSource()
+  {
+#ifndef _WIN32
+    if (mapping_ != nullptr) munmap(mapping_, mapping_size_);
+#endif
+  }
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  void *mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+  std::vector<char> buffer_;
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+class SnapshotReader
+{
+public:
+  SnapshotReader(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  const char *readBytes(std::size_t count)
+  {
+    if (count > size_ - position_) throw SnapshotFormatError("Unexpected end of snapshot data");
+    const char *bytes = data_ + position_;
+    position_ += count;
+    return bytes;
+  }
+
+  template <typename T> T read() { return load_le<T>(readBytes(sizeof(T))); }
+
+  /*!
+   * Read the number of items of a following section. Every item needs at least `min_item_size` bytes, so counts which
+   * cannot be satisfied by the remaining data are rejected before anything is allocated for them.
+   */
+  std::uint32_t readCount(std::size_t min_item_size)
+  {
+    auto count = read<std::uint32_t>();
+    if (count > remaining() / min_item_size) throw SnapshotFormatError("Unexpected end of snapshot data");
+    return count;
+  }
+
+  std::string_view readString()
+  {
+    auto length = read<std::uint32_t>();
+    return std::string_view(readBytes(length), length);
+  }
+
+  template <typename T> std::vector<T> readArray(std::uint64_t length)
+  {
+    if (length > (size_ - position_) / sizeof(T)) throw SnapshotFormatError("Unexpected end of snapshot data");
+    std::vector<T> values(length);
+    const char *bytes = readBytes(length * sizeof(T));
+    if (host_is_little_endian())
+      {
+        std::memcpy(values.data(), bytes, length * sizeof(T));
+      }
+    else
+      {
+        for (std::uint64_t i = 0; i < length; ++i)
+          {
+            values[i] = load_le<T>(bytes + i * sizeof(T));
+          }
+      }
+    return values;
+  }
+
+  void align() { readBytes(aligned_size(position_) - position_); }
+
+  std::size_t remaining() const { return size_ - position_; }
+
+private:
+  const char *data_;
+  std::size_t size_;
+  std::size_t position_ = 0;
+};
+
+static std::shared_ptr<GRM::Element> read_tree(SnapshotReader &reader, GRM::Document &document)
+{
+  /* every name needs at least its length prefix */
+  std::vector<std::string> names(reader.readCount(sizeof(std::uint32_t)));
+  for (auto &name : names)
+    {
+      name = reader.readString();
+    }
+  reader.align();
+  std::vector<std::optional<GRM::AttributeKey>> keys(names.size());
+  auto name_at = [&names](std::uint32_t index) -> const std::string & {
+    if (index >= names.size()) throw SnapshotFormatError("Invalid name index in snapshot");
+    return names[index];
+  };
+
+  std::shared_ptr<GRM::Element> root;
+  std::vector<std::pair<std::shared_ptr<GRM::Element>, std::uint32_t>> open_elements;
+  auto element_count = reader.read<std::uint32_t>();
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    {
+      auto element = document.createElement(name_at(reader.read<std::uint32_t>()));
+      auto attribute_count = reader.read<std::uint32_t>();
+      auto child_count = reader.read<std::uint32_t>();
+      for (std::uint32_t j = 0; j < attribute_count; ++j)
+        {
+          auto name_index = reader.read<std::uint32_t>();
+          const auto &name = name_at(name_index);
+          if (!keys[name_index]) keys[name_index] = GRM::AttributeKey(name);
+          switch (reader.read<std::uint8_t>())
+            {
+            case SNAPSHOT_VALUE_INT:
+              element->setAttribute(*keys[name_index], GRM::Value(static_cast<int>(reader.read<std::int32_t>())));
+              break;
+            case SNAPSHOT_VALUE_DOUBLE:
+              element->setAttribute(*keys[name_index], GRM::Value(reader.read<double>()));
+              break;
+            case SNAPSHOT_VALUE_STRING:
+              element->setAttribute(*keys[name_index], GRM::Value(std::string(reader.readString())));
+              break;
+            default:
+              throw SnapshotFormatError("Unknown attribute type in snapshot");
+            }
+        }
+
+      if (open_elements.empty())
+        {
+          if (root != nullptr) throw SnapshotFormatError("Snapshot contains more than one root element");
+          root = element;
+        }
+      else
+        {
+          open_elements.back().first->appendChild(element);
+          --open_elements.back().second;
+        }
+      open_elements.emplace_back(element, child_count);
+      while (!open_elements.empty() && open_elements.back().second == 0)
+        {
+          open_elements.pop_back();
+        }
+    }
+  if (root == nullptr || !open_elements.empty()) throw SnapshotFormatError("Incomplete element section in snapshot");
+  reader.align();
+
+  return root;
+}
+
+typedef std::variant<std::vector<int>, std::vector<double>, std::vector<std::string>> snapshot_context_values_t;
+typedef std::vector<std::pair<std::string, snapshot_context_values_t>> snapshot_context_entries_t;
+
+static snapshot_context_entries_t read_context(SnapshotReader &reader)
+{
+  /* every entry needs at least a key length prefix, its type and its array length */
+  snapshot_context_entries_t entries(
+      reader.readCount(sizeof(std::uint32_t) + sizeof(std::uint8_t) + sizeof(std::uint64_t)));
+  for (auto &[key, values] : entries)
+    {
+      key = reader.readString();
+      auto type = reader.read<std::uint8_t>();
+      reader.align();
+      auto length = reader.read<std::uint64_t>();
+      switch (type)
+        {
+        case SNAPSHOT_VALUE_INT:
+          values = reader.readArray<int>(length);
+          break;
+        case SNAPSHOT_VALUE_DOUBLE:
+          values = reader.readArray<double>(length);
+          break;
+        case SNAPSHOT_VALUE_STRING:
+          {
+            std::vector<std::string> strings;
+            /* every string needs at least its length prefix */
+            if (length > reader.remaining() / sizeof(std::uint32_t))
+              {
+                throw SnapshotFormatError("Unexpected end of snapshot data");
+              }
+            strings.reserve(length);
+            for (std::uint64_t j = 0; j < length; ++j)
+              {
+                strings.emplace_back(reader.readString());
+              }
+            values = std::move(strings);
+          }
+          break;
+        default:
+          throw SnapshotFormatError("Unknown context type in snapshot");
+        }
+      reader.align();
+    }
+
+  return entries;
+}
+
+
+/* ######################### internal interface ##################################################################### */
+
+/* ========================= functions ============================================================================== */
+
+/* ------------------------- snapshot ------------------------------------------------------------------------------- */
+
+/*!
+ * \brief Check if snapshots can be compressed and decompressed.
+ */
+bool snapshot_zlib_available()
+{
+#ifdef HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*!
+ * \brief Check if a file object contains a graphics tree snapshot without consuming any input.
+ *
+ * Only the first byte is peeked, so this function also works on streams which do not support seeking.
+ *
+ * \param[in] file The file object to check.
+ * \return `true` if the next byte in `file` is the first byte of the snapshot magic.
+ */
+bool is_snapshot_file(FILE *file)
+{
+  int c = getc(file);
+  if (c == EOF) return false;
+  ungetc(c, file);
+  return static_cast<char>(c) == snapshot_magic[0];
+}
+
+/*!
+ * \brief Write a graphics tree and its context as a binary snapshot.
+ *
+ * \param[in] file The file object to write to.
+ * \param[in] root The root element of the graphics tree.
+ * \param[in] context The context which holds the data arrays of the graphics tree.
+ * \param[in] compress Compress the payload with zlib. Ignored (with a log message) if GRM was built without zlib.
+ * \param[in] attribute_filter An optional filter with the same semantics as the filter of `GRM::toXML`.
+ * \param[in] context_keys_to_discard Context keys which will be excluded from the snapshot. The set is read after
+ *                                    the graphics tree has been serialized, so it can be filled by `attribute_filter`.
+ * \return ERROR_NONE on success, an error code on failure.
+ */
+err_t snapshot_write(FILE *file, const GRM::Element &root, GRM::Context &context, bool compress,
+                     const snapshot_attribute_filter_t &attribute_filter,
+                     const std::unordered_set<std::string> *context_keys_to_discard)
+{
+  std::vector<char> header;
+  SnapshotPayload payload;
+  std::vector<char> compressed;
+  std::uint32_t flags = 0;
+
+  try
+    {
+      SnapshotTreeWriter tree_writer(attribute_filter);
+      tree_writer.writeElement(root);
+      tree_writer.writeTo(payload);
+      write_context(payload, context, context_keys_to_discard);
+    }
+  catch (const std::length_error &e)
+    {
+      logger((stderr, "%s\n", e.what()));
+      return ERROR_UNSUPPORTED_DATATYPE;
+    }
+  catch (const std::bad_alloc &)
+    {
+      return ERROR_MALLOC;
+    }
+
+  auto payload_size = payload.size();
+  const auto *blocks = &payload.blocks();
+  std::vector<std::pair<const char *, std::size_t>> compressed_blocks;
+  if (compress)
+    {
+#ifdef HAVE_ZLIB
+      err_t error = compress_payload(*blocks, compressed);
+      if (error != ERROR_NONE) return error;
+      compressed_blocks.push_back({compressed.data(), compressed.size()});
+      blocks = &compressed_blocks;
+      flags |= snapshot_flag_zlib;
+#else
+      logger((stderr, "GRM was built without zlib, the snapshot is stored uncompressed\n"));
+#endif
+    }
+
+  header.insert(header.end(), snapshot_magic, snapshot_magic + sizeof(snapshot_magic));
+  append_le<std::uint32_t>(header, snapshot_version);
+  append_le<std::uint32_t>(header, flags);
+  append_le<std::uint64_t>(header, payload_size);
+  append_le<std::uint64_t>(header, (flags & snapshot_flag_zlib) ? compressed.size() : payload_size);
+  if (fwrite(header.data(), 1, header.size(), file) != header.size()) return ERROR_SNAPSHOT_IO;
+  for (const auto &block : *blocks)
+    {
+      if (fwrite(block.first, 1, block.second, file) != block.second) return ERROR_SNAPSHOT_IO;
+    }
+
+  return ERROR_NONE;
+}
+
+/*!
+ * \brief Read a graphics tree snapshot.
+ *
+ * The tree is created with `document`, but not inserted into it. The data arrays are stored in `context`, existing
+ * entries with the same keys are replaced.
+ *
+ * \param[in] file The file object to read from. Regular files are mapped into memory.
+ * \param[in] document The document which creates the elements of the tree.
+ * \param[in] context The context which receives the data arrays.
+ * \param[out] root The root element of the loaded tree.
+ * \return ERROR_NONE on success, an error code on failure.
+ */
+err_t snapshot_read(FILE *file, GRM::Document &document, GRM::Context &context, std::shared_ptr<GRM::Element> &root)
+{
+  try
+    {
+      SnapshotSource source(file);
+      if (source.size() < snapshot_header_size ||
+          std::memcmp(source.data(), snapshot_magic, sizeof(snapshot_magic)) != 0)
+        {
+          return ERROR_SNAPSHOT_INVALID_FORMAT;
+        }
+      auto version = load_le<std::uint32_t>(source.data() + 8);
+      auto flags = load_le<std::uint32_t>(source.data() + 12);
+      auto payload_size = load_le<std::uint64_t>(source.data() + 16);
+      auto stored_size = load_le<std::uint64_t>(source.data() + 24);
+      if (version != snapshot_version || stored_size != source.size() - snapshot_header_size)
+        {
+          return ERROR_SNAPSHOT_INVALID_FORMAT;
+        }
+
+      const char *payload = source.data() + snapshot_header_size;
+      std::vector<char> decompressed;
+      if (flags & snapshot_flag_zlib)
+        {
+#ifdef HAVE_ZLIB
+          /* payload sizes which cannot be reached by decompressing the stored data are rejected before allocating */
+          if (payload_size / snapshot_zlib_max_ratio > stored_size) return ERROR_SNAPSHOT_INVALID_FORMAT;
+          decompressed.resize(payload_size);
+          err_t error = decompress_payload(payload, stored_size, decompressed);
+          if (error != ERROR_NONE) return error;
+          payload = decompressed.data();
+#else
+          logger((stderr, "GRM was built without zlib, compressed snapshots cannot be read\n"));
+          return ERROR_SNAPSHOT_COMPRESSION;
+#endif
+        }
+      else if (payload_size != stored_size)
+        {
+          return ERROR_SNAPSHOT_INVALID_FORMAT;
+        }
+
+      SnapshotReader reader(payload, payload_size);
+      auto loaded_root = read_tree(reader, document);
+      auto context_entries = read_context(reader);
+      if (reader.remaining() != 0) return ERROR_SNAPSHOT_INVALID_FORMAT;
+      /* the context is only modified after the whole snapshot has been parsed successfully */
+      for (auto &[key, values] : context_entries)
+        {
+          std::visit([&context, &key = key](auto &vec) { context[key] = std::move(vec); }, values);
+        }
+      root = loaded_root;
+    }
+  catch (const SnapshotFormatError &e)
+    {
+      logger((stderr, "%s\n", e.what()));
+      return ERROR_SNAPSHOT_INVALID_FORMAT;
+    }
+  catch (const std::bad_alloc &)
+    {
+      return ERROR_MALLOC;
+    }
+  catch (const std::runtime_error &e)
+    {
+      logger((stderr, "%s\n", e.what()));
+      return ERROR_SNAPSHOT_IO;
+    }
+  catch (const std::exception &e)
+    {
+      /* e.g. a hierarchy error of the graphics tree or too many attribute names */
+      logger((stderr, "%s\n", e.what()));
+      return ERROR_SNAPSHOT_INVALID_FORMAT;
+    }
+
+  return ERROR_NONE;
+}
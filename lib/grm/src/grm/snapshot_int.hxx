@@ -0,0 +1,56 @@
+#ifndef GRM_SNAPSHOT_INT_HXX_INCLUDED
+#define GRM_SNAPSHOT_INT_HXX_INCLUDED
+
+/* ######################### includes ############################################################################### */
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+
+#include <grm/dom_render/context.hxx>
+#include <grm/dom_render/graphics_tree/Document.hxx>
+#include <grm/dom_render/graphics_tree/Element.hxx>
+#include <grm/error.h>
+
+
+/* ######################### internal interface ##################################################################### */
+
+/* ========================= datatypes ============================================================================== */
+
+/* ------------------------- snapshot ------------------------------------------------------------------------------- */
+
+/*!
+ * A graphics tree snapshot is a binary alternative to the XML export. All numbers are stored little endian:
+ *
+ * - A 32 byte header: the magic bytes `\x89GRM\r\n\x1a\n`, a format version (u32), flags (u32), the size of the
+ *   uncompressed payload (u64) and the size of the stored payload (u64). If bit 0 of the flags is set, the payload is
+ *   compressed as one zlib stream.
+ * - A string table with all element and attribute names (u32 count, then u32 length and bytes for each name).
+ * - The element section: the elements of the tree in pre-order, each as tag name index (u32), attribute count (u32)
+ *   and child element count (u32), followed by its attributes (name index (u32), type (u8) and an i32, f64 or a
+ *   length prefixed string).
+ * - The context section: u32 entry count, then for each entry its key, its type (u8) and its element count (u64),
+ *   followed by the raw array data. Numeric arrays are aligned to 8 bytes relative to the payload start, so an
+ *   uncompressed snapshot can be mapped into memory and each array is copied into the context with a single `memcpy`.
+ */
+
+typedef std::function<bool(const std::string &attribute_name, const GRM::Element &element,
+                           std::optional<std::string> &new_attribute_name)>
+    snapshot_attribute_filter_t;
+
+
+/* ========================= functions ============================================================================== */
+
+/* ------------------------- snapshot ------------------------------------------------------------------------------- */
+
+bool snapshot_zlib_available();
+bool is_snapshot_file(FILE *file);
+err_t snapshot_write(FILE *file, const GRM::Element &root, GRM::Context &context, bool compress,
+                     const snapshot_attribute_filter_t &attribute_filter = nullptr,
+                     const std::unordered_set<std::string> *context_keys_to_discard = nullptr);
+err_t snapshot_read(FILE *file, GRM::Document &document, GRM::Context &context, std::shared_ptr<GRM::Element> &root);
+
+#endif /* ifndef GRM_SNAPSHOT_INT_HXX_INCLUDED */
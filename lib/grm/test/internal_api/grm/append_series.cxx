@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <grm.h>
+#include <grm/args_int.h>
+#include <grm/plot_int.h>
+#include "test.h"
+
+
+#define N 10
+#define WINDOW 50
+#define ROUNDS 200
+#define COUNT 3
+
+static std::vector<double> series_values(const char *attribute)
+{
+  auto render = grm_get_render();
+  auto series = render->querySelectors("series_line");
+  assert(series != nullptr && series->hasAttribute(attribute));
+  auto key = static_cast<std::string>(series->getAttribute(attribute));
+  auto values = GRM::get_span<double>((*render->getContext())[key]);
+  return std::vector<double>(values.begin(), values.end());
+}
+
+static void test_rejected_append(const grm_args_t *append_args)
+{
+  char *plot_json = grm_dump_json_str();
+  assert(!grm_append(append_args));
+  char *unchanged_plot_json = grm_dump_json_str();
+  assert(strcmp(plot_json, unchanged_plot_json) == 0);
+  free(plot_json);
+  free(unchanged_plot_json);
+}
+
+static void test_args_window()
+{
+  /* a rolling window keeps exactly the last values, also when the dropped values are moved out of the allocation */
+  double values[COUNT], *stored_values;
+  unsigned int length;
+  grm_args_t *args = grm_args_new();
+  grm_args_push(args, "x", "nD", 0, values);
+  arg_t *arg = args_at_writable(args, "x");
+  assert(arg != nullptr);
+  for (int round = 0; round < ROUNDS; ++round)
+    {
+      for (int i = 0; i < COUNT; ++i) values[i] = round * COUNT + i;
+      assert(arg_append_array(arg, values, COUNT, WINDOW) == ERROR_NONE);
+      assert(grm_args_first_value(args, "x", "D", &stored_values, &length));
+      int expected_length = (round + 1) * COUNT < WINDOW ? (round + 1) * COUNT : WINDOW;
+      assert(static_cast<int>(length) == expected_length);
+      for (int i = 0; i < expected_length; ++i)
+        {
+          assert(stored_values[i] == (round + 1) * COUNT - expected_length + i);
+        }
+    }
+  /* more values than the window size only keep the last values */
+  double many_values[2 * WINDOW];
+  for (int i = 0; i < 2 * WINDOW; ++i) many_values[i] = -i;
+  assert(arg_append_array(arg, many_values, 2 * WINDOW, WINDOW) == ERROR_NONE);
+  assert(grm_args_first_value(args, "x", "D", &stored_values, &length));
+  assert(length == WINDOW && stored_values[0] == -WINDOW && stored_values[WINDOW - 1] == -(2 * WINDOW - 1));
+  /* growing the array afterwards must keep the values */
+  assert(arg_increase_array(arg, 1) == ERROR_NONE);
+  assert(grm_args_first_value(args, "x", "D", &stored_values, &length));
+  assert(length == WINDOW + 1 && stored_values[0] == -WINDOW);
+  grm_args_delete(args);
+}
+
+static void test_context_window()
+{
+  /* reading a rolling window through a const accessor must not move the stored values which spans refer to */
+  double values[COUNT];
+  GRM::Context context;
+  const GRM::Context &const_context = context;
+  for (int round = 0; round < ROUNDS; ++round)
+    {
+      for (int i = 0; i < COUNT; ++i) values[i] = round * COUNT + i;
+      auto modification_count = context.getModificationCount();
+      context.appendDoubles("x", values, COUNT, WINDOW);
+      assert(context.getModificationCount() > modification_count);
+      auto span = GRM::get_span<double>(const_context["x"]);
+      const auto &window = GRM::get<std::vector<double>>(const_context["x"]);
+      assert(window.size() == span.size() && std::equal(window.begin(), window.end(), span.begin()));
+      assert(span.back() == values[COUNT - 1]);
+    }
+  /* non-const accessors erase the dropped values */
+  auto &vec = GRM::get<std::vector<double>>(context["x"]);
+  assert(vec.size() == WINDOW && vec.back() == values[COUNT - 1]);
+}
+
+static void test_append()
+{
+  double x[N], y[N], appended_x[COUNT], appended_y[COUNT];
+  int x_int[N];
+  grm_args_t *args, *append_args;
+
+  for (int i = 0; i < N; ++i)
+    {
+      x[i] = i;
+      y[i] = i * i;
+    }
+  args = grm_args_new();
+  grm_args_push(args, "x", "nD", N, x);
+  grm_args_push(args, "y", "nD", N, y);
+  grm_plot(args);
+  assert(series_values("x").size() == N);
+
+  /* the context of a rendered series is updated in place and keeps the last `window` points */
+  append_args = grm_args_new();
+  grm_args_push(append_args, "window", "i", WINDOW);
+  for (int round = 0; round < ROUNDS; ++round)
+    {
+      for (int i = 0; i < COUNT; ++i)
+        {
+          appended_x[i] = N + round * COUNT + i;
+          appended_y[i] = -appended_x[i];
+        }
+      grm_args_push(append_args, "x", "nD", COUNT, appended_x);
+      grm_args_push(append_args, "y", "nD", COUNT, appended_y);
+      assert(grm_append(append_args));
+      std::vector<double> x_values = series_values("x"), y_values = series_values("y");
+      int expected_length = N + (round + 1) * COUNT < WINDOW ? N + (round + 1) * COUNT : WINDOW;
+      assert(static_cast<int>(x_values.size()) == expected_length && y_values.size() == x_values.size());
+      assert(x_values.back() == appended_x[COUNT - 1] && y_values.back() == appended_y[COUNT - 1]);
+      assert(x_values.front() == N + (round + 1) * COUNT - expected_length);
+    }
+
+  /* appending needs double arrays, a rejected append must not change any of the arrays */
+  for (int i = 0; i < N; ++i) x_int[i] = i;
+  grm_args_push(args, "y", "nI", N, x_int);
+  grm_merge(args);
+  test_rejected_append(append_args);
+  grm_args_push(args, "x", "nI", N, x_int);
+  grm_args_push(args, "y", "nD", N, y);
+  grm_merge(args);
+  test_rejected_append(append_args);
+
+  /* x and y of different lengths are rejected */
+  grm_args_push(args, "x", "nD", N, x);
+  grm_merge(args);
+  grm_args_push(append_args, "y", "nD", COUNT - 1, appended_y);
+  test_rejected_append(append_args);
+
+  grm_args_delete(append_args);
+  grm_args_delete(args);
+}
+
+void test()
+{
+  putenv(const_cast<char *>("GKS_WSTYPE=nul"));
+  test_args_window();
+  test_context_window();
+  test_append();
+  grm_finalize();
+}
+
+DEFINE_TEST_MAIN
@@ -4,6 +4,7 @@
 #endif
 
 #include <assert.h>
+#include <limits.h>
 #include <ftw.h>
 #include <signal.h>
 #include <string.h>
@@ -162,6 +163,67 @@ static void test_bson()
   grm_args_delete(args);
 }
 
+static char *find_element(char *bson_buffer, int bson_buffer_size, char type, const char *key)
+{
+  /* Return the position after the type byte and the key of the element `key` */
+  int i, key_size = strlen(key) + 1;
+
+  for (i = 0; i + 1 + key_size <= bson_buffer_size; ++i)
+    {
+      if (bson_buffer[i] == type && memcmp(bson_buffer + i + 1, key, key_size) == 0)
+        {
+          return bson_buffer + i + 1 + key_size;
+        }
+    }
+  assert(0);
+  return NULL;
+}
+
+static void test_corrupted_bson()
+{
+  double y_d[] = {5.05, 5.05, 5.05};
+  char *bson_buffer, *length_bytes;
+  grm_args_t *args, *subarg, *read_args;
+  memwriter_t *memwriter;
+  int bson_buffer_size, length, i;
+
+  args = grm_args_new();
+  subarg = grm_args_new();
+  grm_args_push(subarg, "y_D", "nD", sizeof(y_d) / sizeof(y_d[0]), y_d);
+  grm_args_push(args, "sub", "a", subarg);
+
+  memwriter = memwriter_new();
+  assert(memwriter != NULL);
+  tobson_write_args(memwriter, args);
+  assert(tobson_is_complete());
+  bson_buffer = memwriter_buf(memwriter);
+  bytes_to_int(&bson_buffer_size, bson_buffer);
+
+  /* lengths which exceed the enclosing object are rejected instead of reading beyond the document */
+  for (i = 0; i < 2; ++i)
+    {
+      char *length_ptr = (i == 0) ? find_element(bson_buffer, bson_buffer_size, 0x05, "y_D")
+                                  : find_element(bson_buffer, bson_buffer_size, 0x03, "sub");
+      bytes_to_int(&length, length_ptr);
+      int_to_bytes(INT_MAX, &length_bytes);
+      memcpy(length_ptr, length_bytes, sizeof(int));
+      free(length_bytes);
+      read_args = grm_args_new();
+      assert(frombson_read(read_args, bson_buffer) != ERROR_NONE);
+      grm_args_delete(read_args);
+      int_to_bytes(length, &length_bytes);
+      memcpy(length_ptr, length_bytes, sizeof(int));
+      free(length_bytes);
+    }
+
+  read_args = grm_args_new();
+  assert(frombson_read(read_args, bson_buffer) == ERROR_NONE);
+  grm_args_delete(read_args);
+
+  memwriter_delete(memwriter);
+  grm_args_delete(args);
+}
+
 int main(void)
 {
   signal(SIGINT, signal_handler);
@@ -174,6 +236,7 @@ int main(void)
   assert(tmp_dir != NULL);
 
   test_bson();
+  test_corrupted_bson();
 
   grm_finalize();
 
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <grm.h>
+#include <grm/base64_int.h>
+#include <grm/plot_int.h>
+#include "test.h"
+
+
+static const std::string key = "deferred_values";
+
+static std::string encode(const std::string &bson)
+{
+  err_t error = ERROR_NONE;
+  char *encoded = base64_encode(nullptr, bson.data(), bson.size(), &error);
+  assert(error == ERROR_NONE);
+  std::string encoded_str(encoded);
+  free(encoded);
+  return encoded_str;
+}
+
+static std::string decode(const std::string &encoded)
+{
+  err_t error = ERROR_NONE;
+  size_t size;
+  char *decoded = base64_decode(nullptr, encoded.c_str(), &size, &error);
+  assert(error == ERROR_NONE);
+  std::string decoded_str(decoded, size);
+  free(decoded);
+  return decoded_str;
+}
+
+static size_t find_value(const std::string &bson)
+{
+  /* Return the position of the value of the binary element `key` (a type byte followed by the key) */
+  std::string element_start = std::string(1, 0x05) + key + std::string(1, '\0');
+  size_t position = bson.find(element_start);
+  assert(position != std::string::npos);
+  return position + element_start.size();
+}
+
+void test()
+{
+  const std::vector<double> values = {1.5, 2.5, 3.5};
+  std::unordered_set<std::string> context_keys_to_discard;
+  double x[] = {0.0, 1.0, 2.0}, y[] = {1.0, 0.0, 1.0};
+  grm_args_t *args;
+
+  putenv(const_cast<char *>("GKS_WSTYPE=nul"));
+  args = grm_args_new();
+  grm_args_push(args, "x", "nD", 3, x);
+  grm_args_push(args, "y", "nD", 3, y);
+  grm_merge(args);
+  (*grm_get_render()->getContext())[key] = values;
+  char *context_str = dump_context_str(DUMP_BSON_BASE64, &context_keys_to_discard);
+  assert(context_str != nullptr);
+  std::string bson = decode(context_str);
+  free(context_str);
+
+  /* entries are decoded on first access and match the dumped values */
+  {
+    GRM::Context context;
+    load_context_str_deferred(context, encode(bson));
+    auto loaded_values = GRM::get_if<std::vector<double>>(context[key]);
+    assert(loaded_values != nullptr);
+    assert(*loaded_values == values);
+  }
+
+  /* a negative element length is rejected when the document is scanned */
+  {
+    std::string broken_bson = bson;
+    std::fill_n(broken_bson.begin() + find_value(broken_bson), sizeof(int), '\xff');
+    GRM::Context context;
+    bool rejected = false;
+    try
+      {
+        load_context_str_deferred(context, encode(broken_bson));
+      }
+    catch (const std::runtime_error &)
+      {
+        rejected = true;
+      }
+    assert(rejected);
+  }
+
+  /* an element which cannot be decoded is left out of the context instead of throwing during the access */
+  {
+    std::string broken_bson = bson;
+    /* the binary subtype follows the element length */
+    broken_bson[find_value(broken_bson) + sizeof(int)] = '\0';
+    GRM::Context context;
+    load_context_str_deferred(context, encode(broken_bson));
+    assert(GRM::get_if<std::vector<double>>(context[key]) == nullptr);
+  }
+
+  grm_args_delete(args);
+  grm_finalize();
+}
+
+DEFINE_TEST_MAIN
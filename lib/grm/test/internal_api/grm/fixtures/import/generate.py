@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Generate the binary data files used by `import_binary_data.cxx`.
+
+The files are written in the layout of `numpy.save` and `numpy.savez` without depending on NumPy. All files contain the
+columns x = [0, 1, 2, 3] and y = [-3, -1, 1, 3] (the unsigned arrays use y + 3).
+"""
+
+import os
+import struct
+import zipfile
+import zlib
+
+X = [0, 1, 2, 3]
+Y = [-3, -1, 1, 3]
+
+
+STRUCT_TYPES = {"f8": "d", "f4": "f", "i4": "i", "u2": "H", "i1": "b"}
+
+
+def npy(descr, shape, values, fortran_order=False):
+    """Return an array in the `.npy` format version 1.0 with a header which is padded to 64 bytes."""
+    shape_string = ", ".join("%d" % dimension for dimension in shape) + ("," if len(shape) == 1 else "")
+    header = "{'descr': '%s', 'fortran_order': %s, 'shape': (%s), }" % (descr, fortran_order, shape_string)
+    header += " " * (63 - (10 + len(header)) % 64) + "\n"
+    byte_order = ">" if descr[0] == ">" else "<"
+    data = struct.pack("%s%d%s" % (byte_order, len(values), STRUCT_TYPES[descr[1:]]), *values)
+    return b"\x93NUMPY\x01\x00" + struct.pack("<H", len(header)) + header.encode() + data
+
+
+def write_npy(name, descr, shape, values, fortran_order=False):
+    with open(name, "wb") as f:
+        f.write(npy(descr, shape, values, fortran_order))
+
+
+def write_npz(name, members, compression):
+    with zipfile.ZipFile(name, "w", compression) as archive:
+        for member_name, data in members:
+            # a fixed time stamp keeps the generated files unchanged
+            archive.writestr(zipfile.ZipInfo(member_name, date_time=(2024, 1, 1, 0, 0, 0)), data, compression)
+
+
+def write_oversized_npz(name, members):
+    """Write a compressed archive whose central directory claims an uncompressed size which deflate cannot produce."""
+    write_npz(name, members, zipfile.ZIP_DEFLATED)
+    with open(name, "r+b") as f:
+        contents = f.read()
+        f.seek(contents.index(struct.pack("<I", 0x02014B50)) + 24)
+        f.write(struct.pack("<I", 0x7FFFFFFF))
+
+
+def write_zip64_npz(name, members):
+    """Write a stored archive whose sizes, offsets and entry count are only given in the zip64 records."""
+    local_headers, central_directory = b"", b""
+    for member_name, data in members:
+        crc = zlib.crc32(data)
+        extra = struct.pack("<HHQQ", 1, 16, len(data), len(data))
+        offset = len(local_headers)
+        local_headers += struct.pack(
+            "<IHHHHHIIIHH", 0x04034B50, 45, 0, 0, 0, 0, crc, 0xFFFFFFFF, 0xFFFFFFFF, len(member_name), len(extra)
+        )
+        local_headers += member_name.encode() + extra + data
+        extra = struct.pack("<HHQQQ", 1, 24, len(data), len(data), offset)
+        central_directory += struct.pack(
+            "<IHHHHHHIIIHHHHHII",
+            0x02014B50,
+            45,
+            45,
+            0,
+            0,
+            0,
+            0,
+            crc,
+            0xFFFFFFFF,
+            0xFFFFFFFF,
+            len(member_name),
+            len(extra),
+            0,
+            0,
+            0,
+            0,
+            0xFFFFFFFF,
+        )
+        central_directory += member_name.encode() + extra
+    record_offset = len(local_headers) + len(central_directory)
+    record = struct.pack(
+        "<IQHHIIQQQQ",
+        0x06064B50,
+        44,
+        45,
+        45,
+        0,
+        0,
+        len(members),
+        len(members),
+        len(central_directory),
+        len(local_headers),
+    )
+    locator = struct.pack("<IIQI", 0x07064B50, 0, record_offset, 1)
+    end = struct.pack("<IHHHHIIH", 0x06054B50, 0, 0, 0xFFFF, 0xFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0)
+    with open(name, "wb") as f:
+        f.write(local_headers + central_directory + record + locator + end)
+
+
+def write_raw(name, kind, blocks, labels):
+    labels = labels.encode()
+    rows = len(blocks[0][0])
+    header = b"GRMRAW\x01" + kind.encode() + struct.pack("<IIQQ", len(blocks[0]), len(blocks), rows, len(labels))
+    values = b"".join(struct.pack("<%d%s" % (rows, kind), *column) for block in blocks for column in block)
+    with open(name, "wb") as f:
+        f.write(header + labels + b"\0" * (-len(labels) % 8) + values)
+
+
+def main():
+    os.chdir(os.path.dirname(os.path.abspath(__file__)))
+    columns = [value for row in zip(X, Y) for value in row]
+    write_npy("c_order_f8.npy", "<f8", (4, 2), columns)
+    write_npy("fortran_order_i4.npy", "<i4", (4, 2), X + Y, fortran_order=True)
+    write_npy("blocks_f4.npy", "<f4", (2, 4, 2), columns + [value + 10 for value in columns])
+    write_npy("big_endian_f8.npy", ">f8", (4,), X)
+    members = [
+        ("x.npy", npy("<f8", (4,), X)),
+        ("y.npy", npy("<u2", (4,), [value + 3 for value in Y])),
+        ("m.npy", npy("|i1", (4, 2), columns)),
+    ]
+    write_npz("stored.npz", members, zipfile.ZIP_STORED)
+    write_npz("deflated.npz", members, zipfile.ZIP_DEFLATED)
+    write_zip64_npz("zip64.npz", members)
+    write_oversized_npz("oversized.npz", members)
+    blocks = ("b.npy", npy("<f4", (2, 4, 2), columns + [value + 10 for value in columns]))
+    write_npz("mixed_3d_first.npz", [blocks, members[2]], zipfile.ZIP_STORED)
+    write_npz("mixed_3d_last.npz", [members[2], blocks], zipfile.ZIP_STORED)
+    write_raw("blocks_d.grmraw", "d", [[X, Y], [[value + 10 for value in X], [value + 10 for value in Y]]], "x\ty")
+    write_raw("single_block_f.grmraw", "f", [[X, Y]], "")
+
+
+if __name__ == "__main__":
+    main()
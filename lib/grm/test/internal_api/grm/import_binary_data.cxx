@@ -0,0 +1,150 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <grm.h>
+#include <grm/import_int.hxx>
+#include "test.h"
+
+
+/* the fixtures are created by `fixtures/import/generate.py` */
+static const std::string fixture_dir = TEST_FIXTURE_DIR "/import/";
+static const std::vector<double> x = {0, 1, 2, 3}, y = {-3, -1, 1, 3}, y_unsigned = {0, 2, 4, 6};
+static std::string tmp_dir;
+
+static std::string create_tmp_dir()
+{
+  const char *system_tmp_dir = getenv("TMPDIR");
+  std::string dirname =
+      std::string(system_tmp_dir != nullptr ? system_tmp_dir : "/tmp") + "/grm.import_binary_data.XXXXXX";
+
+  assert(mkdtemp(&dirname[0]) != nullptr);
+  return dirname;
+}
+
+static err_t load(const std::string &path, std::vector<std::vector<std::vector<double>>> &data,
+                  std::vector<std::string> &labels, const char *columns = "")
+{
+  std::vector<int> x_data, y_data, error_data;
+  PlotRange ranges = {INFINITY, INFINITY, INFINITY, INFINITY, INFINITY, INFINITY};
+
+  data.clear();
+  labels.clear();
+  return read_data_file(path, data, x_data, y_data, error_data, labels, nullptr, columns, "", "", "", &ranges);
+}
+
+static std::vector<double> shifted(const std::vector<double> &values, double offset)
+{
+  std::vector<double> shifted_values;
+  for (auto value : values) shifted_values.push_back(value + offset);
+  return shifted_values;
+}
+
+static void test_truncated(const std::string &name)
+{
+  /* a file which ends early must be rejected instead of reading beyond the mapping */
+  std::string truncated_path = tmp_dir + "/truncated";
+  std::vector<std::vector<std::vector<double>>> data;
+  std::vector<std::string> labels;
+  std::vector<char> contents(4096);
+  FILE *file;
+  size_t size;
+
+  file = fopen((fixture_dir + name).c_str(), "rb");
+  assert(file != nullptr);
+  size = fread(contents.data(), 1, contents.size(), file);
+  fclose(file);
+  assert(size > 0 && size < contents.size());
+  file = fopen(truncated_path.c_str(), "wb");
+  assert(file != nullptr);
+  assert(fwrite(contents.data(), 1, size - 1, file) == size - 1);
+  fclose(file);
+  assert(load(truncated_path, data, labels) != ERROR_NONE);
+  remove(truncated_path.c_str());
+}
+
+static void test_npy()
+{
+  std::vector<std::vector<std::vector<double>>> data;
+  std::vector<std::string> labels;
+
+  for (const char *name : {"c_order_f8.npy", "fortran_order_i4.npy"})
+    {
+      assert(load(fixture_dir + name, data, labels) == ERROR_NONE);
+      assert(data.size() == 1 && data[0].size() == 2);
+      assert(data[0][0] == x && data[0][1] == y);
+      assert(labels.empty());
+      test_truncated(name);
+    }
+
+  /* three-dimensional arrays contain several blocks */
+  assert(load(fixture_dir + "blocks_f4.npy", data, labels) == ERROR_NONE);
+  assert(data.size() == 2 && data[0].size() == 2 && data[1].size() == 2);
+  assert(data[0][0] == x && data[0][1] == y);
+  assert(data[1][0] == shifted(x, 10) && data[1][1] == shifted(y, 10));
+
+  /* only the selected columns are read */
+  assert(load(fixture_dir + "c_order_f8.npy", data, labels, "1") == ERROR_NONE);
+  assert(data.size() == 1 && data[0].size() == 1 && data[0][0] == y);
+
+  assert(load(fixture_dir + "big_endian_f8.npy", data, labels) == ERROR_UNSUPPORTED_DATATYPE);
+}
+
+static void test_npz()
+{
+  std::vector<std::vector<std::vector<double>>> data;
+  std::vector<std::string> labels;
+
+  for (const char *name : {"stored.npz", "deflated.npz", "zip64.npz"})
+    {
+      err_t error = load(fixture_dir + name, data, labels);
+      /* compressed archives can only be read if GRM was built with zlib */
+      if (error == ERROR_UNSUPPORTED_OPERATION && std::string(name) == "deflated.npz") continue;
+      assert(error == ERROR_NONE);
+      assert(data.size() == 1 && data[0].size() == 4);
+      assert(data[0][0] == x && data[0][1] == y_unsigned && data[0][2] == x && data[0][3] == y);
+      assert((labels == std::vector<std::string>{"x", "y", "m[0]", "m[1]"}));
+      test_truncated(name);
+    }
+
+  /* the blocks of a three-dimensional array cannot be combined with other members, regardless of their order */
+  for (const char *name : {"mixed_3d_first.npz", "mixed_3d_last.npz"})
+    {
+      assert(load(fixture_dir + name, data, labels) == ERROR_UNSUPPORTED_DATATYPE);
+    }
+
+  /* an uncompressed size which deflate cannot produce is rejected before the member is allocated */
+  err_t error = load(fixture_dir + "oversized.npz", data, labels);
+  assert(error == ERROR_IMPORT_INVALID_FORMAT || error == ERROR_UNSUPPORTED_OPERATION);
+}
+
+static void test_raw()
+{
+  std::vector<std::vector<std::vector<double>>> data;
+  std::vector<std::string> labels;
+
+  assert(load(fixture_dir + "blocks_d.grmraw", data, labels) == ERROR_NONE);
+  assert(data.size() == 2 && data[0].size() == 2 && data[1].size() == 2);
+  assert(data[0][0] == x && data[0][1] == y);
+  assert(data[1][0] == shifted(x, 10) && data[1][1] == shifted(y, 10));
+  assert((labels == std::vector<std::string>{"x", "y"}));
+  test_truncated("blocks_d.grmraw");
+
+  assert(load(fixture_dir + "single_block_f.grmraw", data, labels) == ERROR_NONE);
+  assert(data.size() == 1 && data[0].size() == 2 && data[0][0] == x && data[0][1] == y);
+  assert(labels.empty());
+  test_truncated("single_block_f.grmraw");
+}
+
+void test()
+{
+  tmp_dir = create_tmp_dir();
+  test_npy();
+  test_npz();
+  test_raw();
+  remove(tmp_dir.c_str());
+}
+
+DEFINE_TEST_MAIN
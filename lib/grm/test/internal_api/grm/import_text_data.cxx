@@ -0,0 +1,85 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grm.h>
+#include <grm/dom_render/context.hxx>
+#include "test.h"
+
+
+#define ROW_COUNT 200000
+
+static std::string tmp_dir, path;
+
+static std::string create_tmp_dir()
+{
+  const char *system_tmp_dir = getenv("TMPDIR");
+  std::string dirname =
+      std::string(system_tmp_dir != nullptr ? system_tmp_dir : "/tmp") + "/grm.import_text_data.XXXXXX";
+
+  assert(mkdtemp(&dirname[0]) != nullptr);
+  return dirname;
+}
+
+static bool load(const std::string &contents, std::shared_ptr<GRM::Context> &context)
+{
+  FILE *file = fopen(path.c_str(), "wb");
+  assert(file != nullptr);
+  assert(fwrite(contents.data(), 1, contents.size(), file) == contents.size());
+  fclose(file);
+  context = std::make_shared<GRM::Context>();
+  return grm_context_data_from_file(context, path);
+}
+
+static std::vector<double> column(const std::shared_ptr<GRM::Context> &context, const std::string &name)
+{
+  auto values = GRM::get_if<std::vector<double>>((*context)[name]);
+  assert(values != nullptr);
+  return *values;
+}
+
+void test()
+{
+  std::shared_ptr<GRM::Context> context;
+  std::string contents;
+
+  tmp_dir = create_tmp_dir();
+  path = tmp_dir + "/data.dat";
+  /* comma separated rows may contain empty fields, a trailing comma and CRLF line endings */
+  assert(load("a\tb\tc\r\n1,,3\r\n4,5,6,\r\n", context));
+  assert((column(context, "a") == std::vector<double>{1, 4}));
+  assert(std::isnan(column(context, "b")[0]) && column(context, "b")[1] == 5);
+  assert((column(context, "c") == std::vector<double>{3, 6}));
+
+  /* all rows need the same number of columns as the first data row */
+  assert(load("a\tb\tc\n1 2 3\n4 5 6\n", context));
+  assert(!load("a\tb\tc\n1 2 3\n4 5\n", context));
+  assert(!load("a\tb\tc\n1 2 3\n4 5 6 7\n", context));
+  assert(!load("a\tb\tc\n1 2 3\n4 x 6\n", context));
+
+  /* large files are split into chunks which are parsed in parallel */
+  contents = "a\tb\n";
+  for (int row = 0; row < ROW_COUNT; ++row)
+    {
+      contents += std::to_string(row) + " " + std::to_string(row * 0.5) + "\n";
+    }
+  assert(load(contents, context));
+  std::vector<double> a = column(context, "a"), b = column(context, "b");
+  assert(a.size() == ROW_COUNT && b.size() == ROW_COUNT);
+  for (int row = 0; row < ROW_COUNT; ++row)
+    {
+      assert(a[row] == row && b[row] == row * 0.5);
+    }
+  /* an invalid row in a later chunk must be reported, too */
+  contents.insert(contents.find('\n', contents.size() * 3 / 4) + 1, "1 2 3\n");
+  assert(!load(contents, context));
+
+  remove(path.c_str());
+  remove(tmp_dir.c_str());
+  grm_finalize();
+}
+
+DEFINE_TEST_MAIN
@@ -0,0 +1,136 @@
+#ifdef __unix__
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <grm.h>
+#include "grm/json_int.h"
+#include "grm/memwriter_int.h"
+#include "grm/util_int.h"
+#include "test.h"
+
+#define N 100
+
+static char *args_to_json(grm_args_t *args)
+{
+  memwriter_t *memwriter;
+  char *json_string;
+
+  memwriter = memwriter_new();
+  assert(memwriter != NULL);
+  assert(tojson_write_args(memwriter, args) == ERROR_NONE);
+  assert(memwriter_putc(memwriter, '\0') == ERROR_NONE);
+  json_string = malloc(memwriter_size(memwriter));
+  assert(json_string != NULL);
+  memcpy(json_string, memwriter_buf(memwriter), memwriter_size(memwriter));
+  memwriter_delete(memwriter);
+
+  return json_string;
+}
+
+static err_t read_byte_by_byte(grm_args_t *args, const char *json_string)
+{
+  fromjson_stream_t *stream;
+  size_t i, length = strlen(json_string);
+  err_t error = ERROR_NONE;
+
+  stream = fromjson_stream_new(args);
+  assert(stream != NULL);
+  for (i = 0; i < length && error == ERROR_NONE; ++i)
+    {
+      error = fromjson_stream_feed(stream, json_string + i, 1);
+    }
+  if (error == ERROR_NONE)
+    {
+      error = fromjson_stream_finish(stream);
+    }
+  fromjson_stream_delete(stream);
+
+  return error;
+}
+
+static void test_round_trip(void)
+{
+  double x[N], y[N];
+  int n[N];
+  const char *labels[] = {"first \"label\"", "second\\label", "\xc3\xa4\xe2\x82\xac"};
+  char *json_string, *read_json_string;
+  grm_args_t *args, *subplot, *read_args;
+  int i;
+
+  for (i = 0; i < N; ++i)
+    {
+      x[i] = i * 0.1 - 3.0;
+      y[i] = (i == N / 2) ? 1e300 * 10.0 : x[i] * x[i] * 1e-7;
+      n[i] = i - N / 2;
+    }
+  subplot = grm_args_new();
+  grm_args_push(subplot, "x", "nD", N, x);
+  grm_args_push(subplot, "y", "nD", N, y);
+  grm_args_push(subplot, "n", "nI", N, n);
+  grm_args_push(subplot, "labels", "nS", 3, labels);
+  args = grm_args_new();
+  grm_args_push(args, "subplots", "a", subplot);
+  grm_args_push(args, "title", "s", "Byte by byte");
+  grm_args_push(args, "size", "dd", 400.0, 300.0);
+  json_string = args_to_json(args);
+
+  /* feeding one byte at a time must give the same result as reading the string at once */
+  read_args = grm_args_new();
+  assert(read_byte_by_byte(read_args, json_string) == ERROR_NONE);
+  read_json_string = args_to_json(read_args);
+  assert(strcmp(json_string, read_json_string) == 0);
+  free(read_json_string);
+  grm_args_delete(read_args);
+
+  read_args = grm_args_new();
+  assert(fromjson_read(read_args, json_string) == ERROR_NONE);
+  read_json_string = args_to_json(read_args);
+  assert(strcmp(json_string, read_json_string) == 0);
+  free(read_json_string);
+  grm_args_delete(read_args);
+
+  free(json_string);
+  grm_args_delete(args);
+}
+
+static void test_invalid_documents(void)
+{
+  const char *valid_documents[] = {
+      "{}", " {\"a\": 1} \n", "{\"a\": -0}", "{\"a\": 1.}", "{\"a\": 1.5E+3}", "{\"a\": [NAN, -INF, 0.25]}",
+  };
+  const char *invalid_documents[] = {
+      "{\"a\": 1,}", "{\"a\": [1,]}", "{\"a\": 01}", "{\"a\": -01}",          "{\"a\": .5}",
+      "{\"a\": +1}", "{\"a\": 1e}",   "{\"a\": 1",  "{\"a\": 1}{\"b\": 2}", "{\"a\": 1} x",
+  };
+  grm_args_t *args;
+  size_t i;
+
+  for (i = 0; i < array_size(valid_documents); ++i)
+    {
+      args = grm_args_new();
+      assert(fromjson_read(args, valid_documents[i]) == ERROR_NONE);
+      grm_args_delete(args);
+      args = grm_args_new();
+      assert(read_byte_by_byte(args, valid_documents[i]) == ERROR_NONE);
+      grm_args_delete(args);
+    }
+  for (i = 0; i < array_size(invalid_documents); ++i)
+    {
+      args = grm_args_new();
+      assert(fromjson_read(args, invalid_documents[i]) != ERROR_NONE);
+      grm_args_delete(args);
+      args = grm_args_new();
+      assert(read_byte_by_byte(args, invalid_documents[i]) != ERROR_NONE);
+      grm_args_delete(args);
+    }
+}
+
+static void test(void)
+{
+  test_round_trip();
+  test_invalid_documents();
+}
+
+DEFINE_TEST_MAIN
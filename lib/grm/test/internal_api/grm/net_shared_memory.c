@@ -0,0 +1,139 @@
+#ifdef __unix__
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <grm.h>
+#include "test.h"
+
+#define N 20000
+#define ROUNDS 4
+
+static double x[N];
+
+static int count_shared_memory_mappings(void)
+{
+  /* Count the mapped segments of `gks_shm_open` (returns -1 if the mappings cannot be inspected) */
+  char line[4096];
+  FILE *maps;
+  int count = 0;
+
+  maps = fopen("/proc/self/maps", "r");
+  if (maps == NULL)
+    {
+      return -1;
+    }
+  while (fgets(line, sizeof(line), maps) != NULL)
+    {
+      if (strstr(line, "/gks-") != NULL) ++count;
+    }
+  fclose(maps);
+
+  return count;
+}
+
+static void send_messages(unsigned int port)
+{
+  grm_args_t *args;
+  void *handle;
+  int round;
+
+  handle = grm_open(GRM_SENDER, "localhost", port, NULL, NULL);
+  assert(handle != NULL);
+  for (round = 0; round < ROUNDS; ++round)
+    {
+      args = grm_args_new();
+      grm_args_push(args, "round", "i", round);
+      grm_args_push(args, "x", "nD", N, x);
+      assert(grm_send_args(handle, args));
+      grm_args_delete(args);
+    }
+  /* the receiver answers after all messages were read, so the shared memory segment is not removed too early */
+  args = grm_recv(handle, NULL);
+  assert(args != NULL);
+  grm_args_delete(args);
+  grm_close(handle);
+}
+
+static void receive_messages(unsigned int port, int use_shared_memory)
+{
+  grm_args_t *args;
+  void *handle;
+  double *received_x;
+  unsigned int length;
+  int round, received_round, mapping_count;
+
+  handle = grm_open(GRM_RECEIVER, "localhost", port, NULL, NULL);
+  assert(handle != NULL);
+  for (round = 0; round < ROUNDS; ++round)
+    {
+      args = grm_recv(handle, NULL);
+      assert(args != NULL);
+      assert(grm_args_values(args, "round", "i", &received_round));
+      assert(received_round == round);
+      assert(grm_args_first_value(args, "x", "D", &received_x, &length));
+      assert(length == N);
+      assert(memcmp(received_x, x, sizeof(x)) == 0);
+      grm_args_delete(args);
+    }
+  /* a segment is only used after it was mapped by the receiver, otherwise all messages come through the socket */
+  mapping_count = count_shared_memory_mappings();
+  if (mapping_count >= 0)
+    {
+      assert(use_shared_memory ? mapping_count > 0 : mapping_count == 0);
+    }
+  args = grm_args_new();
+  grm_args_push(args, "received", "i", ROUNDS);
+  assert(grm_send_args(handle, args));
+  grm_args_delete(args);
+  grm_close(handle);
+}
+
+static void test_transfer(unsigned int port, int use_shared_memory, int use_binary_protocol)
+{
+  pid_t pid;
+  int status;
+
+  unsetenv("GKS_SHARED_MEMORY");
+  if (use_binary_protocol)
+    {
+      setenv("GRM_BINARY_PROTOCOL", "1", 1);
+    }
+  else
+    {
+      unsetenv("GRM_BINARY_PROTOCOL");
+    }
+  pid = fork();
+  assert(pid >= 0);
+  if (pid == 0)
+    {
+      send_messages(port);
+      exit(0);
+    }
+  /* the receiver does not announce shared memory support if it is disabled, the sender must use the socket */
+  if (!use_shared_memory)
+    {
+      setenv("GKS_SHARED_MEMORY", "0", 1);
+    }
+  receive_messages(port, use_shared_memory);
+  assert(waitpid(pid, &status, 0) == pid);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+static void test(void)
+{
+  int i;
+
+  for (i = 0; i < N; ++i)
+    {
+      x[i] = i * 0.001 + 1e-7;
+    }
+  /* shared memory is negotiated for json messages by default, and for BSON messages if they are requested */
+  test_transfer(8135, 0, 0);
+  test_transfer(8136, 1, 0);
+  test_transfer(8137, 1, 1);
+}
+
+DEFINE_TEST_MAIN
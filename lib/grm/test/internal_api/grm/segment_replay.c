@@ -0,0 +1,149 @@
+#ifdef __unix__
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <grm.h>
+#include "test.h"
+
+#define N 1000
+
+static char *create_tmp_dir(void)
+{
+  const char *dirname_template = "grm.segment_replay.XXXXXX", *system_tmp_dir;
+  char *tmp_dir;
+
+  system_tmp_dir = getenv("TMPDIR");
+  if (system_tmp_dir == NULL)
+    {
+      system_tmp_dir = "/tmp";
+    }
+  tmp_dir = malloc(strlen(system_tmp_dir) + strlen(dirname_template) + 2);
+  assert(tmp_dir != NULL);
+  sprintf(tmp_dir, "%s/%s", system_tmp_dir, dirname_template);
+  assert(mkdtemp(tmp_dir) != NULL);
+
+  return tmp_dir;
+}
+
+static char *tmp_file_path(const char *tmp_dir, const char *filename)
+{
+  char *path = malloc(strlen(tmp_dir) + strlen(filename) + 2);
+
+  assert(path != NULL);
+  sprintf(path, "%s/%s", tmp_dir, filename);
+
+  return path;
+}
+
+static char *read_page(const char *path, size_t *length)
+{
+  /*
+   * Read the drawing commands of a PostScript file as a sequence of blank separated tokens. The lines which differ
+   * between two print files are dropped. A direct drawing pass sets the color before each line while a replayed
+   * segment only sets changed colors, so color settings which repeat the current color are dropped as well.
+   */
+  FILE *file;
+  char line[4096], color[256] = "", *page, *token, *color_start;
+  size_t size = 0, token_length, color_starts[4] = {0, 0, 0, 0};
+
+  file = fopen(path, "r");
+  assert(file != NULL);
+  page = malloc(sizeof(line) + 1);
+  assert(page != NULL);
+  while (fgets(line, sizeof(line), file) != NULL)
+    {
+      if (strncmp(line, "%%CreationDate", 14) == 0 || strncmp(line, "%%Title", 7) == 0) continue;
+      for (token = strtok(line, " \n"); token != NULL; token = strtok(NULL, " \n"))
+        {
+          if (strcmp(token, "sc") == 0)
+            {
+              color_start = page + color_starts[1];
+              if (size - color_starts[1] < sizeof(color) && strncmp(color, color_start, size - color_starts[1]) == 0 &&
+                  color[size - color_starts[1]] == '\0')
+                {
+                  size = color_starts[1];
+                  continue;
+                }
+              if (size - color_starts[1] < sizeof(color))
+                {
+                  memcpy(color, color_start, size - color_starts[1]);
+                  color[size - color_starts[1]] = '\0';
+                }
+            }
+          token_length = strlen(token);
+          page = realloc(page, size + token_length + 2);
+          assert(page != NULL);
+          memmove(color_starts, color_starts + 1, 3 * sizeof(size_t));
+          color_starts[3] = size;
+          memcpy(page + size, token, token_length);
+          size += token_length;
+          page[size++] = ' ';
+        }
+    }
+  fclose(file);
+  page[size] = '\0';
+  *length = size;
+
+  return page;
+}
+
+static void test(void)
+{
+  double x[N], y[N];
+  char *tmp_dir, *recorded_path, *replayed_path, *recorded, *replayed;
+  size_t recorded_length, replayed_length;
+  grm_args_t *args;
+  int i;
+
+#ifdef _WIN32
+  putenv("GKS_WSTYPE=nul");
+#else
+  setenv("GKS_WSTYPE", "nul", 1);
+#endif
+  tmp_dir = create_tmp_dir();
+  recorded_path = tmp_file_path(tmp_dir, "recorded.ps");
+  replayed_path = tmp_file_path(tmp_dir, "replayed.ps");
+  for (i = 0; i < N; ++i)
+    {
+      x[i] = i * 2 * 3.14159 / N;
+      y[i] = x[i] * x[i] / 10;
+    }
+  args = grm_args_new();
+  grm_args_push(args, "x", "nD", N, x);
+  grm_args_push(args, "y", "nD", N, y);
+  grm_args_push(args, "title", "s", "Segment replay");
+
+  /* the first pass draws the plot and records it, the second pass replays the unchanged plot from its segments */
+  grm_merge(args);
+  assert(grm_export(recorded_path));
+  assert(grm_export(replayed_path));
+
+  recorded = read_page(recorded_path, &recorded_length);
+  replayed = read_page(replayed_path, &replayed_length);
+  assert(recorded_length > 0);
+  assert(recorded_length == replayed_length);
+  assert(memcmp(recorded, replayed, recorded_length) == 0);
+
+  /* a modified plot must be drawn again */
+  grm_args_push(args, "title", "s", "Modified");
+  grm_merge(args);
+  assert(grm_export(replayed_path));
+  free(replayed);
+  replayed = read_page(replayed_path, &replayed_length);
+  assert(replayed_length != recorded_length || memcmp(recorded, replayed, recorded_length) != 0);
+
+  free(recorded);
+  free(replayed);
+  remove(recorded_path);
+  remove(replayed_path);
+  remove(tmp_dir);
+  free(recorded_path);
+  free(replayed_path);
+  free(tmp_dir);
+  grm_args_delete(args);
+  grm_finalize();
+}
+
+DEFINE_TEST_MAIN
@@ -0,0 +1,148 @@
+#ifdef __unix__
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <grm.h>
+#include "test.h"
+
+#define N 1000
+
+static char *create_tmp_dir(void)
+{
+  const char *dirname_template = "grm.snapshot_round_trip.XXXXXX", *system_tmp_dir;
+  char *tmp_dir;
+
+  system_tmp_dir = getenv("TMPDIR");
+  if (system_tmp_dir == NULL)
+    {
+      system_tmp_dir = "/tmp";
+    }
+  tmp_dir = malloc(strlen(system_tmp_dir) + strlen(dirname_template) + 2);
+  assert(tmp_dir != NULL);
+  sprintf(tmp_dir, "%s/%s", system_tmp_dir, dirname_template);
+  assert(mkdtemp(tmp_dir) != NULL);
+
+  return tmp_dir;
+}
+
+static char *tmp_file_path(const char *tmp_dir, const char *filename)
+{
+  char *path = malloc(strlen(tmp_dir) + strlen(filename) + 2);
+
+  assert(path != NULL);
+  sprintf(path, "%s/%s", tmp_dir, filename);
+
+  return path;
+}
+
+static void write_broken_copy(const char *source_path, const char *destination_path, long length, long count_offset)
+{
+  /* Copy the first `length` bytes of a file and replace the 32 bit count at `count_offset` (if >= 0) by 2^32 - 1 */
+  FILE *source, *destination;
+  char *data;
+
+  source = fopen(source_path, "rb");
+  assert(source != NULL);
+  data = malloc(length);
+  assert(data != NULL);
+  assert(fread(data, 1, length, source) == (size_t)length);
+  fclose(source);
+  if (count_offset >= 0) memset(data + count_offset, 0xff, 4);
+  destination = fopen(destination_path, "wb");
+  assert(destination != NULL);
+  assert(fwrite(data, 1, length, destination) == (size_t)length);
+  fclose(destination);
+  free(data);
+}
+
+static int load(const char *path)
+{
+  FILE *file;
+  int success;
+
+  file = fopen(path, "rb");
+  assert(file != NULL);
+  success = grm_load_graphics_tree(file);
+  fclose(file);
+
+  return success;
+}
+
+static void test_round_trip(const char *path, const char *expected_tree)
+{
+  char *loaded_tree;
+
+  assert(grm_export(path));
+  assert(load(path));
+  loaded_tree = grm_dump_graphics_tree_str();
+  assert(strcmp(expected_tree, loaded_tree) == 0);
+  free(loaded_tree);
+}
+
+static void test(void)
+{
+  double x[N], y[N];
+  char *tmp_dir, *snapshot_path, *compressed_snapshot_path, *broken_snapshot_path, *tree, *unchanged_tree;
+  grm_args_t *args;
+  FILE *file;
+  long size;
+  int i;
+
+#ifdef _WIN32
+  putenv("GKS_WSTYPE=nul");
+#else
+  setenv("GKS_WSTYPE", "nul", 1);
+#endif
+  tmp_dir = create_tmp_dir();
+  snapshot_path = tmp_file_path(tmp_dir, "snapshot.grm");
+  compressed_snapshot_path = tmp_file_path(tmp_dir, "snapshot.grmz");
+  broken_snapshot_path = tmp_file_path(tmp_dir, "broken.grm");
+  for (i = 0; i < N; ++i)
+    {
+      x[i] = i * 2 * 3.14159 / N;
+      y[i] = x[i] * x[i] / 10;
+    }
+  args = grm_args_new();
+  grm_args_push(args, "x", "nD", N, x);
+  grm_args_push(args, "y", "nD", N, y);
+  grm_args_push(args, "title", "s", "Snapshot");
+  grm_merge(args);
+  tree = grm_dump_graphics_tree_str();
+
+  /* saving and loading a snapshot must restore the same graphics tree and context */
+  test_round_trip(snapshot_path, tree);
+  test_round_trip(compressed_snapshot_path, tree);
+
+  /* broken snapshots are rejected and leave the current graphics tree untouched */
+  file = fopen(snapshot_path, "rb");
+  assert(file != NULL);
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fclose(file);
+  write_broken_copy(snapshot_path, broken_snapshot_path, size / 2, -1);
+  assert(!load(broken_snapshot_path));
+  write_broken_copy(snapshot_path, broken_snapshot_path, 16, -1);
+  assert(!load(broken_snapshot_path));
+  /* the name count is the first field after the 32 byte header */
+  write_broken_copy(snapshot_path, broken_snapshot_path, size, 32);
+  assert(!load(broken_snapshot_path));
+  unchanged_tree = grm_dump_graphics_tree_str();
+  assert(strcmp(tree, unchanged_tree) == 0);
+
+  free(tree);
+  free(unchanged_tree);
+  remove(snapshot_path);
+  remove(compressed_snapshot_path);
+  remove(broken_snapshot_path);
+  remove(tmp_dir);
+  free(snapshot_path);
+  free(compressed_snapshot_path);
+  free(broken_snapshot_path);
+  free(tmp_dir);
+  grm_args_delete(args);
+  grm_finalize();
+}
+
+DEFINE_TEST_MAIN
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "grm.h"
+
+/*
+ * Measure key lookups in argument containers. The first test uses one large container, the second one mimics a plot
+ * with many series (a series array in a subplot) where many keys are queried per series.
+ *
+ * Usage: args_benchmark [number of keys / series] [number of lookup passes]
+ */
+
+#define SERIES_KEY_COUNT 20
+
+static double seconds_since(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void test_large_container(int num_keys, int num_passes)
+{
+  grm_args_t *args;
+  char key[32];
+  clock_t start;
+  double push_time, lookup_time;
+  int i, j, value;
+  long sum = 0;
+
+  args = grm_args_new();
+  start = clock();
+  for (i = 0; i < num_keys; ++i)
+    {
+      sprintf(key, "key_%d", i);
+      grm_args_push(args, key, "i", i);
+    }
+  push_time = seconds_since(start);
+
+  start = clock();
+  for (j = 0; j < num_passes; ++j)
+    {
+      for (i = 0; i < num_keys; ++i)
+        {
+          sprintf(key, "key_%d", (i * 7919) % num_keys);
+          if (grm_args_values(args, key, "i", &value))
+            {
+              sum += value;
+            }
+        }
+    }
+  lookup_time = seconds_since(start);
+  grm_args_delete(args);
+
+  printf("large container: %d keys, checksum %ld\n", num_keys, sum);
+  printf("  time per push: %.1f ns\n", push_time * 1e9 / num_keys);
+  printf("  time per lookup: %.1f ns\n", lookup_time * 1e9 / ((double)num_keys * num_passes));
+}
+
+static void test_many_series(int num_series, int num_passes)
+{
+  static const char *series_keys[SERIES_KEY_COUNT] = {
+      "x",         "y",          "z",          "c",          "error",      "spec",        "label",
+      "line_spec", "marker",     "markersize", "line_width", "line_color", "orientation", "x_range",
+      "y_range",   "bin_counts", "bin_edges",  "step_where", "draw_edges", "fill_color"};
+  grm_args_t *subplot, **series;
+  grm_args_t **series_array;
+  unsigned int series_count;
+  clock_t start;
+  double lookup_time;
+  int i, j, k, value;
+  long sum = 0;
+
+  series = malloc(num_series * sizeof(grm_args_t *));
+  for (i = 0; i < num_series; ++i)
+    {
+      series[i] = grm_args_new();
+      for (k = 0; k < SERIES_KEY_COUNT; ++k)
+        {
+          grm_args_push(series[i], series_keys[k], "i", i + k);
+        }
+    }
+  subplot = grm_args_new();
+  grm_args_push(subplot, "kind", "s", "line");
+  grm_args_push(subplot, "series", "nA", (size_t)num_series, series);
+  free(series);
+
+  start = clock();
+  for (j = 0; j < num_passes; ++j)
+    {
+      grm_args_first_value(subplot, "series", "A", &series_array, &series_count);
+      for (i = 0; i < (int)series_count; ++i)
+        {
+          for (k = 0; k < SERIES_KEY_COUNT; ++k)
+            {
+              if (grm_args_values(series_array[i], series_keys[(k * 7) % SERIES_KEY_COUNT], "i", &value))
+                {
+                  sum += value;
+                }
+            }
+        }
+    }
+  lookup_time = seconds_since(start);
+  grm_args_delete(subplot);
+
+  printf("many series: %d series with %d keys, checksum %ld\n", num_series, SERIES_KEY_COUNT, sum);
+  printf("  time per lookup: %.1f ns\n", lookup_time * 1e9 / ((double)num_series * SERIES_KEY_COUNT * num_passes));
+}
+
+int main(int argc, char **argv)
+{
+  int num_keys = (argc > 1) ? atoi(argv[1]) : 1000;
+  int num_passes = (argc > 2) ? atoi(argv[2]) : 1000;
+
+  test_large_container(num_keys, num_passes);
+  test_many_series(num_keys, num_passes);
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#ifdef __unix__
+#define _XOPEN_SOURCE 600
+#endif
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "grm.h"
+#include <grm/dom_render/render.hxx>
+#include <grm/dom_render/graphics_tree/Element.hxx>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * Measure the time the renderer spends per element for a large generated graphics tree. Drawing is sent to the GKS
+ * NULL workstation (unless `GKS_WSTYPE` is set), so mostly the processing of the tree itself is measured.
+ *
+ * Usage: render_benchmark [number of generated elements] [number of render passes]
+ */
+
+static unsigned long count_elements(const GRM::Element &element)
+{
+  unsigned long count = 1;
+  for (const auto &child : element.childElements())
+    {
+      count += count_elements(child);
+    }
+  return count;
+}
+
+static void test_render_benchmark(int num_elements, int num_passes)
+{
+  std::vector<double> x(100), y(100);
+  grm_args_t *args;
+  int i;
+
+  for (i = 0; i < 100; ++i)
+    {
+      x[i] = i * 2 * M_PI / 100;
+      y[i] = sin(x[i]);
+    }
+  args = grm_args_new();
+  grm_args_push(args, "x", "nD", 100, x.data());
+  grm_args_push(args, "y", "nD", 100, y.data());
+  grm_args_push(args, "kind", "s", "line");
+  grm_plot(args);
+  grm_args_delete(args);
+
+  auto render = grm_get_render();
+  auto root = grm_get_document_root();
+  auto central_region = root->querySelectors("central_region");
+  /* otherwise every appended element triggers a render pass */
+  GRM::Render::setAutoUpdate(false);
+  for (i = 0; i < num_elements; ++i)
+    {
+      double t = i * 2 * M_PI / num_elements;
+      if (i % 2 == 0)
+        {
+          central_region->append(render->createPolyline(t, t + 0.01, sin(t), cos(t)));
+        }
+      else
+        {
+          central_region->append(render->createPolymarker(t, sin(t)));
+        }
+    }
+  unsigned long total_elements = count_elements(*root);
+
+  /* the first pass processes the new elements and fills all caches */
+  render->render();
+
+  auto start = std::chrono::steady_clock::now();
+  for (i = 0; i < num_passes; ++i)
+    {
+      /* modifying the context invalidates all cached plots, so every pass processes the whole tree */
+      (*render->getContext())["_render_benchmark_pass"] = std::vector<int>{i};
+      render->render();
+    }
+  auto end = std::chrono::steady_clock::now();
+  double pass_time = std::chrono::duration<double, std::milli>(end - start).count() / num_passes;
+
+  printf("elements: %lu\n", total_elements);
+  printf("time per render pass: %.3f ms\n", pass_time);
+  printf("time per element: %.3f us\n", pass_time * 1000.0 / total_elements);
+}
+
+int main(int argc, char **argv)
+{
+  int num_elements = (argc > 1) ? atoi(argv[1]) : 20000;
+  int num_passes = (argc > 2) ? atoi(argv[2]) : 10;
+
+  if (!getenv("GKS_WSTYPE"))
+    {
+#ifdef _WIN32
+      static char gks_wstype[] = "GKS_WSTYPE=100";
+      putenv(gks_wstype);
+#else
+      setenv("GKS_WSTYPE", "100", 1);
+#endif
+    }
+  test_render_benchmark(num_elements, num_passes);
+  grm_finalize();
+
+  return 0;
+}